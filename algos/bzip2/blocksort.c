@@ -762,7 +762,7 @@ void AOCL_mainSimpleSort ( UInt32* ptr,
 
 #endif
 
- void (*AOCL_mainSimpleSort_fp) ( UInt32* ptr,
+AOCL_TLS void (*AOCL_mainSimpleSort_fp) ( UInt32* ptr,
                       UChar*  block,
                       UInt16* quadrant,
                       Int32   nblock,
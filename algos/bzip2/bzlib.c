@@ -31,6 +31,10 @@
 
 #include "utils/utils.h"
 #include "bzlib_private.h"
+#ifdef AOCL_ENABLE_THREADS
+#include "api/aocl_threads.h"
+#include "threads/threads.h"
+#endif
 
 #ifdef AOCL_BZIP2_OPT
 /* Dynamic dispatcher setup function for native APIs.
@@ -44,7 +48,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_bzip2 = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_bzip2 = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /*---------------------------------------------------*/
 /*--- Compression stuff                           ---*/
@@ -110,9 +114,9 @@ static Bool AOCL_copy_output_until_stop_avx ( EState* s );
 #endif /* AOCL_BZIP2_AVX_OPT */
 #endif
 
- Int32 (*AOCL_BZ2_decompress_fp) ( DState* ) = BZ2_decompress;
- Bool  (*AOCL_copy_input_until_stop_fp) ( EState* s) = copy_input_until_stop;
- Bool  (*AOCL_copy_output_until_stop_fp) ( EState* s) = copy_output_until_stop;
+AOCL_TLS Int32 (*AOCL_BZ2_decompress_fp) ( DState* ) = BZ2_decompress;
+AOCL_TLS Bool  (*AOCL_copy_input_until_stop_fp) ( EState* s) = copy_input_until_stop;
+AOCL_TLS Bool  (*AOCL_copy_output_until_stop_fp) ( EState* s) = copy_output_until_stop;
 
 void aocl_register_decompress_fmv(int optOff, int optLevel)
 {
@@ -209,37 +213,32 @@ BZ_EXTERN char * BZ_API(aocl_setup_bzip2)
                        size_t level,
                        size_t windowLog )
 {
-    AOCL_ENTER_CRITICAL(setup_bzip2)
-    if (!setup_ok_bzip2) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_decompress_fmv(optOff, optLevel);
-        aocl_register_copy_fmv(optOff, optLevel);
-        aocl_register_mainSimpleSort_fmv(optOff, optLevel);
-        setup_ok_bzip2 = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_bzip2)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_bzip2 == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_decompress_fmv(optOff, optLevel);
+    aocl_register_copy_fmv(optOff, optLevel);
+    aocl_register_mainSimpleSort_fmv(optOff, optLevel);
+    dispatch_key_bzip2 = dispatchKey;
    return NULL;
 }
 
 #ifdef AOCL_BZIP2_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_bzip2)
-    if (!setup_ok_bzip2) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_decompress_fmv(optOff, optLevel);
-        aocl_register_copy_fmv(optOff, optLevel);
-        aocl_register_mainSimpleSort_fmv(optOff, optLevel);
-        setup_ok_bzip2 = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_bzip2)
+    if (dispatch_key_bzip2 != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_decompress_fmv(optOff, optLevel);
+    aocl_register_copy_fmv(optOff, optLevel);
+    aocl_register_mainSimpleSort_fmv(optOff, optLevel);
+    dispatch_key_bzip2 = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 BZ_EXTERN void BZ_API(aocl_destroy_bzip2) (void){
-    AOCL_ENTER_CRITICAL(setup_bzip2)
-    setup_ok_bzip2 = 0;
-    AOCL_EXIT_CRITICAL(setup_bzip2)
+    dispatch_key_bzip2 = AOCL_DISPATCH_UNSET;
 }
 
 /*---------------------------------------------------*/
@@ -368,6 +367,38 @@ int BZ_API(BZ2_bzCompressInit)
 }
 
 
+/*---------------------------------------------------*/
+/*-- Rewinds an initialised compressor to the start of
+     a new stream, keeping its block sorting buffers. --*/
+static
+int compress_reset ( bz_stream* strm )
+{
+   EState* s;
+   if (strm == NULL) return BZ_PARAM_ERROR;
+   s = strm->state;
+   if (s == NULL) return BZ_PARAM_ERROR;
+   if (s->strm != strm) return BZ_PARAM_ERROR;
+
+   s->blockNo           = 0;
+   s->state             = BZ_S_INPUT;
+   s->mode              = BZ_M_RUNNING;
+   s->combinedCRC       = 0;
+
+   s->block             = (UChar*)s->arr2;
+   s->mtfv              = (UInt16*)s->arr1;
+   s->zbits             = NULL;
+   s->ptr               = (UInt32*)s->arr1;
+
+   strm->total_in_lo32  = 0;
+   strm->total_in_hi32  = 0;
+   strm->total_out_lo32 = 0;
+   strm->total_out_hi32 = 0;
+   init_RL ( s );
+   prepare_new_block ( s );
+   return BZ_OK;
+}
+
+
 /*---------------------------------------------------*/
 static
 void add_pair_to_block ( EState* s )
@@ -821,6 +852,7 @@ int BZ_API(BZ2_bzDecompressInit)
    s->ll4                   = NULL;
    s->ll16                  = NULL;
    s->tt                    = NULL;
+   s->allocSize100k         = 0;
    s->currBlockNo           = 0;
    s->verbosity             = verbosity;
 
@@ -828,6 +860,33 @@ int BZ_API(BZ2_bzDecompressInit)
 }
 
 
+/*---------------------------------------------------*/
+/*-- Rewinds an initialised decompressor to the start of
+     a new stream. Its block buffers are kept for streams
+     of the same block size. --*/
+static
+int decompress_reset ( bz_stream* strm )
+{
+   DState* s;
+   if (strm == NULL) return BZ_PARAM_ERROR;
+   s = strm->state;
+   if (s == NULL) return BZ_PARAM_ERROR;
+   if (s->strm != strm) return BZ_PARAM_ERROR;
+
+   s->state                 = BZ_X_MAGIC_1;
+   s->bsLive                = 0;
+   s->bsBuff                = 0;
+   s->calculatedCombinedCRC = 0;
+   strm->total_in_lo32      = 0;
+   strm->total_in_hi32      = 0;
+   strm->total_out_lo32     = 0;
+   strm->total_out_hi32     = 0;
+   s->currBlockNo           = 0;
+
+   return BZ_OK;
+}
+
+
 /*---------------------------------------------------*/
 /* Return  True iff data corruption is discovered.
    Returns False if there is no problem.
@@ -1551,6 +1610,627 @@ void BZ_API(BZ2_bzReadGetUnused)
 /*--- Misc convenience stuff                      ---*/
 /*---------------------------------------------------*/
 
+#ifdef AOCL_ENABLE_THREADS
+/*---------------------------------------------------*/
+/*--
+   Multi-threaded buffer to buffer compression and
+   decompression.
+
+   Compression splits the source into partitions through
+   the threads/ partition scheduler.  Each partition is
+   sorted and encoded into its own blocks by a separate
+   thread.  The blocks of all the partitions are then
+   bit-concatenated between one stream header and one
+   end of stream marker, and the combined stream CRC is
+   rebuilt from the combined CRCs of the partitions.
+   The result is a standard .bz2 stream.
+
+   Decompression locates the blocks of a standard stream
+   by scanning for the 48-bit block magic, the same way
+   bzip2recover does.  Each block is wrapped into a one
+   block stream and decoded by a separate thread.
+--*/
+/*---------------------------------------------------*/
+
+/*-- Returned when a call is to be served by the
+     single threaded code path. --*/
+#define BZ_MT_USE_ST         (-100)
+
+#define BZ_BLOCK_MAGIC       0x314159265359ULL
+#define BZ_EOS_MAGIC         0x177245385090ULL
+#define BZ_MAGIC_BITS        48
+#define BZ_CRC_BITS          32
+#define BZ_STREAM_HDR_BITS   32
+
+#define BZ_ROTL32(x,n) \
+   ((n) % 32 == 0 ? (x) : (((x) << ((n) % 32)) | ((x) >> (32 - (n) % 32))))
+
+typedef
+   struct {
+      UChar* out;
+      UInt32 buff;
+      Int32  live;
+   }
+   BitWriter;
+
+static
+void bw_init ( BitWriter* bw, UChar* out )
+{
+   bw->out  = out;
+   bw->buff = 0;
+   bw->live = 0;
+}
+
+/*-- Appends the n (<= 24) low bits of v. --*/
+static
+void bw_put ( BitWriter* bw, Int32 n, UInt32 v )
+{
+   bw->buff = (bw->buff << n) | (v & ((1U << n) - 1));
+   bw->live += n;
+   while (bw->live >= 8) {
+      bw->live -= 8;
+      *(bw->out++) = (UChar)(bw->buff >> bw->live);
+   }
+}
+
+static
+void bw_put_magic_and_crc ( BitWriter* bw, ULong64 magic, UInt32 crc )
+{
+   bw_put ( bw, 24, (UInt32)(magic >> 24) );
+   bw_put ( bw, 24, (UInt32)magic );
+   bw_put ( bw, 16, crc >> 16 );
+   bw_put ( bw, 16, crc );
+}
+
+/*-- Pads the last byte with zero bits.
+     Returns the end of the written data. --*/
+static
+UChar* bw_finish ( BitWriter* bw )
+{
+   if (bw->live > 0) bw_put ( bw, 8 - bw->live, 0 );
+   return bw->out;
+}
+
+/*-- Reads n (<= 32) bits of src starting at bit pos. --*/
+static
+UInt32 get_bits_mt ( const UChar* src, ULong64 srcLen,
+                     ULong64 pos, Int32 n )
+{
+   ULong64 acc = 0;
+   ULong64 idx = pos >> 3;
+   Int32   k;
+   for (k = 0; k < 5; k++)
+      acc = (acc << 8) | (idx + k < srcLen ? src[idx + k] : 0);
+   return (UInt32)((acc << (24 + (pos & 7))) >> (64 - n));
+}
+
+/*-- Appends nBits bits of src starting at bit pos. --*/
+static
+void bw_copy ( BitWriter* bw, const UChar* src, ULong64 srcLen,
+               ULong64 pos, ULong64 nBits )
+{
+   const UChar* p = src + (pos >> 3);
+   Int32   shift  = (Int32)(pos & 7);
+   ULong64 nBytes = nBits >> 3;
+   ULong64 i;
+
+   if (shift == 0 && bw->live == 0) {
+      memcpy ( bw->out, p, nBytes );
+      bw->out += nBytes;
+   } else if (shift == 0) {
+      for (i = 0; i < nBytes; i++) bw_put ( bw, 8, p[i] );
+   } else {
+      for (i = 0; i < nBytes; i++)
+         bw_put ( bw, 8, ((UInt32)p[i] << shift) | (p[i + 1] >> (8 - shift)) );
+   }
+   if (nBits & 7)
+      bw_put ( bw, (Int32)(nBits & 7),
+               get_bits_mt ( src, srcLen, pos + (nBytes << 3),
+                             (Int32)(nBits & 7) ) );
+}
+
+
+/*---------------------------------------------------*/
+/*-- Encoded blocks of one compressed partition. --*/
+typedef
+   struct {
+      ULong64 nBits;    /* bits of the blocks, after the stream header */
+      UInt32  nBlocks;
+      UInt32  combinedCRC;
+   }
+   MTPartition;
+
+/*-- Compresses one partition into a complete stream in
+     dst_trap, and records where its blocks end, how many
+     there are and their combined CRC. --*/
+static
+int compress_partition_mt ( aocl_thread_info_t* cThread,
+                            MTPartition* part,
+                            int blockSize100k,
+                            int verbosity,
+                            int workFactor )
+{
+   bz_stream strm;
+   EState*   s;
+   int       ret;
+
+   strm.bzalloc = NULL;
+   strm.bzfree = NULL;
+   strm.opaque = NULL;
+   ret = BZ2_bzCompressInit ( &strm, blockSize100k,
+                              verbosity, workFactor );
+   if (ret != BZ_OK) return ret;
+
+   strm.next_in = cThread->partition_src;
+   strm.next_out = cThread->dst_trap;
+   strm.avail_in = (unsigned int)cThread->partition_src_size;
+   strm.avail_out = (unsigned int)cThread->dst_trap_size;
+
+   ret = BZ2_bzCompress ( &strm, BZ_FINISH );
+   if (ret == BZ_STREAM_END) {
+      s = strm.state;
+      /*-- bsFinishWrite leaves bsLive at minus the number
+           of padding bits in the last byte. Only the last
+           block of a stream can be empty. --*/
+      cThread->dst_trap_size = strm.total_out_lo32;
+      part->nBits = ((ULong64)strm.total_out_lo32 << 3) - (ULong64)(-s->bsLive)
+                    - BZ_STREAM_HDR_BITS - BZ_MAGIC_BITS - BZ_CRC_BITS;
+      part->nBlocks = s->blockNo - (s->nblock == 0 ? 1 : 0);
+      part->combinedCRC = s->combinedCRC;
+      ret = BZ_OK;
+   } else if (ret == BZ_FINISH_OK) {
+      ret = BZ_OUTBUFF_FULL;
+   }
+   BZ2_bzCompressEnd ( &strm );
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+//Arguments shared by the workers of bzBuffToBuffCompress_MT()
+typedef struct {
+   aocl_thread_group_t* thread_grp;
+   MTPartition* parts;
+   int blockSize100k;
+   int verbosity;
+   int workFactor;
+   int dispatch_key;   //Dispatcher setup of the thread that started the region
+} MTCompressArgs;
+
+//Worker of bzBuffToBuffCompress_MT(): compresses partitions until none is left
+static
+void compress_partitions_mt ( void* arg, AOCL_UINT32 worker_id )
+{
+   MTCompressArgs* args = (MTCompressArgs*)arg;
+   aocl_thread_group_t* thread_grp = args->thread_grp;
+   aocl_thread_info_t cur_thread_info;
+   AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_bzip2);
+   AOCL_UINT32 thread_id;
+   //Take partitions from this thread's queue first, then steal pending ones from the other threads
+   while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+   {
+      AOCL_INTP part_src_size = thread_grp->common_part_src_size +
+                                 thread_grp->leftover_part_src_bytes;
+      //Worst case expansion of bzip2 is 1% + 600 bytes
+      AOCL_UINT32 cmpr_bound_pad = (AOCL_UINT32)(part_src_size / 100) + 600;
+      AOCL_INT32 is_error = BZ_MEM_ERROR;
+      if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
+      {
+         is_error = compress_partition_mt(&cur_thread_info, &args->parts[thread_id],
+                                          args->blockSize100k, args->verbosity, args->workFactor);
+      } //aocl_do_partition_compress_mt
+      thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+      thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+      thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+      thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+      thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+      thread_grp->threads_info_list[thread_id].last_bytes_len = 0;
+      thread_grp->threads_info_list[thread_id].is_error = is_error;
+      thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+   }
+}
+
+/*---------------------------------------------------*/
+static
+int bzBuffToBuffCompress_MT ( char*         dest, 
+                              unsigned int* destLen,
+                              char*         source, 
+                              unsigned int  sourceLen,
+                              int           blockSize100k, 
+                              int           verbosity, 
+                              int           workFactor )
+{
+   aocl_thread_group_t thread_group_handle;
+   aocl_thread_info_t  cur_thread_info;
+   MTPartition*        parts;
+   BitWriter           bw;
+   AOCL_INT32          rap_metadata_len;
+   AOCL_UINT32         thread_cnt;
+   ULong64             total_bits;
+   UInt32              combinedCRC = 0;
+   int                 ret = BZ_OK;
+
+   /*-- The thread group setup writes its frame header
+        into dest, which the stream overwrites later. --*/
+   if (*destLen < RAP_START_OF_PARTITIONS) return BZ_MT_USE_ST;
+
+   /*-- Partitions hold at least one full block. --*/
+   rap_metadata_len = aocl_setup_parallel_compress_mt ( &thread_group_handle,
+                         source, dest, sourceLen, *destLen,
+                         100000 * blockSize100k - 19, 1 );
+   if (rap_metadata_len < 0) return BZ_MEM_ERROR;
+   if (thread_group_handle.num_threads == 1) return BZ_MT_USE_ST;
+
+   parts = malloc ( sizeof(MTPartition) * thread_group_handle.num_threads );
+   if (parts == NULL) {
+      aocl_destroy_parallel_compress_mt ( &thread_group_handle );
+      return BZ_MEM_ERROR;
+   }
+
+   //workers take the dispatcher setup of this thread
+   MTCompressArgs args = { &thread_group_handle, parts, blockSize100k, verbosity, workFactor, dispatch_key_bzip2 };
+   aocl_run_parallel_mt(compress_partitions_mt, &args, thread_group_handle.num_workers);
+
+   //Post processing in single-threaded mode: Bit-concatenates the blocks of the partitions
+   total_bits = BZ_STREAM_HDR_BITS + BZ_MAGIC_BITS + BZ_CRC_BITS;
+   for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+   {
+      cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+      //In case of any thread partitioning or alloc errors, exit the compression process with error
+      if ((AOCL_INT32)cur_thread_info.is_error != BZ_OK)
+      {
+         ret = (AOCL_INT32)cur_thread_info.is_error;
+         break;
+      }
+      total_bits += parts[thread_cnt].nBits;
+   }
+   if (ret == BZ_OK && ((total_bits + 7) >> 3) > *destLen)
+      ret = BZ_OUTBUFF_FULL;
+
+   if (ret == BZ_OK) {
+      bw_init ( &bw, (UChar*)dest );
+      bw_put ( &bw, 8, BZ_HDR_B );
+      bw_put ( &bw, 8, BZ_HDR_Z );
+      bw_put ( &bw, 8, BZ_HDR_h );
+      bw_put ( &bw, 8, BZ_HDR_0 + blockSize100k );
+      for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+      {
+         cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+         bw_copy ( &bw, (UChar*)cur_thread_info.dst_trap,
+                   cur_thread_info.dst_trap_size, BZ_STREAM_HDR_BITS,
+                   parts[thread_cnt].nBits );
+         /*-- Each block rotates the combined CRC by one bit --*/
+         combinedCRC = BZ_ROTL32 ( combinedCRC, parts[thread_cnt].nBlocks );
+         combinedCRC ^= parts[thread_cnt].combinedCRC;
+      }
+      bw_put_magic_and_crc ( &bw, BZ_EOS_MAGIC, combinedCRC );
+      *destLen = (unsigned int)(bw_finish ( &bw ) - (UChar*)dest);
+   }
+
+   free ( parts );
+   aocl_destroy_parallel_compress_mt ( &thread_group_handle );
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+/*-- A block of the stream being decompressed. --*/
+typedef
+   struct {
+      ULong64      pos;     /* bit offset of the block magic */
+      ULong64      nBits;   /* bits up to the next magic */
+      char*        out;
+      unsigned int outLen;
+      int          ret;
+   }
+   MTBlock;
+
+/*-- Finds the blocks of the first stream in src by scanning
+     for the block and end of stream magics at every bit
+     offset, as bzip2recover does.  A byte which is fully
+     covered by a magic selects the offsets worth testing.
+     Returns the number of blocks, 0 when the stream has
+     none or is incomplete, or -1 on allocation failure. --*/
+static
+Int32 find_blocks_mt ( const UChar* src, ULong64 srcLen,
+                       MTBlock** blocks, UInt32* streamCRC )
+{
+   UInt16   cand[256];
+   MTBlock* list = NULL;
+   Int32    nBlocks = 0, nAlloc = 0;
+   ULong64  i;
+   Int32    sh;
+
+   memset ( cand, 0, sizeof(cand) );
+   for (sh = 0; sh < 8; sh++) {
+      cand[(BZ_BLOCK_MAGIC >> (32 + sh)) & 0xff] |= (UInt16)(1 << sh);
+      cand[(BZ_EOS_MAGIC   >> (32 + sh)) & 0xff] |= (UInt16)(0x100 << sh);
+   }
+
+   /*-- A magic must be followed by its 32-bit CRC --*/
+   for (i = BZ_STREAM_HDR_BITS >> 3; i + 10 <= srcLen; i++) {
+      UInt16  m = cand[src[i + 1]];
+      ULong64 w;
+      Int32   k;
+      if (m == 0) continue;
+      w = 0;
+      for (k = 0; k < 8; k++) w = (w << 8) | src[i + k];
+      for (sh = 0; sh < 8; sh++) {
+         ULong64 pos = (i << 3) + sh;
+         ULong64 v = (w << sh) >> 16;
+         if (pos + BZ_MAGIC_BITS + BZ_CRC_BITS > (srcLen << 3)) break;
+         if ((m & (1 << sh)) && v == BZ_BLOCK_MAGIC) {
+            if (nBlocks == nAlloc) {
+               MTBlock* grown;
+               nAlloc = nAlloc ? 2 * nAlloc : 64;
+               grown = realloc ( list, sizeof(MTBlock) * nAlloc );
+               if (grown == NULL) { free ( list ); return -1; }
+               list = grown;
+            }
+            if (nBlocks > 0)
+               list[nBlocks - 1].nBits = pos - list[nBlocks - 1].pos;
+            list[nBlocks].pos = pos;
+            list[nBlocks].out = NULL;
+            list[nBlocks].outLen = 0;
+            nBlocks++;
+         }
+         if ((m & (0x100 << sh)) && v == BZ_EOS_MAGIC && nBlocks > 0) {
+            list[nBlocks - 1].nBits = pos - list[nBlocks - 1].pos;
+            *streamCRC = get_bits_mt ( src, srcLen, pos + BZ_MAGIC_BITS,
+                                       BZ_CRC_BITS );
+            *blocks = list;
+            return nBlocks;
+         }
+      }
+   }
+   free ( list );
+   return 0;
+}
+
+/*-- Wraps blk into a one block stream and decompresses it
+     into a buffer of its own, of at most maxLen bytes. --*/
+static
+int decompress_block_mt ( const UChar* src, ULong64 srcLen,
+                          MTBlock* blk, int blockSize100k,
+                          int verbosity, unsigned int maxLen )
+{
+   bz_stream strm;
+   BitWriter bw;
+   UChar*    stream;
+   ULong64   streamLen, capacity;
+   UInt32    blockCRC;
+   int       ret;
+
+   stream = malloc ( (BZ_STREAM_HDR_BITS >> 3) + (blk->nBits >> 3) + 1 +
+                     ((BZ_MAGIC_BITS + BZ_CRC_BITS) >> 3) + 1 );
+   if (stream == NULL) return BZ_MEM_ERROR;
+
+   /*-- The combined CRC of a one block stream is the
+        CRC of its block --*/
+   blockCRC = get_bits_mt ( src, srcLen, blk->pos + BZ_MAGIC_BITS,
+                            BZ_CRC_BITS );
+   bw_init ( &bw, stream );
+   bw_put ( &bw, 8, BZ_HDR_B );
+   bw_put ( &bw, 8, BZ_HDR_Z );
+   bw_put ( &bw, 8, BZ_HDR_h );
+   bw_put ( &bw, 8, BZ_HDR_0 + blockSize100k );
+   bw_copy ( &bw, src, srcLen, blk->pos, blk->nBits );
+   bw_put_magic_and_crc ( &bw, BZ_EOS_MAGIC, blockCRC );
+   streamLen = bw_finish ( &bw ) - stream;
+
+   strm.bzalloc = NULL;
+   strm.bzfree = NULL;
+   strm.opaque = NULL;
+   ret = BZ2_bzDecompressInit ( &strm, verbosity, 0 );
+   if (ret != BZ_OK) { free ( stream ); return ret; }
+
+   capacity = 100000 * blockSize100k;
+   if (capacity > maxLen) capacity = maxLen;
+   blk->out = malloc ( capacity );
+   if (blk->out == NULL) ret = BZ_MEM_ERROR;
+
+   strm.next_in = (char*)stream;
+   strm.avail_in = (unsigned int)streamLen;
+   strm.next_out = blk->out;
+   strm.avail_out = (unsigned int)capacity;
+
+   while (ret == BZ_OK) {
+      ret = BZ2_bzDecompress ( &strm );
+      if (ret != BZ_OK) break;
+      if (strm.avail_out > 0) {
+         ret = BZ_UNEXPECTED_EOF;
+      } else if (capacity == maxLen) {
+         ret = BZ_OUTBUFF_FULL;
+      } else {
+         /*-- Runs of up to 259 bytes decode from 5 block
+              bytes, so grow the output as needed --*/
+         ULong64 grown_capacity = 2 * capacity;
+         char*   grown;
+         if (grown_capacity > maxLen) grown_capacity = maxLen;
+         grown = realloc ( blk->out, grown_capacity );
+         if (grown == NULL) { ret = BZ_MEM_ERROR; break; }
+         blk->out = grown;
+         strm.next_out = blk->out + capacity;
+         strm.avail_out = (unsigned int)(grown_capacity - capacity);
+         capacity = grown_capacity;
+      }
+   }
+   if (ret == BZ_STREAM_END) {
+      blk->outLen = strm.total_out_lo32;
+      ret = BZ_OK;
+   }
+
+   BZ2_bzDecompressEnd ( &strm );
+   free ( stream );
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+//Arguments shared by the workers of bzBuffToBuffDecompress_MT()
+typedef struct {
+   const UChar* src;
+   unsigned int sourceLen;
+   MTBlock*     blocks;
+   Int32        blockSize100k;
+   int          verbosity;
+   unsigned int maxLen;
+   int          dispatch_key;   //Dispatcher setup of the thread that started the region
+} MTDecompressArgs;
+
+//aocl_run_parallel_for_mt() task decoding the block block_id
+static
+void decompress_blocks_mt ( void* arg, AOCL_INTP block_id, AOCL_UINT32 worker_id )
+{
+   MTDecompressArgs* args = (MTDecompressArgs*)arg;
+   MTBlock*          blk  = &args->blocks[block_id];
+   (void)worker_id;
+   AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_bzip2);
+   blk->ret = decompress_block_mt ( args->src, args->sourceLen, blk,
+                                    args->blockSize100k, args->verbosity,
+                                    args->maxLen );
+}
+
+
+/*---------------------------------------------------*/
+static
+int bzBuffToBuffDecompress_MT ( char*         dest, 
+                                unsigned int* destLen,
+                                char*         source, 
+                                unsigned int  sourceLen,
+                                int           verbosity )
+{
+   const UChar* src = (const UChar*)source;
+   MTBlock*     blocks = NULL;
+   Int32        nBlocks, i;
+   Int32        max_threads = aocl_get_num_threads_mt();
+   Int32        blockSize100k;
+   UInt32       streamCRC = 0, combinedCRC = 0;
+   ULong64      total = 0;
+   int          ret = BZ_OK;
+
+   if (max_threads == 1 || *destLen == 0) return BZ_MT_USE_ST;
+
+   /*-- Malformed streams, and any failure other than a too
+        small dest, are left to the single threaded
+        decompressor, which reports the exact error --*/
+   if (sourceLen < (BZ_STREAM_HDR_BITS >> 3) ||
+       src[0] != BZ_HDR_B || src[1] != BZ_HDR_Z || src[2] != BZ_HDR_h ||
+       src[3] < BZ_HDR_0 + 1 || src[3] > BZ_HDR_0 + 9)
+      return BZ_MT_USE_ST;
+   blockSize100k = src[3] - BZ_HDR_0;
+
+   nBlocks = find_blocks_mt ( src, sourceLen, &blocks, &streamCRC );
+   if (nBlocks < 0) return BZ_MT_USE_ST;
+   if (nBlocks < 2 || blocks[0].pos != BZ_STREAM_HDR_BITS) {
+      free ( blocks );
+      return BZ_MT_USE_ST;
+   }
+
+   /*-- A magic sequence occurring by chance inside the
+        coded data would break the block CRC chain --*/
+   for (i = 0; i < nBlocks; i++) {
+      combinedCRC = BZ_ROTL32 ( combinedCRC, 1 );
+      combinedCRC ^= get_bits_mt ( src, sourceLen,
+                                   blocks[i].pos + BZ_MAGIC_BITS,
+                                   BZ_CRC_BITS );
+   }
+   if (combinedCRC != streamCRC) {
+      free ( blocks );
+      return BZ_MT_USE_ST;
+   }
+
+   {
+      //workers take the dispatcher setup of this thread
+      MTDecompressArgs args = { src, sourceLen, blocks, blockSize100k,
+                                verbosity, *destLen, dispatch_key_bzip2 };
+      aocl_run_parallel_for_mt ( decompress_blocks_mt, &args, nBlocks,
+                                 max_threads < nBlocks ? max_threads : nBlocks );
+   }
+
+   for (i = 0; i < nBlocks && ret == BZ_OK; i++) {
+      ret = blocks[i].ret;
+      total += blocks[i].outLen;
+   }
+   if (ret == BZ_OK && total > *destLen) ret = BZ_OUTBUFF_FULL;
+
+   if (ret == BZ_OK) {
+      total = 0;
+      for (i = 0; i < nBlocks; i++) {
+         memcpy ( dest + total, blocks[i].out, blocks[i].outLen );
+         total += blocks[i].outLen;
+      }
+      *destLen = (unsigned int)total;
+   } else if (ret != BZ_OUTBUFF_FULL) {
+      ret = BZ_MT_USE_ST;
+   }
+
+   for (i = 0; i < nBlocks; i++) free ( blocks[i].out );
+   free ( blocks );
+   return ret;
+}
+#endif /* AOCL_ENABLE_THREADS */
+
+
+/*---------------------------------------------------*/
+/*-- Compresses source as one stream with the
+     initialised compressor strm. --*/
+static
+int bzBuffToBuffCompress_ST ( bz_stream*    strm,
+                              char*         dest, 
+                              unsigned int* destLen,
+                              char*         source, 
+                              unsigned int  sourceLen )
+{
+   int ret;
+
+   strm->next_in = source;
+   strm->next_out = dest;
+   strm->avail_in = sourceLen;
+   strm->avail_out = *destLen;
+
+   ret = BZ2_bzCompress ( strm, BZ_FINISH );
+   if (ret == BZ_FINISH_OK) return BZ_OUTBUFF_FULL;
+   if (ret != BZ_STREAM_END) return ret;
+
+   /* normal termination */
+   *destLen -= strm->avail_out;   
+   return BZ_OK;
+}
+
+
+/*---------------------------------------------------*/
+/*-- Decompresses the stream in source with the
+     initialised decompressor strm. --*/
+static
+int bzBuffToBuffDecompress_ST ( bz_stream*    strm,
+                                char*         dest, 
+                                unsigned int* destLen,
+                                char*         source, 
+                                unsigned int  sourceLen )
+{
+   int ret;
+
+   strm->next_in = source;
+   strm->next_out = dest;
+   strm->avail_in = sourceLen;
+   strm->avail_out = *destLen;
+
+   ret = BZ2_bzDecompress ( strm );
+   if (ret == BZ_OK) {
+      if (strm->avail_out > 0)
+         return BZ_UNEXPECTED_EOF;
+      else
+         return BZ_OUTBUFF_FULL;
+   }
+   if (ret != BZ_STREAM_END) return ret;
+
+   /* normal termination */
+   *destLen -= strm->avail_out;
+   return BZ_OK;
+}
+
+
 /*---------------------------------------------------*/
 int BZ_API(BZ2_bzBuffToBuffCompress) 
                          ( char*         dest, 
@@ -1577,6 +2257,15 @@ int BZ_API(BZ2_bzBuffToBuffCompress)
    }
 
    if (workFactor == 0) workFactor = 30;
+#ifdef AOCL_ENABLE_THREADS
+   ret = bzBuffToBuffCompress_MT ( dest, destLen, source, sourceLen,
+                                   blockSize100k, verbosity, workFactor );
+   if (ret != BZ_MT_USE_ST)
+   {
+      LOG_UNFORMATTED(INFO, logCtx, "Exit");
+      return ret;
+   }
+#endif
    strm.bzalloc = NULL;
    strm.bzfree = NULL;
    strm.opaque = NULL;
@@ -1588,27 +2277,7 @@ int BZ_API(BZ2_bzBuffToBuffCompress)
       return ret;
    }
 
-   strm.next_in = source;
-   strm.next_out = dest;
-   strm.avail_in = sourceLen;
-   strm.avail_out = *destLen;
-
-   ret = BZ2_bzCompress ( &strm, BZ_FINISH );
-   if (ret == BZ_FINISH_OK) goto output_overflow;
-   if (ret != BZ_STREAM_END) goto errhandler;
-
-   /* normal termination */
-   *destLen -= strm.avail_out;   
-   BZ2_bzCompressEnd ( &strm );
-   LOG_UNFORMATTED(INFO, logCtx, "Exit");
-   return BZ_OK;
-
-   output_overflow:
-   BZ2_bzCompressEnd ( &strm );
-   LOG_UNFORMATTED(INFO, logCtx, "Exit");
-   return BZ_OUTBUFF_FULL;
-
-   errhandler:
+   ret = bzBuffToBuffCompress_ST ( &strm, dest, destLen, source, sourceLen );
    BZ2_bzCompressEnd ( &strm );
    LOG_UNFORMATTED(INFO, logCtx, "Exit");
    return ret;
@@ -1638,6 +2307,20 @@ int BZ_API(BZ2_bzBuffToBuffDecompress)
           return BZ_PARAM_ERROR;
        }
 
+#ifdef AOCL_ENABLE_THREADS
+   /*-- The small decompression mode is kept for memory
+        constrained callers and runs single threaded --*/
+   if (small == 0)
+   {
+      ret = bzBuffToBuffDecompress_MT ( dest, destLen, source, sourceLen,
+                                        verbosity );
+      if (ret != BZ_MT_USE_ST)
+      {
+         LOG_UNFORMATTED(INFO, logCtx, "Exit");
+         return ret;
+      }
+   }
+#endif
    strm.bzalloc = NULL;
    strm.bzfree = NULL;
    strm.opaque = NULL;
@@ -1648,35 +2331,142 @@ int BZ_API(BZ2_bzBuffToBuffDecompress)
       return ret;
    }
 
-   strm.next_in = source;
-   strm.next_out = dest;
-   strm.avail_in = sourceLen;
-   strm.avail_out = *destLen;
+   ret = bzBuffToBuffDecompress_ST ( &strm, dest, destLen, source, sourceLen );
+   BZ2_bzDecompressEnd ( &strm );
+   LOG_UNFORMATTED(INFO, logCtx, "Exit");
+   return ret; 
+}
 
-   ret = BZ2_bzDecompress ( &strm );
-   if (ret == BZ_OK) goto output_overflow_or_eof;
-   if (ret != BZ_STREAM_END) goto errhandler;
 
-   /* normal termination */
-   *destLen -= strm.avail_out;
-   BZ2_bzDecompressEnd ( &strm );
+/*---------------------------------------------------*/
+int BZ_API(BZ2_bzBuffToBuffCompressReuse) 
+                         ( bz_stream*    strm,
+                           char*         dest, 
+                           unsigned int* destLen,
+                           char*         source, 
+                           unsigned int  sourceLen,
+                           int           blockSize100k, 
+                           int           verbosity, 
+                           int           workFactor )
+{
+   AOCL_SETUP_NATIVE();
+   LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+   EState* s;
+   int ret;
+
+   if (strm == NULL ||
+       dest == NULL || destLen == NULL || 
+       source == NULL ||
+       blockSize100k < 1 || blockSize100k > 9 ||
+       verbosity < 0 || verbosity > 4 ||
+       workFactor < 0 || workFactor > 250)
+   {
+      LOG_UNFORMATTED(INFO, logCtx, "Exit");
+      return BZ_PARAM_ERROR;
+   }
+
+   if (workFactor == 0) workFactor = 30;
+#ifdef AOCL_ENABLE_THREADS
+   /*-- Partitions are compressed by states of their own --*/
+   ret = bzBuffToBuffCompress_MT ( dest, destLen, source, sourceLen,
+                                   blockSize100k, verbosity, workFactor );
+   if (ret != BZ_MT_USE_ST)
+   {
+      LOG_UNFORMATTED(INFO, logCtx, "Exit");
+      return ret;
+   }
+#endif
+   s = strm->state;
+   if (s != NULL &&
+       (s->strm != strm || s->blockSize100k != blockSize100k ||
+        s->verbosity != verbosity || s->workFactor != workFactor)) {
+      /*-- The buffers are sized by the block size --*/
+      BZ2_bzCompressEnd ( strm );
+      strm->state = NULL;
+      s = NULL;
+   }
+   if (s == NULL) {
+      strm->bzalloc = NULL;
+      strm->bzfree = NULL;
+      strm->opaque = NULL;
+      ret = BZ2_bzCompressInit ( strm, blockSize100k, 
+                                 verbosity, workFactor );
+   } else {
+      ret = compress_reset ( strm );
+   }
+   if (ret != BZ_OK)
+   {
+      LOG_UNFORMATTED(INFO, logCtx, "Exit");
+      return ret;
+   }
+
+   ret = bzBuffToBuffCompress_ST ( strm, dest, destLen, source, sourceLen );
    LOG_UNFORMATTED(INFO, logCtx, "Exit");
-   return BZ_OK;
+   return ret;
+}
+
+
+/*---------------------------------------------------*/
+int BZ_API(BZ2_bzBuffToBuffDecompressReuse) 
+                           ( bz_stream*    strm,
+                             char*         dest, 
+                             unsigned int* destLen,
+                             char*         source, 
+                             unsigned int  sourceLen,
+                             int           small,
+                             int           verbosity )
+{
+   AOCL_SETUP_NATIVE();
+   LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+   DState* s;
+   int ret;
 
-   output_overflow_or_eof:
-   if (strm.avail_out > 0) {
-      BZ2_bzDecompressEnd ( &strm );
+   if (strm == NULL ||
+       dest == NULL || destLen == NULL || 
+       source == NULL ||
+       (small != 0 && small != 1) ||
+       verbosity < 0 || verbosity > 4) 
+   {
       LOG_UNFORMATTED(INFO, logCtx, "Exit");
-      return BZ_UNEXPECTED_EOF;
+      return BZ_PARAM_ERROR;
+   }
+
+#ifdef AOCL_ENABLE_THREADS
+   /*-- Blocks are decompressed by states of their own --*/
+   if (small == 0)
+   {
+      ret = bzBuffToBuffDecompress_MT ( dest, destLen, source, sourceLen,
+                                        verbosity );
+      if (ret != BZ_MT_USE_ST)
+      {
+         LOG_UNFORMATTED(INFO, logCtx, "Exit");
+         return ret;
+      }
+   }
+#endif
+   s = strm->state;
+   if (s != NULL &&
+       (s->strm != strm || s->smallDecompress != (Bool)small ||
+        s->verbosity != verbosity)) {
+      BZ2_bzDecompressEnd ( strm );
+      strm->state = NULL;
+      s = NULL;
+   }
+   if (s == NULL) {
+      strm->bzalloc = NULL;
+      strm->bzfree = NULL;
+      strm->opaque = NULL;
+      ret = BZ2_bzDecompressInit ( strm, verbosity, small );
    } else {
-      BZ2_bzDecompressEnd ( &strm );
+      ret = decompress_reset ( strm );
+   }
+   if (ret != BZ_OK)
+   {
       LOG_UNFORMATTED(INFO, logCtx, "Exit");
-      return BZ_OUTBUFF_FULL;
-   };      
+      return ret;
+   }
 
-   errhandler:
-   BZ2_bzDecompressEnd ( &strm );
-   
+   ret = bzBuffToBuffDecompress_ST ( strm, dest, destLen, source, sourceLen );
    LOG_UNFORMATTED(INFO, logCtx, "Exit");
    return ret; 
 }
@@ -694,6 +694,10 @@ BZ_EXTERN void BZ_API(BZ2_bzWriteClose64) (
 * The resulting compressed data is a complete bzip2 format data stream. There is no mechanism for making additional 
 * calls to provide extra input data. If you want that kind of mechanism, use the low-level interface.
 * 
+* -# When the library is built with AOCL_ENABLE_THREADS, sources spanning several blocks are split into 
+* partitions whose blocks are sorted and encoded by multiple threads. The blocks are concatenated into a 
+* single standard bzip2 stream. A partition may end with a partially filled block.
+* 
 */
 BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffCompress) ( 
       char*         dest, 
@@ -738,6 +742,10 @@ BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffCompress) (
 *
 * -# BZ2_bzBuffToBuffDecompress will not write data at or beyond dest[*destLen], even in case of buffer overflow.
 * 
+* -# When the library is built with AOCL_ENABLE_THREADS and `small` is 0, the blocks of the stream are located 
+* by scanning for the block magic and are decompressed by multiple threads. Streams that cannot be split this 
+* way are decompressed by a single thread.
+* 
 */
 BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffDecompress) ( 
       char*         dest, 
@@ -748,6 +756,68 @@ BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffDecompress) (
       int           verbosity 
    );
 
+/*!
+* @brief Same as BZ2_bzBuffToBuffCompress, with the compression state kept in `strm` across calls.
+* 
+* | Parameters | Direction   | Description |
+* |:-----------|:-----------:|:------------|
+* | \b strm          | in,out | Holds the compression state. Zero it before the first call, release it with BZ2_bzCompressEnd after the last one. |
+* | \b dest          | out    | This is the destination buffer, the compressed data is written to this buffer. |
+* | \b destLen       | in,out | Size of buffer `dest` (which must be already allocated).|
+* | \b source        | in     | Source buffer, the data to be compressed is copied/or pointed here. |
+* | \b sourceLen     | in     | Size of buffer `source`. |
+* | \b blockSize100k | in     | Same as in BZ2_bzBuffToBuffCompress. |
+* | \b verbosity     | in     | Same as in BZ2_bzBuffToBuffCompress. |
+* | \b workFactor    | in     | Same as in BZ2_bzBuffToBuffCompress. |
+*
+* @return Same as BZ2_bzBuffToBuffCompress. `BZ_PARAM_ERROR` is also returned if strm is NULL.
+* 
+* @note
+* -# The block sorting buffers allocated by the first call are reused by the following calls 
+* with the same `blockSize100k`, `verbosity` and `workFactor`. Other settings replace them.
+* 
+*/
+BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffCompressReuse) ( 
+      bz_stream*    strm,
+      char*         dest, 
+      unsigned int* destLen,
+      char*         source, 
+      unsigned int  sourceLen,
+      int           blockSize100k, 
+      int           verbosity, 
+      int           workFactor 
+   );
+
+/*!
+* @brief Same as BZ2_bzBuffToBuffDecompress, with the decompression state kept in `strm` across calls.
+* 
+* | Parameters | Direction   | Description |
+* |:-----------|:-----------:|:------------|
+* | \b strm          | in,out | Holds the decompression state. Zero it before the first call, release it with BZ2_bzDecompressEnd after the last one. |
+* | \b dest          | out    | This is the destination buffer, the data is decompressed to this buffer. |
+* | \b destLen       | in,out | Size of buffer `dest` (which must be already allocated).|
+* | \b source        | in     | Source buffer, the data to be decompressed is pointed here. |
+* | \b sourceLen     | in     | Size of buffer `source`. |
+* | \b small         | in     | Same as in BZ2_bzBuffToBuffDecompress. |
+* | \b verbosity     | in     | Same as in BZ2_bzBuffToBuffDecompress. |
+*
+* @return Same as BZ2_bzBuffToBuffDecompress. `BZ_PARAM_ERROR` is also returned if strm is NULL.
+* 
+* @note
+* -# The block buffers allocated by a call are reused by the following calls while the 
+* streams have the same block size.
+* 
+*/
+BZ_EXTERN int BZ_API(BZ2_bzBuffToBuffDecompressReuse) ( 
+      bz_stream*    strm,
+      char*         dest, 
+      unsigned int* destLen,
+      char*         source, 
+      unsigned int  sourceLen,
+      int           small, 
+      int           verbosity 
+   );
+
 /**
  * @}
 */
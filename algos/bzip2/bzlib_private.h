@@ -387,6 +387,9 @@ typedef
       UInt16   *ll16;
       UChar    *ll4;
 
+      /* block size the buffers above are allocated for, 0 if none */
+      Int32    allocSize100k;
+
       /* stored and calculated CRCs */
       UInt32   storedBlockCRC;
       UInt32   storedCombinedCRC;
@@ -209,15 +209,24 @@ Int32 BZ2_decompress ( DState* s )
           s->blockSize100k > (BZ_HDR_0 + 9)) RETURN(BZ_DATA_ERROR_MAGIC);
       s->blockSize100k -= BZ_HDR_0;
 
-      if (s->smallDecompress) {
-         s->ll16 = BZALLOC( s->blockSize100k * 100000 * sizeof(UInt16) );
-         s->ll4  = BZALLOC( 
-                      ((1 + s->blockSize100k * 100000) >> 1) * sizeof(UChar) 
-                   );
-         if (s->ll16 == NULL || s->ll4 == NULL) RETURN(BZ_MEM_ERROR);
-      } else {
-         s->tt  = BZALLOC( s->blockSize100k * 100000 * sizeof(Int32) );
-         if (s->tt == NULL) RETURN(BZ_MEM_ERROR);
+      /*-- Streams rewound by decompress_reset keep the
+           buffers of the same block size --*/
+      if (s->allocSize100k != s->blockSize100k) {
+         if (s->tt   != NULL) { BZFREE(s->tt);   s->tt   = NULL; }
+         if (s->ll16 != NULL) { BZFREE(s->ll16); s->ll16 = NULL; }
+         if (s->ll4  != NULL) { BZFREE(s->ll4);  s->ll4  = NULL; }
+         s->allocSize100k = 0;
+         if (s->smallDecompress) {
+            s->ll16 = BZALLOC( s->blockSize100k * 100000 * sizeof(UInt16) );
+            s->ll4  = BZALLOC( 
+                         ((1 + s->blockSize100k * 100000) >> 1) * sizeof(UChar) 
+                      );
+            if (s->ll16 == NULL || s->ll4 == NULL) RETURN(BZ_MEM_ERROR);
+         } else {
+            s->tt  = BZALLOC( s->blockSize100k * 100000 * sizeof(Int32) );
+            if (s->tt == NULL) RETURN(BZ_MEM_ERROR);
+         }
+         s->allocSize100k = s->blockSize100k;
       }
 
       GET_UCHAR(BZ_X_BLKHDR_1, uc);
@@ -868,15 +877,24 @@ Int32 AOCL_BZ2_decompress ( DState* s )
           s->blockSize100k > (BZ_HDR_0 + 9)) RETURN(BZ_DATA_ERROR_MAGIC);
       s->blockSize100k -= BZ_HDR_0;
 
-      if (s->smallDecompress) {
-         s->ll16 = BZALLOC( s->blockSize100k * 100000 * sizeof(UInt16) );
-         s->ll4  = BZALLOC( 
-                      ((1 + s->blockSize100k * 100000) >> 1) * sizeof(UChar) 
-                   );
-         if (s->ll16 == NULL || s->ll4 == NULL) RETURN(BZ_MEM_ERROR);
-      } else {
-         s->tt  = BZALLOC( s->blockSize100k * 100000 * sizeof(Int32) );
-         if (s->tt == NULL) RETURN(BZ_MEM_ERROR);
+      /*-- Streams rewound by decompress_reset keep the
+           buffers of the same block size --*/
+      if (s->allocSize100k != s->blockSize100k) {
+         if (s->tt   != NULL) { BZFREE(s->tt);   s->tt   = NULL; }
+         if (s->ll16 != NULL) { BZFREE(s->ll16); s->ll16 = NULL; }
+         if (s->ll4  != NULL) { BZFREE(s->ll4);  s->ll4  = NULL; }
+         s->allocSize100k = 0;
+         if (s->smallDecompress) {
+            s->ll16 = BZALLOC( s->blockSize100k * 100000 * sizeof(UInt16) );
+            s->ll4  = BZALLOC( 
+                         ((1 + s->blockSize100k * 100000) >> 1) * sizeof(UChar) 
+                      );
+            if (s->ll16 == NULL || s->ll4 == NULL) RETURN(BZ_MEM_ERROR);
+         } else {
+            s->tt  = BZALLOC( s->blockSize100k * 100000 * sizeof(Int32) );
+            if (s->tt == NULL) RETURN(BZ_MEM_ERROR);
+         }
+         s->allocSize100k = s->blockSize100k;
       }
 
       GET_UCHAR(BZ_X_BLKHDR_1, uc);
@@ -199,7 +199,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_lz4 = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_lz4 = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /*-************************************
 *  Memory routines
@@ -321,6 +321,14 @@ typedef enum {
 
 #ifdef AOCL_ENABLE_THREADS
 #include "threads/threads.h"
+#ifdef AOCL_LZ4_AVX_OPT
+/* Post processing shared by the multi-threaded LZ4 and LZ4HC compressors. Declared with the
+ * common definitions so that lz4hc.c can use it */
+int AOCL_LZ4_join_partitions_mt(aocl_thread_group_t* thread_grp, AOCL_INT32 rap_metadata_len);
+#define AOCL_LZ4_JOIN_DST_TOO_SMALL (-1)
+/* Non-zero when the dynamic dispatcher selected the multi-threaded LZ4 compressor and decompressor */
+int AOCL_LZ4_mt_enabled(void);
+#endif /* AOCL_LZ4_AVX_OPT */
 #endif
 
 /*-************************************
@@ -684,7 +692,7 @@ unsigned LZ4_count(const BYTE* pIn, const BYTE* pMatch, const BYTE* pInLimit)
  * CPU features */
 /* Function pointer definition placed inside #ifndef LZ4_COMMONDEFS_ONLY to avoid
  warnings related to unused variable. */
-static int (*LZ4_compress_fast_extState_fp)(void* state, const char* source,
+static AOCL_TLS int (*LZ4_compress_fast_extState_fp)(void* state, const char* source,
     char* dest, int inputSize,
     int maxOutputSize, int acceleration) = LZ4_compress_fast_extState;
 
@@ -2572,6 +2580,47 @@ int AOCL_LZ4_compress_fast_extState_mt(void* state, const char* source, char* de
         }
     }
 }
+
+//Same as AOCL_LZ4_compress_fast_extState_mt, but matches may also reference the last (up to 64 KB)
+//prefixSize bytes just before source. Hash table is primed as in LZ4_loadDict, with the hash of the compressor
+static int AOCL_LZ4_compress_prefix_extState_mt(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration, int prefixSize, unsigned char** last_anchor_ptr, unsigned int* last_bytes_len)
+{
+    if (state == NULL || source == NULL || dest == NULL || prefixSize < 0)
+        return 0;
+
+    LZ4_stream_t_internal* const ctx = &LZ4_initStream(state, sizeof(LZ4_stream_t))->internal_donotuse;
+    const BYTE* const prefixEnd = (const BYTE*)source;
+    const BYTE* p;
+    const BYTE* base;
+    assert(ctx != NULL);
+    if (acceleration < 1) acceleration = LZ4_ACCELERATION_DEFAULT;
+    if (acceleration > LZ4_ACCELERATION_MAX) acceleration = LZ4_ACCELERATION_MAX;
+    if (prefixSize > (int)(64 KB)) prefixSize = 64 KB;
+
+    /* Indexes of the prefix start a whole window after 0, as in LZ4_loadDict */
+    ctx->currentOffset += 64 KB;
+    p = prefixEnd - prefixSize;
+    base = prefixEnd - ctx->currentOffset;
+    ctx->dictionary = p;
+    ctx->dictSize = (U32)prefixSize;
+    ctx->tableType = (U32)byU32;
+    if (prefixSize >= (int)sizeof(reg_t)) {
+        while (p <= prefixEnd - sizeof(reg_t)) {
+            AOCL_LZ4_putPosition(p, ctx->hashTable, byU32, base);
+            p += 3;
+        }
+    }
+
+    /* dictSmall rejects the empty table entries that point before a prefix shorter than 64 KB */
+    if (maxOutputSize >= LZ4_compressBound(inputSize)) {
+        return AOCL_LZ4_compress_generic_mt(ctx, source, dest, inputSize, NULL, last_anchor_ptr, last_bytes_len, 0, notLimited, byU32, withPrefix64k,
+            (prefixSize < (int)(64 KB)) ? dictSmall : noDictIssue, acceleration);
+    }
+    else {
+        return AOCL_LZ4_compress_generic_mt(ctx, source, dest, inputSize, NULL, last_anchor_ptr, last_bytes_len, maxOutputSize, limitedOutput, byU32, withPrefix64k,
+            (prefixSize < (int)(64 KB)) ? dictSmall : noDictIssue, acceleration);
+    }
+}
 #endif /* AOCL_LZ4_AVX_OPT */
 #endif /* AOCL_ENABLE_THREADS */
 
@@ -2648,265 +2697,359 @@ int LZ4_compress_fast_ST(const char* source, char* dest, int inputSize, int maxO
 }
 
 #ifdef AOCL_LZ4_AVX_OPT
-/* This function does not use any AVX code, but it produces output with RAP frame added.
-* This data is not compatible with the single threaded decompress APIs. Hence, it is placed under
-* AOCL_LZ4_AVX_OPT and made to pair with AOCL_LZ4_decompress_safe_mt().
+/* Joined sequence written between two neighboring partition chunks: the first sequence of a chunk
+* takes over the left over literals of the previous chunk */
+typedef struct {
+    AOCL_CHAR* dst;             /* position of the joined sequence header in the final stream */
+    const AOCL_CHAR* lit_src;   /* left over literals of the previous chunk, in the source buffer */
+    size_t lit_len;             /* literal length of the joined sequence */
+    AOCL_UINT32 lit_src_len;    /* number of left over literals of the previous chunk */
+    AOCL_UINT32 size;           /* header and left over literal bytes written at dst */
+    AOCL_UCHAR token_low;       /* match length bits of the first sequence's token */
+} AOCL_LZ4_junction_t;
+
+static void AOCL_LZ4_write_junction(const AOCL_LZ4_junction_t* junction) {
+    BYTE* op = (BYTE*)junction->dst;
+    if (junction->lit_len >= RUN_MASK) {
+        size_t accumulator = junction->lit_len - RUN_MASK;
+        *op++ = (BYTE)((RUN_MASK << ML_BITS) | junction->token_low);
+        for (; accumulator >= 255; accumulator -= 255)
+            *op++ = (BYTE)255;
+        *op++ = (BYTE)accumulator;
+    }
+    else {
+        *op++ = (BYTE)((junction->lit_len << ML_BITS) | junction->token_low);
+    }
+    memcpy(op, junction->lit_src, junction->lit_src_len);
+}
+
+//aocl_run_parallel_for_mt() task writing the junction of partition junction_id
+static void AOCL_LZ4_write_junction_task(void* junctions, AOCL_INTP junction_id, AOCL_UINT32 worker_id) {
+    const AOCL_LZ4_junction_t* junction = (const AOCL_LZ4_junction_t*)junctions + junction_id;
+    (void)worker_id;
+    if (junction->size)
+        AOCL_LZ4_write_junction(junction);
+}
+
+/* Post processing of the multi-threaded LZ4 and LZ4HC compressors, in single-threaded mode.
+* The output of every partition but the last stops before its last literals, whose position in the
+* source and length are held in additional_state_info and last_bytes_len. The thread group is left
+* for the caller to destroy. Returns the length of the final stream, 0 on error, or
+* AOCL_LZ4_JOIN_DST_TOO_SMALL when the stream with its RAP frame does not fit in dst, in which
+* case the caller compresses in single-threaded mode instead.
 */
-int AOCL_LZ4_compress_fast_mt(const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration){
-    if ((source == NULL && inputSize != 0) || dest == NULL)
-        return 0;
-    
+int AOCL_LZ4_join_partitions_mt(aocl_thread_group_t* thread_grp, AOCL_INT32 rap_metadata_len) {
     int result;
-    aocl_thread_group_t thread_group_handle;
     aocl_thread_info_t cur_thread_info;
     aocl_thread_info_t prev_thread_info;
-    AOCL_INT32 rap_metadata_len = -1;
     AOCL_UINT32 thread_cnt = 0;
     AOCL_UINT32 dst_offset = 0;
-    
-    rap_metadata_len = aocl_setup_parallel_compress_mt(&thread_group_handle, (char *)source,
-                                                 dest, inputSize, maxOutputSize,
-                                                 LZ4_COMPRESS_INPLACE_MARGIN,
-                                                 WINDOW_FACTOR);
-    if (rap_metadata_len < 0)
-        return 0;
- 
-    if (thread_group_handle.num_threads == 1)
+
+    //Prepares RAP frame and plans the joining of the last sequences of the neighboring threads.
+    //Partition outputs are then moved to their final positions in parallel and the joined sequences are written in the gaps left between them.
+
+    // <-- RAP Header -->
+    //Add at the start of the stream : Although it can be at the end or at any other point in the stream, but it is more easier for parsing at the start
+    AOCL_CHAR* dst_org = thread_grp->dst;
+    AOCL_CHAR* dst_ptr = dst_org;
+    AOCL_UINT32 prev_offset, prev_len;
+    AOCL_UINT32 decomp_len;
+    aocl_partition_move_t* moves;
+    AOCL_LZ4_junction_t* junctions;
+    thread_grp->dst += rap_metadata_len;
+    dst_ptr += RAP_START_OF_PARTITIONS;
+    // <-- RAP Header -->
+
+    moves = (aocl_partition_move_t*)malloc(thread_grp->num_threads *
+                (sizeof(aocl_partition_move_t) + sizeof(AOCL_LZ4_junction_t)));
+    if (moves == NULL)
     {
-        return LZ4_compress_fast_ST(source, dest, inputSize, maxOutputSize, acceleration);
+        return 0;
     }
-    else
+    junctions = (AOCL_LZ4_junction_t*)(moves + thread_grp->num_threads);
+
+    // <-- RAP Metadata payload -->
+    //For the first thread:
+    prev_thread_info = thread_grp->threads_info_list[thread_cnt++];
+    //In case of any thread partitioning or alloc errors, exit the compression process with error
+    if (prev_thread_info.is_error || prev_thread_info.dst_trap_size < 0)
     {
+        result = 0;
+        free(moves);
 #ifdef AOCL_THREADS_LOG
-        printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
+        printf("Compress Thread [id: %d] : Encountered ERROR\n", thread_cnt-1);
 #endif
-
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
+        return result;
+    }
+    //First chunk goes as it is to the output final buffer
+    moves[0].src = prev_thread_info.dst_trap;
+    moves[0].dst = thread_grp->dst;
+    moves[0].size = prev_thread_info.dst_trap_size;
+    junctions[0].size = 0;
+    //For storing this thread's decompressed (src) length
+    decomp_len = prev_thread_info.partition_src_size - prev_thread_info.last_bytes_len;
+    if (((AOCL_UCHAR *)prev_thread_info.additional_state_info - (AOCL_UCHAR*)prev_thread_info.partition_src) !=
+        decomp_len)
+    {
 #ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
+        printf("Compress Thread [id: %d] : Error in last bytes position\n", thread_cnt);
 #endif
-            AOCL_UCHAR *last_anchor_ptr = NULL;
-            AOCL_UINT32 cmpr_bound_pad = ((thread_group_handle.common_part_src_size + 
-                                        thread_group_handle.leftover_part_src_bytes) / 255) + 
-                                        16 + rap_metadata_len;
-            AOCL_UINT32 is_error = 1;
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            AOCL_INT32 local_result = -1;
-            AOCL_UINT32 last_bytes_len = 0;
-
-            if (aocl_do_partition_compress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
-            {
+        result = 0;
+        free(moves);
+        return result;
+    }
+    //For storing this thread's RAP offset, RAP length and decompressed length
+    dst_ptr = aocl_write_rap_partition_mt(thread_grp, dst_ptr, rap_metadata_len,
+                                          prev_thread_info.dst_trap_size, decomp_len);
+    thread_grp->dst += prev_thread_info.dst_trap_size;
 
-#if (LZ4_HEAPMODE)
-                LZ4_stream_t* ctxPtr = ALLOC(sizeof(LZ4_stream_t));   /* malloc-calloc always properly aligned */
-                if (ctxPtr == NULL) return 0;
-#else
-                LZ4_stream_t ctx;
-                LZ4_stream_t* const ctxPtr = &ctx;
-#endif
-                local_result = AOCL_LZ4_compress_fast_extState_mt(ctxPtr,
-                    cur_thread_info.partition_src, cur_thread_info.dst_trap,
-                    cur_thread_info.partition_src_size, 
-                    cur_thread_info.dst_trap_size, acceleration, 
-                    &last_anchor_ptr, (thread_id != (thread_group_handle.num_threads - 1)) ? &last_bytes_len : NULL);
-#if (LZ4_HEAPMODE)
-                FREEMEM(ctxPtr);
-#endif
-                is_error = 0;
-            }//aocl_do_partition_compress_mt
-            
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = (AOCL_VOID *)last_anchor_ptr;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = local_result;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = last_bytes_len;
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-#ifdef AOCL_THREADS_LOG
-            //printf("Compress Thread [id: %d] : Compression output length [%d], original source length [%d]\n",
-            //                                                  omp_get_thread_num(), local_result, inputSize);
-#endif
-        }//#pragma omp parallel
-#ifdef AOCL_THREADS_LOG
-        printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
-#endif
+    prev_offset = rap_metadata_len;
+    prev_len = prev_thread_info.dst_trap_size;
 
-        //Post processing in single-threaded mode: Prepares RAP frame and joins the last sequences of the neighboring threads
-        
-        // <-- RAP Header -->
-        //Add at the start of the stream : Although it can be at the end or at any other point in the stream, but it is more easier for parsing at the start
-        AOCL_CHAR* dst_org = thread_group_handle.dst;
-        AOCL_CHAR* dst_ptr = dst_org;
-        AOCL_UINT32 prev_offset, prev_len;
-        AOCL_UINT32 decomp_len;
-        thread_group_handle.dst += rap_metadata_len;
-        dst_ptr += RAP_START_OF_PARTITIONS;
-        // <-- RAP Header -->
-
-        // <-- RAP Metadata payload -->
-        //For the first thread:
-        prev_thread_info = thread_group_handle.threads_info_list[thread_cnt++];
+    //For next threads:
+    for (; thread_cnt < thread_grp->num_threads; thread_cnt++)
+    {
+        cur_thread_info = thread_grp->threads_info_list[thread_cnt];
         //In case of any thread partitioning or alloc errors, exit the compression process with error
-        if (prev_thread_info.is_error || prev_thread_info.dst_trap_size < 0)
+        if (cur_thread_info.is_error || cur_thread_info.dst_trap_size < 0)
         {
             result = 0;
-            aocl_destroy_parallel_compress_mt(&thread_group_handle);
+            free(moves);
 #ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Encountered ERROR\n", thread_cnt-1);
+            printf("Compress Thread [id: %d] : Encountered ERROR\n", thread_cnt);
 #endif
             return result;
         }
-        //Copy first chunk as it is to the output final buffer
-        memcpy((thread_group_handle.dst + dst_offset), prev_thread_info.dst_trap, prev_thread_info.dst_trap_size);
-        *(AOCL_UINT32*)dst_ptr = rap_metadata_len; //For storing this thread's RAP offset
-        dst_ptr += RAP_OFFSET_BYTES;
-        *(AOCL_INT32*)dst_ptr = prev_thread_info.dst_trap_size; //For storing this thread's RAP length
-        dst_ptr += RAP_LEN_BYTES;
-        //For storing this thread's decompressed (src) length
-        decomp_len = prev_thread_info.partition_src_size - prev_thread_info.last_bytes_len;
-        if (((AOCL_UCHAR *)prev_thread_info.additional_state_info - (AOCL_UCHAR*)prev_thread_info.partition_src) !=
-            decomp_len)
+        moves[thread_cnt].size = 0;
+        junctions[thread_cnt].size = 0;
+
+        //post processing to join parallely decodable chunks into a contiguous stream to allow
+        //standard decoder to process it in ST mode as well
+        //If cur thread's dst_trap_size = 0 (all literals), then carry its literals forward
+        //along with the previous chunk's left over bytes (literals)
+        if (cur_thread_info.dst_trap_size == 0 && cur_thread_info.last_bytes_len)
         {
+            cur_thread_info.last_bytes_len = cur_thread_info.last_bytes_len + prev_thread_info.last_bytes_len;
+            cur_thread_info.additional_state_info = prev_thread_info.additional_state_info;
+            //For storing this thread's RAP offset, RAP length and decompressed (src) length
+            decomp_len = 0;
+            dst_ptr = aocl_write_rap_partition_mt(thread_grp, dst_ptr,
+                                                  (prev_offset + prev_len), 0, decomp_len);
+            if (cur_thread_info.dict_size > 0)
+                aocl_mark_rap_dependent_mt(thread_grp, dst_ptr);
+            prev_thread_info = cur_thread_info;
+            prev_offset = (prev_offset + prev_len);
+            prev_len = 0;
+        }
+        else //Normal situation when cur thread's dst_trap_size > 0
+        {
+            //Parse the literal length of the first sequence of this chunk. Its literals are
+            //merged with the previous chunk's left over bytes into a single literal run.
+            const AOCL_UCHAR* trap_ptr = (const AOCL_UCHAR*)cur_thread_info.dst_trap;
+            size_t cur_token = *trap_ptr++;
+            size_t lit_len = cur_token >> ML_BITS;
+            AOCL_UINT32 junction_size;
+            if (lit_len == RUN_MASK)
+            {
+                AOCL_UCHAR len_byte;
+                do {
+                    len_byte = *trap_ptr++;
+                    lit_len += len_byte;
+                } while (len_byte == 255);
+            }
+            junctions[thread_cnt].token_low = (AOCL_UCHAR)(cur_token & ML_MASK);
+            junctions[thread_cnt].lit_len = lit_len + prev_thread_info.last_bytes_len;
+            junctions[thread_cnt].lit_src = (const AOCL_CHAR*)prev_thread_info.additional_state_info;
+            junctions[thread_cnt].lit_src_len = prev_thread_info.last_bytes_len;
+            junctions[thread_cnt].dst = thread_grp->dst;
+            junction_size = 1 + ((junctions[thread_cnt].lit_len >= RUN_MASK) ?
+                                 ((junctions[thread_cnt].lit_len - RUN_MASK) / 255) + 1 : 0) +
+                            prev_thread_info.last_bytes_len;
+            junctions[thread_cnt].size = junction_size;
+
+            //Rest of this thread's chunk follows the joined sequence header and literals
+            moves[thread_cnt].src = (AOCL_CHAR*)trap_ptr;
+            moves[thread_cnt].size = cur_thread_info.dst_trap_size - ((AOCL_CHAR*)trap_ptr - cur_thread_info.dst_trap);
+            moves[thread_cnt].dst = thread_grp->dst + junction_size;
+            dst_offset = junction_size + moves[thread_cnt].size;
+            thread_grp->dst += dst_offset;
+
+            //For storing this thread's decompressed (src) length
+            decomp_len = cur_thread_info.partition_src_size - cur_thread_info.last_bytes_len;
+            if ((thread_cnt != (thread_grp->num_threads - 1)) &&
+                ((AOCL_UCHAR*)cur_thread_info.additional_state_info - (AOCL_UCHAR*)cur_thread_info.partition_src) !=
+                decomp_len)
+            {
 #ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Error in last bytes position\n", thread_cnt);
+                printf("Compress Thread [id: %d] : Error in last bytes position\n", thread_cnt);
 #endif
-            result = 0;
-            aocl_destroy_parallel_compress_mt(&thread_group_handle);
-            return result;
+                result = 0;
+                free(moves);
+                return result;
+            }
+            //For storing this thread's RAP offset, RAP length and decompressed length
+            dst_ptr = aocl_write_rap_partition_mt(thread_grp, dst_ptr, (prev_offset + prev_len),
+                                                  dst_offset, decomp_len + prev_thread_info.last_bytes_len);
+            //Partitions primed with the previous one are decompressed after it
+            if (cur_thread_info.dict_size > 0)
+                aocl_mark_rap_dependent_mt(thread_grp, dst_ptr);
+
+            prev_thread_info = cur_thread_info;
+            prev_offset = (prev_offset + prev_len);
+            prev_len = dst_offset;
         }
-        *(AOCL_INT32*)dst_ptr = decomp_len;
-        dst_ptr += DECOMP_LEN_BYTES;
-        thread_group_handle.dst += prev_thread_info.dst_trap_size;
+    }
+    // <-- RAP Metadata payload -->
 
-        prev_offset = rap_metadata_len;
-        prev_len = prev_thread_info.dst_trap_size;
+    //The RAP frame can push poorly compressible data past dst: leave dst untouched
+    if (thread_grp->dst - dst_org > thread_grp->dst_size)
+    {
+        free(moves);
+        return AOCL_LZ4_JOIN_DST_TOO_SMALL;
+    }
+
+    //Move the chunks into place, then fill the gaps with the joined sequence headers and literals.
+    //Gaps never overlap the moved chunks, and the literals are read from the source buffer.
+    if (aocl_compact_partitions_mt(moves, thread_grp->num_threads,
+                                   thread_grp->num_workers) != 0)
+    {
+        free(moves);
+        return 0;
+    }
+    //junctions[0] is always empty
+    aocl_run_parallel_for_mt(AOCL_LZ4_write_junction_task, junctions,
+                             thread_grp->num_threads, thread_grp->num_workers);
+    free(moves);
+
+    return (int)(thread_grp->dst - dst_org);
+}
+
+//Arguments shared by the workers of the multi-threaded compressor
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    AOCL_UINT32 cmpr_bound_pad;
+    int acceleration;
+    int dispatch_key;   //Dispatcher setup of the thread that started the compression
+} AOCL_LZ4_compress_mt_args_t;
 
-        //For next threads:
-        for (; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+//Worker of the multi-threaded compressor: compresses partitions until none is left
+static void AOCL_LZ4_compress_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    AOCL_LZ4_compress_mt_args_t* args = (AOCL_LZ4_compress_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_lz4);
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UCHAR *last_anchor_ptr = NULL;
+        AOCL_UINT32 is_error = 1;
+        AOCL_INT32 local_result = -1;
+        AOCL_UINT32 last_bytes_len = 0;
+
+        if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, args->cmpr_bound_pad, thread_id) == 0)
         {
-            size_t cur_token, new_token, cur_lit;
-            cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
-            //In case of any thread partitioning or alloc errors, exit the compression process with error
-            if (cur_thread_info.is_error || cur_thread_info.dst_trap_size < 0)
-            {
-                result = 0;
-                aocl_destroy_parallel_compress_mt(&thread_group_handle);
+
+#if (LZ4_HEAPMODE)
+            LZ4_stream_t* ctxPtr = ALLOC(sizeof(LZ4_stream_t));   /* malloc-calloc always properly aligned */
+            if (ctxPtr == NULL) return;
+#else
+            LZ4_stream_t ctx;
+            LZ4_stream_t* const ctxPtr = &ctx;
+#endif
+            if (cur_thread_info.dict_size > 0)
+                //Primed with the end of the previous partition: the partition depends on it
+                local_result = AOCL_LZ4_compress_prefix_extState_mt(ctxPtr,
+                    cur_thread_info.partition_src, cur_thread_info.dst_trap,
+                    cur_thread_info.partition_src_size,
+                    cur_thread_info.dst_trap_size, args->acceleration,
+                    (cur_thread_info.dict_size > (AOCL_INTP)(64 KB)) ? (int)(64 KB) : (int)cur_thread_info.dict_size,
+                    &last_anchor_ptr, (thread_id != (thread_grp->num_threads - 1)) ? &last_bytes_len : NULL);
+            else
+                local_result = AOCL_LZ4_compress_fast_extState_mt(ctxPtr,
+                    cur_thread_info.partition_src, cur_thread_info.dst_trap,
+                    cur_thread_info.partition_src_size, 
+                    cur_thread_info.dst_trap_size, args->acceleration, 
+                    &last_anchor_ptr, (thread_id != (thread_grp->num_threads - 1)) ? &last_bytes_len : NULL);
+#if (LZ4_HEAPMODE)
+            FREEMEM(ctxPtr);
+#endif
+            is_error = 0;
+        }//aocl_do_partition_compress_mt
+        
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = (AOCL_VOID *)last_anchor_ptr;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = local_result;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = last_bytes_len;
+        thread_grp->threads_info_list[thread_id].dict_size = cur_thread_info.dict_size;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
 #ifdef AOCL_THREADS_LOG
-                printf("Compress Thread [id: %d] : Encountered ERROR\n", thread_cnt);
+        //printf("Compress Thread [id: %d] : Compression output length [%d], original source length [%d]\n",
+        //                                                  worker_id, local_result, inputSize);
 #endif
-                return result;
-            }
-            dst_offset = 0;
-            //thread_group_handle.dst += dst_offset;
-
-            //post processing to join parallely decodable chunks into a contiguous stream to allow
-            //standard decoder to process it in ST mode as well
-            //If cur thread's dst_trap_size = 0 (all literals), then write it to output final buffer
-            //along with the previous chunk's left over bytes (literals)
-            if (cur_thread_info.dst_trap_size == 0 && cur_thread_info.last_bytes_len)
-            {
-                cur_thread_info.last_bytes_len = cur_thread_info.last_bytes_len + prev_thread_info.last_bytes_len;
-                cur_thread_info.additional_state_info = prev_thread_info.additional_state_info;
-                *(AOCL_UINT32*)dst_ptr = (prev_offset + prev_len); //For storing this thread's RAP offset
-                *(AOCL_INT32*)(dst_ptr + RAP_OFFSET_BYTES) = dst_offset; //For storing this thread's RAP length
-                dst_ptr += RAP_DATA_BYTES;
-                //For storing this thread's decompressed (src) length
-                decomp_len = 0;
-                *(AOCL_INT32*)dst_ptr = decomp_len;
-                dst_ptr += DECOMP_LEN_BYTES;
-                prev_thread_info = cur_thread_info;
-                prev_offset = (prev_offset + prev_len);
-                prev_len = dst_offset;
-            }
-            else //Normal situation when cur thread's dst_trap_size > 0
-            {
-                cur_token = *(AOCL_UCHAR*)cur_thread_info.dst_trap;
-                cur_thread_info.dst_trap++;
-                cur_thread_info.dst_trap_size--;
-                cur_lit = (cur_token >> 4);
-                new_token = cur_lit + prev_thread_info.last_bytes_len;
-                if (new_token >= RUN_MASK)
-                {
-                    size_t accumulator = new_token - RUN_MASK;
-                    *thread_group_handle.dst++ = (BYTE)((RUN_MASK << ML_BITS) | (cur_token & 0xF));
-                    dst_offset++;
-                    for (; accumulator >= 255; accumulator -= 255)
-                    {
-                        *thread_group_handle.dst++ = (BYTE)255;
-                        dst_offset++;
-                    }
-                    if (cur_lit >= RUN_MASK)
-                    {
-                        while (*(AOCL_UCHAR*)cur_thread_info.dst_trap == 255)
-                        {
-                            *thread_group_handle.dst++ = (BYTE)255;
-                            dst_offset++;
-                            cur_thread_info.dst_trap++;
-                            cur_thread_info.dst_trap_size--;
-                        }
-                        new_token = *(AOCL_UCHAR*)cur_thread_info.dst_trap;
-                        cur_thread_info.dst_trap++;
-                        cur_thread_info.dst_trap_size--;
-                        accumulator += new_token;
-                        if (accumulator >= 255)
-                        {
-                            *thread_group_handle.dst++ = (BYTE)255;
-                            dst_offset++;
-                            accumulator -= 255;
-                        }
-                    }
-                    *thread_group_handle.dst++ = (BYTE)accumulator;
-                    dst_offset++;
-                }
-                else
-                {
-                    *thread_group_handle.dst++ = (BYTE)((new_token << ML_BITS) | (cur_token & 0xF));
-                    dst_offset++;
-                }
+    }
+}
 
-                //Copy prev thread's last literal bytes to the output final buffer
-                memcpy(thread_group_handle.dst, prev_thread_info.additional_state_info, prev_thread_info.last_bytes_len);
-                dst_offset += prev_thread_info.last_bytes_len;
-                thread_group_handle.dst += prev_thread_info.last_bytes_len;
-
-                //Copy this thread's chunk to the output final buffer
-                memcpy(thread_group_handle.dst, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
-                dst_offset += cur_thread_info.dst_trap_size;
-                thread_group_handle.dst += cur_thread_info.dst_trap_size;
-
-                *(AOCL_UINT32*)dst_ptr = (prev_offset + prev_len); //For storing this thread's RAP offset
-                *(AOCL_INT32*)(dst_ptr + RAP_OFFSET_BYTES) = dst_offset; //For storing this thread's RAP length
-                dst_ptr += RAP_DATA_BYTES;
-                //For storing this thread's decompressed (src) length
-                decomp_len = cur_thread_info.partition_src_size - cur_thread_info.last_bytes_len;
-                if ((thread_cnt != (thread_group_handle.num_threads - 1)) &&
-                    ((AOCL_UCHAR*)cur_thread_info.additional_state_info - (AOCL_UCHAR*)cur_thread_info.partition_src) !=
-                    decomp_len)
-                {
+/* This function does not use any AVX code, but it produces output with RAP frame added.
+* This data is not compatible with the single threaded decompress APIs. Hence, it is placed under
+* AOCL_LZ4_AVX_OPT and made to pair with AOCL_LZ4_decompress_safe_mt().
+*/
+static int AOCL_LZ4_compress_fast_ctx_mt(aocl_thread_ctx_t* mt_ctx, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration){
+    if ((source == NULL && inputSize != 0) || dest == NULL)
+        return 0;
+    
+    int result;
+    aocl_thread_group_t thread_group_handle;
+    AOCL_INT32 rap_metadata_len = -1;
+    
+    rap_metadata_len = aocl_setup_parallel_compress_ctx_mt(&thread_group_handle, mt_ctx, (char *)source,
+                                                 dest, inputSize, maxOutputSize,
+                                                 LZ4_COMPRESS_INPLACE_MARGIN,
+                                                 WINDOW_FACTOR);
+    if (rap_metadata_len < 0)
+        return 0;
+ 
+    if (thread_group_handle.num_threads == 1)
+    {
+        return LZ4_compress_fast_ST(source, dest, inputSize, maxOutputSize, acceleration);
+    }
+    else
+    {
+        AOCL_UINT32 cmpr_bound_pad = ((thread_group_handle.common_part_src_size + 
+                                    thread_group_handle.leftover_part_src_bytes) / 255) + 
+                                    16 + rap_metadata_len;
+        //Compress partitions directly into dest when it can hold all the partition bounds
+        aocl_enable_in_place_compress_mt(&thread_group_handle, cmpr_bound_pad, rap_metadata_len);
 #ifdef AOCL_THREADS_LOG
-                    printf("Compress Thread [id: %d] : Error in last bytes position\n", thread_cnt);
+        printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
-                    result = 0;
-                    aocl_destroy_parallel_compress_mt(&thread_group_handle);
-                    return result;
-                }
-                *(AOCL_INT32*)dst_ptr = decomp_len + prev_thread_info.last_bytes_len;
-                dst_ptr += DECOMP_LEN_BYTES;
 
-                prev_thread_info = cur_thread_info;
-                prev_offset = (prev_offset + prev_len);
-                prev_len = dst_offset;
-            }
-        }
-        // <-- RAP Metadata payload -->
+        //workers take the dispatcher setup of this thread
+        AOCL_LZ4_compress_mt_args_t args = { &thread_group_handle, cmpr_bound_pad, acceleration, dispatch_key_lz4 };
+        aocl_run_parallel_mt(AOCL_LZ4_compress_partitions_mt, &args, thread_group_handle.num_workers);
+#ifdef AOCL_THREADS_LOG
+        printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
+#endif
 
-        result = thread_group_handle.dst - dest;
+        //Post processing in single-threaded mode: Prepares RAP frame and joins the partitions into a contiguous stream
+        result = AOCL_LZ4_join_partitions_mt(&thread_group_handle, rap_metadata_len);
         aocl_destroy_parallel_compress_mt(&thread_group_handle);
+        if (result == AOCL_LZ4_JOIN_DST_TOO_SMALL)
+            result = LZ4_compress_fast_ST(source, dest, inputSize, maxOutputSize, acceleration);
     }//thread_group_handle.num_threads > 1
     return result;
 }
+
+int AOCL_LZ4_compress_fast_mt(const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration){
+    return AOCL_LZ4_compress_fast_ctx_mt(NULL, source, dest, inputSize, maxOutputSize, acceleration);
+}
 #endif /* AOCL_LZ4_AVX_OPT */
 
 int AOCL_LZ4_compress_fast_st(const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration){
@@ -2930,7 +3073,7 @@ int AOCL_LZ4_compress_fast_st(const char* source, char* dest, int inputSize, int
         return result;
 }
 
-static int (*LZ4_compress_fast_mt_fp)(const char* source, char* dest, int inputSize, 
+static AOCL_TLS int (*LZ4_compress_fast_mt_fp)(const char* source, char* dest, int inputSize, 
     int maxOutputSize, int acceleration) = AOCL_LZ4_compress_fast_st;
 #endif
 
@@ -2964,6 +3107,43 @@ int LZ4_compress_fast(const char* source, char* dest, int inputSize, int maxOutp
 #endif /* AOCL_ENABLE_THREADS */
 }
 
+void* LZ4_createMTCtx(void)
+{
+#ifdef AOCL_ENABLE_THREADS
+    return aocl_create_thread_ctx_mt(NULL);
+#else
+    return NULL;
+#endif
+}
+
+void LZ4_freeMTCtx(void* mtCtx)
+{
+#ifdef AOCL_ENABLE_THREADS
+    aocl_destroy_thread_ctx_mt((aocl_thread_ctx_t*)mtCtx);
+#else
+    (void)mtCtx;
+#endif
+}
+
+int LZ4_compress_fast_MTCtx(void* mtCtx, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration)
+{
+    AOCL_SETUP_NATIVE();
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+    /* Use the context only when the dispatcher selected the multi-threaded compressor */
+    if (LZ4_compress_fast_mt_fp == AOCL_LZ4_compress_fast_mt)
+        return AOCL_LZ4_compress_fast_ctx_mt((aocl_thread_ctx_t*)mtCtx, source, dest, inputSize, maxOutputSize, acceleration);
+#endif
+    (void)mtCtx;
+    return LZ4_compress_fast(source, dest, inputSize, maxOutputSize, acceleration);
+}
+
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+int AOCL_LZ4_mt_enabled(void)
+{
+    return LZ4_compress_fast_mt_fp == AOCL_LZ4_compress_fast_mt;
+}
+#endif
+
 int LZ4_compress_default(const char* src, char* dst, int srcSize, int maxOutputSize)
 {
     LOG_UNFORMATTED(TRACE, logCtx, "Enter");
@@ -4765,7 +4945,7 @@ static int AOCL_LZ4_decompress_wrapper(const char* source, char* dest, int compr
 }
 #endif
 
-static int (*LZ4_decompress_wrapper_fp) (const char* source, char* dest, int compressedSize, int maxDecompressedSize) = LZ4_decompress_wrapper;
+static AOCL_TLS int (*LZ4_decompress_wrapper_fp) (const char* source, char* dest, int compressedSize, int maxDecompressedSize) = LZ4_decompress_wrapper;
 
 #ifdef AOCL_ENABLE_THREADS
 LZ4_FORCE_O2
@@ -4782,6 +4962,59 @@ int LZ4_decompress_safe_ST(const char* source, char* dest, int compressedSize, i
 }
 
 #ifdef AOCL_LZ4_AVX_OPT
+//Arguments shared by the workers of the multi-threaded decompressor
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} AOCL_LZ4_decompress_mt_args_t;
+
+//Worker of the multi-threaded decompressor: decompresses partitions until none is left
+static void AOCL_LZ4_decompress_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    AOCL_LZ4_decompress_mt_args_t* args = (AOCL_LZ4_decompress_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_lz4);
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 cmpr_bound_pad = MATCH_SAFEGUARD_DISTANCE + MFLIMIT;
+        AOCL_UINT32 is_error = 1;
+        AOCL_INT32 local_result = -1;
+        AOCL_INT32 thread_parallel_res = 0;
+
+        thread_parallel_res = aocl_do_partition_decompress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id);
+        if (thread_parallel_res == 0)
+        {
+            local_result = AOCL_LZ4_decompress_generic_mt(cur_thread_info.partition_src, cur_thread_info.dst_trap, 
+                cur_thread_info.partition_src_size, cur_thread_info.dst_trap_size,
+                endOnInputSize, decode_full_block, noDict,
+                (BYTE*)cur_thread_info.dst_trap, NULL, 0,
+                (thread_id + cur_thread_info.num_chained == thread_grp->num_threads) ? 1 : 0);
+
+            is_error = 0;
+        }//aocl_do_partition_decompress_mt
+        else if (thread_parallel_res == 1)
+        {
+            local_result = 0;
+            is_error = 0;
+        }
+
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = local_result;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = 0;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
 int AOCL_LZ4_decompress_safe_mt(const char* source, char* dest, int compressedSize, int maxDecompressedSize){
     LOG_UNFORMATTED(TRACE, logCtx, "Enter");
     if (source == NULL || dest == NULL)
@@ -4817,44 +5050,9 @@ int AOCL_LZ4_decompress_safe_mt(const char* source, char* dest, int compressedSi
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
-#ifdef AOCL_THREADS_LOG
-            printf("Decompress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-            AOCL_UINT32 cmpr_bound_pad = MATCH_SAFEGUARD_DISTANCE + MFLIMIT;
-            AOCL_UINT32 is_error = 1;
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            AOCL_INT32 local_result = -1;
-            AOCL_INT32 thread_parallel_res = 0;
-
-            thread_parallel_res = aocl_do_partition_decompress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id);
-            if (thread_parallel_res == 0)
-            {
-                local_result = AOCL_LZ4_decompress_generic_mt(cur_thread_info.partition_src, cur_thread_info.dst_trap, 
-                    cur_thread_info.partition_src_size, cur_thread_info.dst_trap_size,
-                    endOnInputSize, decode_full_block, noDict,
-                    (BYTE*)cur_thread_info.dst_trap, NULL, 0,
-                    (thread_id == (thread_group_handle.num_threads - 1)) ? 1 : 0);
-
-                is_error = 0;
-            }//aocl_do_partition_decompress_mt
-            else if (thread_parallel_res == 1)
-            {
-                local_result = 0;
-                is_error = 0;
-            }
-
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = NULL;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = local_result;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = 0;
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-
-        }//#pragma omp parallel
+        //workers take the dispatcher setup of this thread
+        AOCL_LZ4_decompress_mt_args_t args = { &thread_group_handle, dispatch_key_lz4 };
+        aocl_run_parallel_mt(AOCL_LZ4_decompress_partitions_mt, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -4889,9 +5087,38 @@ int AOCL_LZ4_decompress_safe_mt(const char* source, char* dest, int compressedSi
     }//thread_group_handle.num_threads > 1
 }
 
-static int (*LZ4_decompress_wrapper_mt_fp) (const char* source, char* dest, 
+static AOCL_TLS int (*LZ4_decompress_wrapper_mt_fp) (const char* source, char* dest, 
             int compressedSize, int maxDecompressedSize) = LZ4_decompress_wrapper;
 #endif /* AOCL_LZ4_AVX_OPT */
+
+int LZ4_decompress_partition_MT(const char* src, char* dst, int srcSize, int dstCapacity, int isLastPartition)
+{
+    if (src == NULL || dst == NULL || srcSize < 0 || dstCapacity < 0)
+        return -1;
+#ifdef AOCL_ENABLE_THREADS
+    if (!isLastPartition)
+    {
+        //Partitions other than the last one end with a match: decode into a padded trap buffer
+        int result;
+        char* dst_trap = (char*)ALLOC((size_t)dstCapacity + MATCH_SAFEGUARD_DISTANCE + MFLIMIT);
+        if (dst_trap == NULL)
+            return -1;
+        result = AOCL_LZ4_decompress_generic_mt(src, dst_trap, srcSize,
+            dstCapacity + MATCH_SAFEGUARD_DISTANCE + MFLIMIT,
+            endOnInputSize, decode_full_block, noDict,
+            (BYTE*)dst_trap, NULL, 0, 0);
+        if (result > dstCapacity)
+            result = -1;
+        if (result > 0)
+            memcpy(dst, dst_trap, (size_t)result);
+        FREEMEM(dst_trap);
+        return result;
+    }
+#else
+    (void)isLastPartition;
+#endif
+    return LZ4_decompress_safe(src, dst, srcSize, dstCapacity);
+}
 #endif /* AOCL_ENABLE_THREADS */
 
 LZ4_FORCE_O2
@@ -4924,6 +5151,13 @@ int LZ4_decompress_safe(const char* source, char* dest, int compressedSize, int
 
 static void aocl_register_lz4_fmv(int optOff, int optLevel)
 {
+#ifdef AOCL_ENABLE_THREADS
+    //Single-threaded unless a version below selects the multi-threaded path
+    LZ4_compress_fast_mt_fp = AOCL_LZ4_compress_fast_st;
+#ifdef AOCL_LZ4_AVX_OPT
+    LZ4_decompress_wrapper_mt_fp = LZ4_decompress_wrapper;
+#endif
+#endif
     if (optOff)
     {
         //C version
@@ -4999,32 +5233,27 @@ static void aocl_register_lz4_fmv(int optOff, int optLevel)
 char* aocl_setup_lz4(int optOff, int optLevel, size_t insize,
     size_t level, size_t windowLog)
 {
-    AOCL_ENTER_CRITICAL(setup_lz4)
-    if (!setup_ok_lz4) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_lz4_fmv(optOff, optLevel);
-        setup_ok_lz4 = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lz4)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_lz4 == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_lz4_fmv(optOff, optLevel);
+    dispatch_key_lz4 = dispatchKey;
     return NULL;
 }
 
 void aocl_destroy_lz4(void){
-    AOCL_ENTER_CRITICAL(setup_lz4)
-    setup_ok_lz4 = 0;
-    AOCL_EXIT_CRITICAL(setup_lz4)
+    dispatch_key_lz4 = AOCL_DISPATCH_UNSET;
 }
 
 #ifdef AOCL_LZ4_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_lz4)
-    if (!setup_ok_lz4) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_lz4_fmv(optOff, optLevel);
-        setup_ok_lz4 = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lz4)
+    if (dispatch_key_lz4 != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_lz4_fmv(optOff, optLevel);
+    dispatch_key_lz4 = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif /* AOCL_LZ4_OPT */
 
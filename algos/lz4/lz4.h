@@ -375,6 +375,68 @@ LZ4LIB_API int AOCL_LZ4_compress_fast_extState(void* state, const char* source,
     int maxOutputSize, int acceleration);
 #endif
 
+/** @brief Creates a reusable context for LZ4_compress_fast_MTCtx().
+ *
+ *  The context keeps the buffers of AOCL's multi-threaded compressor between calls,
+ *  so that repeated compressions do not allocate them again.
+ *  Free it with LZ4_freeMTCtx().
+ *
+ *  @return
+ *  |Result | Description                                                                          |
+ *  |:------|:-------------------------------------------------------------------------------------|
+ *  |Success| Pointer to the context.                                                              |
+ *  |Fail   | NULL. Also returned when the library is built without multi-threading support.      |
+ */
+LZ4LIB_API void* LZ4_createMTCtx(void);
+
+/** @brief Frees a context created by LZ4_createMTCtx(). NULL is accepted.
+ */
+LZ4LIB_API void LZ4_freeMTCtx(void* mtCtx);
+
+/** @brief Same as LZ4_compress_fast(), reusing the multi-threaded compression context 'mtCtx' across calls.
+ *
+ *  A context must not be used by two calls at the same time. When 'mtCtx' is NULL, or the
+ *  library is built without multi-threading support, this behaves as LZ4_compress_fast().
+ *
+ *  |Parameters       |Direction|Description                                                                                             |
+ *  |:----------------|:-------:|:-------------------------------------------------------------------------------------------------------|
+ *  | \b mtCtx        |  in,out | Context created by LZ4_createMTCtx(), or NULL.                                                         |
+ *  | \b src          |  in     | Source buffer, the data which you want to compress is copied/or pointed here.                          |
+ *  | \b dst          |  out    | Destination buffer, compressed data is kept here, memory should be allocated already.                  |
+ *  | \b srcSize      |  in     | Maximum supported value is LZ4_MAX_INPUT_SIZE.                                                         |
+ *  | \b dstCapacity  |  in     | Size of buffer 'dst' (which must be already allocated).                                                |
+ *  | \b acceleration |  in     | Same as in LZ4_compress_fast().                                                                        |
+ *
+ *  @return
+ *  |Result | Description                                                                                            |
+ *  |:------|:----------- -------------------------------------------------------------------------------------------|
+ *  |Success| Returns a positive number (<= dstCapacity) indicating the number of bytes written into the buffer dst. |
+ *  |Fail   | Returns 0.                                                                                             |
+ */
+LZ4LIB_API int LZ4_compress_fast_MTCtx(void* mtCtx, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration);
+
+/** @brief Decompresses one partition of a multi-threaded LZ4 stream, as listed in its random access point (RAP) frame.
+ *
+ *  Partitions other than the last one do not follow the end-of-block rules of a regular LZ4 block
+ *  and cannot be decoded by LZ4_decompress_safe(). When the library is built without multi-threading
+ *  support, this behaves as LZ4_decompress_safe().
+ *
+ *  |Parameters          |Direction|Description                                                        |
+ *  |:-------------------|:-------:|:------------------------------------------------------------------|
+ *  | \b src             |  in     | Start of the partition's compressed data.                         |
+ *  | \b dst             |  out    | Destination buffer of at least 'dstCapacity' bytes.               |
+ *  | \b srcSize         |  in     | Compressed size of the partition.                                 |
+ *  | \b dstCapacity     |  in     | Decompressed size of the partition.                               |
+ *  | \b isLastPartition |  in     | Non-zero for the last partition of the stream.                    |
+ *
+ *  @return
+ *  |Result | Description                                                                |
+ *  |:------|:---------------------------------------------------------------------------|
+ *  |Success| The number of bytes decoded in 'dst' (<= dstCapacity).                     |
+ *  |Fail   | If source stream is detected malformed, function returns a negative result.|
+ */
+LZ4LIB_API int LZ4_decompress_partition_MT(const char* src, char* dst, int srcSize, int dstCapacity, int isLastPartition);
+
 /*! @brief This function either compresses the entire 'src' content into 'dst' if it's large enough
  *  or fills 'dst' buffer completely with as much data as possible from 'src'.
  *  Reverse the logic : Compresses as much data as possible from the 'src' buffer
@@ -129,10 +129,10 @@ static void aocl_setup_native_hc(void);
 #define AOCL_SETUP_NATIVE_HC()
 #endif
 
-int setup_ok_lz4hc = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_lz4hc = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 // function pointer to variants of LZ4_compress_HC() function, used for integration with the dynamic dispatcher.
-static int (*LZ4_compress_HC_fp)(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel) = LZ4_compress_HC_internal;
+static AOCL_TLS int (*LZ4_compress_HC_fp)(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel) = LZ4_compress_HC_internal;
 
 /**************************************
 *  HC Compression
@@ -410,7 +410,7 @@ int AOCL_LZ4HC_countBack(const BYTE* const ip, const BYTE* const match,
 #endif /* AOCL_LZ4HC_OPT */
 
 // function pointer to variants of LZ4HC_countBack() function, used for integration with the dynamic dispatcher. 
-static int (*LZ4HC_countBack_fp)(const BYTE* const ip, const BYTE* const match,
+static AOCL_TLS int (*LZ4HC_countBack_fp)(const BYTE* const ip, const BYTE* const match,
     const BYTE* const iMin, const BYTE* const mMin) = LZ4HC_countBack;
 
 #ifdef AOCL_UNIT_TEST
@@ -541,6 +541,10 @@ LZ4HC_InsertAndGetWiderMatch (
     U32 matchIndex;
     repeat_state_e repeat = rep_untested;
     size_t srcPatternLength = 0;
+#ifdef AOCL_LZ4HC_OPT
+    /* read once: the match chain loop below may call it for every candidate */
+    int (*const countBack)(const BYTE* const, const BYTE* const, const BYTE* const, const BYTE* const) = LZ4HC_countBack_fp;
+#endif
 
     DEBUGLOG(7, "LZ4HC_InsertAndGetWiderMatch");
     /* First Match */
@@ -563,7 +567,7 @@ LZ4HC_InsertAndGetWiderMatch (
             if (LZ4_read16(iLowLimit + longest - 1) == LZ4_read16(matchPtr - lookBackLength + longest - 1)) {
                 if (LZ4_read32(matchPtr) == pattern) {
 #ifdef AOCL_LZ4HC_OPT
-                    int const back = lookBackLength ? LZ4HC_countBack_fp(ip, matchPtr, iLowLimit, lowPrefixPtr) : 0;
+                    int const back = lookBackLength ? countBack(ip, matchPtr, iLowLimit, lowPrefixPtr) : 0;
 #else
                     int const back = lookBackLength ? LZ4HC_countBack(ip, matchPtr, iLowLimit, lowPrefixPtr) : 0;
 #endif
@@ -588,7 +592,7 @@ LZ4HC_InsertAndGetWiderMatch (
                 if ((ip+matchLength == vLimit) && (vLimit < iHighLimit))
                     matchLength += LZ4_count(ip+matchLength, lowPrefixPtr, iHighLimit);
 #ifdef AOCL_LZ4HC_OPT
-                back = lookBackLength ? LZ4HC_countBack_fp(ip, matchPtr, iLowLimit, dictStart) : 0;
+                back = lookBackLength ? countBack(ip, matchPtr, iLowLimit, dictStart) : 0;
 #else
                 back = lookBackLength ? LZ4HC_countBack(ip, matchPtr, iLowLimit, dictStart) : 0;
 #endif
@@ -725,7 +729,7 @@ LZ4HC_InsertAndGetWiderMatch (
                 if (vLimit > iHighLimit) vLimit = iHighLimit;
                 mlt = (int)LZ4_count(ip+MINMATCH, matchPtr+MINMATCH, vLimit) + MINMATCH;
 #ifdef AOCL_LZ4HC_OPT
-                back = lookBackLength ? LZ4HC_countBack_fp(ip, matchPtr, iLowLimit, dictCtx->base + dictCtx->dictLimit) : 0;
+                back = lookBackLength ? countBack(ip, matchPtr, iLowLimit, dictCtx->base + dictCtx->dictLimit) : 0;
 #else
                 back = lookBackLength ? LZ4HC_countBack(ip, matchPtr, iLowLimit, dictCtx->base + dictCtx->dictLimit) : 0;
 #endif
@@ -2029,19 +2033,161 @@ int AOCL_LZ4_compress_HC_internal(const char* src, char* dst, int srcSize, int d
 }
 #endif /* AOCL_LZ4HC_OPT */
 
-int LZ4_compress_HC(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+static int LZ4_compress_HC_ST(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
 {
-    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
-    int ret = 0;
-    AOCL_SETUP_NATIVE_HC();
 #ifdef AOCL_LZ4HC_OPT
 if(compressionLevel >= 6 && compressionLevel <=9)
     return LZ4_compress_HC_fp(src, dst, srcSize, dstCapacity, compressionLevel);
 else
-    ret = LZ4_compress_HC_internal(src, dst, srcSize, dstCapacity, compressionLevel);
+    return LZ4_compress_HC_internal(src, dst, srcSize, dstCapacity, compressionLevel);
 #else
-    ret = LZ4_compress_HC_internal(src, dst, srcSize, dstCapacity, compressionLevel);
+    return LZ4_compress_HC_internal(src, dst, srcSize, dstCapacity, compressionLevel);
 #endif /* AOCL_LZ4HC_OPT */
+}
+
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+/* Returns the position in dst of the last sequence of a compressed block, which holds only
+ * literals, and saves the number of these literals in lastRun */
+static int AOCL_LZ4HC_findLastLiterals_mt(const char* dst, int dstSize, unsigned int* lastRun)
+{
+    const BYTE* ip = (const BYTE*)dst;
+    const BYTE* const iend = ip + dstSize;
+    for (;;) {
+        const BYTE* const seq = ip;
+        unsigned const token = *ip++;
+        size_t litLen = token >> ML_BITS;
+        if (litLen == RUN_MASK) {
+            BYTE s;
+            do { s = *ip++; litLen += s; } while (s == 255);
+        }
+        ip += litLen;
+        if (ip >= iend) {
+            *lastRun = (unsigned int)litLen;
+            return (int)(seq - (const BYTE*)dst);
+        }
+        ip += 2; /* offset */
+        if ((token & ML_MASK) == ML_MASK) {
+            BYTE s;
+            do { s = *ip++; } while (s == 255);
+        }
+    }
+}
+
+//Arguments shared by the workers of AOCL_LZ4_compress_HC_mt()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    AOCL_UINT32 cmpr_bound_pad;
+    int compressionLevel;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} AOCL_LZ4_compress_HC_mt_args_t;
+
+//Worker of AOCL_LZ4_compress_HC_mt(): compresses partitions until none is left
+static void AOCL_LZ4_compress_HC_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    AOCL_LZ4_compress_HC_mt_args_t* args = (AOCL_LZ4_compress_HC_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_lz4hc);
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        const char* last_anchor_ptr = NULL;
+        AOCL_UINT32 is_error = 1;
+        AOCL_INT32 local_result = -1;
+        AOCL_UINT32 last_bytes_len = 0;
+
+        if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, args->cmpr_bound_pad, thread_id) == 0)
+        {
+            local_result = LZ4_compress_HC_ST(cur_thread_info.partition_src, cur_thread_info.dst_trap,
+                cur_thread_info.partition_src_size, cur_thread_info.dst_trap_size, args->compressionLevel);
+            if (local_result > 0)
+            {
+                //Leave out the last literals of all but the last partition for joining with the next one
+                if (thread_id != (thread_grp->num_threads - 1))
+                {
+                    local_result = AOCL_LZ4HC_findLastLiterals_mt(cur_thread_info.dst_trap, local_result, &last_bytes_len);
+                    last_anchor_ptr = cur_thread_info.partition_src + cur_thread_info.partition_src_size - last_bytes_len;
+                }
+                is_error = 0;
+            }
+        }//aocl_do_partition_compress_mt
+
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = (AOCL_VOID *)last_anchor_ptr;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = local_result;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = last_bytes_len;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
+/* Multi-threaded LZ4_compress_HC(). Each partition is compressed as an LZ4 block without its
+ * last literals, which are then joined with the next partition by AOCL_LZ4_join_partitions_mt(),
+ * as done by AOCL_LZ4_compress_fast_mt(). The output is read by AOCL_LZ4_decompress_safe_mt(). */
+static int AOCL_LZ4_compress_HC_mt(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+{
+    if ((src == NULL && srcSize != 0) || dst == NULL)
+        return 0;
+
+    int result;
+    aocl_thread_group_t thread_group_handle;
+    AOCL_INT32 rap_metadata_len = -1;
+
+    rap_metadata_len = aocl_setup_parallel_compress_mt(&thread_group_handle, (char *)src,
+                                                 dst, srcSize, dstCapacity,
+                                                 LZ4_COMPRESS_INPLACE_MARGIN,
+                                                 WINDOW_FACTOR);
+    if (rap_metadata_len < 0)
+        return 0;
+
+    if (thread_group_handle.num_threads == 1)
+        return LZ4_compress_HC_ST(src, dst, srcSize, dstCapacity, compressionLevel);
+
+    AOCL_UINT32 cmpr_bound_pad = ((thread_group_handle.common_part_src_size +
+                                thread_group_handle.leftover_part_src_bytes) / 255) +
+                                16 + rap_metadata_len;
+    //Compress partitions directly into dst when it can hold all the partition bounds
+    aocl_enable_in_place_compress_mt(&thread_group_handle, cmpr_bound_pad, rap_metadata_len);
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
+#endif
+
+    //workers take the dispatcher setup of this thread
+    AOCL_LZ4_compress_HC_mt_args_t args = { &thread_group_handle, cmpr_bound_pad, compressionLevel, dispatch_key_lz4hc };
+    aocl_run_parallel_mt(AOCL_LZ4_compress_HC_partitions_mt, &args, thread_group_handle.num_workers);
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
+#endif
+
+    //Post processing in single-threaded mode: Prepares RAP frame and joins the partitions into a contiguous stream
+    result = AOCL_LZ4_join_partitions_mt(&thread_group_handle, rap_metadata_len);
+    aocl_destroy_parallel_compress_mt(&thread_group_handle);
+    if (result == AOCL_LZ4_JOIN_DST_TOO_SMALL)
+        result = LZ4_compress_HC_ST(src, dst, srcSize, dstCapacity, compressionLevel);
+    return result;
+}
+#endif /* AOCL_ENABLE_THREADS && AOCL_LZ4_AVX_OPT */
+
+int LZ4_compress_HC(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+    int ret = 0;
+    AOCL_SETUP_NATIVE_HC();
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+    //Multi-threaded output needs the RAP aware LZ4 decompressor: use it only when that decompressor is dispatched
+    if (AOCL_LZ4_mt_enabled())
+        ret = AOCL_LZ4_compress_HC_mt(src, dst, srcSize, dstCapacity, compressionLevel);
+    else
+        ret = LZ4_compress_HC_ST(src, dst, srcSize, dstCapacity, compressionLevel);
+#else
+    ret = LZ4_compress_HC_ST(src, dst, srcSize, dstCapacity, compressionLevel);
+#endif
     LOG_UNFORMATTED(INFO, logCtx, "Exit");
     return ret;
 }
@@ -2841,31 +2987,33 @@ static void aocl_register_lz4hc_fmv(int optOff, int optLevel) {
 }
 
 char* aocl_setup_lz4hc(int optOff, int optLevel, size_t insize, size_t level, size_t windowLog) {
-    AOCL_ENTER_CRITICAL(setup_lz4hc)
-    if (!setup_ok_lz4hc) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_lz4hc_fmv(optOff, optLevel);
-        setup_ok_lz4hc = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lz4hc)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_lz4hc == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_lz4hc_fmv(optOff, optLevel);
+    dispatch_key_lz4hc = dispatchKey;
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+    //LZ4HC streams are decompressed by LZ4, whose dispatcher also decides if LZ4HC compresses in multi-threaded mode
+    aocl_setup_lz4(optOff, optLevel, insize, level, windowLog);
+#endif
     return NULL;
 }
 
 #ifdef AOCL_LZ4HC_OPT
 static void aocl_setup_native_hc(void) {
-    AOCL_ENTER_CRITICAL(setup_lz4hc)
-    if (!setup_ok_lz4hc) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_lz4hc_fmv(optOff, optLevel);
-        setup_ok_lz4hc = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lz4hc)
+    if (dispatch_key_lz4hc != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_lz4hc_fmv(optOff, optLevel);
+    dispatch_key_lz4hc = AOCL_DISPATCH_KEY(optOff, optLevel);
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_LZ4_AVX_OPT)
+    aocl_setup_lz4(0, get_cpu_opt_flags(0), 0, 0, 0);
+#endif
 }
 #endif
 
 void aocl_destroy_lz4hc(void){
-    AOCL_ENTER_CRITICAL(setup_lz4hc)
-    setup_ok_lz4hc = 0;
-    AOCL_EXIT_CRITICAL(setup_lz4hc)
+    dispatch_key_lz4hc = AOCL_DISPATCH_UNSET;
 }
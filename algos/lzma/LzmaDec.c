@@ -41,6 +41,10 @@
 
 #include <limits.h>
 
+#ifdef AOCL_ENABLE_THREADS
+#include "threads/threads.h"
+#endif
+
 #define kNumTopBits 24
 #define kTopValue ((UInt32)1 << kNumTopBits)
 
@@ -61,7 +65,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_lzma_decode = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_lzma_decode = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /* Key terms used in range decoder:
 *
@@ -1282,7 +1286,7 @@ We use early check of (RangeCoder:Code) over kBadRepCode to simplify main decodi
 #error Stop_Compiling_Bad_LZMA_Check
 #endif
 
-int (*Lzma_Decode_Real_fp)(CLzmaDec* p, SizeT limit, const Byte* bufLimit) = LZMA_DECODE_REAL;
+AOCL_TLS int (*Lzma_Decode_Real_fp)(CLzmaDec* p, SizeT limit, const Byte* bufLimit) = LZMA_DECODE_REAL;
 
 /*
 LzmaDec_DecodeReal2():
@@ -1967,38 +1971,275 @@ SRes LzmaDec_Allocate(CLzmaDec* p, const Byte* props, unsigned propsSize, ISzAll
     return SZ_OK;
 }
 
-SRes LzmaDecode(Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+/* Decodes src straight into dest with the decoder p, whose probabilities
+   are allocated if their size changes. dest is used as the dictionary. */
+static SRes LzmaDecode_Dec(CLzmaDec* p, Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
     const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
     ELzmaStatus* status, ISzAllocPtr alloc)
 {
-    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
-    AOCL_SETUP_NATIVE();
-    if (src == NULL || srcLen == NULL || dest == NULL || propData == NULL ||
-        destLen == NULL || *srcLen == 0 ||
-        *srcLen > (ULLONG_MAX - LZMA_PROPS_SIZE)) // handles case when src size is < LZMA_PROPS_SIZE, resulting in destLen rolling over in calling APIs
-        return SZ_ERROR_PARAM;
-
-    CLzmaDec p;
     SRes res;
     SizeT outSize = *destLen, inSize = *srcLen;
     *destLen = *srcLen = 0;
     *status = LZMA_STATUS_NOT_SPECIFIED;
     if (inSize < RC_INIT_SIZE)
         return SZ_ERROR_INPUT_EOF;
-    LzmaDec_Construct(&p);
-    RINOK(LzmaDec_AllocateProbs(&p, propData, propSize, alloc));
-    p.dic = dest;
-    p.dicBufSize = outSize;
-    LzmaDec_Init(&p);
+    RINOK(LzmaDec_AllocateProbs(p, propData, propSize, alloc));
+    p->dic = dest;
+    p->dicBufSize = outSize;
+    LzmaDec_Init(p);
     *srcLen = inSize;
-    res = LzmaDec_DecodeToDic(&p, outSize, src, srcLen, finishMode, status);
-    *destLen = p.dicPos;
+    res = LzmaDec_DecodeToDic(p, outSize, src, srcLen, finishMode, status);
+    *destLen = p->dicPos;
     if (res == SZ_OK && *status == LZMA_STATUS_NEEDS_MORE_INPUT)
         res = SZ_ERROR_INPUT_EOF;
+    p->dic = NULL; //dest belongs to the caller
+    p->dicBufSize = 0;
+    return res;
+}
+
+static SRes LzmaDecode_ST(Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+    const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
+    ELzmaStatus* status, ISzAllocPtr alloc)
+{
+    CLzmaDec p;
+    SRes res;
+    LzmaDec_Construct(&p);
+    res = LzmaDecode_Dec(&p, dest, destLen, src, srcLen, propData, propSize,
+        finishMode, status, alloc);
     LzmaDec_FreeProbs(&p, alloc);
     return res;
 }
 
+#ifdef AOCL_ENABLE_THREADS
+#define SZ_MT_USE_ST (-1) /* LzmaDecode_MT() leaves the stream to the single threaded decoder */
+
+/* Decodes one partition of a RAP frame written by LzmaEncode(). The partition
+   must decode to exactly decompLen bytes. */
+static SRes LzmaDecode_partition_mt(Byte* dest, SizeT decompLen, const Byte* src,
+    SizeT srcLen, const Byte* propData, unsigned propSize, ELzmaStatus* status,
+    ISzAllocPtr alloc)
+{
+    SizeT outLen = decompLen;
+    SRes res = LzmaDecode_ST(dest, &outLen, src, &srcLen, propData, propSize,
+        LZMA_FINISH_END, status, alloc);
+    if (res == SZ_OK && outLen != decompLen)
+        res = SZ_ERROR_DATA;
+    return res;
+}
+
+//Arguments shared by the workers of LzmaDecode_MT()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    const Byte* propData;
+    unsigned propSize;
+    ISzAllocPtr alloc;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} LzmaDecode_mt_args_t;
+
+//Worker of LzmaDecode_MT(): decodes partitions until none is left
+static void LzmaDecode_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    LzmaDecode_mt_args_t* args = (LzmaDecode_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_lzma_decode);
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 cmpr_bound_pad = 0;
+        AOCL_INT32 thread_parallel_res;
+        ELzmaStatus local_status = LZMA_STATUS_NOT_SPECIFIED;
+        SRes local_res = SZ_ERROR_MEM;
+
+        thread_parallel_res = aocl_do_partition_decompress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id);
+        if (thread_parallel_res == 0)
+            local_res = LzmaDecode_partition_mt((Byte*)cur_thread_info.dst_trap, (SizeT)cur_thread_info.dst_trap_size,
+                (const Byte*)cur_thread_info.partition_src, (SizeT)cur_thread_info.partition_src_size,
+                args->propData, args->propSize, &local_status, args->alloc);
+        else if (thread_parallel_res == 1) //LzmaEncode() never writes an empty partition
+            local_res = SZ_ERROR_DATA;
+
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = (AOCL_UINT32)local_status;
+        thread_grp->threads_info_list[thread_id].is_error = (AOCL_UINT32)local_res;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
+/* Multi-threaded LzmaDecode() for the RAP frame written by the multi-threaded
+   LzmaEncode(). Each partition is an independent LZMA stream, so partitions are
+   decoded in parallel when more than one thread is available and one after
+   the other otherwise. Returns SZ_MT_USE_ST for a plain LZMA stream, which
+   always starts with a zero byte and so never matches the RAP magic word. */
+static SRes LzmaDecode_MT(Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+    const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
+    ELzmaStatus* status, ISzAllocPtr alloc)
+{
+    aocl_thread_group_t thread_group_handle;
+    aocl_thread_info_t cur_thread_info;
+    AOCL_INT32 rap_metadata_len;
+    AOCL_UINT32 num_partitions, thread_cnt;
+    AOCL_INTP rap_offset, rap_len, decomp_len;
+    SizeT outSize = *destLen, inSize = *srcLen, outPos = 0, inPos;
+    SRes res = SZ_OK;
+
+    rap_metadata_len = aocl_setup_parallel_decompress_mt(&thread_group_handle, (AOCL_CHAR*)src,
+        (AOCL_CHAR*)dest, (AOCL_INTP)inSize, (AOCL_INTP)outSize, 0);
+    if (rap_metadata_len < 0)
+        return SZ_ERROR_MEM;
+    if (rap_metadata_len == 0)
+        return SZ_MT_USE_ST;
+
+    *destLen = *srcLen = 0;
+    *status = LZMA_STATUS_NOT_SPECIFIED;
+    inPos = (SizeT)rap_metadata_len;
+    num_partitions = *(AOCL_UINT32*)(src + RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES);
+    if (inPos > inSize || num_partitions > inSize / RAP_DATA_BYTES_WITH_DECOMP_LEN ||
+        (SizeT)RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(thread_group_handle.rap_version,
+            num_partitions, 0) != inPos)
+    {
+        aocl_destroy_parallel_decompress_mt(&thread_group_handle);
+        return SZ_ERROR_DATA;
+    }
+
+    //Validate the partitions before any is decoded
+    for (thread_cnt = 0; thread_cnt < num_partitions; thread_cnt++)
+    {
+        aocl_read_rap_partition_mt(&thread_group_handle, thread_cnt, &rap_offset, &rap_len, &decomp_len);
+        if (rap_offset < rap_metadata_len || rap_len < 0 || decomp_len < 0 ||
+            (SizeT)rap_offset > inSize || (SizeT)rap_len > inSize - (SizeT)rap_offset)
+        {
+            aocl_destroy_parallel_decompress_mt(&thread_group_handle);
+            return SZ_ERROR_DATA;
+        }
+    }
+
+    if (thread_group_handle.num_threads == 1)
+    {
+        //Only one thread is available: decode the partitions in order, straight into dest
+        for (thread_cnt = 0; thread_cnt < num_partitions && res == SZ_OK; thread_cnt++)
+        {
+            SizeT partLen;
+            aocl_read_rap_partition_mt(&thread_group_handle, thread_cnt, &rap_offset, &rap_len, &decomp_len);
+            if ((SizeT)decomp_len > outSize - outPos)
+            {
+                //dest ends inside this partition
+                partLen = outSize - outPos;
+                inPos = (SizeT)rap_len;
+                res = LzmaDecode_ST(dest + outPos, &partLen, src + rap_offset, &inPos,
+                    propData, propSize, finishMode, status, alloc);
+                outPos += partLen;
+                inPos += (SizeT)rap_offset;
+                break;
+            }
+            res = LzmaDecode_partition_mt(dest + outPos, (SizeT)decomp_len, src + rap_offset,
+                (SizeT)rap_len, propData, propSize, status, alloc);
+            if (res == SZ_OK)
+            {
+                outPos += (SizeT)decomp_len;
+                inPos = (SizeT)(rap_offset + rap_len);
+            }
+        }
+        *destLen = outPos;
+        *srcLen = inPos;
+        return res;
+    }
+
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
+#endif
+    //workers take the dispatcher setup of this thread
+    LzmaDecode_mt_args_t args = { &thread_group_handle, propData, propSize, alloc, dispatch_key_lzma_decode };
+    aocl_run_parallel_mt(LzmaDecode_partitions_mt, &args, thread_group_handle.num_workers);
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
+#endif
+
+    //For all the threads: Write to a single output buffer in a single-threaded mode
+    for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+    {
+        cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+        if (cur_thread_info.is_error)
+        {
+            res = (SRes)cur_thread_info.is_error;
+            break;
+        }
+        if ((SizeT)cur_thread_info.dst_trap_size > outSize - outPos)
+        {
+            //dest ends inside this partition. As in LzmaDecode_ST(), this is an
+            //error unless the caller accepts an unfinished stream
+            memcpy(dest + outPos, cur_thread_info.dst_trap, outSize - outPos);
+            outPos = outSize;
+            *status = LZMA_STATUS_NOT_FINISHED;
+            res = (finishMode == LZMA_FINISH_ANY) ? SZ_OK : SZ_ERROR_DATA;
+            break;
+        }
+        memcpy(dest + outPos, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
+        outPos += (SizeT)cur_thread_info.dst_trap_size;
+        inPos = (SizeT)(cur_thread_info.partition_src - (AOCL_CHAR*)src) + (SizeT)cur_thread_info.partition_src_size;
+        *status = (ELzmaStatus)cur_thread_info.last_bytes_len;
+    }
+    *destLen = outPos;
+    *srcLen = inPos;
+
+    aocl_destroy_parallel_decompress_mt(&thread_group_handle);
+    return res;
+}
+#endif /* AOCL_ENABLE_THREADS */
+
+SRes LzmaDecode(Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+    const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
+    ELzmaStatus* status, ISzAllocPtr alloc)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+    AOCL_SETUP_NATIVE();
+    if (src == NULL || srcLen == NULL || dest == NULL || propData == NULL ||
+        destLen == NULL || *srcLen == 0 ||
+        *srcLen > (ULLONG_MAX - LZMA_PROPS_SIZE)) // handles case when src size is < LZMA_PROPS_SIZE, resulting in destLen rolling over in calling APIs
+        return SZ_ERROR_PARAM;
+
+#ifdef AOCL_ENABLE_THREADS
+    SRes res = LzmaDecode_MT(dest, destLen, src, srcLen, propData, propSize,
+        finishMode, status, alloc);
+    if (res != SZ_MT_USE_ST)
+        return res;
+#endif
+
+    return LzmaDecode_ST(dest, destLen, src, srcLen, propData, propSize,
+        finishMode, status, alloc);
+}
+
+SRes LzmaDecode_Reuse(CLzmaDec* p, Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+    const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
+    ELzmaStatus* status, ISzAllocPtr alloc)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+    AOCL_SETUP_NATIVE();
+    if (p == NULL || src == NULL || srcLen == NULL || dest == NULL || propData == NULL ||
+        destLen == NULL || *srcLen == 0 ||
+        *srcLen > (ULLONG_MAX - LZMA_PROPS_SIZE))
+        return SZ_ERROR_PARAM;
+
+#ifdef AOCL_ENABLE_THREADS
+    //Partitions are decoded by decoders of their own
+    SRes res = LzmaDecode_MT(dest, destLen, src, srcLen, propData, propSize,
+        finishMode, status, alloc);
+    if (res != SZ_MT_USE_ST)
+        return res;
+#endif
+
+    return LzmaDecode_Dec(p, dest, destLen, src, srcLen, propData, propSize,
+        finishMode, status, alloc);
+}
+
 static void aocl_register_lzma_decode_fmv(int optOff, int optLevel)
 {
     if (optOff)
@@ -2037,32 +2278,27 @@ static void aocl_register_lzma_decode_fmv(int optOff, int optLevel)
 void aocl_setup_lzma_decode(int optOff, int optLevel, size_t insize,
     size_t level, size_t windowLog)
 {
-    AOCL_ENTER_CRITICAL(setup_lzmadec)
-    if (!setup_ok_lzma_decode) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_lzma_decode_fmv(optOff, optLevel);
-        setup_ok_lzma_decode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lzmadec)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_lzma_decode == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_lzma_decode_fmv(optOff, optLevel);
+    dispatch_key_lzma_decode = dispatchKey;
 }
 
 #ifdef AOCL_LZMA_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_lzmadec)
-    if (!setup_ok_lzma_decode) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_lzma_decode_fmv(optOff, optLevel);
-        setup_ok_lzma_decode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lzmadec)
+    if (dispatch_key_lzma_decode != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_lzma_decode_fmv(optOff, optLevel);
+    dispatch_key_lzma_decode = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 void aocl_destroy_lzma_decode(void){
-    AOCL_ENTER_CRITICAL(setup_lzma_decode)
-    setup_ok_lzma_decode = 0;
-    AOCL_EXIT_CRITICAL(setup_lzma_decode)
+    dispatch_key_lzma_decode = AOCL_DISPATCH_UNSET;
 }
 
 #ifdef AOCL_UNIT_TEST
@@ -461,6 +461,9 @@ Returns:
 
 /*! @brief Decode compressed data in `src` and save result to `dest`
 *
+* @note In multi-threaded builds, a RAP frame written by the multi-threaded LzmaEncode()
+* is recognized and its partitions are decoded in parallel.
+*
 * | Parameters | Direction   | Description |
 * |:-----------|:-----------:|:------------|
 * | \b dest       | out         | Destination buffer to save decompressed data |
@@ -490,6 +493,31 @@ Returns:
 LZMALIB_API SRes LzmaDecode(Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
     const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
     ELzmaStatus* status, ISzAllocPtr alloc);
+
+/*! @brief Same as LzmaDecode(), with the decoder object p provided by the caller.
+*          p can be passed to several calls: its probabilities are reused while
+*          the properties keep them at the same size. dest serves as the dictionary,
+*          so p holds no dictionary buffer. Release p with LzmaDec_FreeProbs().
+*
+* | Parameters | Direction   | Description |
+* |:-----------|:-----------:|:------------|
+* | \b p          | in,out      | Decoder object set up with LzmaDec_Construct() |
+* | \b dest       | out         | Destination buffer to save decompressed data |
+* | \b destLen    | out         | Size of decompressed data|
+* | \b src        | in          | Source buffer containing compressed data |
+* | \b srcLen     | in,out      | Length of source buffer |
+* | \b propData   | in          | Header bytes in compressed source data |
+* | \b propSize   | in          | Size of header |
+* | \b finishMode |             | Same as in LzmaDecode() |
+* | \b status     | out         | Decompression status at the end of current operation |
+* | \b alloc      | in          | Memory allocator object |
+*
+* @return Same as LzmaDecode()
+* 
+*/
+LZMALIB_API SRes LzmaDecode_Reuse(CLzmaDec* p, Byte* dest, SizeT* destLen, const Byte* src, SizeT* srcLen,
+    const Byte* propData, unsigned propSize, ELzmaFinishMode finishMode,
+    ELzmaStatus* status, ISzAllocPtr alloc);
     
 /**
  * @}
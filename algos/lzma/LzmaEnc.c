@@ -53,6 +53,10 @@
 #endif
 
 #include <limits.h>
+
+#ifdef AOCL_ENABLE_THREADS
+#include "threads/threads.h"
+#endif
 /* the following LzmaEnc_* declarations is internal LZMA interface for LZMA2 encoder */
 
 SRes LzmaEnc_PrepareForLzma2(CLzmaEncHandle pp, ISeqInStream *inStream, UInt32 keepWindowSize,
@@ -101,11 +105,11 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_lzma_encode = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_lzma_encode = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 //Forward declarations to allow default pointer initializations
 // Function pointers for optimization overloads
-void (*LzmaEncProps_Normalize_fp)(CLzmaEncProps* p) = LzmaEncProps_Normalize;
+AOCL_TLS void (*LzmaEncProps_Normalize_fp)(CLzmaEncProps* p) = LzmaEncProps_Normalize;
 
 void LzmaEncProps_Init(CLzmaEncProps *p)
 {
@@ -687,13 +691,13 @@ typedef struct
 static unsigned GetOptimum(CLzmaEnc* p, UInt32 position);
 
 // Function pointers for optimization overloads
- void (*MatchFinder_CreateVTable_fp)(CMatchFinder* p, IMatchFinder2* vTable) = MatchFinder_CreateVTable;
- int (*MatchFinder_Create_fp)(CMatchFinder* p, UInt32 historySize,
+AOCL_TLS void (*MatchFinder_CreateVTable_fp)(CMatchFinder* p, IMatchFinder2* vTable) = MatchFinder_CreateVTable;
+AOCL_TLS int (*MatchFinder_Create_fp)(CMatchFinder* p, UInt32 historySize,
   UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter,
   ISzAllocPtr alloc) = MatchFinder_Create;
- void (*MatchFinder_Free_fp)(CMatchFinder* p, ISzAllocPtr alloc) = MatchFinder_Free;
- unsigned (*GetOptimum_fp)(CLzmaEnc* p, UInt32 position) = GetOptimum;
- SRes(*LzmaEnc_SetProps_fp)(CLzmaEncHandle pp, const CLzmaEncProps* props2) = LzmaEnc_SetProps;
+AOCL_TLS void (*MatchFinder_Free_fp)(CMatchFinder* p, ISzAllocPtr alloc) = MatchFinder_Free;
+AOCL_TLS unsigned (*GetOptimum_fp)(CLzmaEnc* p, UInt32 position) = GetOptimum;
+AOCL_TLS SRes(*LzmaEnc_SetProps_fp)(CLzmaEncHandle pp, const CLzmaEncProps* props2) = LzmaEnc_SetProps;
 
 #define MFB (p->matchFinderBase)
 /*
@@ -3645,6 +3649,9 @@ MY_NO_INLINE
 static SRes LzmaEnc_CodeOneBlock(CLzmaEnc *p, UInt32 maxPackSize, UInt32 maxUnpackSize)
 {
   UInt32 nowPos32, startPos32;
+#ifdef AOCL_LZMA_OPT
+  unsigned (*const getOptimum)(CLzmaEnc* p, UInt32 position) = GetOptimum_fp; // read once per block, not per symbol
+#endif
   if (p->needInit)
   {
     p->matchFinder.Init(p->matchFinderObj);
@@ -3689,7 +3696,7 @@ static SRes LzmaEnc_CodeOneBlock(CLzmaEnc *p, UInt32 maxPackSize, UInt32 maxUnpa
       unsigned oci = p->optCur;
       if (p->optEnd == oci)
 #ifdef AOCL_LZMA_OPT
-        len = GetOptimum_fp(p, nowPos32);
+        len = getOptimum(p, nowPos32);
 #else
         len = GetOptimum(p, nowPos32);
 #endif
@@ -4410,34 +4417,196 @@ SRes ValidateParams(const CLzmaEncProps* props) {
         return SZ_OK;
 }
 
-SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+#ifdef AOCL_ENABLE_THREADS
+#define SZ_MT_USE_ST (-1) /* LzmaEncode_MT() leaves the stream to the single threaded encoder */
+
+/* Encodes one partition as an independent LZMA stream into its dst_trap.
+   dst_trap_size is updated to the encoded length. */
+static SRes LzmaEncode_partition_mt(aocl_thread_info_t *cur_thread_info,
+    const CLzmaEncProps *props, int writeEndMark, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  CLzmaEnc *p = (CLzmaEnc *)LzmaEnc_Create(alloc);
+  SizeT destLen = (SizeT)cur_thread_info->dst_trap_size;
+  SRes res;
+  if (!p)
+    return SZ_ERROR_MEM;
+
+#ifdef AOCL_LZMA_OPT
+  CLzmaEncProps props_cur = *props;
+  props_cur.srcLen = (SizeT)cur_thread_info->partition_src_size;
+  res = LzmaEnc_SetProps_fp(p, &props_cur);
+#else
+  res = LzmaEnc_SetProps(p, props);
+#endif
+
+  if (res == SZ_OK)
+    res = LzmaEnc_MemEncode(p, (Byte *)cur_thread_info->dst_trap, &destLen,
+        (const Byte *)cur_thread_info->partition_src, (SizeT)cur_thread_info->partition_src_size,
+        writeEndMark, NULL, alloc, allocBig);
+  cur_thread_info->dst_trap_size = (AOCL_INTP)destLen;
+
+  LzmaEnc_Destroy(p, alloc, allocBig);
+  return res;
+}
+
+//Arguments shared by the workers of LzmaEncode_MT()
+typedef struct {
+  aocl_thread_group_t* thread_grp;
+  const CLzmaEncProps *props;
+  int writeEndMark;
+  ISzAllocPtr alloc;
+  ISzAllocPtr allocBig;
+  int dispatch_key;   //Dispatcher setup of the thread that started the region
+} LzmaEncode_mt_args_t;
+
+//Worker of LzmaEncode_MT(): encodes partitions until none is left
+static void LzmaEncode_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+  LzmaEncode_mt_args_t* args = (LzmaEncode_mt_args_t*)arg;
+  aocl_thread_group_t* thread_grp = args->thread_grp;
+  aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+  printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+  AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_lzma_encode);
+  AOCL_UINT32 thread_id;
+  //Take partitions from this thread's queue first, then steal pending ones from the other threads
+  while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+  {
+    AOCL_INTP part_size = (thread_id != thread_grp->num_threads - 1) ?
+        thread_grp->common_part_src_size :
+        thread_grp->common_part_src_size + thread_grp->leftover_part_src_bytes;
+    //Output bound of srcLen + srcLen / 3 + 128 bytes, as used by LzmaLib
+    AOCL_UINT32 cmpr_bound_pad = (AOCL_UINT32)(part_size / 3) + 128;
+    SRes local_res = SZ_ERROR_MEM;
+
+    if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
+      local_res = LzmaEncode_partition_mt(&cur_thread_info, args->props, args->writeEndMark, args->alloc, args->allocBig);
+
+    thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+    thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+    thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+    thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+    thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+    thread_grp->threads_info_list[thread_id].last_bytes_len = 0;
+    thread_grp->threads_info_list[thread_id].is_error = local_res;
+    thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+  }
+}
+
+/* Multi-threaded LzmaEncode().
+   src is split into partitions of at least one dictionary size, so that each
+   partition still gets the full search window. Every partition is encoded as
+   an independent LZMA stream and their offsets and lengths are recorded in a
+   RAP frame at the start of dest, which LzmaDecode() uses to decode them in
+   parallel. propsEncoded describes the whole stream and is valid for each
+   partition. Returns SZ_MT_USE_ST when the input is better served by a single stream. */
+static SRes LzmaEncode_MT(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
     const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
     ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
 {
-  LOG_UNFORMATTED(TRACE, logCtx, "Enter");
-    AOCL_SETUP_NATIVE();
-  if (src == NULL || srcLen == 0 || dest == NULL || propsEncoded == NULL ||
-      props == NULL || propsSize == NULL || destLen == NULL ||
-      *destLen > (ULLONG_MAX - LZMA_PROPS_SIZE)) // handles case when dest size is < LZMA_PROPS_SIZE, resulting in destLen rolling over in calling APIs
+  aocl_thread_group_t thread_group_handle;
+  aocl_thread_info_t cur_thread_info;
+  AOCL_INT32 rap_metadata_len;
+  AOCL_UINT32 thread_cnt;
+  AOCL_CHAR *rap_ptr;
+  SizeT outSize = *destLen, outPos;
+  UInt32 dictSize;
+  SRes res;
+
+  /* Progress is reported against a single stream. The RAP header is
+     written to dest by the thread group setup. */
+  if (progress != NULL || outSize < RAP_START_OF_PARTITIONS)
+    return SZ_MT_USE_ST;
+
+  dictSize = LzmaEncProps_GetDictSize(props);
+  if (dictSize > INT_MAX)
+    return SZ_MT_USE_ST;
+
+  rap_metadata_len = aocl_setup_parallel_compress_mt(&thread_group_handle, (AOCL_CHAR *)src,
+      (AOCL_CHAR *)dest, (AOCL_INTP)srcLen, (AOCL_INTP)outSize, (AOCL_INT32)dictSize, 1);
+  if (rap_metadata_len < 0)
+    return SZ_ERROR_MEM;
+  if (thread_group_handle.num_threads == 1)
+    return SZ_MT_USE_ST;
+  if ((SizeT)rap_metadata_len > outSize)
   {
-    LOG_UNFORMATTED(INFO, logCtx, "Exit");
-    return SZ_ERROR_PARAM;
+    aocl_destroy_parallel_compress_mt(&thread_group_handle);
+    return SZ_ERROR_OUTPUT_EOF;
   }
 
-  if (ValidateParams(props) != SZ_OK)
+  /* Properties of the whole stream. Partitions use the same lc, lp and pb
+     and a dictionary no larger than this one. */
   {
-    LOG_UNFORMATTED(INFO, logCtx, "Exit");
-    return SZ_ERROR_PARAM;
+    CLzmaEnc *p = (CLzmaEnc *)LzmaEnc_Create(alloc);
+    if (!p)
+    {
+      aocl_destroy_parallel_compress_mt(&thread_group_handle);
+      return SZ_ERROR_MEM;
+    }
+#ifdef AOCL_LZMA_OPT
+    CLzmaEncProps props_cur = *props;
+    props_cur.srcLen = srcLen;
+    res = LzmaEnc_SetProps_fp(p, &props_cur);
+#else
+    res = LzmaEnc_SetProps(p, props);
+#endif
+    if (res == SZ_OK)
+      res = LzmaEnc_WriteProperties(p, propsEncoded, propsSize);
+    LzmaEnc_Destroy(p, alloc, allocBig);
+    if (res != SZ_OK)
+    {
+      aocl_destroy_parallel_compress_mt(&thread_group_handle);
+      return res;
+    }
   }
 
-  CLzmaEnc *p = (CLzmaEnc *)LzmaEnc_Create(alloc);
-  SRes res;
-  if (!p)
+#ifdef AOCL_THREADS_LOG
+  printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
+#endif
+  //workers take the dispatcher setup of this thread
+  LzmaEncode_mt_args_t args = { &thread_group_handle, props, writeEndMark, alloc, allocBig, dispatch_key_lzma_encode };
+  aocl_run_parallel_mt(LzmaEncode_partitions_mt, &args, thread_group_handle.num_workers);
+#ifdef AOCL_THREADS_LOG
+  printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
+#endif
+
+  //For all the threads: Write RAP metadata and the encoded partitions to dest in a single-threaded mode
+  rap_ptr = (AOCL_CHAR *)dest + RAP_START_OF_PARTITIONS;
+  outPos = (SizeT)rap_metadata_len;
+  for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
   {
-    LOG_UNFORMATTED(INFO, logCtx, "Exit");
-    return SZ_ERROR_MEM;
+    cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+    if (cur_thread_info.is_error)
+    {
+      res = (SRes)cur_thread_info.is_error;
+      aocl_destroy_parallel_compress_mt(&thread_group_handle);
+      return res;
+    }
+    if ((SizeT)cur_thread_info.dst_trap_size > outSize - outPos)
+    {
+      aocl_destroy_parallel_compress_mt(&thread_group_handle);
+      return SZ_ERROR_OUTPUT_EOF;
+    }
+    rap_ptr = aocl_write_rap_partition_mt(&thread_group_handle, rap_ptr, (AOCL_INTP)outPos,
+        cur_thread_info.dst_trap_size, cur_thread_info.partition_src_size);
+    memcpy(dest + outPos, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
+    outPos += (SizeT)cur_thread_info.dst_trap_size;
   }
+  *destLen = outPos;
+
+  aocl_destroy_parallel_compress_mt(&thread_group_handle);
+  return SZ_OK;
+}
+#endif /* AOCL_ENABLE_THREADS */
 
+/* Single threaded LzmaEncode() with the encoder p. p keeps its match finder
+   and probability buffers across calls while their sizes stay the same. */
+static SRes LzmaEncode_ST(CLzmaEnc *p, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  SRes res;
 #ifdef AOCL_LZMA_OPT
   CLzmaEncProps props_cur = *props;
   props_cur.srcLen = srcLen; //same srcLen value must be set here and passed to LzmaEnc_MemEncode()
@@ -4453,6 +4622,51 @@ SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
       res = LzmaEnc_MemEncode(p, dest, destLen, src, srcLen,
           writeEndMark, progress, alloc, allocBig);
   }
+  return res;
+}
+
+static SRes LzmaEncode_Check(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize)
+{
+  if (src == NULL || srcLen == 0 || dest == NULL || propsEncoded == NULL ||
+      props == NULL || propsSize == NULL || destLen == NULL ||
+      *destLen > (ULLONG_MAX - LZMA_PROPS_SIZE)) // handles case when dest size is < LZMA_PROPS_SIZE, resulting in destLen rolling over in calling APIs
+    return SZ_ERROR_PARAM;
+  return ValidateParams(props);
+}
+
+SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+    AOCL_SETUP_NATIVE();
+  if (LzmaEncode_Check(dest, destLen, src, srcLen, props, propsEncoded, propsSize) != SZ_OK)
+  {
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return SZ_ERROR_PARAM;
+  }
+
+  SRes res;
+#ifdef AOCL_ENABLE_THREADS
+  res = LzmaEncode_MT(dest, destLen, src, srcLen, props, propsEncoded, propsSize,
+      writeEndMark, progress, alloc, allocBig);
+  if (res != SZ_MT_USE_ST)
+  {
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return res;
+  }
+#endif
+
+  CLzmaEnc *p = (CLzmaEnc *)LzmaEnc_Create(alloc);
+  if (!p)
+  {
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return SZ_ERROR_MEM;
+  }
+
+  res = LzmaEncode_ST(p, dest, destLen, src, srcLen, props, propsEncoded, propsSize,
+      writeEndMark, progress, alloc, allocBig);
 
   LzmaEnc_Destroy(p, alloc, allocBig);
   
@@ -4460,6 +4674,46 @@ SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
   return res;
 }
 
+SRes LzmaEncode_Reuse(CLzmaEncHandle pp, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+  AOCL_SETUP_NATIVE();
+  if (pp == NULL ||
+      LzmaEncode_Check(dest, destLen, src, srcLen, props, propsEncoded, propsSize) != SZ_OK)
+  {
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return SZ_ERROR_PARAM;
+  }
+
+  SRes res;
+#ifdef AOCL_ENABLE_THREADS
+  //Partitions are coded by encoders of their own
+  res = LzmaEncode_MT(dest, destLen, src, srcLen, props, propsEncoded, propsSize,
+      writeEndMark, progress, alloc, allocBig);
+  if (res != SZ_MT_USE_ST)
+  {
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return res;
+  }
+#endif
+
+  res = LzmaEncode_ST((CLzmaEnc *)pp, dest, destLen, src, srcLen, props, propsEncoded,
+      propsSize, writeEndMark, progress, alloc, allocBig);
+
+  LOG_UNFORMATTED(INFO, logCtx, "Exit");
+  return res;
+}
+
+SRes LzmaEnc_SetProps_Dyn(CLzmaEncHandle pp, const CLzmaEncProps *props)
+{
+  AOCL_SETUP_NATIVE();
+  if (pp == NULL || props == NULL || ValidateParams(props) != SZ_OK)
+    return SZ_ERROR_PARAM;
+  return LzmaEnc_SetProps_fp(pp, props);
+}
+
 static void aocl_register_lzma_encode_fmv(int optOff, int optLevel)
 {
     if (optOff)
@@ -4523,32 +4777,27 @@ static void aocl_register_lzma_encode_fmv(int optOff, int optLevel)
 void aocl_setup_lzma_encode(int optOff, int optLevel, size_t insize,
     size_t level, size_t windowLog)
 {
-    AOCL_ENTER_CRITICAL(setup_lzmaenc)
-    if (!setup_ok_lzma_encode) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_lzma_encode_fmv(optOff, optLevel);
-        setup_ok_lzma_encode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lzmaenc)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_lzma_encode == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_lzma_encode_fmv(optOff, optLevel);
+    dispatch_key_lzma_encode = dispatchKey;
 }
 
 #ifdef AOCL_LZMA_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_lzmaenc)
-    if (!setup_ok_lzma_encode) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_lzma_encode_fmv(optOff, optLevel);
-        setup_ok_lzma_encode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_lzmaenc)
+    if (dispatch_key_lzma_encode != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_lzma_encode_fmv(optOff, optLevel);
+    dispatch_key_lzma_encode = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 void aocl_destroy_lzma_encode(void){
-    AOCL_ENTER_CRITICAL(setup_lzma_encode)
-    setup_ok_lzma_encode = 0;
-    AOCL_EXIT_CRITICAL(setup_lzma_encode)
+    dispatch_key_lzma_encode = AOCL_DISPATCH_UNSET;
 }
 
 #ifdef AOCL_UNIT_TEST
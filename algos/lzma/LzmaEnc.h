@@ -182,6 +182,24 @@ LZMALIB_API void LzmaEnc_Destroy(CLzmaEncHandle p, ISzAllocPtr alloc, ISzAllocPt
 */
 LZMALIB_API SRes LzmaEnc_SetProps(CLzmaEncHandle p, const CLzmaEncProps *props);
 
+/*! @brief Same as LzmaEnc_SetProps(), calling the variant selected by the dynamic dispatcher.
+*          props are validated as in LzmaEncode(). With AOCL optimizations, props->srcLen
+*          is the expected size of the data passed to LzmaEnc_MemEncode().
+*
+* | Parameters | Direction   | Description |
+* |:-----------|:-----------:|:------------|
+* | \b p       | out         | Lzma encoder handle |
+* | \b props   | in          | Lzma encoder properties |
+*
+* @return 
+* | Result     | Description |
+* |:-----------|:------------|
+* | Success    |SZ_OK                      |
+* | Fail       |SZ_ERROR_PARAM      - Incorrect parameter in props  |
+* 
+*/
+LZMALIB_API SRes LzmaEnc_SetProps_Dyn(CLzmaEncHandle p, const CLzmaEncProps *props);
+
 /*! @brief Set expected data size in p to expectedDataSiize
 *
 * | Parameters           | Direction   | Description |
@@ -268,6 +286,11 @@ LZMALIB_API SRes LzmaEnc_MemEncode(CLzmaEncHandle p, Byte *dest, SizeT *destLen,
 
 /*! @brief Encode data in src and save compressed data to dest
 *
+* @note In multi-threaded builds, when progress is NULL and src spans several dictionaries,
+* src is split into partitions of at least one dictionary size that are encoded in parallel
+* as independent LZMA streams. dest then holds a RAP frame that locates the partitions.
+* Only LzmaDecode() of a multi-threaded build decodes such a stream.
+*
 * | Parameters      | Direction   | Description |
 * |:----------------|:-----------:|:------------|
 * | \b dest         | out         | Destination buffer to hold compressed data |
@@ -297,6 +320,32 @@ LZMALIB_API SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT s
     const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
     ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig);
 
+/*! @brief Same as LzmaEncode(), with the encoder object p created by the caller.
+*          p can be passed to several calls: its match finder and probability
+*          buffers are reused while props keep them at the same sizes.
+*
+* | Parameters      | Direction   | Description |
+* |:----------------|:-----------:|:------------|
+* | \b p            | in,out      | Lzma encoder handle from LzmaEnc_Create() |
+* | \b dest         | out         | Destination buffer to hold compressed data |
+* | \b destLen      | out         | Size of compressed data written to dest |
+* | \b src          | in          | Source buffer with uncompressed data |
+* | \b srcLen       | in          | Size of uncompressed data in src |
+* | \b props        | in          | Properties to control compression method |
+* | \b propsEncoded | out         | Buffer to save header bytes |
+* | \b propsSize    | out         | Size of header bytes |
+* | \b writeEndMark | in          | If non-0, finish stream with end mark |
+* | \b progress     | in          | Compression progress indicator |
+* | \b alloc        | in          | Allocator object, the one p was created with |
+* | \b allocBig     | in          | Allocator object for large blocks |
+*
+* @return Same as LzmaEncode()
+*
+*/
+LZMALIB_API SRes LzmaEncode_Reuse(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgress *progress, ISzAllocPtr alloc, ISzAllocPtr allocBig);
+
 /**
  * @}
 */
@@ -109,7 +109,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_snappy = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_snappy = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 //Forward declarations to allow default pointer initializations
 bool SAW_RawUncompress(const char* compressed, size_t compressed_length, char* uncompressed);
@@ -118,18 +118,18 @@ bool SAW_RawUncompress(const char* compressed, size_t compressed_length, char* u
     bool SAW_RawUncompressDirect(const char* compressed, size_t compressed_length, char* uncompressed, AOCL_UINT32 uncompressed_len);
 #endif
 
-static char* (*SNAPPY_compress_fragment_fp)(const char* input,
+static AOCL_TLS char* (*SNAPPY_compress_fragment_fp)(const char* input,
     size_t input_size, char* op,
     uint16_t* table, const int table_size) = internal::CompressFragment;
 
 // function pointer to variants of the RawUncompress function, used for integration
 // with the dynamic dispatcher. "SAW" stands for "SnappyArrayWriter" as that is the
 // class used for decompression of flat buffers to flat buffers in this library.
-static bool (*SNAPPY_SAW_raw_uncompress_fp)(const char* compressed,
+static AOCL_TLS bool (*SNAPPY_SAW_raw_uncompress_fp)(const char* compressed,
     size_t compressed_length, char* uncompressed) = SAW_RawUncompress;
 
 #ifdef AOCL_ENABLE_THREADS
-    static bool (*SNAPPY_SAW_raw_uncompress_direct_fp)(const char* compressed,
+    static AOCL_TLS bool (*SNAPPY_SAW_raw_uncompress_direct_fp)(const char* compressed,
         size_t compressed_length, char* uncompressed, AOCL_UINT32 uncompressed_len) = SAW_RawUncompressDirect;
 #endif
 
@@ -1746,9 +1746,11 @@ bool GetUncompressedLength(Source* source, uint32_t* result) {
   return GetUncompressedLengthInternal_fp(source, result);
 }
 
-size_t Compress(Source* reader, Sink* writer) {
-  AOCL_SETUP_NATIVE();
-  if (reader == NULL || writer == NULL) return 0;
+namespace {
+// Compresses all of "reader" into "writer" using the scratch space in "wmem".
+// "wmem" must have been sized for at least min(reader->Available(), kBlockSize).
+size_t CompressWithWorkingMemory(Source* reader, Sink* writer,
+                                 internal::WorkingMemory& wmem) {
   size_t written = 0;
   size_t N = reader->Available();
   const size_t uncompressed_size = N;
@@ -1757,8 +1759,6 @@ size_t Compress(Source* reader, Sink* writer) {
   writer->Append(ulength, p-ulength);
   written += (p - ulength);
 
-  internal::WorkingMemory wmem(N);
-
   while (N > 0) {
     // Get next block to compress (without copying if possible)
     size_t fragment_size;
@@ -1821,6 +1821,14 @@ size_t Compress(Source* reader, Sink* writer) {
 
   return written;
 }
+}  // namespace
+
+size_t Compress(Source* reader, Sink* writer) {
+  AOCL_SETUP_NATIVE();
+  if (reader == NULL || writer == NULL) return 0;
+  internal::WorkingMemory wmem(reader->Available());
+  return CompressWithWorkingMemory(reader, writer, wmem);
+}
 
 // -----------------------------------------------------------------------
 // IOVec interfaces
@@ -2216,7 +2224,7 @@ bool SAW_RawUncompress(const char* compressed, size_t compressed_length, char* u
 }
 
 #ifdef AOCL_SNAPPY_AVX_OPT
-bool (*InternalUncompressAOCLArray_fp)(Source* r, AOCL_SnappyArrayWriter_AVX* writer) = InternalUncompress<AOCL_SnappyArrayWriter_AVX, with_avx>;
+AOCL_TLS bool (*InternalUncompressAOCLArray_fp)(Source* r, AOCL_SnappyArrayWriter_AVX* writer) = InternalUncompress<AOCL_SnappyArrayWriter_AVX, with_avx>;
 AOCL_SNAPPY_TARGET_AVX
 bool AOCL_SAW_RawUncompress_AVX(const char* compressed, size_t compressed_length, char* uncompressed) {
   AOCL_SIMD_UNIT_TEST(DEBUG, logCtx, "Enter");
@@ -2227,7 +2235,7 @@ bool AOCL_SAW_RawUncompress_AVX(const char* compressed, size_t compressed_length
 #endif /* AOCL_SNAPPY_AVX_OPT */
 
 #ifdef AOCL_ENABLE_THREADS // Threaded
-bool (*InternalUncompressDirectArray_fp)(Source* r, SnappyArrayWriter* writer, AOCL_UINT32 uncompressed_len) = InternalUncompressDirect< SnappyArrayWriter, with_avx>;
+AOCL_TLS bool (*InternalUncompressDirectArray_fp)(Source* r, SnappyArrayWriter* writer, AOCL_UINT32 uncompressed_len) = InternalUncompressDirect< SnappyArrayWriter, with_avx>;
 // for multithreaded decompression, where the uncompressed length is not available
 // on the stream but rather is stored externally, we need to have a decompression
 // function that takes the uncompressed length as a parameter. The following functions
@@ -2239,7 +2247,7 @@ bool SAW_RawUncompressDirect(const char* compressed, size_t compressed_length, c
 }
 
 #ifdef AOCL_SNAPPY_AVX_OPT
-bool (*InternalUncompressDirectAOCLArray_fp)(Source* r, AOCL_SnappyArrayWriter_AVX* writer, AOCL_UINT32 uncompressed_len) = InternalUncompressDirect< AOCL_SnappyArrayWriter_AVX, with_avx>;
+AOCL_TLS bool (*InternalUncompressDirectAOCLArray_fp)(Source* r, AOCL_SnappyArrayWriter_AVX* writer, AOCL_UINT32 uncompressed_len) = InternalUncompressDirect< AOCL_SnappyArrayWriter_AVX, with_avx>;
 bool AOCL_SAW_RawUncompressDirect(const char* compressed, size_t compressed_length, char* uncompressed, AOCL_UINT32 uncompressed_len) {
   ByteArraySource reader(compressed, compressed_length);
   AOCL_SnappyArrayWriter_AVX output(uncompressed);
@@ -2267,6 +2275,53 @@ AOCL_INT32 AOCL_GetUncompressedLengthAndVarintByteWidth(const char* start, size_
 #endif // AOCL_ENABLE_THREADS
 
 
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)
+//Arguments shared by the workers of the multi-threaded RawUncompress()
+typedef struct {
+  aocl_thread_group_t* thread_grp;
+  int dispatch_key;   //Dispatcher setup of the thread that started the region
+} RawUncompressMTArgs;
+
+//Worker of the multi-threaded RawUncompress(): decompresses partitions until none is left
+static void RawUncompressPartitions(void* arg, AOCL_UINT32 worker_id)
+{
+  RawUncompressMTArgs* args = (RawUncompressMTArgs*)arg;
+  aocl_thread_group_t* thread_grp = args->thread_grp;
+  aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+  printf("Decompress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+  AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_snappy);
+  AOCL_UINT32 thread_id;
+  //Take partitions from this thread's queue first, then steal pending ones from the other threads
+  while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+  {
+    AOCL_UINT32 is_error = 1;
+    bool local_result = false;
+    AOCL_INT32 thread_parallel_res = 0;
+
+    thread_parallel_res = aocl_do_partition_decompress_mt(thread_grp, &cur_thread_info, 0 /*cmpr_bound_pad*/, thread_id);
+    if (thread_parallel_res == 0)
+    {
+      local_result = SNAPPY_SAW_raw_uncompress_direct_fp(cur_thread_info.partition_src, cur_thread_info.partition_src_size, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
+      is_error = local_result ? 0 : 1;
+    } // aocl_do_partition_decompress_mt
+    else if (thread_parallel_res == 1)
+    {
+      local_result = 0;
+      is_error = 0;
+    }
+
+    thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+    thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+    thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+    thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+    thread_grp->threads_info_list[thread_id].is_error = is_error;
+    thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+  }
+}
+#endif
+
 #ifdef AOCL_SNAPPY_OPT
 bool RawUncompress(const char* compressed, size_t compressed_length, char* uncompressed) {
   LOG_UNFORMATTED(TRACE, logCtx, "Enter");
@@ -2312,35 +2367,9 @@ bool RawUncompress(const char* compressed, size_t compressed_length, char* uncom
         printf("Decompress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
 
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-    {
-#ifdef AOCL_THREADS_LOG
-      printf("Decompress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-      AOCL_UINT32 is_error = 1;
-      AOCL_UINT32 thread_id = omp_get_thread_num();
-      bool local_result = false;
-      AOCL_INT32 thread_parallel_res = 0;
-
-      thread_parallel_res = aocl_do_partition_decompress_mt(&thread_group_handle, &cur_thread_info, 0 /*cmpr_bound_pad*/, thread_id);
-      if (thread_parallel_res == 0)
-      {
-        local_result = SNAPPY_SAW_raw_uncompress_direct_fp(cur_thread_info.partition_src, cur_thread_info.partition_src_size, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
-        is_error = local_result ? 0 : 1;
-      } // aocl_do_partition_decompress_mt
-      else if (thread_parallel_res == 1)
-      {
-        local_result = 0;
-        is_error = 0;
-      }
-
-      thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-      thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-      thread_group_handle.threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
-      thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-      thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-      thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-    } // #pragma omp parallel
+    //workers take the dispatcher setup of this thread
+    RawUncompressMTArgs args = { &thread_group_handle, dispatch_key_snappy };
+    aocl_run_parallel_mt(RawUncompressPartitions, &args, thread_group_handle.num_workers);
 
 #ifdef AOCL_THREADS_LOG
     printf("Decompress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
@@ -2401,6 +2430,24 @@ bool RawUncompress(const char* compressed, size_t compressed_length,
 }
 #endif
 
+bool RawUncompressPartitionMT(const char* compressed, size_t compressed_length,
+                              char* uncompressed, size_t uncompressed_length) {
+  AOCL_SETUP_NATIVE();
+  if (compressed == NULL || uncompressed == NULL)
+    return false;
+#ifdef AOCL_ENABLE_THREADS
+  // partitions carry no varint header; their length comes from the RAP frame
+  if (uncompressed_length > 0xFFFFFFFFu)
+    return false;
+  return SNAPPY_SAW_raw_uncompress_direct_fp(compressed, compressed_length, uncompressed,
+                                             (AOCL_UINT32)uncompressed_length);
+#else
+  (void)compressed_length;
+  (void)uncompressed_length;
+  return false;
+#endif
+}
+
 bool RawUncompress(Source* compressed, char* uncompressed) {
     // sanity checks ------------------------------------------------------------
     size_t _readable_length, ulength;
@@ -2491,10 +2538,101 @@ bool IsValidCompressed(Source* compressed) {
   return InternalUncompressDecompression_fp(compressed, &writer);
 }
 
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)
+// Release function for the per thread WorkingMemory kept in the thread context
+static void FreeThreadWorkingMemory(AOCL_VOID* state) {
+  delete static_cast<internal::WorkingMemory*>(state);
+}
+#endif
+
+void* CreateMTContext() {
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)
+  return aocl_create_thread_ctx_mt(FreeThreadWorkingMemory);
+#else
+  return NULL;
+#endif
+}
+
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)
+//Arguments shared by the workers of the multi-threaded RawCompress()
+typedef struct {
+  aocl_thread_group_t* thread_grp;
+  AOCL_UINT32 cmpr_bound_pad;
+  int dispatch_key;   //Dispatcher setup of the thread that started the region
+} RawCompressMTArgs;
+
+//Worker of the multi-threaded RawCompress(): compresses partitions until none is left
+static void RawCompressPartitions(void* arg, AOCL_UINT32 worker_id)
+{
+  RawCompressMTArgs* args = (RawCompressMTArgs*)arg;
+  aocl_thread_group_t* thread_grp = args->thread_grp;
+  aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+  printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+  AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_snappy);
+  AOCL_UINT32 thread_id;
+  // reuse this thread's hash table and scratch buffers from the context.
+  // A kBlockSize WorkingMemory serves partitions of any size.
+  internal::WorkingMemory* wmem = static_cast<internal::WorkingMemory*>(
+      aocl_get_thread_state_mt(thread_grp, worker_id, FreeThreadWorkingMemory));
+  bool wmem_kept = (wmem != NULL);
+  //Take partitions from this thread's queue first, then steal pending ones from the other threads
+  while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+  {
+    AOCL_UINT32 is_error = 1;
+    AOCL_INT32 partition_compressed_length = 0;
+
+    if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, args->cmpr_bound_pad, thread_id) == 0)
+    {
+      ByteArraySource reader(cur_thread_info.partition_src, cur_thread_info.partition_src_size);
+      UncheckedByteArraySink writer(cur_thread_info.dst_trap);
+
+      if (wmem == NULL) {
+        wmem = new internal::WorkingMemory(kBlockSize);
+        wmem_kept = (aocl_set_thread_state_mt(thread_grp, worker_id, wmem,
+                                              FreeThreadWorkingMemory) == 0);
+      }
+      CompressWithWorkingMemory(&reader, &writer, *wmem);
+
+      // Compute how many bytes were added
+      partition_compressed_length = (writer.CurrentDestination() - cur_thread_info.dst_trap);
+      is_error = 0;
+    } // aocl_do_partition_compress_mt
+
+    thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+    thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+    thread_grp->threads_info_list[thread_id].dst_trap_size = partition_compressed_length;
+    thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+    thread_grp->threads_info_list[thread_id].is_error = is_error;
+    thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+  }
+  // wmem is shared by all the partitions of this thread when it is not kept in the context
+  if (!wmem_kept)
+    delete wmem;
+}
+#endif
+
+void FreeMTContext(void* mt_ctx) {
+#if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)
+  aocl_destroy_thread_ctx_mt(static_cast<aocl_thread_ctx_t*>(mt_ctx));
+#else
+  (void)mt_ctx;
+#endif
+}
+
 void RawCompress(const char* input,
                  size_t input_length,
                  char* compressed,
                  size_t* compressed_length) {
+  RawCompress(input, input_length, compressed, compressed_length, NULL);
+}
+
+void RawCompress(const char* input,
+                 size_t input_length,
+                 char* compressed,
+                 size_t* compressed_length,
+                 void* mt_ctx) {
   LOG_UNFORMATTED(TRACE, logCtx, "Enter");
   if (input == NULL || compressed == NULL || compressed_length == NULL)
   {
@@ -2505,11 +2643,12 @@ void RawCompress(const char* input,
 
 #if defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT) // Threaded
   aocl_thread_group_t thread_group_handle;
-  aocl_thread_info_t cur_thread_info;
   AOCL_INT32 ret_status = -1;
   AOCL_INT32 maxCompressedLength = (AOCL_INT32)MaxCompressedLength(input_length);
 
-  ret_status = aocl_setup_parallel_compress_mt(&thread_group_handle, (char *)input, compressed,
+  ret_status = aocl_setup_parallel_compress_ctx_mt(&thread_group_handle,
+                                              static_cast<aocl_thread_ctx_t*>(mt_ctx),
+                                              (char *)input, compressed,
                                               (AOCL_INT32)input_length, maxCompressedLength,
                                               (AOCL_INT32)kBlockSize, WINDOW_FACTOR);
   if (ret_status < 0)
@@ -2526,40 +2665,19 @@ void RawCompress(const char* input,
     return;
   }
   else {
+    AOCL_INT32 thread_max_src_size = thread_group_handle.common_part_src_size + thread_group_handle.leftover_part_src_bytes;
+    AOCL_UINT32 cmpr_bound_pad = (AOCL_INT32)MaxCompressedLength(thread_max_src_size) - thread_max_src_size;
+    // compress partitions directly into the destination buffer, leaving room
+    // for the RAP frame and the combined uncompressed length varint
+    aocl_enable_in_place_compress_mt(&thread_group_handle, cmpr_bound_pad,
+                                     ret_status + Varint::kMax32);
 #ifdef AOCL_THREADS_LOG
       printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
 
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-    {
-#ifdef AOCL_THREADS_LOG
-      printf("Compress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-      AOCL_INT32 thread_max_src_size = thread_group_handle.common_part_src_size + thread_group_handle.leftover_part_src_bytes;
-      AOCL_UINT32 cmpr_bound_pad = (AOCL_INT32)MaxCompressedLength(thread_max_src_size) - thread_max_src_size;
-      AOCL_UINT32 is_error = 1;
-      AOCL_UINT32 thread_id = omp_get_thread_num();
-      AOCL_INT32 partition_compressed_length = 0;
-
-      if (aocl_do_partition_compress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
-      {
-        ByteArraySource reader(cur_thread_info.partition_src, cur_thread_info.partition_src_size);
-        UncheckedByteArraySink writer(cur_thread_info.dst_trap);
-        Compress(&reader, &writer);
-
-        // Compute how many bytes were added
-        partition_compressed_length = (writer.CurrentDestination() - cur_thread_info.dst_trap);
-        is_error = 0;
-      } // aocl_do_partition_compress_mt
-
-      thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-      thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-      thread_group_handle.threads_info_list[thread_id].dst_trap_size = partition_compressed_length;
-      thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-      thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-      thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-
-    } // #pragma omp parallel
+    //workers take the dispatcher setup of this thread
+    RawCompressMTArgs args = { &thread_group_handle, cmpr_bound_pad, dispatch_key_snappy };
+    aocl_run_parallel_mt(RawCompressPartitions, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
     printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -2619,6 +2737,14 @@ void RawCompress(const char* input,
     *compressed_length = (size_t)(after_varint - dst_org);
     thread_group_handle.dst = after_varint;
 
+    aocl_partition_move_t* moves = (aocl_partition_move_t*)malloc(
+        thread_group_handle.num_threads * sizeof(aocl_partition_move_t));
+    if (moves == NULL) {
+      aocl_destroy_parallel_compress_mt(&thread_group_handle);
+      *compressed_length = 0;
+      return;
+    }
+
     thread_cnt = 0;
     // since at this point, 'compressed_length' stores the number of bytes
     // between the start of the buffer and the byte immediately after the
@@ -2628,32 +2754,39 @@ void RawCompress(const char* input,
     for (; thread_cnt < thread_group_handle.num_threads; ++thread_cnt) {
       thread_info_iter = &thread_group_handle.threads_info_list[thread_cnt];
 
-      // copy compressed data of the current thread to the destination buffer.
+      // plan the move of the compressed data of the current thread to the destination buffer.
       // (the dst_trap_size for each thread has already been modified to take
       // into account the varint at beginning and additional_state_info has the
       // location in the dst_trap buffer that is just past the varint's bytes)
-      memcpy(thread_group_handle.dst, (AOCL_CHAR*)thread_info_iter->additional_state_info, thread_info_iter->dst_trap_size);
+      moves[thread_cnt].src = (AOCL_CHAR*)thread_info_iter->additional_state_info;
+      moves[thread_cnt].dst = thread_group_handle.dst;
+      moves[thread_cnt].size = thread_info_iter->dst_trap_size;
 
-      // push the dst buffer pointer ahead by the number of bytes copied
+      // push the dst buffer pointer ahead by the number of bytes to be moved
       thread_group_handle.dst += thread_info_iter->dst_trap_size;
 
       // generate RAP data and write to corresponding location in destination buffer
-      *(AOCL_UINT32*)dst_ptr = thread_dst_offset;
-      dst_ptr += RAP_OFFSET_BYTES;
+      dst_ptr = aocl_write_rap_partition_mt(&thread_group_handle, dst_ptr, thread_dst_offset,
+                                            thread_info_iter->dst_trap_size,
+                                            thread_info_iter->partition_src_size);
       thread_dst_offset += thread_info_iter->dst_trap_size;
-      *(AOCL_INT32*)dst_ptr = thread_info_iter->dst_trap_size;
-      dst_ptr += RAP_LEN_BYTES;
-      *(AOCL_INT32*)dst_ptr = thread_info_iter->partition_src_size;
-      dst_ptr += DECOMP_LEN_BYTES;
 
       // update the compressed_length to include the current thread's compressed length
       *compressed_length += thread_info_iter->dst_trap_size;
     }
 
+    // move the compressed data of all threads into place. The partitions may
+    // overlap their final positions when they were compressed in-place.
+    if (aocl_compact_partitions_mt(moves, thread_group_handle.num_threads,
+                                   thread_group_handle.num_workers) != 0)
+      *compressed_length = 0;
+    free(moves);
+
     // free the memory allocated for the the thread_info_list and/or for each thread's dst_trap
     aocl_destroy_parallel_compress_mt(&thread_group_handle);
   }
 #else /* !(defined(AOCL_ENABLE_THREADS) && defined(AOCL_SNAPPY_OPT)) */ // Non-threaded
+  (void)mt_ctx;
   ByteArraySource reader(input, input_length);
   UncheckedByteArraySink writer(compressed);
   Compress(&reader, &writer);
@@ -3152,32 +3285,27 @@ static void aocl_register_snappy_fmv(int optOff, int optLevel) {
 
 char* aocl_setup_snappy(int optOff, int optLevel, size_t insize,
     size_t level, size_t windowLog) {
-    AOCL_ENTER_CRITICAL(setup_snappy)
-    if (!setup_ok_snappy) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_snappy_fmv(optOff, optLevel);
-        setup_ok_snappy = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_snappy)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_snappy == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_snappy_fmv(optOff, optLevel);
+    dispatch_key_snappy = dispatchKey;
     return NULL;
 }
 
 #ifdef AOCL_SNAPPY_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_snappy)
-    if (!setup_ok_snappy) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_snappy_fmv(optOff, optLevel);
-        setup_ok_snappy = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_snappy)
+    if (dispatch_key_snappy != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_snappy_fmv(optOff, optLevel);
+    dispatch_key_snappy = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 void aocl_destroy_snappy(void){
-    AOCL_ENTER_CRITICAL(setup_snappy)
-    setup_ok_snappy = 0;
-    AOCL_EXIT_CRITICAL(setup_snappy)
+    dispatch_key_snappy = AOCL_DISPATCH_UNSET;
 }
 }  // namespace snappy
@@ -257,6 +257,47 @@ namespace snappy {
                    char* compressed,
                    size_t* compressed_length);
 
+  /**
+   * @brief
+   *
+   * Same as RawCompress() above, reusing the multi-threaded compression context
+   * "mt_ctx" created by CreateMTContext(). The context keeps the per thread
+   * buffers and hash tables of AOCL's multi-threaded compressor between calls,
+   * so that repeated compressions do not allocate them again.
+   * A context must not be used by two calls at the same time.
+   *
+   *  |Parameters            |Direction|Description                                                          |
+   *  |:---------------------|:-------:|:--------------------------------------------------------------------|
+   *  | \b input             |  in     | This is the buffer where the data we want to compress is accessible.|
+   *  | \b input_length      |  in     | Length of the input buffer.                                         |
+   *  | \b compressed        |  out    | This is a buffer in which compressed data is stored.                |
+   *  | \b compressed_length |  out    | The length of the data after compression is stored in this.         |
+   *  | \b mt_ctx            |  in,out | Context created by CreateMTContext(), or NULL.                      |
+   *
+   * @return \b  void
+   */
+
+ SNAPPYLIB_API void RawCompress(const char* input,
+                   size_t input_length,
+                   char* compressed,
+                   size_t* compressed_length,
+                   void* mt_ctx);
+
+  /**
+   * @brief
+   * Creates a reusable context for RawCompress(). Free it with FreeMTContext().
+   *
+   * @return Pointer to the context. NULL on allocation failure or when the
+   * library is built without multi-threading support.
+   */
+ SNAPPYLIB_API void* CreateMTContext();
+
+  /**
+   * @brief
+   * Frees a context created by CreateMTContext(). NULL is accepted.
+   */
+ SNAPPYLIB_API void FreeMTContext(void* mt_ctx);
+
   /**
    * @brief 
    * Given data in "compressed[0..compressed_length-1]" generated by
@@ -301,6 +342,29 @@ namespace snappy {
 
  SNAPPYLIB_API bool RawUncompress(Source* compressed, char* uncompressed);
 
+  /**
+   * @brief 
+   * Decompresses one partition of a multi-threaded snappy stream, as listed in
+   * its random access point (RAP) frame. Partitions do not carry the varint
+   * length header, so their uncompressed length is passed in.
+   *
+   *  |Parameters              |Direction| Description                                             |
+   *  |:-----------------------|:-------:|:--------------------------------------------------------|
+   *  | \b compressed          |  in     | Start of the partition's compressed data.               |
+   *  | \b compressed_length   |  in     | Compressed size of the partition.                       |
+   *  | \b uncompressed        |  out    | Uncompressed data is stored in this buffer.             |
+   *  | \b uncompressed_length |  in     | Uncompressed size of the partition.                     |
+   * 
+   *  @return
+   *  |Result | Description                                                                      |
+   *  |:------|:---------------------------------------------------------------------------------|
+   *  |Success|Returns \b true if successful.                                                   |
+   *  |Failure|Returns \b false if the partition is corrupted, or without multi-threading support.|
+   */
+
+ SNAPPYLIB_API bool RawUncompressPartitionMT(const char* compressed, size_t compressed_length,
+                     char* uncompressed, size_t uncompressed_length);
+
   /**
    * @brief 
    * Given data in "compressed[0..compressed_length-1]" generated by
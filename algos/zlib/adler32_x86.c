@@ -41,7 +41,7 @@
 static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE() aocl_setup_native()
 
-static int setup_ok_zlib_adler = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_adler = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /* Largest prime smaller than 65536 */
 #define BASE 65521U
@@ -65,7 +65,7 @@ static int setup_ok_zlib_adler = 0; // flag to indicate status of dynamic dispat
 
 /* Function pointer holding the optimized variant as per the detected CPU
  * features */
-static uint32_t (*adler32_x86_fp)(uint32_t adler, const Bytef* buf, z_size_t len) =
+static AOCL_TLS uint32_t (*adler32_x86_fp)(uint32_t adler, const Bytef* buf, z_size_t len) =
 (uint32_t(*)(uint32_t, const Bytef*, z_size_t))adler32;
 
 #ifdef AOCL_ZLIB_AVX_OPT
@@ -382,30 +382,25 @@ static inline void aocl_setup_adler32_fmv(int optOff, int optLevel)
 }
 
 void ZLIB_INTERNAL aocl_setup_adler32(int optOff, int optLevel){
-    AOCL_ENTER_CRITICAL(setup_zlib_adler)
-    if (!setup_ok_zlib_adler) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_setup_adler32_fmv(optOff, optLevel);
-        setup_ok_zlib_adler = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_adler)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_adler == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_setup_adler32_fmv(optOff, optLevel);
+    dispatch_key_zlib_adler = dispatchKey;
 }
 
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_adler)
-    if (!setup_ok_zlib_adler) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_setup_adler32_fmv(optOff, optLevel);
-        setup_ok_zlib_adler = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_adler)
+    if (dispatch_key_zlib_adler != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_setup_adler32_fmv(optOff, optLevel);
+    dispatch_key_zlib_adler = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 
 void ZLIB_INTERNAL aocl_destroy_adler32(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_adler)
-    setup_ok_zlib_adler = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_adler)
+    dispatch_key_zlib_adler = AOCL_DISPATCH_UNSET;
 }
 
 #endif /* AOCL_ZLIB_OPT */
@@ -32,6 +32,7 @@
 
  /* Dynamically opting AOCL variant of send_bits */
 #ifdef AOCL_ZLIB_OPT
+#include "aocl_zlib_setup.h"
 #define OPT_send_bits(s, c, v) \
     { if (zlibOptOff == 1) { send_bits((s), (c), (v)); } else { AOCL_send_bits((s), (c), (v)); } }
 #else
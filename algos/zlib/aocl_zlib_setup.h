@@ -30,6 +30,11 @@
 
 #ifdef AOCL_ZLIB_OPT
 
+#include "utils/utils.h"
+
+extern AOCL_TLS int zlibOptOff; /* Flag to choose code paths based on dynamic dispatcher settings */
+extern AOCL_TLS int dispatch_key_zlib; /* Dispatcher key of this thread's setup */
+
 extern void aocl_register_slide_hash(int optOff, int optLevel);
 extern void aocl_destroy_slide_hash(void);
 
@@ -34,6 +34,11 @@
 ZEXTERN void slide_hash_x86(deflate_state *s);
 ZEXTERN uInt longest_match_x86 (deflate_state *s, IPos cur_match);
 
+/* Variant of longest_match_x86() registered on the calling thread. Match
+ * loops load it once instead of reading the thread local pointer per match. */
+typedef uInt (*longest_match_func)(deflate_state *s, IPos cur_match);
+ZEXTERN longest_match_func aocl_get_longest_match_x86(void);
+
 /* Equivalent functions for adler32_x86
  * that do not call AOCL_SETUP_NATIVE(). When these functions are called
  * from other APIs, dynamic dispatcher setup is already done, and overhead
@@ -6,15 +6,14 @@
 
 /* @(#) $Id$ */
 
-#define ZLIB_INTERNAL
-#include "zlib.h"
+#include "zutil.h" /* defines ZLIB_INTERNAL, DEF_MEM_LEVEL and OS_CODE */
 #include "utils/utils.h"
 
 #ifdef AOCL_ZLIB_OPT
 #include "aocl_zlib_setup.h"
 
-int zlibOptOff = 0; // default, run reference code
-static int setup_ok_zlib = 0; // flag to indicate status of dynamic dispatcher setup
+AOCL_TLS int zlibOptOff = 0; // default, run reference code
+AOCL_TLS int dispatch_key_zlib = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /* Dynamic dispatcher setup function for native APIs.
  * All native APIs that call aocl optimized functions within their call stack,
@@ -33,41 +32,36 @@ ZEXTERN char * ZEXPORT aocl_setup_zlib(int optOff, int optLevel, int insize,
     int level, int windowLog)
 {
 #ifdef AOCL_ZLIB_OPT
-    AOCL_ENTER_CRITICAL(setup_zlib)
-    if (!setup_ok_zlib) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        zlibOptOff = optOff;
-        aocl_setup_deflate(optOff, optLevel);
-        aocl_setup_inflate(optOff, optLevel);
-        aocl_setup_adler32(optOff, optLevel);
-        setup_ok_zlib = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    zlibOptOff = optOff;
+    aocl_setup_deflate(optOff, optLevel);
+    aocl_setup_inflate(optOff, optLevel);
+    aocl_setup_adler32(optOff, optLevel);
+    dispatch_key_zlib = dispatchKey;
 #endif /* AOCL_ZLIB_OPT */
     return NULL;
 }
 
 #ifdef AOCL_ZLIB_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib)
-    if (!setup_ok_zlib) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        zlibOptOff = optOff;
-        aocl_setup_deflate(optOff, optLevel);
-        aocl_setup_inflate(optOff, optLevel);
-        aocl_setup_adler32(optOff, optLevel);
-        setup_ok_zlib = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib)
+    if (dispatch_key_zlib != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    zlibOptOff = optOff;
+    aocl_setup_deflate(optOff, optLevel);
+    aocl_setup_inflate(optOff, optLevel);
+    aocl_setup_adler32(optOff, optLevel);
+    dispatch_key_zlib = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 ZEXTERN void ZEXPORT aocl_destroy_zlib (void) {
 #ifdef AOCL_ZLIB_OPT
-    AOCL_ENTER_CRITICAL(setup_zlib)
-    setup_ok_zlib = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib)
+    dispatch_key_zlib = AOCL_DISPATCH_UNSET;
     aocl_destroy_adler32();
     aocl_destroy_deflate();
     aocl_destroy_inflate();
@@ -77,6 +71,7 @@ ZEXTERN void ZEXPORT aocl_destroy_zlib (void) {
 #ifdef AOCL_ENABLE_THREADS
 #define ZLIB_MT_WINDOW_LEN 32768
 #include <string.h>
+#include "api/aocl_threads.h"
 #include "threads/threads.h"
 #endif
 /* ===========================================================================
@@ -148,6 +143,57 @@ uLong ZEXPORT compressBound_ST(uLong sourceLen) {
     return sourceLen + (sourceLen >> 12) + (sourceLen >> 14) +
            (sourceLen >> 25) + 13;
 }
+//Arguments shared by the workers of the multi-threaded compress2()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    int level;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} compress2_mt_args_t;
+
+//Worker of the multi-threaded compress2(): compresses partitions until none is left
+local void compress2_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    compress2_mt_args_t* args = (compress2_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+#ifdef AOCL_ZLIB_OPT
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_zlib);
+#endif
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 cmpr_bound_pad;
+        AOCL_UINT32 is_error = Z_OK;
+        if (thread_id != (thread_grp->num_threads - 1))
+            cmpr_bound_pad = compressBound_ST(thread_grp->common_part_src_size);
+        else
+            cmpr_bound_pad = compressBound_ST(thread_grp->common_part_src_size + 
+                                    thread_grp->leftover_part_src_bytes);
+        if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
+        {
+            if (thread_id != (thread_grp->num_threads - 1))
+                is_error = compress2_ST(&cur_thread_info, args->level, Z_SYNC_FLUSH);
+            else
+                is_error = compress2_ST(&cur_thread_info, args->level, Z_FINISH);
+        } //aocl_do_partition_compress_mt
+#ifdef AOCL_THREADS_LOG
+        printf("Compress Thread [id: %d] : Return value %d\n", worker_id, is_error);
+#endif
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = cur_thread_info.last_bytes_len;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
 #endif /* AOCL_ENABLE_THREADS */
 
 int ZEXPORT compress2(Bytef *dest, uLongf *destLen, const Bytef *source,
@@ -231,38 +277,11 @@ int ZEXPORT compress2(Bytef *dest, uLongf *destLen, const Bytef *source,
         printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
 
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
-#ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            AOCL_UINT32 cmpr_bound_pad;
-            AOCL_UINT32 is_error = Z_OK;
-            if (thread_id != (thread_group_handle.num_threads - 1))
-                cmpr_bound_pad = compressBound_ST(thread_group_handle.common_part_src_size);
-            else
-                cmpr_bound_pad = compressBound_ST(thread_group_handle.common_part_src_size + 
-                                        thread_group_handle.leftover_part_src_bytes);
-            if (aocl_do_partition_compress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
-            {
-                if (thread_id != (thread_group_handle.num_threads - 1))
-                    is_error = compress2_ST(&cur_thread_info, level, Z_SYNC_FLUSH);
-                else
-                    is_error = compress2_ST(&cur_thread_info, level, Z_FINISH);
-            } //aocl_do_partition_compress_mt
-#ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Return value %d\n", omp_get_thread_num(), is_error);
+        compress2_mt_args_t args = { &thread_group_handle, level, 0 };
+#ifdef AOCL_ZLIB_OPT
+        args.dispatch_key = dispatch_key_zlib; //workers take the dispatcher setup of this thread
 #endif
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = NULL;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = cur_thread_info.last_bytes_len;
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-        } //#pragma omp parallel
+        aocl_run_parallel_mt(compress2_partitions_mt, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
         printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -296,15 +315,10 @@ int ZEXPORT compress2(Bytef *dest, uLongf *destLen, const Bytef *source,
             //Copy this thread's chunk to the output final buffer
             memcpy(thread_group_handle.dst, cur_thread_info.dst_trap + offset, cur_thread_info.dst_trap_size - offset);
 
-            *(AOCL_UINT32*)dst_ptr = *destLen; //For storing this thread's RAP offset
-            dst_ptr += RAP_OFFSET_BYTES;
-            *(AOCL_INT32*)dst_ptr = cur_thread_info.dst_trap_size - offset; //For storing this thread's RAP length
-            dst_ptr += RAP_LEN_BYTES;
-            //For storing this thread's decompressed (src) length
+            //For storing this thread's RAP offset, RAP length and decompressed (src) length
             decomp_len = cur_thread_info.partition_src_size;
-
-            *(AOCL_INT32*)dst_ptr = decomp_len;
-            dst_ptr += DECOMP_LEN_BYTES;
+            dst_ptr = aocl_write_rap_partition_mt(&thread_group_handle, dst_ptr, *destLen,
+                                                  cur_thread_info.dst_trap_size - offset, decomp_len);
             thread_group_handle.dst += (cur_thread_info.dst_trap_size - offset);
             *destLen += (cur_thread_info.dst_trap_size - offset);
             offset = 2; // skip 2 bytes zlib header
@@ -336,10 +350,348 @@ int ZEXPORT compress(Bytef *dest, uLongf *destLen, const Bytef *source,
  */
 uLong ZEXPORT compressBound(uLong sourceLen) {
 #ifdef AOCL_ENABLE_THREADS
+    /* RAP frame bound covers all the partitions. Its 64-bit fields also leave room
+       for the sync flush marker that ends each partition. */
     return sourceLen + (sourceLen >> 12) + (sourceLen >> 14) +
-           (sourceLen >> 25) + 13 + RAP_FRAME_LEN_WITH_DECOMP_LENGTH(omp_get_max_threads(), 0);
+           (sourceLen >> 25) + 13 + aocl_get_rap_frame_bound_mt();
 #else
     return sourceLen + (sourceLen >> 12) + (sourceLen >> 14) +
            (sourceLen >> 25) + 13;
 #endif
 }
+
+/* ===========================================================================
+     Parallel compression into a single standard zlib or gzip stream.
+
+     The source is split into partitions that are deflated as raw deflate
+   streams by separate threads. Each partition is primed with the preceding
+   32 KB of the source via deflateSetDictionary(), so matches can still reach
+   back across partition boundaries. All partitions except the last end with a
+   Z_SYNC_FLUSH, which byte aligns them and lets them be concatenated. The
+   check values of the partitions are merged with adler32_combine() or
+   crc32_combine(). The result carries no RAP frame and is decodable by any
+   inflater, but it is decompressed by a single thread.
+*/
+#define ZLIB_HEADER_LEN 2
+#define ZLIB_TRAILER_LEN 4
+#define GZIP_HEADER_LEN 10
+#define GZIP_TRAILER_LEN 8
+#define RAW_DEFLATE_BOUND_PAD 7 /* Overhead of a raw deflate stream in the deflateBound() estimate */
+#define SYNC_FLUSH_MARKER_LEN 5 /* Empty stored block emitted by Z_SYNC_FLUSH */
+
+/* Single threaded compression into a zlib or gzip stream */
+local int compress_stream_ST(Bytef *dest, uLongf *destLen, const Bytef *source,
+                             uLong sourceLen, int level, int windowBits) {
+    z_stream stream;
+    int err;
+    const uInt max = (uInt)-1;
+    uLong left;
+
+    left = *destLen;
+    *destLen = 0;
+
+    stream.zalloc = (alloc_func)0;
+    stream.zfree = (free_func)0;
+    stream.opaque = (voidpf)0;
+
+    err = deflateInit2(&stream, level, Z_DEFLATED, windowBits, DEF_MEM_LEVEL,
+                       Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) return err;
+
+    stream.next_out = dest;
+    stream.avail_out = 0;
+    stream.next_in = (z_const Bytef *)source;
+    stream.avail_in = 0;
+
+    do {
+        if (stream.avail_out == 0) {
+            stream.avail_out = left > (uLong)max ? max : (uInt)left;
+            left -= stream.avail_out;
+        }
+        if (stream.avail_in == 0) {
+            stream.avail_in = sourceLen > (uLong)max ? max : (uInt)sourceLen;
+            sourceLen -= stream.avail_in;
+        }
+        err = deflate(&stream, sourceLen ? Z_NO_FLUSH : Z_FINISH);
+    } while (err == Z_OK);
+
+    *destLen = stream.total_out;
+    deflateEnd(&stream);
+    return err == Z_STREAM_END ? Z_OK : err;
+}
+
+#ifdef AOCL_ENABLE_THREADS
+/* Writes the zlib or gzip header for a stream deflated at the given level.
+   Returns the number of bytes written. */
+local uLong write_stream_header(Bytef *dest, int level, int gzip) {
+    if (gzip) {
+        dest[0] = 0x1f;
+        dest[1] = 0x8b;
+        dest[2] = Z_DEFLATED;
+        dest[3] = 0; /* no file name, comment or extra fields */
+        dest[4] = dest[5] = dest[6] = dest[7] = 0; /* no modification time */
+        dest[8] = level == 9 ? 2 : (level < 2 ? 4 : 0);
+        dest[9] = OS_CODE;
+        return GZIP_HEADER_LEN;
+    }
+    else {
+        uInt level_flags = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+        uInt header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+        header |= (level_flags << 6);
+        header += 31 - (header % 31);
+        dest[0] = (Bytef)(header >> 8);
+        dest[1] = (Bytef)(header & 0xff);
+        return ZLIB_HEADER_LEN;
+    }
+}
+
+/* Writes the zlib or gzip trailer for the check value of the whole source.
+   Returns the number of bytes written. */
+local uLong write_stream_trailer(Bytef *dest, uLong check, uLong sourceLen,
+                                 int gzip) {
+    if (gzip) {
+        dest[0] = (Bytef)(check & 0xff);
+        dest[1] = (Bytef)((check >> 8) & 0xff);
+        dest[2] = (Bytef)((check >> 16) & 0xff);
+        dest[3] = (Bytef)((check >> 24) & 0xff);
+        dest[4] = (Bytef)(sourceLen & 0xff);
+        dest[5] = (Bytef)((sourceLen >> 8) & 0xff);
+        dest[6] = (Bytef)((sourceLen >> 16) & 0xff);
+        dest[7] = (Bytef)((sourceLen >> 24) & 0xff);
+        return GZIP_TRAILER_LEN;
+    }
+    else {
+        dest[0] = (Bytef)((check >> 24) & 0xff);
+        dest[1] = (Bytef)((check >> 16) & 0xff);
+        dest[2] = (Bytef)((check >> 8) & 0xff);
+        dest[3] = (Bytef)(check & 0xff);
+        return ZLIB_TRAILER_LEN;
+    }
+}
+
+/* Deflates one partition as a raw deflate stream primed with dictLen bytes of
+   the source preceding it. Partitions other than the last end with
+   Z_SYNC_FLUSH. The check value of the partition is saved in last_bytes_len. */
+local int deflate_partition_mt(aocl_thread_info_t *cThread, const Bytef *dict,
+                               uInt dictLen, int level, int flush, int gzip) {
+    Bytef *dest = (Bytef*)cThread->dst_trap;
+    Bytef *source = (Bytef*)cThread->partition_src;
+    uLong sourceLen = cThread->partition_src_size;
+    uLong left = cThread->dst_trap_size;
+    z_stream stream;
+    int err;
+    const uInt max = (uInt)-1;
+
+    cThread->dst_trap_size = 0;
+    cThread->last_bytes_len = gzip ?
+        crc32_z(0L, source, (z_size_t)sourceLen) :
+        adler32_z(1L, source, (z_size_t)sourceLen);
+
+    stream.zalloc = (alloc_func)0;
+    stream.zfree = (free_func)0;
+    stream.opaque = (voidpf)0;
+
+    err = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, DEF_MEM_LEVEL,
+                       Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) return err;
+    if (dictLen) {
+        err = deflateSetDictionary(&stream, dict, dictLen);
+        if (err != Z_OK) {
+            deflateEnd(&stream);
+            return err;
+        }
+    }
+
+    stream.next_out = dest;
+    stream.avail_out = 0;
+    stream.next_in = (z_const Bytef *)source;
+    stream.avail_in = 0;
+
+    do {
+        if (stream.avail_out == 0) {
+            stream.avail_out = left > (uLong)max ? max : (uInt)left;
+            left -= stream.avail_out;
+        }
+        if (stream.avail_in == 0) {
+            stream.avail_in = sourceLen > (uLong)max ? max : (uInt)sourceLen;
+            sourceLen -= stream.avail_in;
+        }
+        err = deflate(&stream, sourceLen ? Z_NO_FLUSH : flush);
+        /* A sync flush is complete once all input is consumed and deflate
+           returns with output space left */
+    } while (err == Z_OK && (flush == Z_FINISH || sourceLen ||
+             stream.avail_in || stream.avail_out == 0));
+
+    cThread->dst_trap_size = stream.total_out;
+    deflateEnd(&stream);
+    if (flush == Z_FINISH)
+        return err == Z_STREAM_END ? Z_OK : (err == Z_OK ? Z_BUF_ERROR : err);
+    return err;
+}
+//Arguments shared by the workers of aocl_parallel_compress_zlib()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    int level;
+    int gzip;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} parallel_compress_mt_args_t;
+
+//Worker of aocl_parallel_compress_zlib(): deflates partitions until none is left
+local void parallel_compress_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    parallel_compress_mt_args_t* args = (parallel_compress_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_ZLIB_OPT
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_zlib);
+#endif
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_INTP part_src_size = thread_grp->common_part_src_size +
+                                    thread_grp->leftover_part_src_bytes;
+        AOCL_UINT32 cmpr_bound_pad = (part_src_size >> 12) + (part_src_size >> 14) +
+                                     (part_src_size >> 25) + RAW_DEFLATE_BOUND_PAD +
+                                     SYNC_FLUSH_MARKER_LEN;
+        AOCL_INT32 is_error = Z_MEM_ERROR;
+        if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
+        {
+            //Prime with the window preceding this partition in the source
+            AOCL_INTP dict_len = cur_thread_info.partition_src - thread_grp->src;
+            if (dict_len > ZLIB_MT_WINDOW_LEN)
+                dict_len = ZLIB_MT_WINDOW_LEN;
+            is_error = deflate_partition_mt(&cur_thread_info,
+                (const Bytef *)cur_thread_info.partition_src - dict_len, (uInt)dict_len, args->level,
+                (thread_id != (thread_grp->num_threads - 1)) ? Z_SYNC_FLUSH : Z_FINISH, args->gzip);
+        } //aocl_do_partition_compress_mt
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = cur_thread_info.last_bytes_len;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
+#endif /* AOCL_ENABLE_THREADS */
+
+uLong ZEXPORT aocl_parallel_compressBound_zlib(uLong sourceLen) {
+    uLong num_partitions = 1;
+#ifdef AOCL_ENABLE_THREADS
+    num_partitions = (uLong)aocl_get_available_threads_mt() * PARTITIONS_PER_THREAD;
+#endif
+    return sourceLen + (sourceLen >> 12) + (sourceLen >> 14) +
+           (sourceLen >> 25) + GZIP_HEADER_LEN + GZIP_TRAILER_LEN +
+           num_partitions * (RAW_DEFLATE_BOUND_PAD + SYNC_FLUSH_MARKER_LEN);
+}
+
+int ZEXPORT aocl_parallel_compress_zlib(Bytef *dest, uLongf *destLen,
+                                        const Bytef *source, uLong sourceLen,
+                                        int level, int windowBits) {
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+    AOCL_SETUP_NATIVE();
+    if (destLen == NULL)
+    {
+        LOG_UNFORMATTED(INFO, logCtx, "Exit");
+        return Z_BUF_ERROR;
+    }
+    if (dest == NULL || (source == NULL && sourceLen))
+    {
+        LOG_UNFORMATTED(INFO, logCtx, "Exit");
+        return Z_STREAM_ERROR;
+    }
+#ifndef AOCL_ENABLE_THREADS //Non threaded
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return compress_stream_ST(dest, destLen, source, sourceLen, level, windowBits);
+#else //Threaded
+    int result = Z_OK;
+    int gzip = (windowBits == MAX_WBITS + 16);
+    aocl_thread_group_t thread_group_handle;
+    aocl_thread_info_t cur_thread_info;
+    AOCL_INT32 rap_metadata_len;
+    AOCL_UINT32 thread_cnt;
+
+    if (level == Z_DEFAULT_COMPRESSION)
+        level = 6;
+    /* Partitions are primed with a full 32 KB window. Other window sizes,
+       invalid levels and destinations too small for the thread group setup
+       are handled by the single threaded compressor. */
+    if ((windowBits != MAX_WBITS && !gzip) || level < 0 || level > 9 ||
+        *destLen < RAP_START_OF_PARTITIONS)
+    {
+        LOG_UNFORMATTED(INFO, logCtx, "Exit");
+        return compress_stream_ST(dest, destLen, source, sourceLen, level, windowBits);
+    }
+
+    /* The RAP frame header written by the setup is overwritten by the stream */
+    rap_metadata_len = aocl_setup_parallel_compress_mt(&thread_group_handle, (char *)source,
+                                                 (char *)dest, sourceLen, *destLen,
+                                                 ZLIB_MT_WINDOW_LEN, WINDOW_FACTOR);
+    if (rap_metadata_len < 0)
+    {
+        LOG_UNFORMATTED(INFO, logCtx, "Exit");
+        return Z_MEM_ERROR;
+    }
+
+    if (thread_group_handle.num_threads == 1)
+    {
+        LOG_UNFORMATTED(INFO, logCtx, "Exit");
+        return compress_stream_ST(dest, destLen, source, sourceLen, level, windowBits);
+    }
+
+    parallel_compress_mt_args_t args = { &thread_group_handle, level, gzip, 0 };
+#ifdef AOCL_ZLIB_OPT
+    args.dispatch_key = dispatch_key_zlib; //workers take the dispatcher setup of this thread
+#endif
+    aocl_run_parallel_mt(parallel_compress_partitions_mt, &args, thread_group_handle.num_workers);
+
+    //Post processing in single-threaded mode: Stitches the partitions between the stream header and trailer
+    {
+        uLong check = gzip ? crc32(0L, Z_NULL, 0) : adler32(0L, Z_NULL, 0);
+        uLong out_len = 0;
+        uLong total_len = (gzip ? GZIP_HEADER_LEN + GZIP_TRAILER_LEN : ZLIB_HEADER_LEN + ZLIB_TRAILER_LEN);
+
+        for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+        {
+            cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+            //In case of any thread partitioning or alloc errors, exit the compression process with error
+            if (cur_thread_info.is_error != Z_OK)
+            {
+                result = (AOCL_INT32)cur_thread_info.is_error;
+                aocl_destroy_parallel_compress_mt(&thread_group_handle);
+                *destLen = 0;
+                LOG_UNFORMATTED(INFO, logCtx, "Exit");
+                return result;
+            }
+            total_len += cur_thread_info.dst_trap_size;
+        }
+        if (total_len > *destLen)
+        {
+            aocl_destroy_parallel_compress_mt(&thread_group_handle);
+            *destLen = 0;
+            LOG_UNFORMATTED(INFO, logCtx, "Exit");
+            return Z_BUF_ERROR;
+        }
+
+        out_len = write_stream_header(dest, level, gzip);
+        for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+        {
+            cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+            memcpy(dest + out_len, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
+            out_len += cur_thread_info.dst_trap_size;
+            check = gzip ?
+                crc32_combine(check, cur_thread_info.last_bytes_len, (z_off_t)cur_thread_info.partition_src_size) :
+                adler32_combine(check, cur_thread_info.last_bytes_len, (z_off_t)cur_thread_info.partition_src_size);
+        }
+        out_len += write_stream_trailer(dest + out_len, check, sourceLen, gzip);
+        *destLen = out_len;
+    }
+
+    aocl_destroy_parallel_compress_mt(&thread_group_handle);
+    LOG_UNFORMATTED(INFO, logCtx, "Exit");
+    return result;
+#endif /* !AOCL_ENABLE_THREADS */
+}
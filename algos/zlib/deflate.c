@@ -56,7 +56,7 @@
 
 #ifdef AOCL_ZLIB_OPT
 #undef FASTEST // not supported with AOCL zlib optimizations
-static int setup_ok_zlib_deflate = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_deflate = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 /* Dynamic dispatcher setup function for native APIs.
  * All native APIs that call aocl optimized functions within their call stack,
  * must call AOCL_SETUP_NATIVE() at the start of the function. This sets up 
@@ -112,7 +112,7 @@ local block_state aocl_deflate_fast_v1(deflate_state *s, int flush);
 local block_state aocl_deflate_slow_v1(deflate_state *s, int flush);
 extern block_state deflate_medium(deflate_state *s, int flush);
 #ifdef AOCL_ZLIB_DEFLATE_FAST_MODE
-block_state (*aocl_deflate_lvl1_fp)(deflate_state *s, int flush) = deflate_fast;
+AOCL_TLS block_state (*aocl_deflate_lvl1_fp)(deflate_state *s, int flush) = deflate_fast;
 extern block_state deflate_quick(deflate_state *s, int flush);
 #endif /* AOCL_ZLIB_DEFLATE_FAST_MODE */
 #endif /* AOCL_ZLIB_OPT */
@@ -167,7 +167,7 @@ local const config configuration_table[10] = {
 #endif /* FASTEST */
 
 #ifdef AOCL_ZLIB_OPT
-local const config *config_table = configuration_table;
+local AOCL_TLS const config *config_table = configuration_table;
 local const config configuration_table_opt[10] = {
 /*      good lazy nice chain */
 /* 0 */ {0,    0,  0,    0, deflate_stored},  /* store only */
@@ -310,10 +310,10 @@ local void fill_window(deflate_state* s);
 #ifdef AOCL_ZLIB_OPT
 /* Function pointers holding the optimized variant as per the detected CPU
  * features */
-static  int (*aocl_deflateSetDictionary_fp) (z_streamp strm, const Bytef *dictionary, uInt  dictLength) = deflateSetDictionary;
-static  void (*aocl_fill_window_fp) (deflate_state *s) = fill_window;
-static  block_state (*aocl_deflate_fast_fp)(deflate_state *s, int flush) = deflate_fast;
-static  block_state (*aocl_deflate_slow_fp)(deflate_state *s, int flush) = deflate_slow;
+static AOCL_TLS int (*aocl_deflateSetDictionary_fp) (z_streamp strm, const Bytef *dictionary, uInt  dictLength) = deflateSetDictionary;
+static AOCL_TLS void (*aocl_fill_window_fp) (deflate_state *s) = fill_window;
+static AOCL_TLS block_state (*aocl_deflate_fast_fp)(deflate_state *s, int flush) = deflate_fast;
+static AOCL_TLS block_state (*aocl_deflate_slow_fp)(deflate_state *s, int flush) = deflate_slow;
 #endif /* AOCL_ZLIB_OPT */
 
 /* ===========================================================================
@@ -451,7 +451,7 @@ local void fill_window(deflate_state *s) {
 
 #ifdef AOCL_ZLIB_OPT
 /* Function pointers holding the optimized variant as per dynamic dispatcher settings */
-static void (*deflate_slide_hash_fp)(deflate_state* s) = slide_hash;
+static AOCL_TLS void (*deflate_slide_hash_fp)(deflate_state* s) = slide_hash;
 
 local void aocl_fill_window_v1(deflate_state *s)
 {
@@ -2414,13 +2414,14 @@ local block_state deflate_fast(deflate_state *s, int flush) {
 
 #ifdef AOCL_ZLIB_OPT
 /* Function pointers holding the optimized variant as per the detected CPU
- * features */
-static uInt(*deflate_longest_match_fp)(deflate_state* s, IPos cur_match) = longest_match;
+ * features. The match loops below load it once per call. */
+static AOCL_TLS longest_match_func deflate_longest_match_fp = longest_match;
 
 local block_state aocl_deflate_fast_v1(deflate_state *s, int flush)
 {
     IPos hash_head;       /* head of the hash chain */
     int bflush;           /* set if current block must be flushed */
+    longest_match_func longest_match_fn = deflate_longest_match_fp;
 
     for (;;) {
         /* Make sure that we always have enough lookahead, except
@@ -2452,7 +2453,7 @@ local block_state aocl_deflate_fast_v1(deflate_state *s, int flush)
              * of window index 0 (in particular we have to avoid a match
              * of the string with itself at the start of the input file).
              */
-            s->match_length = deflate_longest_match_fp(s, hash_head);
+            s->match_length = longest_match_fn(s, hash_head);
             /* longest_match() sets match_start */
         }
         if (s->match_length >= MIN_MATCH) {
@@ -2515,6 +2516,7 @@ local block_state aocl_deflate_fast_v2(deflate_state *s, int flush)
 {
     IPos hash_head;       /* head of the hash chain */
     int bflush;           /* set if current block must be flushed */
+    longest_match_func longest_match_fn = deflate_longest_match_fp;
 
     for (;;) {
         /* Make sure that we always have enough lookahead, except
@@ -2546,7 +2548,7 @@ local block_state aocl_deflate_fast_v2(deflate_state *s, int flush)
              * of window index 0 (in particular we have to avoid a match
              * of the string with itself at the start of the input file).
              */
-            s->match_length = deflate_longest_match_fp(s, hash_head);
+            s->match_length = longest_match_fn(s, hash_head);
             /* longest_match() sets match_start */
         }
         if (s->match_length >= MIN_MATCH) {
@@ -2737,6 +2739,7 @@ local block_state aocl_deflate_slow_v1(deflate_state *s, int flush)
 {
     IPos hash_head;          /* head of hash chain */
     int bflush;              /* set if current block must be flushed */
+    longest_match_func longest_match_fn = deflate_longest_match_fp;
 
     /* Process the input block. */
     for (;;) {
@@ -2772,7 +2775,7 @@ local block_state aocl_deflate_slow_v1(deflate_state *s, int flush)
              * of window index 0 (in particular we have to avoid a match
              * of the string with itself at the start of the input file).
              */
-            s->match_length = deflate_longest_match_fp(s, hash_head);
+            s->match_length = longest_match_fn(s, hash_head);
             /* longest_match() sets match_start */
 
             if (s->match_length <= 5 && (s->strategy == Z_FILTERED
@@ -2862,6 +2865,7 @@ local block_state aocl_deflate_slow_v2(deflate_state *s, int flush)
 {
     IPos hash_head;          /* head of hash chain */
     int bflush;              /* set if current block must be flushed */
+    longest_match_func longest_match_fn = deflate_longest_match_fp;
 
     /* Process the input block. */
     for (;;) {
@@ -2897,7 +2901,7 @@ local block_state aocl_deflate_slow_v2(deflate_state *s, int flush)
              * of window index 0 (in particular we have to avoid a match
              * of the string with itself at the start of the input file).
              */
-            s->match_length = deflate_longest_match_fp(s, hash_head);
+            s->match_length = longest_match_fn(s, hash_head);
             /* longest_match() sets match_start */
 
             if (s->match_length <= 5 && (s->strategy == Z_FILTERED
@@ -3130,7 +3134,7 @@ static void aocl_setup_deflate_fmv(int optOff, int optLevel)
             case 1://SSE version
                 config_table = configuration_table_opt;
                 deflate_slide_hash_fp = slide_hash_x86;
-                deflate_longest_match_fp = longest_match_x86;
+                deflate_longest_match_fp = aocl_get_longest_match_x86();
                 aocl_deflateSetDictionary_fp = aocl_deflateSetDictionary_v1;
                 aocl_fill_window_fp = aocl_fill_window_v1;
                 aocl_deflate_fast_fp = aocl_deflate_fast_v1;
@@ -3146,7 +3150,7 @@ static void aocl_setup_deflate_fmv(int optOff, int optLevel)
 #ifdef AOCL_ZLIB_AVX_OPT
                 config_table = configuration_table_opt;
                 deflate_slide_hash_fp = slide_hash_x86;
-                deflate_longest_match_fp = longest_match_x86;
+                deflate_longest_match_fp = aocl_get_longest_match_x86();
                 aocl_deflateSetDictionary_fp = aocl_deflateSetDictionary_v2;
                 aocl_fill_window_fp = aocl_fill_window_v2;
                 aocl_deflate_fast_fp = aocl_deflate_fast_v2;
@@ -3157,7 +3161,7 @@ static void aocl_setup_deflate_fmv(int optOff, int optLevel)
 #else
                 config_table = configuration_table_opt;
                 deflate_slide_hash_fp = slide_hash_x86;
-                deflate_longest_match_fp = longest_match_x86;
+                deflate_longest_match_fp = aocl_get_longest_match_x86();
                 aocl_deflateSetDictionary_fp = aocl_deflateSetDictionary_v1;
                 aocl_fill_window_fp = aocl_fill_window_v1;
                 aocl_deflate_fast_fp = aocl_deflate_fast_v1;
@@ -3173,34 +3177,29 @@ static void aocl_setup_deflate_fmv(int optOff, int optLevel)
 
 void ZLIB_INTERNAL aocl_setup_deflate(int optOff, int optLevel)
 {
-    AOCL_ENTER_CRITICAL(setup_zlib_deflate)
-    if (!setup_ok_zlib_deflate) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_setup_tree(optOff, optLevel);
-        aocl_setup_deflate_fmv(optOff, optLevel);
-        setup_ok_zlib_deflate = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_deflate)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_deflate == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_setup_tree(optOff, optLevel);
+    aocl_setup_deflate_fmv(optOff, optLevel);
+    dispatch_key_zlib_deflate = dispatchKey;
 }
 
 void ZLIB_INTERNAL aocl_destroy_deflate(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_deflate)
-    setup_ok_zlib_deflate = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_deflate)
+    dispatch_key_zlib_deflate = AOCL_DISPATCH_UNSET;
     aocl_destroy_tree();
     aocl_destroy_longest_match();
     aocl_destroy_slide_hash();
 }
 
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_deflate)
-    if (!setup_ok_zlib_deflate) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_setup_tree(optOff, optLevel);
-        aocl_setup_deflate_fmv(optOff, optLevel);
-        setup_ok_zlib_deflate = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_deflate)
+    if (dispatch_key_zlib_deflate != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_setup_tree(optOff, optLevel);
+    aocl_setup_deflate_fmv(optOff, optLevel);
+    dispatch_key_zlib_deflate = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif /* AOCL_ZLIB_OPT */
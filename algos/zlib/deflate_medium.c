@@ -11,7 +11,7 @@
 
 #ifdef AOCL_ZLIB_OPT
  /* Flag to choose code paths based on dynamic dispatcher settings */
-static int zlibOptLevel = 0; // default, use reference code paths
+static AOCL_TLS int zlibOptLevel = 0; // default, use reference code paths
 
 struct match {
     uInt    match_start;
@@ -242,6 +242,7 @@ static void fizzle_matches(deflate_state *s, struct match *current, struct match
 local block_state aocl_deflate_medium_v1(deflate_state *s, int flush)
 {
     struct match current_match, next_match;
+    longest_match_func longest_match_fn = aocl_get_longest_match_x86();
     
     memset(&current_match, 0, sizeof(struct match));
     memset(&next_match, 0, sizeof(struct match));
@@ -298,7 +299,7 @@ local block_state aocl_deflate_medium_v1(deflate_state *s, int flush)
                  * of window index 0 (in particular we have to avoid a match
                  * of the string with itself at the start of the input file).
                  */
-                current_match.match_length = longest_match_x86(s, hash_head);
+                current_match.match_length = longest_match_fn(s, hash_head);
                 current_match.match_start = s->match_start;
                 if (current_match.match_length < MIN_MATCH)
                     current_match.match_length = 1;
@@ -333,7 +334,7 @@ local block_state aocl_deflate_medium_v1(deflate_state *s, int flush)
                  * of window index 0 (in particular we have to avoid a match
                  * of the string with itself at the start of the input file).
                  */
-                next_match.match_length = longest_match_x86(s, hash_head);
+                next_match.match_length = longest_match_fn(s, hash_head);
                 next_match.match_start = s->match_start;
                 if (next_match.match_start >= next_match.strstart)
                     /* this can happen due to some restarts */
@@ -378,6 +379,7 @@ __attribute__((__target__("avx"))) // uses AVX intrinsics
 local block_state aocl_deflate_medium_v2(deflate_state *s, int flush)
 {
     struct match current_match, next_match;
+    longest_match_func longest_match_fn = aocl_get_longest_match_x86();
     
     memset(&current_match, 0, sizeof(struct match));
     memset(&next_match, 0, sizeof(struct match));
@@ -434,7 +436,7 @@ local block_state aocl_deflate_medium_v2(deflate_state *s, int flush)
                  * of window index 0 (in particular we have to avoid a match
                  * of the string with itself at the start of the input file).
                  */
-                current_match.match_length = longest_match_x86(s, hash_head);
+                current_match.match_length = longest_match_fn(s, hash_head);
                 current_match.match_start = s->match_start;
                 if (current_match.match_length < MIN_MATCH)
                     current_match.match_length = 1;
@@ -469,7 +471,7 @@ local block_state aocl_deflate_medium_v2(deflate_state *s, int flush)
                  * of window index 0 (in particular we have to avoid a match
                  * of the string with itself at the start of the input file).
                  */
-                next_match.match_length = longest_match_x86(s, hash_head);
+                next_match.match_length = longest_match_fn(s, hash_head);
                 next_match.match_start = s->match_start;
                 if (next_match.match_start >= next_match.strstart)
                     /* this can happen due to some restarts */
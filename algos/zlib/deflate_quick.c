@@ -7,6 +7,7 @@
  * For conditions of distribution and use, see copyright notice in zlib.h
  */
 
+#include "utils/utils.h"
 #include "aocl_zlib_x86.h"
 
 #ifdef AOCL_ZLIB_DEFLATE_FAST_MODE
@@ -78,7 +79,7 @@ local void static_emit_tree(deflate_state *z_const s,
     OPT_send_bits(s, (STATIC_TREES<<1) + last, 3);
 }
 
-extern void (*bi_windup_fp)(deflate_state *s);
+extern AOCL_TLS void (*bi_windup_fp)(deflate_state *s);
 
 local void static_emit_end_block(deflate_state *z_const s,
         int last)
@@ -102,6 +103,7 @@ block_state ZLIB_INTERNAL deflate_quick(deflate_state *s, int flush)
 {
     IPos hash_head;
     unsigned dist, match_len;
+    longest_match_func longest_match_fn = aocl_get_longest_match_x86();
 
     static_emit_tree(s, flush);
 
@@ -121,7 +123,7 @@ block_state ZLIB_INTERNAL deflate_quick(deflate_state *s, int flush)
             dist = s->strstart - hash_head;
 
             if ((dist-1) < (s->w_size - 1)) {
-                match_len = longest_match_x86(s, hash_head);
+                match_len = longest_match_fn(s, hash_head);
 
                 if (match_len >= MIN_MATCH) {
                     if (match_len > s->lookahead)
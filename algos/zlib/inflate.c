@@ -97,7 +97,7 @@
 #ifdef AOCL_ZLIB_OPT
 #include "aocl_zlib_setup.h"
 
-static int setup_ok_zlib_inflate = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_inflate = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /* Dynamic dispatcher setup function for native APIs.
  * All native APIs that call aocl optimized functions within their call stack,
@@ -447,10 +447,10 @@ local int updatewindow(z_streamp strm, const Bytef *end, unsigned copy) {
 
 #ifdef AOCL_ZLIB_OPT
 /* Flag to choose code paths based on dynamic dispatcher settings */
-static int inflateOptLevel = 0;
+static AOCL_TLS int inflateOptLevel = 0;
 /* Function pointers holding the optimized variant as per dynamic dispatcher settings */
-static int (*updatewindow_fp)(z_streamp strm, const Bytef * end, unsigned copy) = updatewindow;
-static void (*inflate_fast_fp)(z_streamp strm, unsigned start) = inflate_fast;
+static AOCL_TLS int (*updatewindow_fp)(z_streamp strm, const Bytef * end, unsigned copy) = updatewindow;
+static AOCL_TLS void (*inflate_fast_fp)(z_streamp strm, unsigned start) = inflate_fast;
 #endif /* AOCL_ZLIB_OPT */
 
 #ifdef AOCL_ZLIB_SSE2_OPT
@@ -1826,29 +1826,24 @@ static void aocl_setup_inflate_fmv(int optOff, int optLevel)
 }
 
 void ZLIB_INTERNAL aocl_setup_inflate(int optOff, int optLevel) {
-    AOCL_ENTER_CRITICAL(setup_zlib_inflate)
-    if (!setup_ok_zlib_inflate) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_setup_inflate_fmv(optOff, optLevel);
-        setup_ok_zlib_inflate = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_inflate)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_inflate == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_setup_inflate_fmv(optOff, optLevel);
+    dispatch_key_zlib_inflate = dispatchKey;
 }
 
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_inflate)
-    if (!setup_ok_zlib_inflate) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_setup_inflate_fmv(optOff, optLevel);
-        setup_ok_zlib_inflate = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_inflate)
+    if (dispatch_key_zlib_inflate != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_setup_inflate_fmv(optOff, optLevel);
+    dispatch_key_zlib_inflate = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 
 void ZLIB_INTERNAL aocl_destroy_inflate (void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_inflate)
-    setup_ok_zlib_inflate = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_inflate)
+    dispatch_key_zlib_inflate = AOCL_DISPATCH_UNSET;
 }
 #endif /* AOCL_ZLIB_OPT */
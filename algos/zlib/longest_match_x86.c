@@ -40,8 +40,9 @@
 
 #ifdef AOCL_ZLIB_OPT
 #include "aocl_zlib_setup.h"
+#include "aocl_zlib_x86.h"
 
-static int setup_ok_zlib_longest = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_longest = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 #define NIL 0
 
@@ -267,7 +268,7 @@ break_matching: /* sorry for goto's, but such code is smaller and easier to view
 
 /* Function pointer holding the optimized variant as per the detected CPU 
  * features */
-static uInt (*longest_match_fp)(deflate_state* s, IPos cur_match) = longest_match_c_opt;
+static AOCL_TLS uInt (*longest_match_fp)(deflate_state* s, IPos cur_match) = longest_match_c_opt;
 
 #if defined(AOCL_ZLIB_AVX2_OPT) && defined(HAVE_BUILTIN_CTZ)
 __attribute__((__target__("avx2")))
@@ -350,6 +351,11 @@ uInt ZLIB_INTERNAL longest_match_x86(deflate_state *s, IPos cur_match)
     return longest_match_fp(s, cur_match);
 }
 
+longest_match_func ZLIB_INTERNAL aocl_get_longest_match_x86(void)
+{
+    return longest_match_fp;
+}
+
 static inline void aocl_register_longest_match_fmv(int optOff, int optLevel)
 {
     if (UNLIKELY(optOff == 1))
@@ -387,19 +393,16 @@ static inline void aocl_register_longest_match_fmv(int optOff, int optLevel)
 }
 
 void ZLIB_INTERNAL aocl_register_longest_match(int optOff, int optLevel){
-    AOCL_ENTER_CRITICAL(setup_zlib_longest)
-    if (!setup_ok_zlib_longest) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_longest_match_fmv(optOff, optLevel);
-        setup_ok_zlib_longest = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_longest)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_longest == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_longest_match_fmv(optOff, optLevel);
+    dispatch_key_zlib_longest = dispatchKey;
 }
 
 void ZLIB_INTERNAL aocl_destroy_longest_match(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_longest)
-    setup_ok_zlib_longest = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_longest)
+    dispatch_key_zlib_longest = AOCL_DISPATCH_UNSET;
 }
 
 #endif /* AOCL_ZLIB_OPT */
@@ -34,7 +34,7 @@
 #ifdef AOCL_ZLIB_OPT
 #include "aocl_zlib_setup.h"
 
-static int setup_ok_zlib_slide = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_slide = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 static inline void slide_hash_c_opt(deflate_state *s)
 {
@@ -57,7 +57,7 @@ static inline void slide_hash_c_opt(deflate_state *s)
 
 /* Function pointer holding the optimized variant as per the detected CPU 
  * features */
-static void (*slide_hash_fp)(deflate_state* s) = slide_hash_c_opt;
+static AOCL_TLS void (*slide_hash_fp)(deflate_state* s) = slide_hash_c_opt;
 
 #ifdef AOCL_ZLIB_AVX2_OPT
 __attribute__((__target__("avx2")))
@@ -124,19 +124,16 @@ void aocl_register_slide_hash_fmv(int optOff, int optLevel)
 }
 
 void ZLIB_INTERNAL aocl_register_slide_hash(int optOff, int optLevel){
-    AOCL_ENTER_CRITICAL(setup_zlib_slide)
-    if (!setup_ok_zlib_slide) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_slide_hash_fmv(optOff, optLevel);
-        setup_ok_zlib_slide = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_slide)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_slide == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_slide_hash_fmv(optOff, optLevel);
+    dispatch_key_zlib_slide = dispatchKey;
 }
 
 void ZLIB_INTERNAL aocl_destroy_slide_hash(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_slide)
-    setup_ok_zlib_slide = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_slide)
+    dispatch_key_zlib_slide = AOCL_DISPATCH_UNSET;
 }
 
 #endif /* AOCL_ZLIB_OPT */
@@ -45,7 +45,7 @@
 
 #ifdef AOCL_ZLIB_OPT
 #include "aocl_zlib_setup.h"
-static int setup_ok_zlib_tree = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zlib_tree = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 #endif /* AOCL_ZLIB_OPT */
 
 /* ===========================================================================
@@ -341,8 +341,8 @@ local void gen_trees_header(void);
 
 #ifdef AOCL_ZLIB_OPT
 /* Function pointers holding the AOCL optimized variant. */
-static void (*bi_flush_fp)(deflate_state *s) = bi_flush;
-void (*bi_windup_fp)(deflate_state *s) = bi_windup;
+static AOCL_TLS void (*bi_flush_fp)(deflate_state *s) = bi_flush;
+AOCL_TLS void (*bi_windup_fp)(deflate_state *s) = bi_windup;
 #endif /* AOCL_ZLIB_OPT */
 
 #ifdef AOCL_ZLIB_OPT
@@ -360,19 +360,16 @@ static inline void aocl_setup_tree_fmv(int optOff, int optLevel)
 
 void ZLIB_INTERNAL aocl_setup_tree(int optOff, int optLevel) 
 {
-    AOCL_ENTER_CRITICAL(setup_zlib_tree)
-    if (!setup_ok_zlib_tree) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_setup_tree_fmv(optOff, optLevel);
-        setup_ok_zlib_tree = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zlib_tree)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zlib_tree == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_setup_tree_fmv(optOff, optLevel);
+    dispatch_key_zlib_tree = dispatchKey;
 }
 
 void ZLIB_INTERNAL aocl_destroy_tree(void) {
-    AOCL_ENTER_CRITICAL(setup_zlib_tree)
-    setup_ok_zlib_tree = 0;
-    AOCL_EXIT_CRITICAL(setup_zlib_tree)
+    dispatch_key_zlib_tree = AOCL_DISPATCH_UNSET;
 }
 #endif /* AOCL_ZLIB_OPT */
 
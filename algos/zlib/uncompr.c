@@ -34,6 +34,7 @@
 */
 #ifdef AOCL_ENABLE_THREADS
 #ifdef AOCL_ZLIB_OPT
+#include "aocl_zlib_setup.h"
 extern uint32_t adler32_x86_internal(uint32_t adler, const Bytef *buf, z_size_t len);
 #endif /* AOCL_ZLIB_OPT */
 static inline AOCL_UINT32 partition_checksum(Bytef *source, AOCL_INTP length)
@@ -104,6 +105,67 @@ static inline int uncompress2_ST(Bytef *dest, uLongf *destLen, const Bytef *sour
            err == Z_BUF_ERROR && left + stream.avail_out ? Z_DATA_ERROR :
            err;
 }
+//Arguments shared by the workers of the multi-threaded uncompress2()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} uncompress2_mt_args_t;
+
+//Worker of the multi-threaded uncompress2(): decompresses partitions until none is left
+static void uncompress2_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    uncompress2_mt_args_t* args = (uncompress2_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+#ifdef AOCL_ZLIB_OPT
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_zlib);
+#endif
+    AOCL_UINT32 thread_id;
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 cmpr_bound_pad = 0;
+        AOCL_UINT32 is_error = 0;
+        AOCL_INT32 thread_parallel_res = 0;
+
+        thread_parallel_res = aocl_do_partition_decompress_mt(thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id);
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        if(thread_id == 0) // skip header from first partition
+        {
+            cur_thread_info.partition_src += 2;
+            cur_thread_info.partition_src_size -= 2;
+        }
+        else if(thread_id == (thread_grp->num_threads - 1)) // skip trailer from first partition
+        {
+            cur_thread_info.partition_src_size -= 4;
+            thread_grp->threads_info_list[thread_id].additional_state_info = cur_thread_info.partition_src + cur_thread_info.partition_src_size;
+        }
+        if (thread_parallel_res == 0)
+        {
+            is_error = uncompress2_ST((Bytef *)cur_thread_info.dst_trap, (uLong *)&(cur_thread_info.dst_trap_size),
+                                        (Bytef *)cur_thread_info.partition_src, (uLong *)&(cur_thread_info.partition_src_size), -1 * MAX_WBITS);
+            cur_thread_info.last_bytes_len = partition_checksum((Bytef *)cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
+        }//aocl_do_partition_decompress_mt
+        else if (thread_parallel_res == 1)
+        {
+            is_error = 0;
+        }
+#ifdef AOCL_THREADS_LOG
+        printf("Decompress Thread [id: %d] : Return value %d\n", worker_id, is_error);
+#endif
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = cur_thread_info.last_bytes_len; // storing checksum value
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+}
+
 #endif
 
 int ZEXPORT uncompress2(Bytef *dest, uLongf *destLen, const Bytef *source,
@@ -195,50 +257,11 @@ int ZEXPORT uncompress2(Bytef *dest, uLongf *destLen, const Bytef *source,
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
-#ifdef AOCL_THREADS_LOG
-            printf("Decompress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-            AOCL_UINT32 cmpr_bound_pad = 0;
-            AOCL_UINT32 is_error = 0;
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            AOCL_INT32 thread_parallel_res = 0;
-
-            thread_parallel_res = aocl_do_partition_decompress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id);
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = NULL;
-            if(thread_id == 0) // skip header from first partition
-            {
-                cur_thread_info.partition_src += 2;
-                cur_thread_info.partition_src_size -= 2;
-            }
-            else if(thread_id == (thread_group_handle.num_threads - 1)) // skip trailer from first partition
-            {
-                cur_thread_info.partition_src_size -= 4;
-                thread_group_handle.threads_info_list[thread_id].additional_state_info = cur_thread_info.partition_src + cur_thread_info.partition_src_size;
-            }
-            if (thread_parallel_res == 0)
-            {
-                is_error = uncompress2_ST((Bytef *)cur_thread_info.dst_trap, (uLong *)&(cur_thread_info.dst_trap_size),
-                                            (Bytef *)cur_thread_info.partition_src, (uLong *)&(cur_thread_info.partition_src_size), -1 * MAX_WBITS);
-                cur_thread_info.last_bytes_len = partition_checksum((Bytef *)cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
-            }//aocl_do_partition_decompress_mt
-            else if (thread_parallel_res == 1)
-            {
-                is_error = 0;
-            }
-#ifdef AOCL_THREADS_LOG
-            printf("Decompress Thread [id: %d] : Return value %d\n", omp_get_thread_num(), is_error);
+        uncompress2_mt_args_t args = { &thread_group_handle, 0 };
+#ifdef AOCL_ZLIB_OPT
+        args.dispatch_key = dispatch_key_zlib; //workers take the dispatcher setup of this thread
 #endif
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = cur_thread_info.last_bytes_len; // storing checksum value
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-
-        }//#pragma omp parallel
+        aocl_run_parallel_mt(uncompress2_partitions_mt, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -560,5 +560,4 @@ typedef uLong FAR uLongf;
 #define LIKELY(x) x
 #define UNLIKELY(x) x
 #endif
-extern int zlibOptOff; /* Flag to choose code paths based on dynamic dispatcher settings */
 #endif /* ZCONF_H */
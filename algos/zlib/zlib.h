@@ -3162,6 +3162,40 @@ ZEXTERN char * ZEXPORT aocl_setup_zlib (int optOff, int optLevel,
  */
 ZEXTERN void ZEXPORT aocl_destroy_zlib (void);
 
+/**
+ * @brief AOCL-Compression defined parallel compression into a single standard zlib or gzip stream.
+ *
+ * The source is split into partitions that are compressed by multiple threads when the library
+ * is built with multi-threading support. Each partition is primed with the preceding 32 KB of the
+ * source, ends on a byte boundary with #Z_SYNC_FLUSH and the check values of the partitions are combined.
+ * Unlike compress2(), the output has no RAP frame and can be decoded by any inflater, with a single thread.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b dest       | out         | Destination buffer. |
+ * | \b destLen    | in,out      | Size of the destination buffer on entry, at least aocl_parallel_compressBound_zlib(sourceLen). Size of the compressed stream on exit. |
+ * | \b source     | in          | Source buffer. |
+ * | \b sourceLen  | in          | Length of the source buffer. |
+ * | \b level      | in          | Compression level, as in deflateInit(). |
+ * | \b windowBits | in          | MAX_WBITS for a zlib stream or MAX_WBITS + 16 for a gzip stream. Other values accepted by deflateInit2() are compressed by a single thread. |
+ *
+ * @return
+ * | Result   | Description |
+ * |:---------|:------------|
+ * | Success  | #Z_OK |
+ * | Fail     | #Z_MEM_ERROR if there was not enough memory |
+ * | ^        | #Z_BUF_ERROR if there was not enough room in the output buffer |
+ * | ^        | #Z_STREAM_ERROR if the level or windowBits parameter is invalid |
+ */
+ZEXTERN int ZEXPORT aocl_parallel_compress_zlib(Bytef *dest, uLongf *destLen,
+                                                const Bytef *source, uLong sourceLen,
+                                                int level, int windowBits);
+
+/**
+ * @brief Upper bound on the size of the stream produced by aocl_parallel_compress_zlib() for sourceLen bytes.
+ */
+ZEXTERN uLong ZEXPORT aocl_parallel_compressBound_zlib(uLong sourceLen);
+
 /**
  * @brief AOCL-Compression optimized adler32 checksum for zlib.
  */
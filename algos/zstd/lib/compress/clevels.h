@@ -259,6 +259,6 @@ static const ZSTD_compressionParameters AOCL_ZSTD_defaultCParameters[4][ZSTD_MAX
 },
 };
 
-static const ZSTD_compressionParameters (*AOCL_ZSTD_defaultCParameters_used)[ZSTD_MAX_CLEVEL+1] = ZSTD_defaultCParameters;
+static AOCL_TLS const ZSTD_compressionParameters (*AOCL_ZSTD_defaultCParameters_used)[ZSTD_MAX_CLEVEL+1] = ZSTD_defaultCParameters;
 
 #endif  /* ZSTD_CLEVELS_H */
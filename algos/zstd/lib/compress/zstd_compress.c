@@ -69,7 +69,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_zstd_encode = 0; // flag to indicate status of dynamic dispatcher setup
+static AOCL_TLS int dispatch_key_zstd_encode = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 #ifdef AOCL_ENABLE_THREADS
 #include "threads/threads.h"
@@ -147,7 +147,7 @@ struct ZSTD_CDict_s {
                                            */
 };  /* typedef'd to ZSTD_CDict within "zstd.h" */
 
-static unsigned char aoclOptFlag = 0;
+static AOCL_TLS unsigned char aoclOptFlag = 0;
 
 ZSTD_CCtx* ZSTD_createCCtx(void)
 {
@@ -233,6 +233,9 @@ static void ZSTD_freeCCtxContent(ZSTD_CCtx* cctx)
     ZSTD_clearAllDicts(cctx);
 #ifdef ZSTD_MULTITHREAD
     ZSTDMT_freeCCtx(cctx->mtctx); cctx->mtctx = NULL;
+#endif
+#ifdef AOCL_ENABLE_THREADS
+    aocl_destroy_thread_ctx_mt((aocl_thread_ctx_t*)cctx->aoclThreadCtx); cctx->aoclThreadCtx = NULL;
 #endif
     ZSTD_cwksp_free(&cctx->workspace, cctx->customMem);
 }
@@ -5340,6 +5343,11 @@ size_t AOCL_ZSTD_writeSkippableFrameHeader(void* dst, size_t dstCapacity, size_t
 * thread_group_handle->dst must point to a RAP frame
 * Note: data in thread_group_handle->dst beyond rap_frame_len will get overwitten
 */
+/* Release function for the per thread ZSTD_CCtx kept in the AOCL thread context */
+static void AOCL_ZSTD_freeThreadCCtx(void* state) {
+    ZSTD_freeCCtx((ZSTD_CCtx*)state);
+}
+
 size_t AOCL_write_skippable_rap_frame(aocl_thread_group_t* thread_group_handle, size_t dstCapacity, AOCL_INTP rap_frame_len) {
     AOCL_CHAR* dst_org = thread_group_handle->dst;
     AOCL_CHAR* dst_ptr = dst_org;
@@ -5357,7 +5365,7 @@ size_t AOCL_write_skippable_rap_frame(aocl_thread_group_t* thread_group_handle,
     dst_ptr += (skip_head_sz + RAP_START_OF_PARTITIONS);
 
     //Write RAP frame metadata
-    AOCL_UINT32 dst_offset = rap_frame_len;
+    AOCL_INTP dst_offset = rap_frame_len;
     aocl_thread_info_t cur_thread_info;
     for (AOCL_UINT32 thread_cnt = 0; thread_cnt < thread_group_handle->num_threads; thread_cnt++)
     {
@@ -5368,21 +5376,93 @@ size_t AOCL_write_skippable_rap_frame(aocl_thread_group_t* thread_group_handle,
             return ERROR(GENERIC);
         }
 
-        *(AOCL_UINT32*)dst_ptr = dst_offset; //For storing this thread's RAP offset
-        dst_ptr += RAP_OFFSET_BYTES;
-
-        *(AOCL_INT32*)dst_ptr = cur_thread_info.dst_trap_size; //For storing this thread's RAP length
-        dst_ptr += RAP_LEN_BYTES;
-
-        AOCL_INTP decomp_len = cur_thread_info.partition_src_size;
-        *(AOCL_INT32*)dst_ptr = decomp_len;
-        dst_ptr += DECOMP_LEN_BYTES;
+        //For storing this thread's RAP offset, RAP length and decompressed length
+        dst_ptr = aocl_write_rap_partition_mt(thread_group_handle, dst_ptr, dst_offset,
+                    cur_thread_info.dst_trap_size, cur_thread_info.partition_src_size);
 
         dst_offset += cur_thread_info.dst_trap_size;
     }
 
     return (dst_ptr - dst_org);
 }
+//Arguments shared by the workers of the multi-threaded ZSTD_compress_advanced()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    AOCL_UINT32 cmpr_bound_pad;
+    ZSTD_parameters params;
+    const void* dict;
+    size_t dictSize;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} AOCL_ZSTD_compress_mt_args_t;
+
+//Worker of the multi-threaded ZSTD_compress_advanced(): compresses partitions until none is left
+static void AOCL_ZSTD_compress_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    AOCL_ZSTD_compress_mt_args_t* args = (AOCL_ZSTD_compress_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Compress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_zstd_encode);
+    AOCL_UINT32 thread_id;
+    /* Copying cctx directly to cur_cctx might result in data associated with
+    * pointer members being shared between threads. Hence use separate cur_cctx
+    * objects for each thread and set necessary parameters here.
+    * They are kept in the thread context of cctx and reused by later calls. */
+    ZSTD_CCtx* cur_cctx = (ZSTD_CCtx*)aocl_get_thread_state_mt(thread_grp,
+        worker_id, AOCL_ZSTD_freeThreadCCtx);
+    int cur_cctx_kept = (cur_cctx != NULL);
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 is_error = 1;
+        size_t local_result = 0;
+
+        if (aocl_do_partition_compress_mt(thread_grp, &cur_thread_info, args->cmpr_bound_pad, thread_id) == 0)
+        {
+            if (cur_cctx == NULL)
+            {
+                cur_cctx = ZSTD_createCCtx();
+                if (cur_cctx)
+                    cur_cctx_kept = (aocl_set_thread_state_mt(thread_grp, worker_id,
+                                        cur_cctx, AOCL_ZSTD_freeThreadCCtx) == 0);
+            }
+
+            if (cur_cctx)
+            {
+                ZSTD_CCtx_setParameter(cur_cctx, ZSTD_c_compressionLevel, cur_cctx->requestedParams.compressionLevel);
+                ZSTD_CCtxParams_init_internal(&cur_cctx->simpleApiParams, &args->params, ZSTD_NO_CLEVEL);
+
+                local_result = ZSTD_compress_advanced_internal(cur_cctx,
+                    cur_thread_info.dst_trap, cur_thread_info.dst_trap_size,
+                    cur_thread_info.partition_src, cur_thread_info.partition_src_size,
+                    args->dict, args->dictSize,
+                    &cur_cctx->simpleApiParams);
+
+                if (!ERR_isError(local_result))
+                    is_error = 0;
+            }
+        }//aocl_do_partition_compress_mt
+
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = local_result;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = 0;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+#ifdef AOCL_THREADS_LOG
+        //printf("Compress Thread [id: %d] : Compression output length [%d], original source length [%d]\n",
+        //                                                  worker_id, local_result, inputSize);
+#endif
+    }
+    //cur_cctx is shared by all the partitions of this thread when it is not kept in the thread context
+    if (!cur_cctx_kept)
+        ZSTD_freeCCtx(cur_cctx);
+}
+
 #endif
 
 size_t ZSTD_compress_advanced (ZSTD_CCtx* cctx,
@@ -5413,10 +5493,15 @@ size_t ZSTD_compress_advanced (ZSTD_CCtx* cctx,
     aocl_thread_info_t cur_thread_info;
     AOCL_INT32 rap_frame_len = -1;
     AOCL_UINT32 thread_cnt = 0;
-    AOCL_UINT32 dst_offset = 0;
+    size_t dst_offset = 0;
 
     AOCL_UINT32 window_factor = ZSTD_GET_WINDOW_FACTOR(srcSize);
-    rap_frame_len = aocl_setup_parallel_compress_mt(&thread_group_handle, (char*)src,
+    /* Thread buffers and per thread contexts are kept in cctx and reused by later calls.
+    * Static contexts are never freed, hence they cannot own one. */
+    if (cctx->aoclThreadCtx == NULL && cctx->staticSize == 0)
+        cctx->aoclThreadCtx = aocl_create_thread_ctx_mt(AOCL_ZSTD_freeThreadCCtx);
+    rap_frame_len = aocl_setup_parallel_compress_ctx_mt(&thread_group_handle,
+        (aocl_thread_ctx_t*)cctx->aoclThreadCtx, (char*)src,
         dst, srcSize, dstCapacity, 1U << params.cParams.windowLog, window_factor);
 
     if (rap_frame_len < 0) {
@@ -5437,56 +5522,19 @@ size_t ZSTD_compress_advanced (ZSTD_CCtx* cctx,
     }
     else
     {
+        size_t maxSrcSize = thread_group_handle.common_part_src_size +
+                            thread_group_handle.leftover_part_src_bytes;
+        AOCL_UINT32 cmpr_bound_pad = (ZSTD_compressBound(maxSrcSize) - maxSrcSize); //Number of additional bytes beyond srcSize that could be written
+        /* Compress partitions directly into dst when it can hold all the partition bounds.
+        * Space is left for the RAP frame and the skippable frame header that wraps it. */
+        aocl_enable_in_place_compress_mt(&thread_group_handle, cmpr_bound_pad,
+                                         rap_frame_len + ZSTD_SKIPPABLEHEADERSIZE);
 #ifdef AOCL_THREADS_LOG
         printf("Compress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
-#ifdef AOCL_THREADS_LOG
-            printf("Compress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-            size_t maxSrcSize = thread_group_handle.common_part_src_size +
-                                thread_group_handle.leftover_part_src_bytes;
-            AOCL_UINT32 cmpr_bound_pad = (ZSTD_compressBound(maxSrcSize) - maxSrcSize); //Number of additional bytes beyond srcSize that could be written
-            AOCL_UINT32 is_error = 1;
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            size_t local_result = 0;
-
-            if (aocl_do_partition_compress_mt(&thread_group_handle, &cur_thread_info, cmpr_bound_pad, thread_id) == 0)
-            {
-                /* Copying cctx directly to cur_cctx might result in data associated with
-                * pointer members being shared between threads. Hence create new cur_cctx
-                * objects for each thread and set necessary parameters here */
-                ZSTD_CCtx* cur_cctx = ZSTD_createCCtx();
-                ZSTD_CCtx_setParameter(cur_cctx, ZSTD_c_compressionLevel, cur_cctx->requestedParams.compressionLevel);
-                ZSTD_CCtxParams_init_internal(&cur_cctx->simpleApiParams, &params, ZSTD_NO_CLEVEL);
-
-                local_result = ZSTD_compress_advanced_internal(cur_cctx,
-                    cur_thread_info.dst_trap, cur_thread_info.dst_trap_size,
-                    cur_thread_info.partition_src, cur_thread_info.partition_src_size,
-                    dict, dictSize,
-                    &cur_cctx->simpleApiParams);
-
-                if (!ERR_isError(local_result))
-                    is_error = 0;
-
-                if (cur_cctx)
-                    ZSTD_freeCCtx(cur_cctx);
-            }//aocl_do_partition_compress_mt
-
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = NULL;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = local_result;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = 0;
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-#ifdef AOCL_THREADS_LOG
-            //printf("Compress Thread [id: %d] : Compression output length [%d], original source length [%d]\n",
-            //                                                  omp_get_thread_num(), local_result, inputSize);
-#endif
-        }//#pragma omp parallel
+        //workers take the dispatcher setup of this thread
+        AOCL_ZSTD_compress_mt_args_t args = { &thread_group_handle, cmpr_bound_pad, params, dict, dictSize, dispatch_key_zstd_encode };
+        aocl_run_parallel_mt(AOCL_ZSTD_compress_partitions_mt, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
         printf("Compress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -5507,11 +5555,31 @@ size_t ZSTD_compress_advanced (ZSTD_CCtx* cctx,
         }
         thread_group_handle.dst += dst_offset; //move by skippable frame
 
-        for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
         {
-            cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
-            memcpy(thread_group_handle.dst, cur_thread_info.dst_trap, cur_thread_info.dst_trap_size);
-            thread_group_handle.dst += cur_thread_info.dst_trap_size;
+            /* Move the compressed data from threads into place after the skippable frame */
+            aocl_partition_move_t* moves = (aocl_partition_move_t*)ZSTD_customMalloc(
+                thread_group_handle.num_threads * sizeof(aocl_partition_move_t), ZSTD_defaultCMem);
+            if (moves == NULL) {
+                aocl_destroy_parallel_compress_mt(&thread_group_handle);
+                LOG_UNFORMATTED(INFO, logCtx, "Exit");
+                return ERROR(memory_allocation);
+            }
+            for (thread_cnt = 0; thread_cnt < thread_group_handle.num_threads; thread_cnt++)
+            {
+                cur_thread_info = thread_group_handle.threads_info_list[thread_cnt];
+                moves[thread_cnt].src = cur_thread_info.dst_trap;
+                moves[thread_cnt].dst = thread_group_handle.dst;
+                moves[thread_cnt].size = cur_thread_info.dst_trap_size;
+                thread_group_handle.dst += cur_thread_info.dst_trap_size;
+            }
+            if (aocl_compact_partitions_mt(moves, thread_group_handle.num_threads,
+                                           thread_group_handle.num_workers) != 0) {
+                ZSTD_customFree(moves, ZSTD_defaultCMem);
+                aocl_destroy_parallel_compress_mt(&thread_group_handle);
+                LOG_UNFORMATTED(INFO, logCtx, "Exit");
+                return ERROR(memory_allocation);
+            }
+            ZSTD_customFree(moves, ZSTD_defaultCMem);
         }
 
         aocl_destroy_parallel_compress_mt(&thread_group_handle);
@@ -7429,37 +7497,32 @@ static void aocl_register_zstd_compress_fmv(int optOff, int optLevel)
 char* aocl_setup_zstd_encode(int optOff, int optLevel, size_t insize,
     size_t level, size_t windowLog)
 {
-    AOCL_ENTER_CRITICAL(setup_zstd_encode)
-    if (!setup_ok_zstd_encode) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_zstd_compress_fmv(optOff, optLevel);
-        aocl_register_compressfast_fmv(optOff, optLevel);
-        aocl_register_compressdoublefast_fmv(optOff, optLevel);
-        setup_ok_zstd_encode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zstd_encode)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zstd_encode == dispatchKey)
+        return NULL;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_zstd_compress_fmv(optOff, optLevel);
+    aocl_register_compressfast_fmv(optOff, optLevel);
+    aocl_register_compressdoublefast_fmv(optOff, optLevel);
+    dispatch_key_zstd_encode = dispatchKey;
     return NULL;
 }
 
 #ifdef AOCL_ZSTD_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zstd_encode)
-    if (!setup_ok_zstd_encode) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_zstd_compress_fmv(optOff, optLevel);
-        aocl_register_compressfast_fmv(optOff, optLevel);
-        aocl_register_compressdoublefast_fmv(optOff, optLevel);
-        setup_ok_zstd_encode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zstd_encode)
+    if (dispatch_key_zstd_encode != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_zstd_compress_fmv(optOff, optLevel);
+    aocl_register_compressfast_fmv(optOff, optLevel);
+    aocl_register_compressdoublefast_fmv(optOff, optLevel);
+    dispatch_key_zstd_encode = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 #endif
 
 void aocl_destroy_zstd_encode(void) {
-    AOCL_ENTER_CRITICAL(setup_zstd_encode)
-    setup_ok_zstd_encode = 0;
-    AOCL_EXIT_CRITICAL(setup_zstd_encode)
+    dispatch_key_zstd_encode = AOCL_DISPATCH_UNSET;
 }
 
 #ifdef AOCL_UNIT_TEST
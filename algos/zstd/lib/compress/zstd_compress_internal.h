@@ -474,6 +474,9 @@ struct ZSTD_CCtx_s {
 #ifdef ZSTD_MULTITHREAD
     ZSTDMT_CCtx* mtctx;
 #endif
+#ifdef AOCL_ENABLE_THREADS
+    void* aoclThreadCtx;   /* aocl_thread_ctx_t reused by the AOCL multi-threaded compressor, created on first use */
+#endif
 
     /* Tracing */
 #if ZSTD_TRACE
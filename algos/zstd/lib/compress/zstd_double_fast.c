@@ -833,10 +833,10 @@ AOCL_ZSTD_GEN_DFAST_NODICT_FN(6)
 AOCL_ZSTD_GEN_DFAST_NODICT_FN(7)
 #endif /* AOCL_ZSTD_OPT */
 
-static size_t (*ZSTD_compressBlock_doubleFast_noDict_4_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_4;
-static size_t (*ZSTD_compressBlock_doubleFast_noDict_5_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_5;
-static size_t (*ZSTD_compressBlock_doubleFast_noDict_6_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_6;
-static size_t (*ZSTD_compressBlock_doubleFast_noDict_7_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_7;
+static AOCL_TLS size_t (*ZSTD_compressBlock_doubleFast_noDict_4_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_4;
+static AOCL_TLS size_t (*ZSTD_compressBlock_doubleFast_noDict_5_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_5;
+static AOCL_TLS size_t (*ZSTD_compressBlock_doubleFast_noDict_6_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_6;
+static AOCL_TLS size_t (*ZSTD_compressBlock_doubleFast_noDict_7_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_doubleFast_noDict_7;
 
 size_t ZSTD_compressBlock_doubleFast(
         ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM],
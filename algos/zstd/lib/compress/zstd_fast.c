@@ -744,14 +744,14 @@ AOCL_ZSTD_GEN_FAST_NODICT_FN(6, 0)
 AOCL_ZSTD_GEN_FAST_NODICT_FN(7, 0)
 #endif /* AOCL_ZSTD_OPT */
 
-static size_t(*ZSTD_compressBlock_fast_noDict_4_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_4_1;
-static size_t(*ZSTD_compressBlock_fast_noDict_5_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_5_1;
-static size_t(*ZSTD_compressBlock_fast_noDict_6_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_6_1;
-static size_t(*ZSTD_compressBlock_fast_noDict_7_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_7_1;
-static size_t(*ZSTD_compressBlock_fast_noDict_4_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_4_0;
-static size_t(*ZSTD_compressBlock_fast_noDict_5_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_5_0;
-static size_t(*ZSTD_compressBlock_fast_noDict_6_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_6_0;
-static size_t(*ZSTD_compressBlock_fast_noDict_7_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_7_0;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_4_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_4_1;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_5_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_5_1;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_6_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_6_1;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_7_1_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_7_1;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_4_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_4_0;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_5_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_5_0;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_6_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_6_0;
+static AOCL_TLS size_t (*ZSTD_compressBlock_fast_noDict_7_0_fp)(ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM], void const* src, size_t srcSize) = ZSTD_compressBlock_fast_noDict_7_0;
 
 size_t ZSTD_compressBlock_fast(
         ZSTD_matchState_t* ms, seqStore_t* seqStore, U32 rep[ZSTD_REP_NUM],
@@ -1247,6 +1247,63 @@ size_t AOCL_ZSTD_readSkippableFrameHeader(const void* src, size_t srcSize)
     return ZSTD_SKIPPABLEHEADERSIZE;
     }
 }
+//Arguments shared by the workers of the multi-threaded ZSTD_decompressDCtx()
+typedef struct {
+    aocl_thread_group_t* thread_grp;
+    int dispatch_key;   //Dispatcher setup of the thread that started the region
+} AOCL_ZSTD_decompress_mt_args_t;
+
+//Worker of the multi-threaded ZSTD_decompressDCtx(): decompresses partitions until none is left
+static void AOCL_ZSTD_decompress_partitions_mt(void* arg, AOCL_UINT32 worker_id)
+{
+    AOCL_ZSTD_decompress_mt_args_t* args = (AOCL_ZSTD_decompress_mt_args_t*)arg;
+    aocl_thread_group_t* thread_grp = args->thread_grp;
+    aocl_thread_info_t cur_thread_info;
+#ifdef AOCL_THREADS_LOG
+    printf("Decompress Thread [id: %d] : Inside parallel region\n", worker_id);
+#endif
+    AOCL_SETUP_WORKER(args->dispatch_key, aocl_setup_zstd_decode);
+    AOCL_UINT32 thread_id;
+    ZSTD_DCtx* cur_dctx = NULL; //Shared by all the partitions of this thread
+    //Take partitions from this thread's queue first, then steal pending ones from the other threads
+    while (aocl_get_next_partition_mt(thread_grp, worker_id, &thread_id))
+    {
+        AOCL_UINT32 cmpr_bound_pad = WILDCOPY_OVERLENGTH;
+        AOCL_UINT32 is_error = 1;
+        size_t local_result = 0;
+        AOCL_INT32 thread_parallel_res = 0;
+
+        thread_parallel_res = aocl_do_partition_decompress_mt(thread_grp, 
+                              &cur_thread_info, cmpr_bound_pad, thread_id);
+        if (thread_parallel_res == 0)
+        {
+            if (cur_dctx == NULL)
+                cur_dctx = ZSTD_createDCtx();
+            local_result = ZSTD_decompress_usingDDict(cur_dctx, cur_thread_info.dst_trap,
+                cur_thread_info.dst_trap_size, cur_thread_info.partition_src, 
+                cur_thread_info.partition_src_size, ZSTD_getDDict(cur_dctx));
+            if (!ERR_isError(local_result))
+                is_error = 0;
+        }
+        else if (thread_parallel_res == 1)
+        {
+            local_result = 0;
+            is_error = 0;
+        }
+
+        thread_grp->threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
+        thread_grp->threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
+        thread_grp->threads_info_list[thread_id].additional_state_info = NULL;
+        thread_grp->threads_info_list[thread_id].dst_trap_size = local_result;
+        thread_grp->threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
+        thread_grp->threads_info_list[thread_id].last_bytes_len = 0;
+        thread_grp->threads_info_list[thread_id].is_error = is_error;
+        thread_grp->threads_info_list[thread_id].num_child_threads = 0;
+    }
+    if (cur_dctx)
+        ZSTD_freeDCtx(cur_dctx);
+}
+
 #endif
 
 size_t ZSTD_decompressDCtx(ZSTD_DCtx* dctx, void* dst, size_t dstCapacity, const void* src, size_t srcSize)
@@ -1309,47 +1366,9 @@ size_t ZSTD_decompressDCtx(ZSTD_DCtx* dctx, void* dst, size_t dstCapacity, const
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : Before parallel region\n", omp_get_thread_num());
 #endif
-#pragma omp parallel private(cur_thread_info) shared(thread_group_handle) num_threads(thread_group_handle.num_threads)
-        {
-#ifdef AOCL_THREADS_LOG
-            printf("Decompress Thread [id: %d] : Inside parallel region\n", omp_get_thread_num());
-#endif
-            AOCL_UINT32 cmpr_bound_pad = WILDCOPY_OVERLENGTH;
-            AOCL_UINT32 is_error = 1;
-            AOCL_UINT32 thread_id = omp_get_thread_num();
-            size_t local_result = 0;
-            AOCL_INT32 thread_parallel_res = 0;
-
-            thread_parallel_res = aocl_do_partition_decompress_mt(&thread_group_handle, 
-                                  &cur_thread_info, cmpr_bound_pad, thread_id);
-            if (thread_parallel_res == 0)
-            {
-                ZSTD_DCtx* cur_dctx = ZSTD_createDCtx();
-                local_result = ZSTD_decompress_usingDDict(cur_dctx, cur_thread_info.dst_trap,
-                    cur_thread_info.dst_trap_size, cur_thread_info.partition_src, 
-                    cur_thread_info.partition_src_size, ZSTD_getDDict(cur_dctx));
-                if (!ERR_isError(local_result))
-                    is_error = 0;
-
-                if (cur_dctx)
-                    ZSTD_freeDCtx(cur_dctx);
-            }
-            else if (thread_parallel_res == 1)
-            {
-                local_result = 0;
-                is_error = 0;
-            }
-
-            thread_group_handle.threads_info_list[thread_id].partition_src = cur_thread_info.partition_src;
-            thread_group_handle.threads_info_list[thread_id].dst_trap = cur_thread_info.dst_trap;
-            thread_group_handle.threads_info_list[thread_id].additional_state_info = NULL;
-            thread_group_handle.threads_info_list[thread_id].dst_trap_size = local_result;
-            thread_group_handle.threads_info_list[thread_id].partition_src_size = cur_thread_info.partition_src_size;
-            thread_group_handle.threads_info_list[thread_id].last_bytes_len = 0;
-            thread_group_handle.threads_info_list[thread_id].is_error = is_error;
-            thread_group_handle.threads_info_list[thread_id].num_child_threads = 0;
-
-        }//#pragma omp parallel
+        //workers take the dispatcher setup of this thread
+        AOCL_ZSTD_decompress_mt_args_t args = { &thread_group_handle, dispatch_key_zstd_decode };
+        aocl_run_parallel_mt(AOCL_ZSTD_decompress_partitions_mt, &args, thread_group_handle.num_workers);
 #ifdef AOCL_THREADS_LOG
         printf("Decompress Thread [id: %d] : After parallel region\n", omp_get_thread_num());
 #endif
@@ -2586,9 +2605,7 @@ char* aocl_setup_zstd_decode(int optOff, int optLevel, size_t insize,
 
 #ifdef AOCL_ZSTD_OPT
 static void aocl_setup_native(void) {
-    int optLevel = get_cpu_opt_flags(0);
-    int optOff = get_disable_opt_flags(0);
-    aocl_setup_zstd_decompress_block(optOff, optLevel);
+    aocl_setup_zstd_decompress_block_native();
 }
 #endif
 
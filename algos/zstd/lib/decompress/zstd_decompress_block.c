@@ -68,7 +68,7 @@ static void aocl_setup_native(void);
 #define AOCL_SETUP_NATIVE()
 #endif
 
-static int setup_ok_zstd_decode = 0; // flag to indicate status of dynamic dispatcher setup
+AOCL_TLS int dispatch_key_zstd_decode = AOCL_DISPATCH_UNSET; // dispatcher key of this thread's setup
 
 /*_*******************************************************
 *  Macros
@@ -2022,7 +2022,7 @@ AOCL_ZSTD_decompressSequences_default(ZSTD_DCtx* dctx,
 }
 #endif
 
- size_t (*ZSTD_decompressSequences_default_fp)(ZSTD_DCtx* dctx, void* dst, size_t maxDstSize,
+AOCL_TLS size_t (*ZSTD_decompressSequences_default_fp)(ZSTD_DCtx* dctx, void* dst, size_t maxDstSize,
     const void* seqStart, size_t seqSize, int nbSeq, const ZSTD_longOffset_e isLongOffset, const int frame)
     = ZSTD_decompressSequences_default;
 
@@ -2263,7 +2263,7 @@ AOCL_ZSTD_decompressSequences_bmi2(ZSTD_DCtx* dctx,
 }
 #endif
 
- size_t (*ZSTD_decompressSequences_bmi2_fp)(ZSTD_DCtx* dctx, void* dst, size_t maxDstSize,
+AOCL_TLS size_t (*ZSTD_decompressSequences_bmi2_fp)(ZSTD_DCtx* dctx, void* dst, size_t maxDstSize,
     const void* seqStart, size_t seqSize, int nbSeq, const ZSTD_longOffset_e isLongOffset, const int frame)
     = ZSTD_decompressSequences_bmi2;
 
@@ -2623,25 +2623,22 @@ static void aocl_register_zstd_decompress_block_fmv(int optOff, int optLevel)
 
 void aocl_setup_zstd_decompress_block(int optOff, int optLevel)
 {
-    AOCL_ENTER_CRITICAL(setup_zstd_decode)
-    if (!setup_ok_zstd_decode) {
-        optOff = optOff ? 1 : get_disable_opt_flags(0);
-        aocl_register_zstd_decompress_block_fmv(optOff, optLevel);
-        setup_ok_zstd_decode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zstd_decode)
+    int dispatchKey = AOCL_DISPATCH_KEY(optOff, optLevel);
+    if (dispatch_key_zstd_decode == dispatchKey)
+        return;
+    optOff = optOff ? 1 : get_disable_opt_flags(0);
+    aocl_register_zstd_decompress_block_fmv(optOff, optLevel);
+    dispatch_key_zstd_decode = dispatchKey;
 }
 
 #ifdef AOCL_ZSTD_OPT
 static void aocl_setup_native(void) {
-    AOCL_ENTER_CRITICAL(setup_zstd_decode)
-    if (!setup_ok_zstd_decode) {
-        int optLevel = get_cpu_opt_flags(0);
-        int optOff = get_disable_opt_flags(0);
-        aocl_register_zstd_decompress_block_fmv(optOff, optLevel);
-        setup_ok_zstd_decode = 1;
-    }
-    AOCL_EXIT_CRITICAL(setup_zstd_decode)
+    if (dispatch_key_zstd_decode != AOCL_DISPATCH_UNSET)
+        return;
+    int optLevel = get_cpu_opt_flags(0);
+    int optOff = get_disable_opt_flags(0);
+    aocl_register_zstd_decompress_block_fmv(optOff, optLevel);
+    dispatch_key_zstd_decode = AOCL_DISPATCH_KEY(optOff, optLevel);
 }
 
 void aocl_setup_zstd_decompress_block_native(void) {
@@ -2650,9 +2647,7 @@ void aocl_setup_zstd_decompress_block_native(void) {
 #endif
 
 void aocl_destroy_zstd_decompress_block(void) {
-    AOCL_ENTER_CRITICAL(setup_zstd_decode)
-    setup_ok_zstd_decode = 0;
-    AOCL_EXIT_CRITICAL(setup_zstd_decode)
+    dispatch_key_zstd_decode = AOCL_DISPATCH_UNSET;
 }
 
 #ifdef AOCL_UNIT_TEST
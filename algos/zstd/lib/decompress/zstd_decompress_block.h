@@ -98,6 +98,8 @@ size_t ZSTD_decompressBlock_deprecated(ZSTD_DCtx* dctx,
 
 void aocl_setup_zstd_decompress_block(int optOff, int optLevel);
 
+extern AOCL_TLS int dispatch_key_zstd_decode; /* dispatcher key of this thread's setup */
+
 void aocl_setup_zstd_decompress_block_native(void);
 
 void aocl_destroy_zstd_decompress_block(void);
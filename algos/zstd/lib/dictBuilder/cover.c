@@ -37,6 +37,9 @@
 #include "../common/bits.h" /* ZSTD_highbit32 */
 #include "../zdict.h"
 #include "cover.h"
+#ifdef COVER_OMP_JOBS
+#include "threads/threads.h"
+#endif
 
 /*-*************************************
 *  Constants
@@ -903,11 +906,10 @@ void COVER_best_start(COVER_best_t *best) {
 }
 
 /**
- * Called when a thread finishes executing, both on error or success.
- * Decrements liveJobs and signals any waiting threads if liveJobs == 0.
- * If this dictionary is the best so far save it and its parameters.
+ * Body of COVER_best_finish(), run under the lock.
  */
-void COVER_best_finish(COVER_best_t *best, ZDICT_cover_params_t parameters,
+static void COVER_best_update(COVER_best_t *best,
+                              ZDICT_cover_params_t parameters,
                               COVER_dictSelection_t selection) {
   void* dict = selection.dictContent;
   size_t compressedSize = selection.totalCompressedSize;
@@ -920,8 +922,11 @@ void COVER_best_finish(COVER_best_t *best, ZDICT_cover_params_t parameters,
     ZSTD_pthread_mutex_lock(&best->mutex);
     --best->liveJobs;
     liveJobs = best->liveJobs;
-    /* If the new dictionary is better */
-    if (compressedSize < best->compressedSize) {
+    /* If the new dictionary is better. Ties go to the smaller k, which a
+     * serial run tries first, whatever order parallel jobs finish in. */
+    if (compressedSize < best->compressedSize ||
+        (compressedSize == best->compressedSize && dict && best->dict &&
+         parameters.d == best->parameters.d && parameters.k < best->parameters.k)) {
       /* Allocate space if necessary */
       if (!best->dict || best->dictSize < dictSize) {
         if (best->dict) {
@@ -951,6 +956,43 @@ void COVER_best_finish(COVER_best_t *best, ZDICT_cover_params_t parameters,
   }
 }
 
+/**
+ * Called when a thread finishes executing, both on error or success.
+ * Decrements liveJobs and signals any waiting threads if liveJobs == 0.
+ * If this dictionary is the best so far save it and its parameters.
+ */
+void COVER_best_finish(COVER_best_t *best, ZDICT_cover_params_t parameters,
+                              COVER_dictSelection_t selection) {
+#ifdef COVER_OMP_JOBS
+  /* Jobs may run on executor threads, which are not OpenMP threads */
+  static aocl_lock_t COVER_best_lock = 0;
+  aocl_lock_mt(&COVER_best_lock);
+  COVER_best_update(best, parameters, selection);
+  aocl_unlock_mt(&COVER_best_lock);
+#else
+  COVER_best_update(best, parameters, selection);
+#endif
+}
+
+#ifdef COVER_OMP_JOBS
+typedef struct {
+  POOL_function function;
+  void **jobs;
+} COVER_jobList_t;
+
+static void COVER_runJob(void *arg, AOCL_INTP jobId, AOCL_UINT32 workerId) {
+  COVER_jobList_t *list = (COVER_jobList_t *)arg;
+  (void)workerId;
+  list->function(list->jobs[jobId]);
+}
+
+void COVER_runJobs(POOL_function function, void **jobs, unsigned nbJobs,
+                   unsigned nbThreads) {
+  COVER_jobList_t list = { function, jobs };
+  aocl_run_parallel_for_mt(COVER_runJob, &list, (AOCL_INTP)nbJobs, nbThreads);
+}
+#endif
+
 static COVER_dictSelection_t setDictSelection(BYTE* buf, size_t s, size_t csz)
 {
     COVER_dictSelection_t ds;
@@ -1144,6 +1186,10 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
   unsigned k;
   COVER_best_t best;
   POOL_ctx *pool = NULL;
+  void **jobs = NULL;
+#ifdef COVER_OMP_JOBS
+  unsigned nbJobs = 0;
+#endif
   int warned = 0;
 
   /* Checks */
@@ -1165,10 +1211,17 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
     return ERROR(dstSize_tooSmall);
   }
   if (nbThreads > 1) {
+#ifdef COVER_OMP_JOBS
+    jobs = (void **)malloc(kIterations * sizeof(void *));
+    if (!jobs) {
+      return ERROR(memory_allocation);
+    }
+#else
     pool = POOL_create(nbThreads, 1);
     if (!pool) {
       return ERROR(memory_allocation);
     }
+#endif
   }
   /* Initialization */
   COVER_best_init(&best);
@@ -1187,6 +1240,7 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
         LOCALDISPLAYLEVEL(displayLevel, 1, "Failed to initialize context\n");
         COVER_best_destroy(&best);
         POOL_free(pool);
+        free(jobs);
         return initVal;
       }
     }
@@ -1202,9 +1256,13 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
       LOCALDISPLAYLEVEL(displayLevel, 3, "k=%u\n", k);
       if (!data) {
         LOCALDISPLAYLEVEL(displayLevel, 1, "Failed to allocate parameters\n");
+#ifdef COVER_OMP_JOBS
+        COVER_runJobs(&COVER_tryParameters, jobs, nbJobs, nbThreads);
+#endif
         COVER_best_destroy(&best);
         COVER_ctx_destroy(&ctx);
         POOL_free(pool);
+        free(jobs);
         return ERROR(memory_allocation);
       }
       data->ctx = &ctx;
@@ -1225,6 +1283,11 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
       }
       /* Call the function and pass ownership of data to it */
       COVER_best_start(&best);
+#ifdef COVER_OMP_JOBS
+      if (jobs) {
+        jobs[nbJobs++] = data;
+      } else
+#endif
       if (pool) {
         POOL_add(pool, &COVER_tryParameters, data);
       } else {
@@ -1235,6 +1298,10 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
                          (unsigned)((iteration * 100) / kIterations));
       ++iteration;
     }
+#ifdef COVER_OMP_JOBS
+    COVER_runJobs(&COVER_tryParameters, jobs, nbJobs, nbThreads);
+    nbJobs = 0;
+#endif
     COVER_best_wait(&best);
     COVER_ctx_destroy(&ctx);
   }
@@ -1246,12 +1313,14 @@ ZDICTLIB_API size_t ZDICT_optimizeTrainFromBuffer_cover(
       const size_t compressedSize = best.compressedSize;
       COVER_best_destroy(&best);
       POOL_free(pool);
+      free(jobs);
       return compressedSize;
     }
     *parameters = best.parameters;
     memcpy(dictBuffer, best.dict, dictSize);
     COVER_best_destroy(&best);
     POOL_free(pool);
+    free(jobs);
     return dictSize;
   }
 }
@@ -129,6 +129,19 @@ void COVER_best_start(COVER_best_t *best);
  */
 void COVER_best_finish(COVER_best_t *best, ZDICT_cover_params_t parameters,
                        COVER_dictSelection_t selection);
+
+#if defined(AOCL_ENABLE_THREADS) && !defined(ZSTD_MULTITHREAD)
+/* Without ZSTD_MULTITHREAD the pool runs jobs serially: the parameters tried for
+ * one value of d are collected instead and run by aocl_run_parallel_for_mt(). */
+#define COVER_OMP_JOBS
+
+/**
+ * Runs the collected jobs on nbThreads threads and returns once all are done.
+ * COVER_best_finish() is serialized between them.
+ */
+void COVER_runJobs(POOL_function function, void **jobs, unsigned nbJobs,
+                   unsigned nbThreads);
+#endif
 /**
  * Error function for COVER_selectDict function. Checks if the return
  * value is an error.
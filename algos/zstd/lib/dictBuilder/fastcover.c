@@ -645,6 +645,10 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
     unsigned k;
     COVER_best_t best;
     POOL_ctx *pool = NULL;
+    void **jobs = NULL;
+#ifdef COVER_OMP_JOBS
+    unsigned nbJobs = 0;
+#endif
     int warned = 0;
     /* Checks */
     if (splitPoint <= 0 || splitPoint > 1) {
@@ -669,10 +673,17 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
       return ERROR(dstSize_tooSmall);
     }
     if (nbThreads > 1) {
+#ifdef COVER_OMP_JOBS
+      jobs = (void **)malloc(kIterations * sizeof(void *));
+      if (!jobs) {
+        return ERROR(memory_allocation);
+      }
+#else
       pool = POOL_create(nbThreads, 1);
       if (!pool) {
         return ERROR(memory_allocation);
       }
+#endif
     }
     /* Initialization */
     COVER_best_init(&best);
@@ -694,6 +705,7 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
           LOCALDISPLAYLEVEL(displayLevel, 1, "Failed to initialize context\n");
           COVER_best_destroy(&best);
           POOL_free(pool);
+          free(jobs);
           return initVal;
         }
       }
@@ -709,9 +721,13 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
         LOCALDISPLAYLEVEL(displayLevel, 3, "k=%u\n", k);
         if (!data) {
           LOCALDISPLAYLEVEL(displayLevel, 1, "Failed to allocate parameters\n");
+#ifdef COVER_OMP_JOBS
+          COVER_runJobs(&FASTCOVER_tryParameters, jobs, nbJobs, nbThreads);
+#endif
           COVER_best_destroy(&best);
           FASTCOVER_ctx_destroy(&ctx);
           POOL_free(pool);
+          free(jobs);
           return ERROR(memory_allocation);
         }
         data->ctx = &ctx;
@@ -733,6 +749,11 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
         }
         /* Call the function and pass ownership of data to it */
         COVER_best_start(&best);
+#ifdef COVER_OMP_JOBS
+        if (jobs) {
+          jobs[nbJobs++] = data;
+        } else
+#endif
         if (pool) {
           POOL_add(pool, &FASTCOVER_tryParameters, data);
         } else {
@@ -743,6 +764,10 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
                            (unsigned)((iteration * 100) / kIterations));
         ++iteration;
       }
+#ifdef COVER_OMP_JOBS
+      COVER_runJobs(&FASTCOVER_tryParameters, jobs, nbJobs, nbThreads);
+      nbJobs = 0;
+#endif
       COVER_best_wait(&best);
       FASTCOVER_ctx_destroy(&ctx);
     }
@@ -754,12 +779,14 @@ ZDICT_optimizeTrainFromBuffer_fastCover(
         const size_t compressedSize = best.compressedSize;
         COVER_best_destroy(&best);
         POOL_free(pool);
+        free(jobs);
         return compressedSize;
       }
       FASTCOVER_convertToFastCoverParams(best.parameters, parameters, f, accel);
       memcpy(dictBuffer, best.dict, dictSize);
       COVER_best_destroy(&best);
       POOL_free(pool);
+      free(jobs);
       return dictSize;
     }
 
@@ -131,7 +131,7 @@ typedef struct
     size_t outSize;      /**<  Output data length                                     */ 
     size_t level;        /**<  Requested compression level                            */
     size_t optVar;       /**<  Additional variables or parameters                     */
-    int numThreads;      /**<  Number of threads available for multi-threading        */
+    int numThreads;      /**<  Number of threads available for multi-threading, 0 or less for the budget of the calling thread (aocl_set_num_threads_mt()), all available threads by default */
     int numMPIranks;     /**<  Number of available multi-core MPI ranks               */
     size_t memLimit;     /**<  Maximum memory limit for compression/decompression     */
     int measureStats;    /**<  Measure speed and size of compression/decompression    */
@@ -148,9 +148,37 @@ typedef struct
                                2 - AVX optimizations, \n
                                3 - AVX2 optimizations, \n
                                4 - AVX512 optimizations                               */
+    char *batchBuf;      /**<  Per thread copies of workBuf kept by the batch APIs. Set by aocl_llc_setup(), released by aocl_llc_destroy() */
     //size_t chunk_size; //Unused variable
 } aocl_compression_desc;
 
+/**
+ * @brief Direction of a stream created by aocl_llc_stream_begin().
+ */
+typedef enum
+{
+    AOCL_STREAM_COMPRESS = 0, ///<Compress the data passed to aocl_llc_stream_update()
+    AOCL_STREAM_DECOMPRESS    ///<Decompress the data passed to aocl_llc_stream_update()
+} aocl_stream_mode;
+
+/**
+ * @brief Opaque state of a stream created by aocl_llc_stream_begin().
+ */
+typedef struct aocl_stream_s aocl_stream;
+
+/**
+ * @brief A buffer compressed or decompressed by aocl_llc_compress_batch() or
+ * aocl_llc_decompress_batch().
+ */
+typedef struct
+{
+    char *src;           /**<  Input buffer                                           */
+    size_t srcSize;      /**<  Input size                                             */
+    char *dst;           /**<  Output buffer                                          */
+    size_t dstCapacity;  /**<  Size of the output buffer                              */
+    int64_t result;      /**<  Set to the bytes written to dst, or an error code      */
+} aocl_batch_item;
+
 /**
  * @brief Interface API to compress data.
  * 
@@ -190,6 +218,108 @@ EXPORT_SYM_DYN int64_t aocl_llc_compress(aocl_compression_desc *handle,
 EXPORT_SYM_DYN int64_t aocl_llc_decompress(aocl_compression_desc *handle,
                               aocl_compression_type codec_type);
 
+/**
+ * @brief Interface API to decompress a range of the uncompressed data.
+ *
+ * Decompresses `length` bytes starting at byte `offset` of the uncompressed data
+ * of the stream in `handle->inBuf` into `handle->outBuf`. For streams produced by the
+ * multi-threaded compressor, only the partitions recorded in the RAP frame that cover
+ * the range, and the partitions they depend on, are decompressed. Other streams are
+ * decompressed up to the end of the range.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `outSize` must be at least `length`. |
+ * | \b codec_type | in          | Select the algorithm to be used for decompression, choose from aocl_compression_type. |
+ * | \b offset     | in          | Offset of the range in the uncompressed data. |
+ * | \b length     | in          | Length of the range. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    |Number of bytes decompressed. Less than `length` if the range runs past the end of the data |
+ * | Fail       |`ERR_INVALID_INPUT`               |
+ * | ^          |`ERR_EXCLUDED_METHOD`             |
+ * | ^          |`ERR_COMPRESSION_FAILED`          |
+ *
+ */
+EXPORT_SYM_DYN int64_t aocl_llc_decompress_range(aocl_compression_desc *handle,
+                              aocl_compression_type codec_type,
+                              uint64_t offset, uint64_t length);
+
+/**
+ * @brief Interface API to start a streaming compression or decompression.
+ *
+ * The data is then passed in pieces to aocl_llc_stream_update(), which uses a
+ * bounded amount of memory whatever the total size of the data. `handle->level`
+ * and `handle->optVar` are used as in aocl_llc_compress(). aocl_llc_setup() must
+ * have been called for `codec_type`.
+ *
+ * Streams of ZLIB, BZIP2 and ZSTD are in the standard format of their codec, and
+ * their decompression also reads the output of aocl_llc_compress(). LZMA streams hold
+ * the properties followed by independently coded chunks closed by an end marker;
+ * their decompression also reads the output of single-threaded aocl_llc_compress().
+ * LZ4, LZ4HC and SNAPPY streams are a sequence of blocks, each preceded by its
+ * compressed length in 4 little-endian bytes and ending with a zero length.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in          | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. |
+ * | \b codec_type | in          | Select the algorithm to be used, choose from aocl_compression_type. |
+ * | \b mode       | in          | Compress or decompress, choose from aocl_stream_mode. |
+ * | \b stream     | out         | Receives the new stream. Release it with aocl_llc_stream_end(). |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                           |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`        |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_stream_begin(aocl_compression_desc *handle,
+                              aocl_compression_type codec_type,
+                              aocl_stream_mode mode, aocl_stream **stream);
+
+/**
+ * @brief Interface API to pass the next piece of data through a stream.
+ *
+ * Consumes input from `handle->inBuf` and writes the result to `handle->outBuf`.
+ * On return, `handle->inBuf` and `handle->inSize` are advanced past the consumed
+ * input. Input left unconsumed because `handle->outBuf` is full must be passed again.
+ * Once all the input is passed, call with `finish` set until it returns 0, which
+ * marks the complete end of the stream. A decompression stream fails with
+ * `ERR_COMPRESSION_FAILED` when finished on a truncated stream.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `outSize` must be non-zero. |
+ * | \b stream     | in,out      | Stream created by aocl_llc_stream_begin(). |
+ * | \b finish     | in          | Non-zero when no more input follows. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    |Number of bytes written to `handle->outBuf` |
+ * | Fail       |`ERR_INVALID_INPUT`               |
+ * | ^          |`ERR_COMPRESSION_FAILED`          |
+ *
+ */
+EXPORT_SYM_DYN int64_t aocl_llc_stream_update(aocl_compression_desc *handle,
+                              aocl_stream *stream, int32_t finish);
+
+/**
+ * @brief Interface API to release a stream created by aocl_llc_stream_begin().
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b stream     | in          | Stream to release. NULL is accepted. |
+ *
+ * @return void
+ */
+EXPORT_SYM_DYN void aocl_llc_stream_end(aocl_stream *stream);
+
 /**
  * @brief Interface API to setup the compression method.
  * 
@@ -210,6 +340,138 @@ EXPORT_SYM_DYN int64_t aocl_llc_decompress(aocl_compression_desc *handle,
 EXPORT_SYM_DYN int32_t aocl_llc_setup(aocl_compression_desc *handle,
                       aocl_compression_type codec_type);
 
+/**
+ * @brief Interface API to load a dictionary for the compression method.
+ *
+ * The dictionary is digested once into the codec state held in `handle->workBuf`
+ * and used by every following aocl_llc_compress() and aocl_llc_decompress() call on
+ * the handle, until it is replaced by another call or the handle is destroyed. Data
+ * compressed with a dictionary must be decompressed with the same dictionary.
+ * Compression with a dictionary is single-threaded and does not apply to
+ * aocl_llc_decompress_range() or to streams.
+ *
+ * ZSTD accepts raw content or dictionaries in the zstd format, such as those trained
+ * by zstd. ZLIB and LZ4 use raw content, of which only the last 32KB and 64KB are
+ * referenced.
+ * aocl_llc_setup() must have been called for `codec_type`.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `level` is the compression level the dictionary is first prepared for. |
+ * | \b codec_type | in          | Select the algorithm to be used, choose from aocl_compression_type. Supported for LZ4, ZLIB and ZSTD. |
+ * | \b dict       | in          | Dictionary content. The library keeps its own copy. NULL along with a `dictSize` of 0 unloads the dictionary. |
+ * | \b dictSize   | in          | Length of the dictionary. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                           |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_UNSUPPORTED_METHOD`        |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`        |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_load_dictionary(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      const char *dict, size_t dictSize);
+
+/**
+ * @brief Interface API to train a dictionary on samples of the data to compress.
+ *
+ * The dictionary is built by the FASTCOVER algorithm of the zstd dictionary builder,
+ * whose search for the best segment parameters runs on `handle->numThreads` threads,
+ * or within the thread budget of the calling thread when it is 0 or less, in
+ * multi-threaded library builds.
+ * The result is passed to aocl_llc_load_dictionary(). For ZSTD it is in the zstd
+ * format, holding entropy tables along with the content. For other methods it is the
+ * raw content alone. aocl_llc_setup() need not be called.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b handle       | in          | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `level` is the ZSTD level the dictionary is tuned for. |
+ * | \b codec_type   | in          | Select the algorithm the dictionary is for, choose from aocl_compression_type. Supported for LZ4, ZLIB and ZSTD. |
+ * | \b samples      | in          | Samples stored one after the other. |
+ * | \b sampleSizes  | in          | Lengths of the `nbSamples` samples. |
+ * | \b nbSamples    | in          | Number of samples. |
+ * | \b dict         | out         | Receives the dictionary. |
+ * | \b dictCapacity | in          | Maximum size of the dictionary, at least 256 bytes. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    |Size of the dictionary written to `dict` |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_UNSUPPORTED_METHOD`        |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`        |
+ *
+ */
+EXPORT_SYM_DYN int64_t aocl_llc_train_dictionary(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      const char *samples, const size_t *sampleSizes,
+                      unsigned nbSamples, char *dict, size_t dictCapacity);
+
+/**
+ * @brief Interface API to compress a batch of independent buffers.
+ *
+ * Each item is compressed on its own, giving the same output as aocl_llc_compress()
+ * with the same handle. The timing and logging of the call are done once for the whole
+ * batch, and the dispatch once for each thread. In multi-threaded library builds the
+ * items are spread across `handle->numThreads` threads, or the thread budget of the
+ * calling thread when it is 0 or less. Each thread uses its own copy of the codec state
+ * in `handle->workBuf`, dictionary included. The copies are kept in `handle->batchBuf`
+ * for the following batches until aocl_llc_destroy(), or aocl_llc_load_dictionary(),
+ * releases them. aocl_llc_setup() must have been called for `codec_type`.
+ * With `handle->measureStats` set, `cSize`, `cTime` and `cSpeed` hold totals of the batch.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `inBuf` and `outBuf` are unused. |
+ * | \b codec_type | in          | Select the algorithm to be used for compression, choose from aocl_compression_type. |
+ * | \b items      | in,out      | Buffers to compress. `result` of each item is set. |
+ * | \b nbItems    | in          | Number of items. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0, all items compressed      |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`, set when any item failed |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_compress_batch(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      aocl_batch_item *items, size_t nbItems);
+
+/**
+ * @brief Interface API to decompress a batch of independent buffers.
+ *
+ * Each item is decompressed on its own as by aocl_llc_decompress(), spread across
+ * threads as in aocl_llc_compress_batch().
+ * With `handle->measureStats` set, `dSize`, `dTime` and `dSpeed` hold totals of the batch.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. `inBuf` and `outBuf` are unused. |
+ * | \b codec_type | in          | Select the algorithm to be used for decompression, choose from aocl_compression_type. |
+ * | \b items      | in,out      | Buffers to decompress. `result` of each item is set. |
+ * | \b nbItems    | in          | Number of items. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0, all items decompressed    |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`, set when any item failed |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_decompress_batch(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      aocl_batch_item *items, size_t nbItems);
+
 /**
  * @brief Interface API to destroy the compression method.
  * 
@@ -32,7 +32,8 @@
  *  in AOCL-Compression library
  *
  *  This file contains APIs that can be used to interpret streams
- *  produced by AOCL-Compression library with multi-threaded support.
+ *  produced by AOCL-Compression library with multi-threaded support,
+ *  and APIs that run compression on library-owned threads.
  *
  *  @author S. Biplab Raut
  */
@@ -42,6 +43,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "aocl_compression.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -132,6 +134,336 @@ EXPORT_SYM_DYN int32_t aocl_get_rap_frame_bound_mt(void);
  */
 EXPORT_SYM_DYN int32_t aocl_skip_rap_frame_mt(char* src, int32_t src_size);
 
+/**
+ * @brief Interface API to set the number of threads that multi-threaded compression and
+ * decompression may use on the calling thread.
+ *
+ * The budget applies to the later calls made from the calling thread, including calls to the
+ * native codec APIs. The aocl_llc_* APIs replace it with aocl_compression_desc::numThreads of their
+ * handle, when above 0, for the duration of each call, and restore it before they return. The
+ * number of threads used is also capped by omp_get_max_threads() and by the cgroup CPU quota of
+ * the process, so that a container never runs more threads than its quota allows.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b numThreads   | in          | Maximum number of threads. 0 or less for all available threads. |
+ *
+ */
+EXPORT_SYM_DYN void aocl_set_num_threads_mt(int32_t numThreads);
+
+/**
+ * @brief Interface API to get the number of threads that multi-threaded compression and
+ * decompression may use on the calling thread.
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | numThreads | Budget set by aocl_set_num_threads_mt(), capped by the available threads |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_get_num_threads_mt(void);
+
+/**
+ * @brief Partition sizing modes of the multi-threaded compressors.
+ *
+ * The adaptive modes sample the entropy and the density of short matches of the source at a few
+ * offsets before partitioning it. Compressible data gets fewer, larger partitions, which keep more
+ * matches, and incompressible data gets more, smaller partitions, which balance the load across
+ * threads. The mode sets how far each trade-off goes. Fewer partitions than threads leave the
+ * extra threads unused.
+ */
+typedef enum
+{
+    AOCL_PARTITION_FIXED = 0,         /**< Partitions of at least the codec's window length times its window factor (default) */
+    AOCL_PARTITION_ADAPTIVE_SPEED,    /**< Favor throughput: keep many partitions, only halving them on incompressible data */
+    AOCL_PARTITION_ADAPTIVE_BALANCED, /**< Halve partitions on incompressible data and double them on compressible data */
+    AOCL_PARTITION_ADAPTIVE_RATIO,    /**< Favor ratio: up to four times larger partitions, one per thread on compressible data */
+    AOCL_PARTITION_MODES_NUM          /**< Number of modes */
+} aocl_partition_mode;
+
+/**
+ * @brief Interface API to set the partition sizing mode of multi-threaded compression on the
+ * calling thread.
+ *
+ * As the thread budget of aocl_set_num_threads_mt(), the mode applies to the later calls made
+ * from the calling thread, through the aocl_llc_* APIs or the native codec APIs. Streams
+ * compressed in any mode are decompressed the same way.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b mode         | in          | One of aocl_partition_mode. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                |
+ * | Fail       |`ERR_INVALID_INPUT`, mode is not an aocl_partition_mode |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_set_partition_mode_mt(int32_t mode);
+
+/**
+ * @brief Interface API to get the partition sizing mode of multi-threaded compression on the
+ * calling thread.
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | mode       | Mode set by aocl_set_partition_mode_mt(), AOCL_PARTITION_FIXED when not set |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_get_partition_mode_mt(void);
+
+/**
+ * @brief Interface API to enable or disable dictionary priming of multi-threaded compression on
+ * the calling thread.
+ *
+ * Partitions of a multi-threaded compressor start with an empty history, so the matches that
+ * cross a partition boundary are lost. With priming, the partitions of LZ4 are grouped in one
+ * chain per thread, and every partition but the first of a chain starts with the last 64 KB of
+ * the previous partition as dictionary. The multi-threaded decompressor decompresses each chain
+ * as a whole, so streams decompress with as many threads as chains, and remain readable by the
+ * single-threaded decompressor. Other codecs ignore the setting: Snappy, for one, never matches
+ * across the 64 KB blocks it compresses independently. Like aocl_set_partition_mode_mt(), it
+ * applies to the later calls made from the calling thread, and priming is disabled by default.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b enable       | in          | 1 to enable priming, 0 to disable it. |
+ *
+ */
+EXPORT_SYM_DYN void aocl_set_dict_priming_mt(int32_t enable);
+
+/**
+ * @brief Interface API to get the dictionary priming setting of multi-threaded compression on
+ * the calling thread.
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | enable     | 1 when enabled by aocl_set_dict_priming_mt(), 0 otherwise |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_get_dict_priming_mt(void);
+
+/**
+ * @brief Task submitted to an aocl_executor.
+ */
+typedef void (*aocl_executor_task)(void *arg);
+
+/**
+ * @brief Thread pool supplied by the host application to run the multi-threaded codecs.
+ *
+ * A parallel region of a codec creates a wait group, submits one task per extra worker
+ * to it, runs the first worker on the calling thread and then waits for the group.
+ * Workers share the partitions of the region, so a region completes even when the pool
+ * runs its tasks late or one after the other. `wait` must not return before all the tasks
+ * submitted to the group have run. It should run pending tasks of the group itself
+ * when the calling thread may be a thread of the pool.
+ */
+typedef struct
+{
+    void *ctx;                                        /**< Passed to the callbacks below */
+    void *(*create_group)(void *ctx);                 /**< Returns a new wait group, or NULL on failure */
+    int32_t (*submit)(void *ctx, void *group,
+                      aocl_executor_task task, void *arg); /**< Queues task(arg) in the group. Returns 0 on success */
+    void (*wait)(void *ctx, void *group);             /**< Waits for all tasks of the group to complete and releases the group */
+    int32_t numThreads;                               /**< Threads of the pool. 0 or less to keep omp_get_max_threads() */
+} aocl_executor;
+
+/**
+ * @brief Interface API to run the multi-threaded codecs on a thread pool of the application.
+ *
+ * Once an executor is registered, the parallel regions of the multi-threaded compressors and
+ * decompressors, of batch calls and of dictionary training submit their work to it instead of
+ * starting OpenMP threads. The tasks may run on any thread: the workers of a region
+ * synchronize through locks of the library, not OpenMP. The executor is copied, and the copy
+ * is published at once, so it may be replaced or removed while calls are in flight. Calls
+ * already running keep the executor they started with, so the application must keep a
+ * replaced pool running until they complete.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b executor     | in          | Executor to use, or NULL to go back to OpenMP. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                |
+ * | Fail       |`ERR_INVALID_INPUT`, a callback is NULL. The registered executor is kept |
+ * | ^          |`ERR_COMPRESSION_FAILED`, the executor could not be copied |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_set_executor(const aocl_executor *executor);
+
+/**
+ * @brief Interface API to enable or disable NUMA aware placement of the multi-threaded codecs.
+ *
+ * On Linux® systems with more than one NUMA node, each thread of a multi-threaded compressor or
+ * decompressor starts with the partitions whose source pages are on its own node, and steals
+ * pending partitions of its node before those of other nodes. Per thread buffers kept across
+ * calls are moved to the node of the thread that reuses them. Placement is enabled by default
+ * and has no effect on single node systems and other platforms.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b enable       | in          | 1 to enable placement, 0 to disable it. |
+ *
+ */
+EXPORT_SYM_DYN void aocl_set_numa_placement_mt(int32_t enable);
+
+/**
+ * @brief Partitions processed by the multi-threaded codecs on the NUMA node holding their source,
+ * and on other nodes.
+ *
+ * Only partitions whose source node is known are counted, so all the counts stay 0 on single
+ * node systems. Bytes are the source bytes of the partitions: uncompressed bytes for compression
+ * and compressed bytes for decompression.
+ */
+typedef struct
+{
+    uint32_t numNodes;          /**< Online NUMA nodes. 1 when the system is not NUMA */
+    uint64_t localPartitions;   /**< Partitions processed on the node holding their source */
+    uint64_t remotePartitions;  /**< Partitions processed on another node */
+    uint64_t localBytes;        /**< Source bytes of the local partitions */
+    uint64_t remoteBytes;       /**< Source bytes of the remote partitions */
+} aocl_numa_stats;
+
+/**
+ * @brief Interface API to get the NUMA statistics of the multi-threaded codecs.
+ *
+ * Statistics are process wide and accumulate over all the calls since the last reset.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b stats        | out         | Receives the statistics. May be NULL when reset is set. |
+ * | \b reset        | in          | When not 0, the statistics are cleared after being read. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                |
+ * | Fail       |`ERR_INVALID_INPUT`, stats is NULL and reset is 0 |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_get_numa_stats_mt(aocl_numa_stats *stats, int32_t reset);
+
+/**
+ * @brief Completion callback of a job queued by aocl_llc_compress_async() or
+ * aocl_llc_decompress_async().
+ *
+ * Called on a library-owned thread with the `userData` given at submission and the
+ * value aocl_llc_compress() or aocl_llc_decompress() would have returned. It should
+ * return quickly, as the thread runs other jobs after it. It must not call
+ * aocl_llc_async_wait() on its own job.
+ */
+typedef void (*aocl_async_callback)(void *userData, int64_t result);
+
+/**
+ * @brief Opaque state of a job queued by aocl_llc_compress_async() or
+ * aocl_llc_decompress_async().
+ */
+typedef struct aocl_async_job_s aocl_async_job;
+
+/**
+ * @brief Interface API to compress data on a library-owned thread.
+ *
+ * The job runs aocl_llc_compress() on `handle` on a thread of a pool that the library
+ * starts on first use, and the call returns as soon as it is queued. The handle and
+ * its buffers must not be used or freed until the job completes, so a handle runs one
+ * job at a time: use one handle per job in flight. Completion is signalled through
+ * `callback`, through aocl_llc_async_poll(), or both.
+ *
+ * The job runs with the partition sizing mode and dictionary priming of the calling
+ * thread at the time of the call. It asks for `handle->numThreads` threads, or the
+ * thread budget of the calling thread when it is 0 or less, and the jobs in flight
+ * share the available threads: a job gets what the running jobs leave free, at least one.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. |
+ * | \b codec_type | in          | Select the algorithm to be used for compression, choose from aocl_compression_type. |
+ * | \b callback   | in          | Called on completion. May be NULL. |
+ * | \b userData   | in          | Passed to `callback`. |
+ * | \b job        | out         | Receives the job, to be released by aocl_llc_async_wait(). When NULL, the job is released by the library on completion, and only `callback` reports it. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                           |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`, the job could not be queued |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_compress_async(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      aocl_async_callback callback, void *userData,
+                      aocl_async_job **job);
+
+/**
+ * @brief Interface API to decompress data on a library-owned thread.
+ *
+ * As aocl_llc_compress_async(), with the job running aocl_llc_decompress().
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b handle     | in,out      | This acts as a handle for compression and decompression. For more information, refer to aocl_compression_desc. |
+ * | \b codec_type | in          | Select the algorithm to be used for decompression, choose from aocl_compression_type. |
+ * | \b callback   | in          | Called on completion. May be NULL. |
+ * | \b userData   | in          | Passed to `callback`. |
+ * | \b job        | out         | Receives the job, to be released by aocl_llc_async_wait(). When NULL, the job is released by the library on completion, and only `callback` reports it. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | \b 0                           |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ * | ^          |`ERR_EXCLUDED_METHOD`           |
+ * | ^          |`ERR_COMPRESSION_FAILED`, the job could not be queued |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_decompress_async(aocl_compression_desc *handle,
+                      aocl_compression_type codec_type,
+                      aocl_async_callback callback, void *userData,
+                      aocl_async_job **job);
+
+/**
+ * @brief Interface API to check whether an asynchronous job has completed, without blocking.
+ *
+ * A job is complete once its callback, if any, has returned.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b job        | in          | Job returned by aocl_llc_compress_async() or aocl_llc_decompress_async(). |
+ * | \b result     | out         | Receives the result of the job once complete. May be NULL. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Complete   | \b 1                           |
+ * | Pending    | \b 0                           |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ *
+ */
+EXPORT_SYM_DYN int32_t aocl_llc_async_poll(aocl_async_job *job, int64_t *result);
+
+/**
+ * @brief Interface API to wait for an asynchronous job to complete and release it.
+ *
+ * | Parameters    | Direction   | Description |
+ * |:--------------|:-----------:|:------------|
+ * | \b job        | in          | Job returned by aocl_llc_compress_async() or aocl_llc_decompress_async(). It must not be used after this call. |
+ *
+ * @return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Result of the job, as returned by aocl_llc_compress() or aocl_llc_decompress() |
+ * | Fail       |`ERR_INVALID_INPUT`             |
+ *
+ */
+EXPORT_SYM_DYN int64_t aocl_llc_async_wait(aocl_async_job *job);
+
 /**
  * @}
  */
@@ -40,10 +40,71 @@
 #include "utils/utils.h"
 #include "aocl_compression.h"
 #include "codec.h"
+#include <cstdlib>
+#ifdef AOCL_ENABLE_THREADS
+#include <atomic>
+#include "threads/threads.h"
+#include "threads/async_pool.h"
+#endif
 
-//Unified API function to compress the input
-AOCL_INT64 aocl_llc_compress(aocl_compression_desc *handle,
-                        aocl_compression_type codec_type)
+//Sets up the dispatcher of the calling thread with the optimization settings of the handle.
+//Function pointers of the codecs are thread local: handles with different settings can run
+//at the same time, and a thread switching between them only re-registers the pointers.
+//Multi-threaded codecs run on up to numThreads threads, handle->numThreads for all but async
+//jobs, or within the budget of the caller when it is 0 or less. Returns the budget of the caller,
+//which aocl_llc_release() puts back before the API returns.
+static inline AOCL_INT32 aocl_llc_dispatch(aocl_compression_desc *handle,
+                        aocl_compression_type codec_type, AOCL_INT32 numThreads)
+{
+    if (aocl_codec[codec_type].dispatch)
+        aocl_codec[codec_type].dispatch(handle->optOff, handle->optLevel);
+#ifdef AOCL_ENABLE_THREADS
+    return aocl_swap_num_threads_mt(numThreads);
+#else
+    (AOCL_VOID)numThreads;
+    return 0;
+#endif
+}
+
+//Restores the thread budget of the caller replaced by aocl_llc_dispatch()
+static inline AOCL_VOID aocl_llc_release(AOCL_INT32 budget)
+{
+#ifdef AOCL_ENABLE_THREADS
+    aocl_set_num_threads_mt(budget);
+#else
+    (AOCL_VOID)budget;
+#endif
+}
+
+#ifdef AOCL_ENABLE_THREADS
+//Copies of handle->workBuf made for the workers of the batch APIs. They are kept in
+//handle->batchBuf across calls and released by aocl_llc_destroy()
+typedef struct {
+    aocl_compression_type codec_type;   //codec owning the copies
+    AOCL_INT32 nbWorkers;               //entries of workBuf
+    AOCL_CHAR **workBuf;                //workmem of each worker, handle->workBuf for the first
+} aocl_batch_workmem_t;
+
+//Releases the copies of the workmem kept by the batch APIs
+static AOCL_VOID aocl_llc_batch_release(aocl_compression_desc *handle)
+{
+    aocl_batch_workmem_t *cache = (aocl_batch_workmem_t *)handle->batchBuf;
+    if (cache == NULL)
+        return;
+    for (AOCL_INT32 w = 1; w < cache->nbWorkers; w++)
+    {
+        if (cache->workBuf[w])
+            aocl_codec[cache->codec_type].free_workmem(cache->workBuf[w]);
+    }
+    free(cache->workBuf);
+    free(cache);
+    handle->batchBuf = NULL;
+}
+#endif
+
+//Body of aocl_llc_compress(), running multi-threaded codecs on up to numThreads threads
+static AOCL_INT64 aocl_llc_compress_run(aocl_compression_desc *handle,
+                        aocl_compression_type codec_type, AOCL_INT32 numThreads)
 {
     AOCL_INT64 ret;
 #ifdef WIN32
@@ -55,6 +116,7 @@ AOCL_INT64 aocl_llc_compress(aocl_compression_desc *handle,
 
     LOG_FORMATTED(INFO, logCtx,
        "Calling compression method: %s", aocl_codec[codec_type].codec_name);
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, numThreads);
     initTimer(clkTick);
     getTime(startTime);
     
@@ -67,6 +129,7 @@ AOCL_INT64 aocl_llc_compress(aocl_compression_desc *handle,
                                           handle->workBuf);
     
     getTime(endTime);
+    aocl_llc_release(budget);
     if (handle->measureStats == 1)
     {
         handle->cSize = ret;
@@ -82,9 +145,16 @@ AOCL_INT64 aocl_llc_compress(aocl_compression_desc *handle,
     return ret;
 }
 
-//Unified API function to decompress the input
-AOCL_INT64 aocl_llc_decompress(aocl_compression_desc *handle,
-                          aocl_compression_type codec_type)
+//Unified API function to compress the input
+AOCL_INT64 aocl_llc_compress(aocl_compression_desc *handle,
+                        aocl_compression_type codec_type)
+{
+    return aocl_llc_compress_run(handle, codec_type, handle->numThreads);
+}
+
+//Body of aocl_llc_decompress(), running multi-threaded codecs on up to numThreads threads
+static AOCL_INT64 aocl_llc_decompress_run(aocl_compression_desc *handle,
+                          aocl_compression_type codec_type, AOCL_INT32 numThreads)
 {
     AOCL_INT64 ret;
 #ifdef WIN32
@@ -96,6 +166,7 @@ AOCL_INT64 aocl_llc_decompress(aocl_compression_desc *handle,
 
     LOG_FORMATTED(INFO, logCtx,
        "Calling decompression method: %s", aocl_codec[codec_type].codec_name);
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, numThreads);
     initTimer(clkTick);
     getTime(startTime);
     
@@ -108,6 +179,7 @@ AOCL_INT64 aocl_llc_decompress(aocl_compression_desc *handle,
                                             handle->workBuf);
     
     getTime(endTime);
+    aocl_llc_release(budget);
     if (handle->measureStats == 1)
     {
         handle->dSize = ret;
@@ -123,6 +195,183 @@ AOCL_INT64 aocl_llc_decompress(aocl_compression_desc *handle,
     return ret;
 }
 
+//Unified API function to decompress the input
+AOCL_INT64 aocl_llc_decompress(aocl_compression_desc *handle,
+                          aocl_compression_type codec_type)
+{
+    return aocl_llc_decompress_run(handle, codec_type, handle->numThreads);
+}
+
+//Unified API function to decompress a range of the uncompressed data
+AOCL_INT64 aocl_llc_decompress_range(aocl_compression_desc *handle,
+                          aocl_compression_type codec_type,
+                          AOCL_UINT64 offset, AOCL_UINT64 length)
+{
+    AOCL_INT64 ret;
+#ifdef WIN32
+    timer clkTick;
+#endif
+    timeVal startTime, endTime;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || (codec_type < LZ4) || (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM) ||
+        handle->inBuf == NULL || handle->outBuf == NULL || length > handle->outSize)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "decompress range failed !! invalid input.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    if (aocl_codec[codec_type].decompress_range == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "decompress range failed !! compression method is excluded from this library build.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    LOG_FORMATTED(INFO, logCtx,
+       "Calling decompression range method: %s", aocl_codec[codec_type].codec_name);
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, handle->numThreads);
+    initTimer(clkTick);
+    getTime(startTime);
+
+    ret = aocl_codec[codec_type].decompress_range (handle->inBuf,
+                                                  handle->inSize,
+                                                  handle->outBuf,
+                                                  (AOCL_UINTP)length,
+                                                  offset,
+                                                  handle->workBuf);
+
+    getTime(endTime);
+    aocl_llc_release(budget);
+    if (handle->measureStats == 1)
+    {
+        handle->dSize = ret;
+        handle->dTime = diffTime(clkTick, startTime, endTime);
+        handle->dSpeed = (handle->dSize * 1000.0) / handle->dTime;
+    }
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+
+    if (ret < 0)
+        return ERR_COMPRESSION_FAILED;
+
+    return ret;
+}
+
+struct aocl_stream_s
+{
+    aocl_compression_type codec_type;
+    AOCL_CHAR *state;
+};
+
+//Unified API function to start a streaming compression or decompression
+AOCL_INT32 aocl_llc_stream_begin(aocl_compression_desc *handle,
+                          aocl_compression_type codec_type,
+                          aocl_stream_mode mode, aocl_stream **stream)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || stream == NULL || (codec_type < LZ4) ||
+        (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM) ||
+        (mode != AOCL_STREAM_COMPRESS && mode != AOCL_STREAM_DECOMPRESS))
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "stream begin failed !! invalid input.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+    *stream = NULL;
+
+    if (aocl_codec[codec_type].stream_create == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "stream begin failed !! compression method is excluded from this library build.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    LOG_FORMATTED(INFO, logCtx,
+       "Calling stream %s method: %s", (mode == AOCL_STREAM_COMPRESS) ? "compression" :
+       "decompression", aocl_codec[codec_type].codec_name);
+
+    aocl_stream *strm = (aocl_stream *)malloc(sizeof(aocl_stream));
+    if (strm == NULL)
+    {
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_COMPRESSION_FAILED;
+    }
+    strm->codec_type = codec_type;
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, handle->numThreads);
+    strm->state = aocl_codec[codec_type].stream_create (mode == AOCL_STREAM_DECOMPRESS,
+                                                       handle->level,
+                                                       handle->optVar);
+    aocl_llc_release(budget);
+    if (strm->state == NULL)
+    {
+        free(strm);
+        LOG_UNFORMATTED(ERR, logCtx,
+            "stream begin failed !! could not create the stream.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_COMPRESSION_FAILED;
+    }
+    *stream = strm;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+    return 0;
+}
+
+//Unified API function to pass the next piece of data through a stream
+AOCL_INT64 aocl_llc_stream_update(aocl_compression_desc *handle,
+                          aocl_stream *stream, AOCL_INT32 finish)
+{
+    AOCL_INT64 ret;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || stream == NULL || (handle->inBuf == NULL && handle->inSize > 0) ||
+        handle->outBuf == NULL || handle->outSize == 0)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "stream update failed !! invalid input.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, stream->codec_type, handle->numThreads);
+    ret = aocl_codec[stream->codec_type].stream_update (stream->state,
+                                                       &handle->inBuf,
+                                                       &handle->inSize,
+                                                       handle->outBuf,
+                                                       handle->outSize,
+                                                       finish);
+    aocl_llc_release(budget);
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+
+    if (ret < 0)
+        return ERR_COMPRESSION_FAILED;
+
+    return ret;
+}
+
+//Unified API function to release a stream
+AOCL_VOID aocl_llc_stream_end(aocl_stream *stream)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (stream)
+    {
+        aocl_codec[stream->codec_type].stream_free(stream->state);
+        free(stream);
+    }
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+}
+
 //API to setup and initialize memory for the compression method
 AOCL_INT32 aocl_llc_setup(aocl_compression_desc *handle,
                     aocl_compression_type codec_type)
@@ -141,6 +390,7 @@ AOCL_INT32 aocl_llc_setup(aocl_compression_desc *handle,
        "All optimizations are turned %s", (handle->optOff ? "off" : "on"));
 
     set_cpu_opt_flags((AOCL_VOID *)handle);
+    handle->batchBuf = NULL;
 
     LOG_FORMATTED(INFO, logCtx,
        "Calling setup method for: %s", aocl_codec[codec_type].codec_name);
@@ -165,6 +415,460 @@ AOCL_INT32 aocl_llc_setup(aocl_compression_desc *handle,
     return 0;
 }
 
+//API to load a dictionary used by the following calls on the handle
+AOCL_INT32 aocl_llc_load_dictionary(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type,
+                    const AOCL_CHAR *dict, AOCL_UINTP dictSize)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || (codec_type < LZ4) || (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM) ||
+        (dict == NULL && dictSize > 0))
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "load dictionary failed !! invalid input.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    if (aocl_codec[codec_type].setup == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "load dictionary failed !! compression method is excluded from this library build.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    if (aocl_codec[codec_type].load_dictionary == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "load dictionary failed !! compression method does not support dictionaries.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_UNSUPPORTED_METHOD;
+    }
+
+    LOG_FORMATTED(INFO, logCtx,
+       "Calling load dictionary method for: %s", aocl_codec[codec_type].codec_name);
+
+#ifdef AOCL_ENABLE_THREADS
+    //Copies made for batch workers hold the previous dictionary
+    aocl_llc_batch_release(handle);
+#endif
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, handle->numThreads);
+    AOCL_INT32 ret = aocl_codec[codec_type].load_dictionary (&handle->workBuf,
+                                                dict,
+                                                dictSize,
+                                                handle->level);
+    aocl_llc_release(budget);
+    if (ret != 0)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "load dictionary failed !! could not prepare the dictionary.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_COMPRESSION_FAILED;
+    }
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+    return 0;
+}
+
+//API to train a dictionary on samples of the data to compress
+AOCL_INT64 aocl_llc_train_dictionary(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type,
+                    const AOCL_CHAR *samples, const AOCL_UINTP *sampleSizes,
+                    AOCL_UINT32 nbSamples, AOCL_CHAR *dict, AOCL_UINTP dictCapacity)
+{
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || (codec_type < LZ4) || (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM) ||
+        samples == NULL || sampleSizes == NULL || nbSamples == 0 || dict == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "train dictionary failed !! invalid input.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    if (aocl_codec[codec_type].setup == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "train dictionary failed !! compression method is excluded from this library build.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    if (aocl_codec[codec_type].load_dictionary == NULL)
+    {
+        LOG_UNFORMATTED(ERR, logCtx,
+            "train dictionary failed !! compression method does not support dictionaries.");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_UNSUPPORTED_METHOD;
+    }
+
+#ifdef AOCL_EXCLUDE_ZSTD
+    LOG_UNFORMATTED(ERR, logCtx,
+        "train dictionary failed !! zstd dictionary builder is excluded from this library build.");
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+    return ERR_EXCLUDED_METHOD;
+#else
+    LOG_FORMATTED(INFO, logCtx,
+       "Calling train dictionary method for: %s", aocl_codec[codec_type].codec_name);
+
+    AOCL_INT64 ret = aocl_zstd_train_dictionary(samples, sampleSizes, nbSamples, dict, dictCapacity,
+                                     handle->level, handle->numThreads, codec_type != ZSTD);
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+
+    if (ret < 0)
+        return ERR_COMPRESSION_FAILED;
+
+    return ret;
+#endif
+}
+
+//Compress or decompress a single item of a batch, returns 1 on failure
+static AOCL_INT32 aocl_llc_batch_item(aocl_compression_desc *handle, comp_decomp_fp codec_fn,
+                    aocl_batch_item *item, AOCL_CHAR *workBuf)
+{
+    if ((item->src == NULL && item->srcSize > 0) || item->dst == NULL)
+    {
+        item->result = ERR_INVALID_INPUT;
+        return 1;
+    }
+    AOCL_INT64 ret = codec_fn(item->src, item->srcSize, item->dst, item->dstCapacity,
+                              handle->level, handle->optVar, workBuf);
+    item->result = (ret < 0) ? ERR_COMPRESSION_FAILED : ret;
+    return (ret < 0);
+}
+
+#ifdef AOCL_ENABLE_THREADS
+//Returns the workmem of up to maxWorkers workers held in handle->batchBuf, making the
+//copies still missing, and sets *nbWorkers to the number of workers that have one
+static AOCL_CHAR **aocl_llc_batch_workmem(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, AOCL_INT32 maxWorkers,
+                    AOCL_INT32 *nbWorkers)
+{
+    aocl_batch_workmem_t *cache = (aocl_batch_workmem_t *)handle->batchBuf;
+    *nbWorkers = 1;
+    //Copies of another codec or of a workmem set up again are not used
+    if (cache != NULL && (cache->codec_type != codec_type ||
+        (cache->nbWorkers > 0 && cache->workBuf[0] != handle->workBuf)))
+    {
+        aocl_llc_batch_release(handle);
+        cache = NULL;
+    }
+    if (cache == NULL)
+    {
+        cache = (aocl_batch_workmem_t *)malloc(sizeof(aocl_batch_workmem_t));
+        if (cache == NULL)
+            return NULL;
+        cache->codec_type = codec_type;
+        cache->nbWorkers = 0;
+        cache->workBuf = NULL;
+        handle->batchBuf = (AOCL_CHAR *)cache;
+    }
+    if (cache->nbWorkers < maxWorkers)
+    {
+        AOCL_CHAR **workBuf = (AOCL_CHAR **)realloc(cache->workBuf, maxWorkers * sizeof(AOCL_CHAR *));
+        if (workBuf == NULL)
+            return NULL;
+        cache->workBuf = workBuf;
+        if (cache->nbWorkers == 0)
+            workBuf[cache->nbWorkers++] = handle->workBuf;
+        //Workers other than the first need their own copy of a non-NULL workmem
+        for (; cache->nbWorkers < maxWorkers; cache->nbWorkers++)
+        {
+            if (handle->workBuf == NULL)
+                workBuf[cache->nbWorkers] = NULL;
+            else if (aocl_codec[codec_type].clone_workmem == NULL ||
+                     (workBuf[cache->nbWorkers] = aocl_codec[codec_type].clone_workmem(handle->workBuf)) == NULL)
+                break;
+        }
+    }
+    *nbWorkers = (cache->nbWorkers < maxWorkers) ? cache->nbWorkers : maxWorkers;
+    return cache->workBuf;
+}
+
+//Arguments shared by the workers of a batch
+typedef struct {
+    aocl_compression_desc *handle;
+    aocl_compression_type codec_type;
+    comp_decomp_fp codec_fn;
+    aocl_batch_item *items;
+    AOCL_INTP nbItems;
+    std::atomic<AOCL_INTP> nextItem;    //next item to take
+    AOCL_CHAR **workBuf;                //workmem of each worker
+} aocl_batch_args_t;
+
+//aocl_run_parallel_mt() worker taking the items of a batch one at a time
+static AOCL_VOID aocl_llc_batch_worker(AOCL_VOID *arg, AOCL_UINT32 worker_id)
+{
+    aocl_batch_args_t *args = (aocl_batch_args_t *)arg;
+    AOCL_INTP i;
+    //Dispatch is set up once per worker for all the items it takes
+    AOCL_INT32 budget = aocl_llc_dispatch(args->handle, args->codec_type, args->handle->numThreads);
+    while ((i = args->nextItem++) < args->nbItems)
+    {
+        aocl_llc_batch_item(args->handle, args->codec_fn, &args->items[i],
+                            args->workBuf[worker_id]);
+    }
+    aocl_llc_release(budget);
+}
+#endif
+
+//Compress or decompress each item of a batch with the workmem of a worker
+static AOCL_INT32 aocl_llc_batch_items(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, aocl_batch_item *items,
+                    AOCL_UINTP nbItems, AOCL_INTP decompress)
+{
+    comp_decomp_fp codec_fn = decompress ? aocl_codec[codec_type].decompress :
+                                           aocl_codec[codec_type].compress;
+    AOCL_INT32 failed = 0;
+
+#ifdef AOCL_ENABLE_THREADS
+    AOCL_INT32 maxWorkers = (AOCL_INT32)aocl_get_available_threads_mt();
+    AOCL_INT32 numThreads = (handle->numThreads > 0) ? handle->numThreads : aocl_get_num_threads_mt();
+    if (numThreads < maxWorkers)
+        maxWorkers = numThreads;
+    AOCL_INT32 nbWorkers = 1;
+    AOCL_CHAR **workBuf = NULL;
+    if ((AOCL_UINTP)maxWorkers > nbItems)
+        maxWorkers = (AOCL_INT32)nbItems;
+    if (maxWorkers > 1)
+        workBuf = aocl_llc_batch_workmem(handle, codec_type, maxWorkers, &nbWorkers);
+
+    if (nbWorkers > 1)
+    {
+        aocl_batch_args_t args;
+        args.handle = handle;
+        args.codec_type = codec_type;
+        args.codec_fn = codec_fn;
+        args.items = items;
+        args.nbItems = (AOCL_INTP)nbItems;
+        args.nextItem = 0;
+        args.workBuf = workBuf;
+        aocl_run_parallel_mt(aocl_llc_batch_worker, &args, nbWorkers);
+        for (AOCL_UINTP i = 0; i < nbItems; i++)
+        {
+            failed |= (items[i].result < 0);
+        }
+        return failed;
+    }
+    //No copy of the workmem could be made: run on this thread alone
+#endif
+
+    AOCL_INT32 budget = aocl_llc_dispatch(handle, codec_type, handle->numThreads);
+    for (AOCL_UINTP i = 0; i < nbItems; i++)
+    {
+        failed |= aocl_llc_batch_item(handle, codec_fn, &items[i], handle->workBuf);
+    }
+    aocl_llc_release(budget);
+    return failed;
+}
+
+//Common body of the batch APIs
+static AOCL_INT32 aocl_llc_batch(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, aocl_batch_item *items,
+                    AOCL_UINTP nbItems, AOCL_INTP decompress)
+{
+#ifdef WIN32
+    timer clkTick;
+#endif
+    timeVal startTime, endTime;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (handle == NULL || (codec_type < LZ4) || (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM) ||
+        (items == NULL && nbItems > 0))
+    {
+        LOG_FORMATTED(ERR, logCtx,
+            "batch %s failed !! invalid input.", decompress ? "decompression" : "compression");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    if (aocl_codec[codec_type].setup == NULL)
+    {
+        LOG_FORMATTED(ERR, logCtx,
+            "batch %s failed !! compression method is excluded from this library build.", decompress ? "decompression" : "compression");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    LOG_FORMATTED(INFO, logCtx,
+       "Calling batch %s method: %s for %zu items",
+       decompress ? "decompression" : "compression",
+       aocl_codec[codec_type].codec_name, (size_t)nbItems);
+    initTimer(clkTick);
+    getTime(startTime);
+
+    AOCL_INT32 failed = aocl_llc_batch_items(handle, codec_type, items, nbItems, decompress);
+
+    getTime(endTime);
+    if (handle->measureStats == 1)
+    {
+        AOCL_UINT64 inSize = 0, outSize = 0;
+        for (AOCL_UINTP i = 0; i < nbItems; i++)
+        {
+            inSize += items[i].srcSize;
+            if (items[i].result > 0)
+                outSize += items[i].result;
+        }
+        if (decompress)
+        {
+            handle->dSize = outSize;
+            handle->dTime = diffTime(clkTick, startTime, endTime);
+            handle->dSpeed = (outSize * 1000.0) / handle->dTime;
+        }
+        else
+        {
+            handle->cSize = outSize;
+            handle->cTime = diffTime(clkTick, startTime, endTime);
+            handle->cSpeed = (inSize * 1000.0) / handle->cTime;
+        }
+    }
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+
+    if (failed)
+        return ERR_COMPRESSION_FAILED;
+
+    return 0;
+}
+
+//API to compress a batch of independent buffers
+AOCL_INT32 aocl_llc_compress_batch(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type,
+                    aocl_batch_item *items, AOCL_UINTP nbItems)
+{
+    return aocl_llc_batch(handle, codec_type, items, nbItems, 0);
+}
+
+//API to decompress a batch of independent buffers
+AOCL_INT32 aocl_llc_decompress_batch(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type,
+                    aocl_batch_item *items, AOCL_UINTP nbItems)
+{
+    return aocl_llc_batch(handle, codec_type, items, nbItems, 1);
+}
+
+#ifdef AOCL_ENABLE_THREADS
+typedef struct
+{
+    aocl_compression_desc *handle;
+    aocl_compression_type codec_type;
+    AOCL_INTP decompress;
+    AOCL_INT32 partitionMode;   //partition sizing mode of the caller at submit time
+    AOCL_INT32 dictPriming;     //dictionary priming of the caller at submit time
+} aocl_async_args_t;
+
+//Job body run on a thread of the async pool, with numThreads threads left to it by the
+//other jobs in flight
+static AOCL_INT64 aocl_llc_async_run(AOCL_VOID *arg, AOCL_INT32 numThreads)
+{
+    aocl_async_args_t args = *(aocl_async_args_t *)arg;
+    free(arg);
+    //The job runs with the per-thread modes of the thread that queued it
+    aocl_set_partition_mode_mt(args.partitionMode);
+    aocl_set_dict_priming_mt(args.dictPriming);
+    if (args.decompress)
+        return aocl_llc_decompress_run(args.handle, args.codec_type, numThreads);
+    return aocl_llc_compress_run(args.handle, args.codec_type, numThreads);
+}
+
+//Common body of the async APIs
+static AOCL_INT32 aocl_llc_async(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, aocl_async_callback callback,
+                    AOCL_VOID *userData, aocl_async_job **job, AOCL_INTP decompress)
+{
+    AOCL_INT32 err;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Enter");
+
+    if (job)
+        *job = NULL;
+
+    if (handle == NULL || (codec_type < LZ4) || (codec_type >= AOCL_COMPRESSOR_ALGOS_NUM))
+    {
+        LOG_FORMATTED(ERR, logCtx,
+            "async %s failed !! invalid input.", decompress ? "decompression" : "compression");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_INVALID_INPUT;
+    }
+
+    if (aocl_codec[codec_type].setup == NULL)
+    {
+        LOG_FORMATTED(ERR, logCtx,
+            "async %s failed !! compression method is excluded from this library build.",
+            decompress ? "decompression" : "compression");
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_EXCLUDED_METHOD;
+    }
+
+    aocl_async_args_t *args = (aocl_async_args_t *)malloc(sizeof(aocl_async_args_t));
+    if (args == NULL)
+    {
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_COMPRESSION_FAILED;
+    }
+    args->handle = handle;
+    args->codec_type = codec_type;
+    args->decompress = decompress;
+    args->partitionMode = aocl_get_partition_mode_mt();
+    args->dictPriming = aocl_get_dict_priming_mt();
+
+    //The job asks for the threads of the handle, or the budget of the caller
+    AOCL_INT32 numThreads = (handle->numThreads > 0) ? handle->numThreads : aocl_get_num_threads_mt();
+    aocl_async_job *newJob = aocl_async_job_submit(aocl_llc_async_run, args, numThreads,
+                                    callback, userData, job == NULL, &err);
+    if (err != 0)
+    {
+        LOG_FORMATTED(ERR, logCtx,
+            "async %s failed !! job could not be queued.", decompress ? "decompression" : "compression");
+        free(args);
+        LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+        return ERR_COMPRESSION_FAILED;
+    }
+    if (job)
+        *job = newJob;
+
+    LOG_UNFORMATTED(TRACE, logCtx, "Exit");
+    return 0;
+}
+
+//API to compress the input on a library-owned thread
+AOCL_INT32 aocl_llc_compress_async(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, aocl_async_callback callback,
+                    AOCL_VOID *userData, aocl_async_job **job)
+{
+    return aocl_llc_async(handle, codec_type, callback, userData, job, 0);
+}
+
+//API to decompress the input on a library-owned thread
+AOCL_INT32 aocl_llc_decompress_async(aocl_compression_desc *handle,
+                    aocl_compression_type codec_type, aocl_async_callback callback,
+                    AOCL_VOID *userData, aocl_async_job **job)
+{
+    return aocl_llc_async(handle, codec_type, callback, userData, job, 1);
+}
+
+//API to check for completion of an async job
+AOCL_INT32 aocl_llc_async_poll(aocl_async_job *job, AOCL_INT64 *result)
+{
+    if (job == NULL)
+        return ERR_INVALID_INPUT;
+    return aocl_async_job_poll(job, result);
+}
+
+//API to wait for completion of an async job and release it
+AOCL_INT64 aocl_llc_async_wait(aocl_async_job *job)
+{
+    if (job == NULL)
+        return ERR_INVALID_INPUT;
+    return aocl_async_job_wait(job);
+}
+#endif /* AOCL_ENABLE_THREADS */
+
 //API to destroy memory and deinit the compression method
 AOCL_VOID aocl_llc_destroy(aocl_compression_desc *handle,
                       aocl_compression_type codec_type)
@@ -174,6 +878,9 @@ AOCL_VOID aocl_llc_destroy(aocl_compression_desc *handle,
     LOG_FORMATTED(INFO, logCtx,
        "Calling destroy method for: %s", aocl_codec[codec_type].codec_name);
 
+#ifdef AOCL_ENABLE_THREADS
+    aocl_llc_batch_release(handle);
+#endif
     if (aocl_codec[codec_type].destroy)
     {
         aocl_codec[codec_type].destroy(handle->workBuf);
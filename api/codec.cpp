@@ -40,6 +40,14 @@
 #include "aocl_compression.h"
 #include "codec.h"
 #include "utils/utils.h"
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#ifdef AOCL_ENABLE_THREADS
+#include "threads/threads.h"
+#include "api/aocl_threads.h"
+#endif
 
 //bzip2
 #ifndef AOCL_EXCLUDE_BZIP2
@@ -47,6 +55,7 @@
 #endif
 //lz4
 #ifndef AOCL_EXCLUDE_LZ4
+#define LZ4_STATIC_LINKING_ONLY
 #include "algos/lz4/lz4.h"
 #endif
 //lz4hc
@@ -73,63 +82,607 @@
 #include <cstdlib>
 #define ZSTD_STATIC_LINKING_ONLY
 #include "algos/zstd/lib/zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "algos/zstd/lib/zdict.h"
 #endif
 
 #define CODEC_ERROR -1
 
+//Decodes at most outsize bytes from the start of a compressed stream (partition < 0),
+//or the whole of the given RAP partition, whose decompressed length is outsize.
+//Returns the number of bytes decoded or CODEC_ERROR.
+typedef AOCL_INT64 (*decode_prefix_fp)(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                  AOCL_UINTP outsize, AOCL_INT32 partition, AOCL_INT32 last,
+                                  AOCL_CHAR *stream, AOCL_CHAR *workmem);
+
+//Decodes bytes [skip, skip + outsize) of a stream into outbuf
+static AOCL_INT64 aocl_decode_slice(decode_prefix_fp decode, AOCL_CHAR *inbuf, AOCL_UINTP insize,
+                               AOCL_CHAR *stream, AOCL_CHAR *workmem,
+                               AOCL_UINTP skip, AOCL_CHAR *outbuf, AOCL_UINTP outsize)
+{
+    AOCL_INT64 res;
+    AOCL_CHAR *tmp;
+
+    if (skip == 0)
+        return decode(inbuf, insize, outbuf, outsize, -1, 0, stream, workmem);
+
+    if (outsize > SIZE_MAX - skip)
+        return CODEC_ERROR;
+    tmp = (AOCL_CHAR *)malloc(skip + outsize);
+    if (tmp == NULL)
+        return CODEC_ERROR;
+    res = decode(inbuf, insize, tmp, skip + outsize, -1, 0, stream, workmem);
+    if (res > (AOCL_INT64)skip)
+    {
+        memcpy(outbuf, tmp + skip, res - skip);
+        res -= skip;
+    }
+    else if (res >= 0)
+    {
+        res = 0;
+    }
+    free(tmp);
+    return res;
+}
+
+//Decodes outsize bytes starting at uncompressed offset into outbuf. When the stream
+//holds a RAP frame at rappos, only the partitions covering the range are decoded.
+//Otherwise the stream, whose codec data starts at datapos, is decoded up to the
+//end of the range. Returns the number of bytes decoded, which is less than outsize
+//when the range runs past the end of the stream.
+static AOCL_INT64 aocl_decompress_range(decode_prefix_fp decode, AOCL_CHAR *inbuf,
+                                   AOCL_UINTP insize, AOCL_UINTP datapos, AOCL_UINTP rappos,
+                                   AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_UINT64 offset,
+                                   AOCL_CHAR *workmem)
+{
+#ifdef AOCL_ENABLE_THREADS
+    if (rappos < insize)
+    {
+        aocl_thread_group_t thread_group_handle;
+        AOCL_CHAR *rap = inbuf + rappos;
+        AOCL_UINTP rap_size = insize - rappos;
+        AOCL_INT32 rap_metadata_len = aocl_setup_parallel_decompress_mt(&thread_group_handle,
+                                            rap, NULL, rap_size, 0, 1);
+        if (rap_metadata_len < 0)
+            return CODEC_ERROR;
+
+        if (rap_metadata_len > 0)
+        {
+            AOCL_UINT32 num_partitions, partition;
+            AOCL_INT32 num_chained = 1;
+            AOCL_UINT64 partition_start = 0;
+            AOCL_UINTP written = 0;
+
+            if (rap_metadata_len < RAP_START_OF_PARTITIONS || (AOCL_UINTP)rap_metadata_len > rap_size)
+                return CODEC_ERROR;
+            num_partitions = *(AOCL_USHORT *)(rap + RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES);
+            if (num_partitions > (AOCL_UINT32)(rap_metadata_len - RAP_START_OF_PARTITIONS) /
+                    RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(thread_group_handle.rap_version))
+                return CODEC_ERROR;
+
+            //Dependent partitions are decoded with the partitions they depend on
+            for (partition = 0; partition < num_partitions && written < outsize; partition += num_chained)
+            {
+                AOCL_INTP rap_offset, rap_len, decomp_len;
+                AOCL_UINTP skip, want;
+                AOCL_INT64 res;
+
+                num_chained = aocl_read_rap_chain_mt(&thread_group_handle, partition, num_partitions,
+                                                     &rap_offset, &rap_len, &decomp_len);
+                if (num_chained < 0 || rap_offset < 0 || rap_len < 0 || decomp_len < 0 ||
+                    (AOCL_UINTP)rap_offset > rap_size || (AOCL_UINTP)rap_len > rap_size - rap_offset)
+                    return CODEC_ERROR;
+
+                if (offset + written >= partition_start + decomp_len)
+                {
+                    partition_start += decomp_len;
+                    continue;
+                }
+                //Partitions cover the range from its start onwards
+                skip = (AOCL_UINTP)(offset + written - partition_start);
+                want = (AOCL_UINTP)decomp_len - skip;
+                if (want > outsize - written)
+                    want = outsize - written;
+                //Partitions are decoded whole: some codecs cannot stop inside one
+                if (skip == 0 && want == (AOCL_UINTP)decomp_len)
+                {
+                    res = decode(rap + rap_offset, rap_len, outbuf + written, want, partition,
+                                 partition + num_chained == num_partitions, inbuf, workmem);
+                }
+                else
+                {
+                    AOCL_CHAR *tmp = (AOCL_CHAR *)malloc(decomp_len);
+                    if (tmp == NULL)
+                        return CODEC_ERROR;
+                    res = decode(rap + rap_offset, rap_len, tmp, decomp_len, partition,
+                                 partition + num_chained == num_partitions, inbuf, workmem);
+                    if (res == (AOCL_INT64)decomp_len)
+                        memcpy(outbuf + written, tmp + skip, want);
+                    free(tmp);
+                }
+                if (res != (AOCL_INT64)decomp_len)
+                    return CODEC_ERROR;
+                written += want;
+                partition_start += decomp_len;
+            }
+            return written;
+        }
+    }
+#endif /* AOCL_ENABLE_THREADS */
+
+    if (offset > SIZE_MAX || datapos > insize)
+        return CODEC_ERROR;
+    return aocl_decode_slice(decode, inbuf + datapos, insize - datapos, inbuf, workmem,
+                             (AOCL_UINTP)offset, outbuf, outsize);
+}
+
+//Copies the pending bytes [*pos, len) of buf to out. Returns the number of bytes copied.
+static AOCL_UINTP aocl_stream_drain(AOCL_CHAR *buf, AOCL_UINTP *pos, AOCL_UINTP len,
+                                    AOCL_CHAR *out, AOCL_UINTP outsize)
+{
+    AOCL_UINTP n = len - *pos;
+    if (n > outsize)
+        n = outsize;
+    memcpy(out, buf + *pos, n);
+    *pos += n;
+    return n;
+}
+
+#if !defined(AOCL_EXCLUDE_LZ4) || !defined(AOCL_EXCLUDE_SNAPPY)
+//LZ4, LZ4HC and snappy streams are a sequence of blocks of at most STREAM_BLOCK_SIZE
+//uncompressed bytes. Every block is preceded by its compressed length in 4 little
+//endian bytes, and a zero length ends the stream.
+#define STREAM_BLOCK_SIZE (64 * 1024)
+#define STREAM_BLOCK_HEADER_SIZE 4
+
+//Compresses or decompresses one block. Returns the size of dst used or CODEC_ERROR.
+typedef AOCL_INT64 (*block_code_fp)(AOCL_CHAR *ctx, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                    AOCL_CHAR *dst, AOCL_UINTP dstCap);
+typedef AOCL_VOID (*block_free_fp)(AOCL_CHAR *ctx);
+
+typedef struct {
+    AOCL_INTP decompress;
+    AOCL_INTP ended;        //end of the stream is written or read
+    block_code_fp code;
+    block_free_fp free_ctx;
+    AOCL_CHAR *ctx;         //codec stream state
+    AOCL_CHAR *block[2];    //uncompressed blocks, used in turns so that the previous
+                            //block stays in place as the LZ4 dictionary
+    AOCL_UINTP cur;         //block in use
+    AOCL_UINTP blockLen;    //bytes held in the current block
+    AOCL_UINTP blockPos;    //bytes of the current block already output on decompression
+    AOCL_CHAR *frame;       //compressed block along with its header
+    AOCL_UINTP frameCap;
+    AOCL_UINTP frameLen;
+    AOCL_UINTP framePos;    //bytes of the frame already output on compression
+} block_stream_t;
+
+static AOCL_VOID aocl_block_stream_free(AOCL_CHAR *stream)
+{
+    block_stream_t *bs = (block_stream_t *)stream;
+    if (bs == NULL)
+        return;
+    if (bs->ctx)
+        bs->free_ctx(bs->ctx);
+    free(bs->block[0]);
+    free(bs->frame);
+    free(bs);
+}
+
+static AOCL_CHAR *aocl_block_stream_create(AOCL_INTP decompress, AOCL_UINTP bound,
+                                      block_code_fp code, block_free_fp free_ctx,
+                                      AOCL_CHAR *ctx)
+{
+    block_stream_t *bs;
+    if (ctx == NULL)
+        return NULL;
+    bs = (block_stream_t *)calloc(1, sizeof(block_stream_t));
+    if (bs == NULL)
+    {
+        free_ctx(ctx);
+        return NULL;
+    }
+    bs->decompress = decompress;
+    bs->code = code;
+    bs->free_ctx = free_ctx;
+    bs->ctx = ctx;
+    bs->block[0] = (AOCL_CHAR *)malloc(2 * STREAM_BLOCK_SIZE);
+    bs->frameCap = STREAM_BLOCK_HEADER_SIZE + bound;
+    bs->frame = (AOCL_CHAR *)malloc(bs->frameCap);
+    if (bs->block[0] == NULL || bs->frame == NULL)
+    {
+        aocl_block_stream_free((AOCL_CHAR *)bs);
+        return NULL;
+    }
+    bs->block[1] = bs->block[0] + STREAM_BLOCK_SIZE;
+    return (AOCL_CHAR *)bs;
+}
+
+static AOCL_INT64 aocl_block_stream_compress(block_stream_t *bs, AOCL_CHAR **inbuf,
+                                        AOCL_UINTP *insize, AOCL_CHAR *outbuf,
+                                        AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    AOCL_UINTP written = 0;
+
+    if (bs->ended && *insize > 0)
+        return CODEC_ERROR; //input after the end of the stream
+    for (;;)
+    {
+        AOCL_INT64 res = 0;
+        AOCL_UINTP n;
+
+        written += aocl_stream_drain(bs->frame, &bs->framePos, bs->frameLen,
+                                     outbuf + written, outsize - written);
+        if (bs->framePos < bs->frameLen || bs->ended)
+            break;
+
+        n = STREAM_BLOCK_SIZE - bs->blockLen;
+        if (n > *insize)
+            n = *insize;
+        if (n)
+            memcpy(bs->block[bs->cur] + bs->blockLen, *inbuf, n);
+        bs->blockLen += n;
+        *inbuf += n;
+        *insize -= n;
+        if (bs->blockLen < STREAM_BLOCK_SIZE && !(finish && *insize == 0))
+            break; //wait for a full block
+
+        if (bs->blockLen > 0)
+        {
+            res = bs->code(bs->ctx, bs->block[bs->cur], bs->blockLen,
+                           bs->frame + STREAM_BLOCK_HEADER_SIZE,
+                           bs->frameCap - STREAM_BLOCK_HEADER_SIZE);
+            if (res <= 0)
+                return CODEC_ERROR;
+            bs->cur ^= 1;
+            bs->blockLen = 0;
+        }
+        else
+        {
+            bs->ended = 1;
+        }
+        bs->frame[0] = (AOCL_CHAR)(res & 0xFF);
+        bs->frame[1] = (AOCL_CHAR)((res >> 8) & 0xFF);
+        bs->frame[2] = (AOCL_CHAR)((res >> 16) & 0xFF);
+        bs->frame[3] = (AOCL_CHAR)((res >> 24) & 0xFF);
+        bs->frameLen = STREAM_BLOCK_HEADER_SIZE + res;
+        bs->framePos = 0;
+    }
+    return written;
+}
+
+static AOCL_INT64 aocl_block_stream_decompress(block_stream_t *bs, AOCL_CHAR **inbuf,
+                                          AOCL_UINTP *insize, AOCL_CHAR *outbuf,
+                                          AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    AOCL_UINTP written = 0;
+
+    for (;;)
+    {
+        AOCL_UINTP need = STREAM_BLOCK_HEADER_SIZE, n;
+        AOCL_INT64 res;
+
+        written += aocl_stream_drain(bs->block[bs->cur], &bs->blockPos, bs->blockLen,
+                                     outbuf + written, outsize - written);
+        if (bs->blockPos < bs->blockLen || bs->ended)
+            break;
+
+        if (bs->frameLen >= STREAM_BLOCK_HEADER_SIZE)
+        {
+            const AOCL_UINT8 *hdr = (const AOCL_UINT8 *)bs->frame;
+            need += (AOCL_UINTP)hdr[0] | ((AOCL_UINTP)hdr[1] << 8) |
+                    ((AOCL_UINTP)hdr[2] << 16) | ((AOCL_UINTP)hdr[3] << 24);
+            if (need > bs->frameCap)
+                return CODEC_ERROR;
+        }
+        n = need - bs->frameLen;
+        if (n > *insize)
+            n = *insize;
+        if (n)
+            memcpy(bs->frame + bs->frameLen, *inbuf, n);
+        bs->frameLen += n;
+        *inbuf += n;
+        *insize -= n;
+        if (bs->frameLen < need)
+        {
+            if (finish)
+                return CODEC_ERROR; //truncated stream
+            break;
+        }
+        if (need == STREAM_BLOCK_HEADER_SIZE)
+        {
+            //Header read: an empty block ends the stream
+            if (bs->frame[0] == 0 && bs->frame[1] == 0 && bs->frame[2] == 0 && bs->frame[3] == 0)
+                bs->ended = 1;
+            continue;
+        }
+
+        bs->cur ^= 1;
+        res = bs->code(bs->ctx, bs->frame + STREAM_BLOCK_HEADER_SIZE,
+                       need - STREAM_BLOCK_HEADER_SIZE, bs->block[bs->cur], STREAM_BLOCK_SIZE);
+        if (res < 0)
+            return CODEC_ERROR;
+        bs->blockLen = res;
+        bs->blockPos = 0;
+        bs->frameLen = 0;
+    }
+    return written;
+}
+
+static AOCL_INT64 aocl_block_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf,
+                                      AOCL_UINTP *insize, AOCL_CHAR *outbuf,
+                                      AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    block_stream_t *bs = (block_stream_t *)stream;
+    if (bs == NULL)
+        return CODEC_ERROR;
+    if (bs->decompress)
+        return aocl_block_stream_decompress(bs, inbuf, insize, outbuf, outsize, finish);
+    return aocl_block_stream_compress(bs, inbuf, insize, outbuf, outsize, finish);
+}
+#endif /* !AOCL_EXCLUDE_LZ4 || !AOCL_EXCLUDE_SNAPPY */
+
 //bzip2
 #ifndef AOCL_EXCLUDE_BZIP2
+typedef struct {
+    bz_stream cstrm;        //compression state, kept across aocl_bzip2_compress() calls
+    bz_stream dstrm;        //decompression state, kept across aocl_bzip2_decompress() calls
+} bzip2_params_t;
+
 AOCL_CHAR *aocl_bzip2_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                        AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog)
 {
-    return aocl_setup_bzip2(optOff, optLevel, insize, level, windowLog);
+    aocl_setup_bzip2(optOff, optLevel, insize, level, windowLog);
+
+    //States are initialized on first use: a handle may only compress or decompress
+    return (AOCL_CHAR *)calloc(1, sizeof(bzip2_params_t));
+}
+
+AOCL_VOID aocl_bzip2_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    aocl_setup_bzip2(optOff, optLevel, 0, 0, 0);
 }
 
 AOCL_INT64 aocl_bzip2_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf, 
-						  AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP windowLog, AOCL_CHAR *)
+						  AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP windowLog, AOCL_CHAR *workmem)
 {
     AOCL_UINT32 outSizeL = outsize;
-    if (BZ2_bzBuffToBuffCompress((AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf, 
-	   (AOCL_UINTP)insize, level, 0, 0)==BZ_OK)
+    AOCL_INTP res;
+    if (workmem)
+        res = BZ2_bzBuffToBuffCompressReuse(&((bzip2_params_t *)workmem)->cstrm,
+                (AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf,
+                (AOCL_UINTP)insize, level, 0, 0);
+    else
+        res = BZ2_bzBuffToBuffCompress((AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf, 
+	   (AOCL_UINTP)insize, level, 0, 0);
+    if (res == BZ_OK)
         return outSizeL;
 
     return CODEC_ERROR;
 }
 
 AOCL_INT64 aocl_bzip2_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf, 
-							AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
+							AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *workmem)
 {
     AOCL_UINT32 outSizeL = outsize;
-    if (BZ2_bzBuffToBuffDecompress((AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf, 
-	   (AOCL_UINTP)insize, 0, 0)==BZ_OK)
+    AOCL_INTP res;
+    if (workmem)
+        res = BZ2_bzBuffToBuffDecompressReuse(&((bzip2_params_t *)workmem)->dstrm,
+                (AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf,
+                (AOCL_UINTP)insize, 0, 0);
+    else
+        res = BZ2_bzBuffToBuffDecompress((AOCL_CHAR *)outbuf, &outSizeL, (AOCL_CHAR *)inbuf, 
+	   (AOCL_UINTP)insize, 0, 0);
+    if (res == BZ_OK)
         return outSizeL;
 
     return CODEC_ERROR;
 }
 
+static AOCL_INT64 aocl_bzip2_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                      AOCL_UINTP outsize, AOCL_INT32, AOCL_INT32, AOCL_CHAR *, AOCL_CHAR *)
+{
+    bz_stream strm;
+    AOCL_INTP res = BZ_OK;
+    AOCL_UINTP inLeft = insize, outLeft = outsize, decoded;
+
+    memset(&strm, 0, sizeof(strm));
+    if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK)
+        return CODEC_ERROR;
+    strm.next_in = inbuf;
+    strm.next_out = outbuf;
+    while (res == BZ_OK)
+    {
+        AOCL_UINT32 availIn, availOut;
+        if (strm.avail_in == 0 && inLeft)
+        {
+            strm.avail_in = (inLeft > UINT_MAX) ? UINT_MAX : (AOCL_UINT32)inLeft;
+            inLeft -= strm.avail_in;
+        }
+        if (strm.avail_out == 0)
+        {
+            if (outLeft == 0)
+                break;
+            strm.avail_out = (outLeft > UINT_MAX) ? UINT_MAX : (AOCL_UINT32)outLeft;
+            outLeft -= strm.avail_out;
+        }
+        availIn = strm.avail_in;
+        availOut = strm.avail_out;
+        res = BZ2_bzDecompress(&strm);
+        if (res == BZ_OK && strm.avail_in == availIn && strm.avail_out == availOut)
+            break; //truncated stream
+    }
+    decoded = outsize - outLeft - strm.avail_out;
+    BZ2_bzDecompressEnd(&strm);
+    if (res == BZ_STREAM_END || (res == BZ_OK && decoded == outsize))
+        return decoded;
+    return CODEC_ERROR;
+}
+
+//bzip2 streams have no RAP frame and are decoded up to the end of the range
+AOCL_INT64 aocl_bzip2_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                  AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    return aocl_decompress_range(aocl_bzip2_decode_prefix, inbuf, insize, 0, insize,
+                                 outbuf, outsize, offset, workmem);
+}
+
+AOCL_CHAR *aocl_bzip2_clone_workmem(AOCL_CHAR *)
+{
+    return (AOCL_CHAR *)calloc(1, sizeof(bzip2_params_t));
+}
+
+AOCL_VOID aocl_bzip2_free_workmem(AOCL_CHAR *workmem)
+{
+    bzip2_params_t *bp = (bzip2_params_t *)workmem;
+    if (bp)
+    {
+        if (bp->cstrm.state)
+            BZ2_bzCompressEnd(&bp->cstrm);
+        if (bp->dstrm.state)
+            BZ2_bzDecompressEnd(&bp->dstrm);
+        free(workmem);
+    }
+}
+
 AOCL_VOID aocl_bzip2_destroy(AOCL_CHAR* workmem) {
+    aocl_bzip2_free_workmem(workmem);
     aocl_destroy_bzip2();
 }
+
+typedef struct {
+    AOCL_INTP decompress;
+    AOCL_INTP ended;
+    bz_stream strm;
+} bzip2_stream_t;
+
+AOCL_CHAR *aocl_bzip2_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP)
+{
+    AOCL_INTP res;
+    bzip2_stream_t *bs = (bzip2_stream_t *)calloc(1, sizeof(bzip2_stream_t));
+    if (bs == NULL)
+        return NULL;
+    bs->decompress = decompress;
+    if (decompress)
+        res = BZ2_bzDecompressInit(&bs->strm, 0, 0);
+    else
+        res = BZ2_bzCompressInit(&bs->strm, level, 0, 0);
+    if (res != BZ_OK)
+    {
+        free(bs);
+        return NULL;
+    }
+    return (AOCL_CHAR *)bs;
+}
+
+AOCL_INT64 aocl_bzip2_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                               AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    bzip2_stream_t *bs = (bzip2_stream_t *)stream;
+    AOCL_UINTP written = 0;
+
+    if (bs == NULL)
+        return CODEC_ERROR;
+    while (!bs->ended && written < outsize)
+    {
+        AOCL_UINT32 availIn = (*insize > UINT_MAX) ? UINT_MAX : (AOCL_UINT32)*insize;
+        AOCL_UINT32 availOut = (outsize - written > UINT_MAX) ? UINT_MAX : (AOCL_UINT32)(outsize - written);
+        AOCL_UINTP consumed, produced;
+        AOCL_INTP res;
+
+        bs->strm.next_in = *inbuf;
+        bs->strm.avail_in = availIn;
+        bs->strm.next_out = outbuf + written;
+        bs->strm.avail_out = availOut;
+        if (bs->decompress)
+        {
+            res = BZ2_bzDecompress(&bs->strm);
+            if (res != BZ_OK && res != BZ_STREAM_END)
+                return CODEC_ERROR;
+        }
+        else
+        {
+            //All the remaining input must be passed along with BZ_FINISH
+            AOCL_INTP action = (finish && *insize == availIn) ? BZ_FINISH : BZ_RUN;
+            if (action == BZ_RUN && availIn == 0)
+                break;
+            res = BZ2_bzCompress(&bs->strm, action);
+            if (res != BZ_RUN_OK && res != BZ_FINISH_OK && res != BZ_STREAM_END)
+                return CODEC_ERROR;
+        }
+        consumed = availIn - bs->strm.avail_in;
+        produced = availOut - bs->strm.avail_out;
+        *inbuf += consumed;
+        *insize -= consumed;
+        written += produced;
+        if (res == BZ_STREAM_END)
+            bs->ended = 1;
+        else if (consumed == 0 && produced == 0)
+            break;
+    }
+
+    if (bs->decompress && finish && !bs->ended && *insize == 0 && written < outsize)
+        return CODEC_ERROR; //truncated stream
+    return written;
+}
+
+AOCL_VOID aocl_bzip2_stream_free(AOCL_CHAR *stream)
+{
+    bzip2_stream_t *bs = (bzip2_stream_t *)stream;
+    if (bs == NULL)
+        return;
+    if (bs->decompress)
+        BZ2_bzDecompressEnd(&bs->strm);
+    else
+        BZ2_bzCompressEnd(&bs->strm);
+    free(bs);
+}
 #endif
 
 
 //lz4
 #ifndef AOCL_EXCLUDE_LZ4
+//LZ4 matches reach at most 64KB back, the rest of a dictionary is never referenced
+#define LZ4_DICT_MAX_SIZE (64 * 1024)
+
+//workmem of a handle with a dictionary loaded, otherwise LZ4 uses no workmem
+typedef struct {
+    LZ4_stream_t dictStream;    //dictionary digested by LZ4_loadDict()
+    LZ4_stream_t work;          //compression state the dictionary is attached to per call
+    AOCL_CHAR *dict;            //copy of the end of the dictionary
+    AOCL_INT32 dictSize;
+} lz4_dict_t;
+
 AOCL_CHAR *aocl_lz4_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                      AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog)
 {
     return aocl_setup_lz4(optOff, optLevel, insize, level, windowLog);
 }
 
+AOCL_VOID aocl_lz4_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    aocl_setup_lz4(optOff, optLevel, 0, 0, 0);
+}
+
 #if defined(__GNUC__) && defined(__x86_64__)
 /* Changes in code alignment affects performance of LZ4 compress
 * functions. Aligning to 16-bytes boundary to fix this instability.*/
 __asm__(".p2align 4");
 #endif
 AOCL_INT64 aocl_lz4_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
-                        AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
+                        AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *workmem)
 {
-    AOCL_INT32 res = LZ4_compress_default(inbuf, outbuf, insize, outsize);
+    AOCL_INT32 res;
+    if (workmem)
+    {
+        //Attaching the digested dictionary saves hashing it again on every call
+        lz4_dict_t *ld = (lz4_dict_t *)workmem;
+        LZ4_resetStream_fast(&ld->work);
+        LZ4_attach_dictionary(&ld->work, &ld->dictStream);
+        res = LZ4_compress_fast_continue(&ld->work, inbuf, outbuf, insize, outsize, 1);
+    }
+    else
+        res = LZ4_compress_default(inbuf, outbuf, insize, outsize);
     if (res > 0)
         return res;
     
@@ -144,18 +697,175 @@ __asm__("nop");
 __asm__(".p2align 5");
 #endif
 AOCL_INT64 aocl_lz4_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
-                          AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
+                          AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *workmem)
 {
-    AOCL_INT32 res = LZ4_decompress_safe(inbuf, outbuf, insize, outsize);
+    AOCL_INT32 res;
+    if (workmem)
+        res = LZ4_decompress_safe_usingDict(inbuf, outbuf, insize, outsize,
+                    ((lz4_dict_t *)workmem)->dict, ((lz4_dict_t *)workmem)->dictSize);
+    else
+        res = LZ4_decompress_safe(inbuf, outbuf, insize, outsize);
     if (res >= 0)
         return res;
 
     return CODEC_ERROR;
 }
 
+static AOCL_INT64 aocl_lz4_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                    AOCL_UINTP outsize, AOCL_INT32 partition, AOCL_INT32 last,
+                                    AOCL_CHAR *, AOCL_CHAR *)
+{
+    AOCL_INT32 res;
+    if (insize > INT_MAX)
+        return CODEC_ERROR;
+    if (outsize > INT_MAX)
+    {
+        if (partition >= 0)
+            return CODEC_ERROR;
+        outsize = INT_MAX; //LZ4 blocks do not decode to more
+    }
+    if (partition >= 0)
+        res = LZ4_decompress_partition_MT(inbuf, outbuf, insize, outsize, last);
+    else
+        res = LZ4_decompress_safe_partial(inbuf, outbuf, insize, outsize, outsize);
+    if (res >= 0)
+        return res;
+    return CODEC_ERROR;
+}
+
+//LZ4 and LZ4HC streams share the same RAP frame and partition format
+AOCL_INT64 aocl_lz4_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    return aocl_decompress_range(aocl_lz4_decode_prefix, inbuf, insize, 0, 0,
+                                 outbuf, outsize, offset, workmem);
+}
+
+AOCL_INT32 aocl_lz4_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                               AOCL_UINTP dictSize, AOCL_UINTP)
+{
+    lz4_dict_t *ld = (lz4_dict_t *)*workBuf;
+    AOCL_CHAR *copy;
+
+    if (dictSize == 0)
+    {
+        if (ld)
+        {
+            free(ld->dict);
+            free(ld);
+        }
+        *workBuf = NULL;
+        return 0;
+    }
+    if (dictSize > LZ4_DICT_MAX_SIZE)
+    {
+        dict += dictSize - LZ4_DICT_MAX_SIZE;
+        dictSize = LZ4_DICT_MAX_SIZE;
+    }
+
+    copy = (AOCL_CHAR *)malloc(dictSize);
+    if (copy == NULL)
+        return CODEC_ERROR;
+    memcpy(copy, dict, dictSize);
+    if (ld == NULL)
+    {
+        ld = (lz4_dict_t *)malloc(sizeof(lz4_dict_t));
+        if (ld == NULL)
+        {
+            free(copy);
+            return CODEC_ERROR;
+        }
+        LZ4_initStream(&ld->work, sizeof(LZ4_stream_t));
+        ld->dict = NULL;
+        *workBuf = (AOCL_CHAR *)ld;
+    }
+    free(ld->dict);
+    ld->dict = copy;
+    ld->dictSize = (AOCL_INT32)dictSize;
+    LZ4_loadDict(&ld->dictStream, ld->dict, ld->dictSize);
+    return 0;
+}
+
+//Only a handle with a dictionary has workmem to clone
+AOCL_CHAR *aocl_lz4_clone_workmem(AOCL_CHAR *workmem)
+{
+    lz4_dict_t *ld = (lz4_dict_t *)workmem;
+    AOCL_CHAR *clone = NULL;
+    if (ld == NULL || aocl_lz4_load_dictionary(&clone, ld->dict, ld->dictSize, 0) != 0)
+        return NULL;
+    return clone;
+}
+
+AOCL_VOID aocl_lz4_free_workmem(AOCL_CHAR *workmem)
+{
+    lz4_dict_t *ld = (lz4_dict_t *)workmem;
+    if (ld)
+    {
+        free(ld->dict);
+        free(workmem);
+    }
+}
+
 AOCL_VOID aocl_lz4_destroy(AOCL_CHAR* workmem) {
+    aocl_lz4_free_workmem(workmem);
     aocl_destroy_lz4();
 }
+
+static AOCL_INT64 aocl_lz4_stream_compress_block(AOCL_CHAR *ctx, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                            AOCL_CHAR *dst, AOCL_UINTP dstCap)
+{
+    AOCL_INT32 res = LZ4_compress_fast_continue((LZ4_stream_t *)ctx, src, dst, srcLen, dstCap, 1);
+    if (res > 0)
+        return res;
+
+    return CODEC_ERROR;
+}
+
+static AOCL_INT64 aocl_lz4_stream_decompress_block(AOCL_CHAR *ctx, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                              AOCL_CHAR *dst, AOCL_UINTP dstCap)
+{
+    AOCL_INT32 res = LZ4_decompress_safe_continue((LZ4_streamDecode_t *)ctx, src, dst, srcLen, dstCap);
+    if (res >= 0)
+        return res;
+
+    return CODEC_ERROR;
+}
+
+static AOCL_VOID aocl_lz4_stream_free_cctx(AOCL_CHAR *ctx)
+{
+    LZ4_freeStream((LZ4_stream_t *)ctx);
+}
+
+static AOCL_VOID aocl_lz4_stream_free_dctx(AOCL_CHAR *ctx)
+{
+    LZ4_freeStreamDecode((LZ4_streamDecode_t *)ctx);
+}
+
+//Blocks of LZ4 and LZ4HC streams reference the previous block. Both are read
+//by the same decoder.
+AOCL_CHAR *aocl_lz4_stream_create(AOCL_INTP decompress, AOCL_UINTP, AOCL_UINTP)
+{
+    if (decompress)
+        return aocl_block_stream_create(decompress, LZ4_COMPRESSBOUND(STREAM_BLOCK_SIZE),
+                                        aocl_lz4_stream_decompress_block,
+                                        aocl_lz4_stream_free_dctx,
+                                        (AOCL_CHAR *)LZ4_createStreamDecode());
+    return aocl_block_stream_create(decompress, LZ4_COMPRESSBOUND(STREAM_BLOCK_SIZE),
+                                    aocl_lz4_stream_compress_block,
+                                    aocl_lz4_stream_free_cctx,
+                                    (AOCL_CHAR *)LZ4_createStream());
+}
+
+AOCL_INT64 aocl_lz4_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                             AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    return aocl_block_stream_update(stream, inbuf, insize, outbuf, outsize, finish);
+}
+
+AOCL_VOID aocl_lz4_stream_free(AOCL_CHAR *stream)
+{
+    aocl_block_stream_free(stream);
+}
 #endif
 
 
@@ -167,6 +877,13 @@ AOCL_CHAR *aocl_lz4hc_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
     return aocl_setup_lz4hc(optOff, optLevel, insize, level, windowLog);
 }
 
+AOCL_VOID aocl_lz4hc_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    aocl_setup_lz4hc(optOff, optLevel, 0, 0, 0);
+    //LZ4HC streams are decompressed by LZ4
+    aocl_setup_lz4(optOff, optLevel, 0, 0, 0);
+}
+
 AOCL_INT64 aocl_lz4hc_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
                           AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
 {
@@ -190,33 +907,96 @@ AOCL_INT64 aocl_lz4hc_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR
 AOCL_VOID aocl_lz4hc_destroy(AOCL_CHAR* workmem) {
     aocl_destroy_lz4hc();
 }
+
+static AOCL_INT64 aocl_lz4hc_stream_compress_block(AOCL_CHAR *ctx, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                              AOCL_CHAR *dst, AOCL_UINTP dstCap)
+{
+    AOCL_INT32 res = LZ4_compress_HC_continue((LZ4_streamHC_t *)ctx, src, dst, srcLen, dstCap);
+    if (res > 0)
+        return res;
+
+    return CODEC_ERROR;
+}
+
+static AOCL_VOID aocl_lz4hc_stream_free_cctx(AOCL_CHAR *ctx)
+{
+    LZ4_freeStreamHC((LZ4_streamHC_t *)ctx);
+}
+
+//LZ4HC streams are decompressed by aocl_lz4_stream_update()
+AOCL_CHAR *aocl_lz4hc_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar)
+{
+    LZ4_streamHC_t *cctx;
+    if (decompress)
+        return aocl_lz4_stream_create(decompress, level, optVar);
+    cctx = LZ4_createStreamHC();
+    if (cctx)
+        LZ4_resetStreamHC_fast(cctx, level);
+    return aocl_block_stream_create(decompress, LZ4_COMPRESSBOUND(STREAM_BLOCK_SIZE),
+                                    aocl_lz4hc_stream_compress_block,
+                                    aocl_lz4hc_stream_free_cctx, (AOCL_CHAR *)cctx);
+}
 #endif
 
 
 //lzma
 #ifndef AOCL_EXCLUDE_LZMA
+typedef struct {
+    CLzmaEncHandle enc;     //encoder kept across aocl_lzma_compress() calls
+    CLzmaDec dec;           //decoder kept across aocl_lzma_decompress() calls
+} lzma_params_t;
+
 AOCL_CHAR *aocl_lzma_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                       AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog)
 {
     aocl_setup_lzma_encode(optOff, optLevel, insize, level, windowLog);
     aocl_setup_lzma_decode(optOff, optLevel, insize, level, windowLog);
-    return NULL;
+
+    return aocl_lzma_clone_workmem(NULL);
+}
+
+AOCL_VOID aocl_lzma_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    aocl_setup_lzma_encode(optOff, optLevel, 0, 0, 0);
+    aocl_setup_lzma_decode(optOff, optLevel, 0, 0, 0);
+}
+
+//The encoder allocates its match finder on first use
+AOCL_CHAR *aocl_lzma_clone_workmem(AOCL_CHAR *)
+{
+    lzma_params_t *lzma_params = (lzma_params_t *)calloc(1, sizeof(lzma_params_t));
+    if (!lzma_params)
+        return NULL;
+    LzmaDec_Construct(&lzma_params->dec);
+    return (AOCL_CHAR *)lzma_params;
 }
 
 AOCL_INT64 aocl_lzma_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
-                         AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
+                         AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *workmem)
 {
     CLzmaEncProps encProps;
     AOCL_INTP res;
     AOCL_UINTP headerSize = LZMA_PROPS_SIZE;
     SizeT outLen = outsize - LZMA_PROPS_SIZE;
+    lzma_params_t *lzma_params = (lzma_params_t *)workmem;
 	
     LzmaEncProps_Init(&encProps);
     encProps.level = level;
 
-    res = LzmaEncode((AOCL_UINT8 *)outbuf+LZMA_PROPS_SIZE, &outLen, (AOCL_UINT8 *)inbuf, 
+    if (lzma_params && !lzma_params->enc)
+        lzma_params->enc = LzmaEnc_Create(&g_Alloc);
+    if (lzma_params && lzma_params->enc)
+    {
+        res = LzmaEncode_Reuse(lzma_params->enc, (AOCL_UINT8 *)outbuf+LZMA_PROPS_SIZE, &outLen,
+                     (AOCL_UINT8 *)inbuf, insize, &encProps, (AOCL_UINT8 *)outbuf, &headerSize,
+                     0, NULL, &g_Alloc, &g_Alloc);
+    }
+    else
+    {
+        res = LzmaEncode((AOCL_UINT8 *)outbuf+LZMA_PROPS_SIZE, &outLen, (AOCL_UINT8 *)inbuf, 
                      insize, &encProps, (AOCL_UINT8 *)outbuf, &headerSize, 0, NULL, 
                      &g_Alloc, &g_Alloc);
+    }
 	if (res == SZ_OK)
         return LZMA_PROPS_SIZE + outLen;
     
@@ -224,14 +1004,20 @@ AOCL_INT64 aocl_lzma_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *ou
 }
 
 AOCL_INT64 aocl_lzma_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
-						   AOCL_UINTP outsize, AOCL_UINTP, AOCL_UINTP, AOCL_CHAR *)
+						   AOCL_UINTP outsize, AOCL_UINTP, AOCL_UINTP, AOCL_CHAR *workmem)
 {
     AOCL_INTP res;
     SizeT outLen = outsize;
     SizeT srcLen = insize - LZMA_PROPS_SIZE;
     ELzmaStatus status;
+    lzma_params_t *lzma_params = (lzma_params_t *)workmem;
 	
-    res = LzmaDecode((AOCL_UINT8 *)outbuf, &outLen, (AOCL_UINT8 *)inbuf+LZMA_PROPS_SIZE, 
+    if (lzma_params)
+        res = LzmaDecode_Reuse(&lzma_params->dec, (AOCL_UINT8 *)outbuf, &outLen,
+                     (AOCL_UINT8 *)inbuf+LZMA_PROPS_SIZE, &srcLen, (AOCL_UINT8 *)inbuf,
+                     LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    else
+        res = LzmaDecode((AOCL_UINT8 *)outbuf, &outLen, (AOCL_UINT8 *)inbuf+LZMA_PROPS_SIZE, 
                      &srcLen, (AOCL_UINT8 *)inbuf, LZMA_PROPS_SIZE, LZMA_FINISH_END,
                      &status, &g_Alloc);
     if (res == SZ_OK ||
@@ -242,10 +1028,229 @@ AOCL_INT64 aocl_lzma_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *
     return CODEC_ERROR;
 }
 
+static AOCL_INT64 aocl_lzma_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                     AOCL_UINTP outsize, AOCL_INT32, AOCL_INT32, AOCL_CHAR *stream, AOCL_CHAR *)
+{
+    AOCL_INTP res;
+    SizeT outLen = outsize;
+    SizeT srcLen = insize;
+    ELzmaStatus status;
+    //All the partitions are coded with the properties at the start of the stream
+    res = LzmaDecode((AOCL_UINT8 *)outbuf, &outLen, (AOCL_UINT8 *)inbuf, &srcLen,
+                     (AOCL_UINT8 *)stream, LZMA_PROPS_SIZE, LZMA_FINISH_ANY, &status, &g_Alloc);
+    if (res == SZ_OK ||
+        (res == SZ_ERROR_INPUT_EOF && status == LZMA_STATUS_NEEDS_MORE_INPUT && outLen > 0))
+        return outLen;
+    return CODEC_ERROR;
+}
+
+AOCL_INT64 aocl_lzma_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                 AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    if (inbuf == NULL || insize < LZMA_PROPS_SIZE)
+        return CODEC_ERROR;
+    return aocl_decompress_range(aocl_lzma_decode_prefix, inbuf, insize, LZMA_PROPS_SIZE,
+                                 LZMA_PROPS_SIZE, outbuf, outsize, offset, workmem);
+}
+
+AOCL_VOID aocl_lzma_free_workmem(AOCL_CHAR *workmem)
+{
+    lzma_params_t *lzma_params = (lzma_params_t *)workmem;
+    if (lzma_params)
+    {
+        if (lzma_params->enc)
+            LzmaEnc_Destroy(lzma_params->enc, &g_Alloc, &g_Alloc);
+        LzmaDec_FreeProbs(&lzma_params->dec, &g_Alloc);
+        free(workmem);
+    }
+}
+
 AOCL_VOID aocl_lzma_destroy(AOCL_CHAR* workmem) {
+    aocl_lzma_free_workmem(workmem);
     aocl_destroy_lzma_encode();
     aocl_destroy_lzma_decode();
 }
+
+//LZMA streams hold the properties followed by chunks of at most
+//LZMA_STREAM_CHUNK_SIZE uncompressed bytes, each coded independently and
+//closed by an end marker. Streams of aocl_lzma_compress() are also read.
+#define LZMA_STREAM_CHUNK_SIZE (4 * 1024 * 1024)
+#define LZMA_STREAM_CHUNK_BOUND (LZMA_STREAM_CHUNK_SIZE + LZMA_STREAM_CHUNK_SIZE / 3 + 128)
+
+typedef struct {
+    AOCL_INTP decompress;
+    AOCL_INTP ended;
+    CLzmaEncHandle enc;
+    CLzmaDec dec;
+    ELzmaStatus status;     //decoder status after the last call
+    AOCL_INTP atChunkStart; //no byte of the current chunk is decoded yet
+    AOCL_UINT8 props[LZMA_PROPS_SIZE];
+    AOCL_UINTP propsLen;
+    AOCL_CHAR *chunk;       //uncompressed chunk on compression
+    AOCL_UINTP chunkLen;
+    AOCL_CHAR *frame;       //compressed data pending output on compression
+    AOCL_UINTP frameLen;
+    AOCL_UINTP framePos;
+} lzma_stream_t;
+
+AOCL_VOID aocl_lzma_stream_free(AOCL_CHAR *stream)
+{
+    lzma_stream_t *ls = (lzma_stream_t *)stream;
+    if (ls == NULL)
+        return;
+    if (ls->enc)
+        LzmaEnc_Destroy(ls->enc, &g_Alloc, &g_Alloc);
+    if (ls->decompress)
+        LzmaDec_Free(&ls->dec, &g_Alloc);
+    free(ls->chunk);
+    free(ls->frame);
+    free(ls);
+}
+
+AOCL_CHAR *aocl_lzma_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP)
+{
+    lzma_stream_t *ls = (lzma_stream_t *)calloc(1, sizeof(lzma_stream_t));
+    if (ls == NULL)
+        return NULL;
+    ls->decompress = decompress;
+    if (decompress)
+    {
+        LzmaDec_Construct(&ls->dec);
+        return (AOCL_CHAR *)ls;
+    }
+
+    CLzmaEncProps encProps;
+    SizeT propsSize = LZMA_PROPS_SIZE;
+    LzmaEncProps_Init(&encProps);
+    encProps.level = level;
+    //Chunks are at most this long: no larger dictionary gets allocated
+    encProps.reduceSize = LZMA_STREAM_CHUNK_SIZE;
+#ifdef AOCL_LZMA_OPT
+    encProps.srcLen = LZMA_STREAM_CHUNK_SIZE;
+#endif
+    ls->enc = LzmaEnc_Create(&g_Alloc);
+    ls->chunk = (AOCL_CHAR *)malloc(LZMA_STREAM_CHUNK_SIZE);
+    ls->frame = (AOCL_CHAR *)malloc(LZMA_STREAM_CHUNK_BOUND);
+    if (ls->enc == NULL || ls->chunk == NULL || ls->frame == NULL ||
+        LzmaEnc_SetProps_Dyn(ls->enc, &encProps) != SZ_OK ||
+        LzmaEnc_WriteProperties(ls->enc, (AOCL_UINT8 *)ls->frame, &propsSize) != SZ_OK)
+    {
+        aocl_lzma_stream_free((AOCL_CHAR *)ls);
+        return NULL;
+    }
+    ls->frameLen = propsSize;
+    return (AOCL_CHAR *)ls;
+}
+
+static AOCL_INT64 aocl_lzma_stream_compress(lzma_stream_t *ls, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                                       AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    AOCL_UINTP written = 0;
+
+    if (ls->ended && *insize > 0)
+        return CODEC_ERROR; //input after the end of the stream
+    for (;;)
+    {
+        AOCL_UINTP n;
+
+        written += aocl_stream_drain(ls->frame, &ls->framePos, ls->frameLen,
+                                     outbuf + written, outsize - written);
+        if (ls->framePos < ls->frameLen || ls->ended)
+            break;
+
+        n = LZMA_STREAM_CHUNK_SIZE - ls->chunkLen;
+        if (n > *insize)
+            n = *insize;
+        if (n)
+            memcpy(ls->chunk + ls->chunkLen, *inbuf, n);
+        ls->chunkLen += n;
+        *inbuf += n;
+        *insize -= n;
+        if (ls->chunkLen < LZMA_STREAM_CHUNK_SIZE && !(finish && *insize == 0))
+            break; //wait for a full chunk
+
+        if (ls->chunkLen == 0)
+        {
+            ls->ended = 1;
+            continue;
+        }
+        SizeT outLen = LZMA_STREAM_CHUNK_BOUND;
+        if (LzmaEnc_MemEncode(ls->enc, (AOCL_UINT8 *)ls->frame, &outLen,
+                              (AOCL_UINT8 *)ls->chunk, ls->chunkLen, 1, NULL,
+                              &g_Alloc, &g_Alloc) != SZ_OK)
+            return CODEC_ERROR;
+        ls->frameLen = outLen;
+        ls->framePos = 0;
+        ls->chunkLen = 0;
+    }
+    return written;
+}
+
+static AOCL_INT64 aocl_lzma_stream_decompress(lzma_stream_t *ls, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                                         AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    AOCL_UINTP written = 0;
+
+    if (ls->propsLen < LZMA_PROPS_SIZE)
+    {
+        AOCL_UINTP n = LZMA_PROPS_SIZE - ls->propsLen;
+        if (n > *insize)
+            n = *insize;
+        if (n)
+            memcpy(ls->props + ls->propsLen, *inbuf, n);
+        ls->propsLen += n;
+        *inbuf += n;
+        *insize -= n;
+        if (ls->propsLen < LZMA_PROPS_SIZE)
+            return finish ? CODEC_ERROR : 0;
+        if (LzmaDec_Allocate(&ls->dec, ls->props, LZMA_PROPS_SIZE, &g_Alloc) != SZ_OK)
+            return CODEC_ERROR;
+        LzmaDec_Init(&ls->dec);
+        ls->atChunkStart = 1;
+    }
+
+    while (written < outsize)
+    {
+        SizeT inLen = *insize, outLen = outsize - written;
+        if (LzmaDec_DecodeToBuf(&ls->dec, (AOCL_UINT8 *)outbuf + written, &outLen,
+                                (const AOCL_UINT8 *)*inbuf, &inLen, LZMA_FINISH_ANY,
+                                &ls->status) != SZ_OK)
+            return CODEC_ERROR;
+        *inbuf += inLen;
+        *insize -= inLen;
+        written += outLen;
+        if (ls->status == LZMA_STATUS_FINISHED_WITH_MARK)
+        {
+            //The next chunk starts with a new state and an empty dictionary
+            LzmaDec_Init(&ls->dec);
+            ls->atChunkStart = 1;
+            continue;
+        }
+        if (inLen > 0)
+            ls->atChunkStart = 0;
+        if (inLen == 0 && outLen == 0)
+            break;
+    }
+
+    //Streams of aocl_lzma_compress() end without a marker: the range coder is
+    //then flushed to a zero code with no pending match
+    if (finish && *insize == 0 && written < outsize && !ls->atChunkStart &&
+        ls->status != LZMA_STATUS_MAYBE_FINISHED_WITHOUT_MARK &&
+        !(ls->dec.remainLen == 0 && ls->dec.code == 0 && ls->dec.tempBufSize == 0))
+        return CODEC_ERROR; //truncated stream
+    return written;
+}
+
+AOCL_INT64 aocl_lzma_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                              AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    lzma_stream_t *ls = (lzma_stream_t *)stream;
+    if (ls == NULL)
+        return CODEC_ERROR;
+    if (ls->decompress)
+        return aocl_lzma_stream_decompress(ls, inbuf, insize, outbuf, outsize, finish);
+    return aocl_lzma_stream_compress(ls, inbuf, insize, outbuf, outsize, finish);
+}
 #endif
 
 
@@ -256,6 +1261,11 @@ AOCL_CHAR *aocl_snappy_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
     return snappy::aocl_setup_snappy(optOff, optLevel, insize, level, windowLog);
 }
 
+AOCL_VOID aocl_snappy_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    snappy::aocl_setup_snappy(optOff, optLevel, 0, 0, 0);
+}
+
 AOCL_INT64 aocl_snappy_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf, 
 						   AOCL_UINTP outsize, AOCL_UINTP, AOCL_UINTP, AOCL_CHAR *)
 {
@@ -299,25 +1309,241 @@ AOCL_INT64 aocl_snappy_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR
     return CODEC_ERROR;
 }
 
+static AOCL_INT64 aocl_snappy_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                       AOCL_UINTP outsize, AOCL_INT32 partition, AOCL_INT32,
+                                       AOCL_CHAR *, AOCL_CHAR *)
+{
+    AOCL_UINTP uncompressed_len;
+    AOCL_CHAR *tmp;
+    bool res;
+
+    //RAP partitions carry no length header
+    if (partition >= 0)
+        return snappy::RawUncompressPartitionMT(inbuf, insize, outbuf, outsize) ?
+               (AOCL_INT64)outsize : CODEC_ERROR;
+    if (!snappy::GetUncompressedLength(inbuf, insize, &uncompressed_len))
+        return CODEC_ERROR;
+    if (uncompressed_len <= outsize)
+        return snappy::RawUncompress(inbuf, insize, outbuf) ? uncompressed_len : CODEC_ERROR;
+
+    //Snappy cannot stop early: decode all and keep the prefix
+    tmp = (AOCL_CHAR *)malloc(uncompressed_len);
+    if (tmp == NULL)
+        return CODEC_ERROR;
+    res = snappy::RawUncompress(inbuf, insize, tmp);
+    if (res)
+        memcpy(outbuf, tmp, outsize);
+    free(tmp);
+    return res ? outsize : CODEC_ERROR;
+}
+
+//The length header of multi-threaded snappy streams follows the RAP frame
+AOCL_INT64 aocl_snappy_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                   AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    return aocl_decompress_range(aocl_snappy_decode_prefix, inbuf, insize, 0, 0,
+                                 outbuf, outsize, offset, workmem);
+}
+
 AOCL_VOID aocl_snappy_destroy(AOCL_CHAR* workmem) {
     snappy::aocl_destroy_snappy();
 }
+
+//Snappy blocks are compressed independently, each with its own length header
+static AOCL_INT64 aocl_snappy_stream_compress_block(AOCL_CHAR *, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                               AOCL_CHAR *dst, AOCL_UINTP dstCap)
+{
+    AOCL_UINTP outLen = dstCap + 1;
+    snappy::RawCompress(src, srcLen, dst, &outLen);
+    if (outLen <= dstCap)
+        return outLen;
+
+    return CODEC_ERROR;
+}
+
+static AOCL_INT64 aocl_snappy_stream_decompress_block(AOCL_CHAR *, AOCL_CHAR *src, AOCL_UINTP srcLen,
+                                                 AOCL_CHAR *dst, AOCL_UINTP dstCap)
+{
+    AOCL_UINTP uncompressed_len;
+    if (!snappy::GetUncompressedLength(src, srcLen, &uncompressed_len) || uncompressed_len > dstCap)
+        return CODEC_ERROR;
+    if (snappy::RawUncompress(src, srcLen, dst))
+        return uncompressed_len;
+
+    return CODEC_ERROR;
+}
+
+static AOCL_VOID aocl_snappy_stream_free_ctx(AOCL_CHAR *)
+{
+}
+
+AOCL_CHAR *aocl_snappy_stream_create(AOCL_INTP decompress, AOCL_UINTP, AOCL_UINTP)
+{
+    //Snappy keeps no state between blocks, so a placeholder is passed as context
+    static AOCL_CHAR no_ctx;
+    return aocl_block_stream_create(decompress, snappy::MaxCompressedLength(STREAM_BLOCK_SIZE),
+                                    decompress ? aocl_snappy_stream_decompress_block :
+                                                 aocl_snappy_stream_compress_block,
+                                    aocl_snappy_stream_free_ctx, &no_ctx);
+}
+
+AOCL_INT64 aocl_snappy_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                                AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    return aocl_block_stream_update(stream, inbuf, insize, outbuf, outsize, finish);
+}
+
+AOCL_VOID aocl_snappy_stream_free(AOCL_CHAR *stream)
+{
+    aocl_block_stream_free(stream);
+}
 #endif
 
 
 #ifndef AOCL_EXCLUDE_ZLIB
+#ifdef AOCL_ENABLE_THREADS
+//Smaller inputs are coded by a single thread, so they go to the reused streams
+#define ZLIB_REUSE_MAX_SIZE (32768 * WINDOW_FACTOR)
+#endif
+
+typedef struct {
+    z_stream dstrm;         //deflate stream, kept across aocl_zlib_compress() calls
+    z_stream istrm;         //inflate stream, kept across aocl_zlib_decompress() calls
+    AOCL_INTP dInit;
+    AOCL_INTP iInit;
+    AOCL_UINTP level;       //level dstrm is initialized with
+    AOCL_CHAR *dict;        //dictionary set on both streams for every call, NULL if none
+    AOCL_UINTP dictSize;
+} zlib_params_t;
+
 AOCL_CHAR *aocl_zlib_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                       AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog)
 {
-    return aocl_setup_zlib (optOff, optLevel, insize, level, windowLog);
+    aocl_setup_zlib (optOff, optLevel, insize, level, windowLog);
+
+    //Streams are initialized on first use: a handle may only compress or decompress
+    return (AOCL_CHAR *)calloc(1, sizeof(zlib_params_t));
+}
+
+AOCL_VOID aocl_zlib_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
+{
+    aocl_setup_zlib(optOff, optLevel, 0, 0, 0);
+}
+
+//Deflate with the stream kept in workmem, reset instead of reallocated per call
+static AOCL_INT64 aocl_zlib_compress_reuse(zlib_params_t *zp, AOCL_CHAR *inbuf, AOCL_UINTP insize,
+                                      AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_UINTP level)
+{
+    z_stream *strm = &zp->dstrm;
+    AOCL_UINTP inLeft = insize, outLeft = outsize;
+    AOCL_INTP res = Z_OK;
+
+    if (zp->dInit && zp->level != level)
+    {
+        deflateEnd(strm);
+        zp->dInit = 0;
+    }
+    if (!zp->dInit)
+    {
+        memset(strm, 0, sizeof(z_stream));
+        if (deflateInit(strm, (AOCL_INTP)level) != Z_OK)
+            return CODEC_ERROR;
+        zp->dInit = 1;
+        zp->level = level;
+    }
+    else if (deflateReset(strm) != Z_OK)
+        return CODEC_ERROR;
+    if (zp->dict && deflateSetDictionary(strm, (const Bytef *)zp->dict, (uInt)zp->dictSize) != Z_OK)
+        return CODEC_ERROR;
+
+    strm->next_in = (Bytef *)inbuf;
+    strm->avail_in = 0;
+    strm->next_out = (Bytef *)outbuf;
+    strm->avail_out = 0;
+    do {
+        if (strm->avail_out == 0)
+        {
+            strm->avail_out = (outLeft > UINT_MAX) ? UINT_MAX : (uInt)outLeft;
+            outLeft -= strm->avail_out;
+        }
+        if (strm->avail_in == 0)
+        {
+            strm->avail_in = (inLeft > UINT_MAX) ? UINT_MAX : (uInt)inLeft;
+            inLeft -= strm->avail_in;
+        }
+        res = deflate(strm, inLeft ? Z_NO_FLUSH : Z_FINISH);
+    } while (res == Z_OK);
+
+    if (res == Z_STREAM_END)
+        return strm->total_out;
+    return CODEC_ERROR;
+}
+
+//Inflate with the stream kept in workmem, reset instead of reallocated per call
+static AOCL_INT64 aocl_zlib_decompress_reuse(zlib_params_t *zp, AOCL_CHAR *inbuf, AOCL_UINTP insize,
+                                        AOCL_CHAR *outbuf, AOCL_UINTP outsize)
+{
+    z_stream *strm = &zp->istrm;
+    AOCL_UINTP inLeft = insize, outLeft = outsize;
+    AOCL_INTP res = Z_OK;
+
+    if (!zp->iInit)
+    {
+        memset(strm, 0, sizeof(z_stream));
+        if (inflateInit(strm) != Z_OK)
+            return CODEC_ERROR;
+        zp->iInit = 1;
+    }
+    else if (inflateReset(strm) != Z_OK)
+        return CODEC_ERROR;
+
+    strm->next_in = (Bytef *)inbuf;
+    strm->avail_in = 0;
+    strm->next_out = (Bytef *)outbuf;
+    strm->avail_out = 0;
+    do {
+        //inflate() stops with Z_BUF_ERROR once it can make no progress
+        if (strm->avail_out == 0)
+        {
+            strm->avail_out = (outLeft > UINT_MAX) ? UINT_MAX : (uInt)outLeft;
+            outLeft -= strm->avail_out;
+        }
+        if (strm->avail_in == 0)
+        {
+            strm->avail_in = (inLeft > UINT_MAX) ? UINT_MAX : (uInt)inLeft;
+            inLeft -= strm->avail_in;
+        }
+        res = inflate(strm, Z_NO_FLUSH);
+        if (res == Z_NEED_DICT && zp->dict) //fails on a stream made with another dictionary
+            res = inflateSetDictionary(strm, (const Bytef *)zp->dict, (uInt)zp->dictSize);
+    } while (res == Z_OK);
+
+    if (res == Z_STREAM_END)
+        return strm->total_out;
+    return CODEC_ERROR;
 }
 
 AOCL_INT64 aocl_zlib_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
-                         AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *)
+                         AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP, AOCL_CHAR *workmem)
 {
+#ifdef AOCL_ENABLE_THREADS
+    //Multi-threaded streams cannot carry a dictionary
+    if (workmem && (insize < ZLIB_REUSE_MAX_SIZE || ((zlib_params_t *)workmem)->dict))
+#else
+    if (workmem)
+#endif
+        return aocl_zlib_compress_reuse((zlib_params_t *)workmem, inbuf, insize,
+                                        outbuf, outsize, level);
+
     uLongf zencLen = outsize;
+#ifdef AOCL_ENABLE_THREADS
+    //Partitions are deflated by the threads into one standard zlib stream
+    AOCL_INTP res = aocl_parallel_compress_zlib((AOCL_UINT8 *)outbuf, &zencLen,
+                         (AOCL_UINT8 *)inbuf, insize, level, MAX_WBITS);
+#else
     AOCL_INTP res = compress2((AOCL_UINT8 *)outbuf, &zencLen, 
                          (AOCL_UINT8 *)inbuf, insize, level);
+#endif
     if (res == Z_OK)
         return zencLen;
     
@@ -325,8 +1551,18 @@ AOCL_INT64 aocl_zlib_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *ou
 }
 
 AOCL_INT64 aocl_zlib_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf, 
-						   AOCL_UINTP outsize, AOCL_UINTP, AOCL_UINTP, AOCL_CHAR *)
+						   AOCL_UINTP outsize, AOCL_UINTP, AOCL_UINTP, AOCL_CHAR *workmem)
 {
+#ifdef AOCL_ENABLE_THREADS
+    //Streams of the multi-threaded compress2() start with a RAP frame and are left to uncompress()
+    if (workmem && inbuf && (insize == 0 ||
+        (AOCL_UINT8)inbuf[0] != (AOCL_UINT8)(RAP_MAGIC_WORD & 0xFF)))
+#else
+    if (workmem && inbuf)
+#endif
+        return aocl_zlib_decompress_reuse((zlib_params_t *)workmem, inbuf, insize,
+                                          outbuf, outsize);
+
     uLongf zdecLen = outsize;
     AOCL_INTP res = uncompress((AOCL_UINT8*)outbuf, &zdecLen, (AOCL_UINT8 *)inbuf, insize);
     if (res == Z_OK)
@@ -335,9 +1571,252 @@ AOCL_INT64 aocl_zlib_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *
     return CODEC_ERROR;
 }
 
+static AOCL_INT64 aocl_zlib_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                     AOCL_UINTP outsize, AOCL_INT32 partition, AOCL_INT32, AOCL_CHAR *, AOCL_CHAR *)
+{
+    z_stream strm;
+    AOCL_INTP res = Z_OK;
+    AOCL_UINTP inLeft, outLeft = outsize, decoded;
+
+    //RAP partitions hold raw deflate data. The first one starts with the zlib header
+    //and the last one ends with the adler32 trailer, which inflate does not read.
+    if (partition == 0)
+    {
+        if (insize < 2)
+            return CODEC_ERROR;
+        inbuf += 2;
+        insize -= 2;
+    }
+    memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, (partition < 0) ? MAX_WBITS : -MAX_WBITS) != Z_OK)
+        return CODEC_ERROR;
+    inLeft = insize;
+    strm.next_in = (Bytef *)inbuf;
+    strm.next_out = (Bytef *)outbuf;
+    while (res == Z_OK)
+    {
+        if (strm.avail_in == 0 && inLeft)
+        {
+            strm.avail_in = (inLeft > UINT_MAX) ? UINT_MAX : (uInt)inLeft;
+            inLeft -= strm.avail_in;
+        }
+        if (strm.avail_out == 0)
+        {
+            if (outLeft == 0)
+                break;
+            strm.avail_out = (outLeft > UINT_MAX) ? UINT_MAX : (uInt)outLeft;
+            outLeft -= strm.avail_out;
+        }
+        res = inflate(&strm, Z_NO_FLUSH);
+    }
+    decoded = outsize - outLeft - strm.avail_out;
+    inflateEnd(&strm);
+    //Partitions other than the last end with a sync flush and no final block
+    if (res == Z_STREAM_END || decoded == outsize ||
+        (res == Z_BUF_ERROR && partition >= 0 && strm.avail_in == 0 && inLeft == 0))
+        return decoded;
+    return CODEC_ERROR;
+}
+
+AOCL_INT64 aocl_zlib_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                 AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    return aocl_decompress_range(aocl_zlib_decode_prefix, inbuf, insize, 0, 0,
+                                 outbuf, outsize, offset, workmem);
+}
+
+//Deflate keeps no digested form of a dictionary across deflateReset(): the dictionary
+//is kept whole, as inflate checks its Adler-32, and set on the stream per call
+AOCL_INT32 aocl_zlib_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                                AOCL_UINTP dictSize, AOCL_UINTP)
+{
+    zlib_params_t *zp = (zlib_params_t *)*workBuf;
+    AOCL_CHAR *copy = NULL;
+
+    if (zp == NULL || dictSize > UINT_MAX)
+        return CODEC_ERROR;
+    if (dictSize)
+    {
+        copy = (AOCL_CHAR *)malloc(dictSize);
+        if (copy == NULL)
+            return CODEC_ERROR;
+        memcpy(copy, dict, dictSize);
+    }
+    free(zp->dict);
+    zp->dict = copy;
+    zp->dictSize = dictSize;
+    return 0;
+}
+
+AOCL_CHAR *aocl_zlib_clone_workmem(AOCL_CHAR *workmem)
+{
+    zlib_params_t *zp = (zlib_params_t *)workmem;
+    AOCL_CHAR *clone = (AOCL_CHAR *)calloc(1, sizeof(zlib_params_t));
+    if (clone && zp && zp->dict &&
+        aocl_zlib_load_dictionary(&clone, zp->dict, zp->dictSize, 0) != 0)
+    {
+        free(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+AOCL_VOID aocl_zlib_free_workmem(AOCL_CHAR *workmem)
+{
+    zlib_params_t *zp = (zlib_params_t *)workmem;
+    if (zp)
+    {
+        if (zp->dInit)
+            deflateEnd(&zp->dstrm);
+        if (zp->iInit)
+            inflateEnd(&zp->istrm);
+        free(zp->dict);
+        free(workmem);
+    }
+}
+
+//Streams must be freed before aocl_destroy_zlib()
 AOCL_VOID aocl_zlib_destroy(AOCL_CHAR* workmem) {
+    aocl_zlib_free_workmem(workmem);
     aocl_destroy_zlib();
 }
+
+typedef struct {
+    AOCL_INTP decompress;
+    AOCL_INTP ended;
+    z_stream strm;
+#ifdef AOCL_ENABLE_THREADS
+    AOCL_INTP rapChecked;   //start of the stream is checked for a RAP frame
+    AOCL_UINT8 rap[RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES];
+    AOCL_UINTP rapLen;
+    AOCL_UINTP rapSkip;     //bytes of the RAP frame left to skip
+#endif
+} zlib_stream_t;
+
+AOCL_CHAR *aocl_zlib_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP)
+{
+    AOCL_INTP res;
+    zlib_stream_t *zs = (zlib_stream_t *)calloc(1, sizeof(zlib_stream_t));
+    if (zs == NULL)
+        return NULL;
+    zs->decompress = decompress;
+    if (decompress)
+        res = inflateInit(&zs->strm);
+    else
+        res = deflateInit(&zs->strm, (AOCL_INTP)level);
+    if (res != Z_OK)
+    {
+        free(zs);
+        return NULL;
+    }
+    return (AOCL_CHAR *)zs;
+}
+
+#ifdef AOCL_ENABLE_THREADS
+//Multi-threaded zlib streams start with a RAP frame, whose first byte can not
+//start a zlib header. Returns 0 once the stream data is reached, 1 when more
+//input is needed and CODEC_ERROR for an invalid frame.
+static AOCL_INTP aocl_zlib_stream_skip_rap(zlib_stream_t *zs, AOCL_CHAR **inbuf, AOCL_UINTP *insize)
+{
+    AOCL_UINTP n;
+    if (!zs->rapChecked)
+    {
+        AOCL_UINT64 magic;
+        AOCL_UINT32 metadataLen;
+        if (*insize == 0)
+            return 1;
+        if (zs->rapLen == 0 && (AOCL_UINT8)(*inbuf)[0] != (AOCL_UINT8)(RAP_MAGIC_WORD & 0xFF))
+        {
+            zs->rapChecked = 1;
+            return 0;
+        }
+        n = sizeof(zs->rap) - zs->rapLen;
+        if (n > *insize)
+            n = *insize;
+        if (n)
+            memcpy(zs->rap + zs->rapLen, *inbuf, n);
+        zs->rapLen += n;
+        *inbuf += n;
+        *insize -= n;
+        if (zs->rapLen < sizeof(zs->rap))
+            return 1;
+        memcpy(&magic, zs->rap, RAP_MAGIC_WORD_BYTES);
+        memcpy(&metadataLen, zs->rap + RAP_MAGIC_WORD_BYTES, RAP_METADATA_LEN_BYTES);
+        if ((magic != RAP_MAGIC_WORD && magic != RAP_MAGIC_WORD_64) || metadataLen < sizeof(zs->rap))
+            return CODEC_ERROR;
+        zs->rapSkip = metadataLen - sizeof(zs->rap);
+        zs->rapChecked = 1;
+    }
+    n = (zs->rapSkip > *insize) ? *insize : zs->rapSkip;
+    *inbuf += n;
+    *insize -= n;
+    zs->rapSkip -= n;
+    return (zs->rapSkip > 0) ? 1 : 0;
+}
+#endif
+
+AOCL_INT64 aocl_zlib_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                              AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    zlib_stream_t *zs = (zlib_stream_t *)stream;
+    AOCL_UINTP written = 0;
+
+    if (zs == NULL)
+        return CODEC_ERROR;
+#ifdef AOCL_ENABLE_THREADS
+    if (zs->decompress)
+    {
+        AOCL_INTP res = aocl_zlib_stream_skip_rap(zs, inbuf, insize);
+        if (res < 0 || (res > 0 && finish))
+            return CODEC_ERROR;
+        if (res > 0)
+            return 0;
+    }
+#endif
+    while (!zs->ended && written < outsize)
+    {
+        uInt availIn = (*insize > UINT_MAX) ? UINT_MAX : (uInt)*insize;
+        uInt availOut = (outsize - written > UINT_MAX) ? UINT_MAX : (uInt)(outsize - written);
+        AOCL_UINTP consumed, produced;
+        AOCL_INTP res;
+
+        zs->strm.next_in = (Bytef *)*inbuf;
+        zs->strm.avail_in = availIn;
+        zs->strm.next_out = (Bytef *)outbuf + written;
+        zs->strm.avail_out = availOut;
+        if (zs->decompress)
+            res = inflate(&zs->strm, Z_NO_FLUSH);
+        else
+            res = deflate(&zs->strm, (finish && *insize == availIn) ? Z_FINISH : Z_NO_FLUSH);
+        if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR)
+            return CODEC_ERROR;
+        consumed = availIn - zs->strm.avail_in;
+        produced = availOut - zs->strm.avail_out;
+        *inbuf += consumed;
+        *insize -= consumed;
+        written += produced;
+        if (res == Z_STREAM_END)
+            zs->ended = 1;
+        else if (consumed == 0 && produced == 0)
+            break;
+    }
+
+    if (zs->decompress && finish && !zs->ended && *insize == 0 && written < outsize)
+        return CODEC_ERROR; //truncated stream
+    return written;
+}
+
+AOCL_VOID aocl_zlib_stream_free(AOCL_CHAR *stream)
+{
+    zlib_stream_t *zs = (zlib_stream_t *)stream;
+    if (zs == NULL)
+        return;
+    if (zs->decompress)
+        inflateEnd(&zs->strm);
+    else
+        deflateEnd(&zs->strm);
+    free(zs);
+}
 #endif
 
 
@@ -347,32 +1826,30 @@ typedef struct {
     ZSTD_CCtx *cctx;
     ZSTD_DCtx *dctx;
     ZSTD_CDict *cdict;
+    ZSTD_DDict *ddict;      //referenced by dctx while a dictionary is loaded
+    AOCL_CHAR *dict;        //dictionary content both digested forms refer to
+    AOCL_UINTP dictSize;
+    AOCL_UINTP cdictLevel;  //level cdict is digested for
     ZSTD_parameters zparams;
     ZSTD_customMem cmem;
 } zstd_params_t;
 AOCL_CHAR *aocl_zstd_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                       AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog)
 {
-    zstd_params_t *zstd_params = (zstd_params_t *) 
-    malloc(sizeof(zstd_params_t));
-
     aocl_setup_zstd_encode(optOff, optLevel, insize, level, windowLog);
     aocl_setup_zstd_decode(optOff, optLevel, insize, level, windowLog);
-    
-    if (!zstd_params)
-		return NULL;
-    zstd_params->cctx = ZSTD_createCCtx();
-    zstd_params->dctx = ZSTD_createDCtx();
-    zstd_params->cdict = NULL;
 
-    return (AOCL_CHAR*) zstd_params;
+    return aocl_zstd_clone_workmem(NULL);
 }
 
-AOCL_VOID aocl_zstd_destroy(AOCL_CHAR *workmem)
+AOCL_VOID aocl_zstd_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel)
 {
-    aocl_destroy_zstd_encode();
-    aocl_destroy_zstd_decode();
+    aocl_setup_zstd_encode(optOff, optLevel, 0, 0, 0);
+    aocl_setup_zstd_decode(optOff, optLevel, 0, 0, 0);
+}
 
+AOCL_VOID aocl_zstd_free_workmem(AOCL_CHAR *workmem)
+{
     zstd_params_t *zstd_params = (zstd_params_t *) workmem;
     if (!zstd_params)
 		return;
@@ -382,9 +1859,128 @@ AOCL_VOID aocl_zstd_destroy(AOCL_CHAR *workmem)
 		ZSTD_freeDCtx(zstd_params->dctx);
     if (zstd_params->cdict)
 		ZSTD_freeCDict(zstd_params->cdict);
+    if (zstd_params->ddict)
+		ZSTD_freeDDict(zstd_params->ddict);
+    free(zstd_params->dict);
     free(workmem);
 }
 
+//New contexts, along with the dictionary of workmem if any
+AOCL_CHAR *aocl_zstd_clone_workmem(AOCL_CHAR *workmem)
+{
+    zstd_params_t *src = (zstd_params_t *) workmem;
+    zstd_params_t *zstd_params = (zstd_params_t *) 
+    malloc(sizeof(zstd_params_t));
+
+    if (!zstd_params)
+		return NULL;
+    zstd_params->cctx = ZSTD_createCCtx();
+    zstd_params->dctx = ZSTD_createDCtx();
+    zstd_params->cdict = NULL;
+    zstd_params->ddict = NULL;
+    zstd_params->dict = NULL;
+    zstd_params->dictSize = 0;
+    zstd_params->cdictLevel = 0;
+
+    if (src && src->dict &&
+        aocl_zstd_load_dictionary((AOCL_CHAR **)&zstd_params, src->dict,
+                                  src->dictSize, src->cdictLevel) != 0)
+    {
+        aocl_zstd_free_workmem((AOCL_CHAR *)zstd_params);
+        return NULL;
+    }
+    return (AOCL_CHAR*) zstd_params;
+}
+
+AOCL_VOID aocl_zstd_destroy(AOCL_CHAR *workmem)
+{
+    aocl_destroy_zstd_encode();
+    aocl_destroy_zstd_decode();
+
+    aocl_zstd_free_workmem(workmem);
+}
+
+AOCL_INT32 aocl_zstd_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                                AOCL_UINTP dictSize, AOCL_UINTP level)
+{
+    zstd_params_t *zstd_params = (zstd_params_t *) *workBuf;
+    AOCL_CHAR *copy = NULL;
+    ZSTD_DDict *ddict = NULL;
+    ZSTD_CDict *cdict = NULL;
+
+    if (!zstd_params || !zstd_params->dctx)
+        return CODEC_ERROR;
+
+    if (dictSize)
+    {
+        copy = (AOCL_CHAR *)malloc(dictSize);
+        if (copy == NULL)
+            return CODEC_ERROR;
+        memcpy(copy, dict, dictSize);
+        ddict = ZSTD_createDDict_byReference(copy, dictSize);
+        cdict = ZSTD_createCDict_byReference(copy, dictSize, (AOCL_INTP)level);
+        if (ddict == NULL || cdict == NULL)
+        {
+            ZSTD_freeDDict(ddict);
+            ZSTD_freeCDict(cdict);
+            free(copy);
+            return CODEC_ERROR;
+        }
+    }
+
+    //ZSTD_decompressDCtx() uses the referenced dictionary, NULL unloads it
+    if (ZSTD_isError(ZSTD_DCtx_refDDict(zstd_params->dctx, ddict)))
+    {
+        ZSTD_freeDDict(ddict);
+        ZSTD_freeCDict(cdict);
+        free(copy);
+        return CODEC_ERROR;
+    }
+    ZSTD_freeDDict(zstd_params->ddict);
+    ZSTD_freeCDict(zstd_params->cdict);
+    free(zstd_params->dict);
+    zstd_params->ddict = ddict;
+    zstd_params->cdict = cdict;
+    zstd_params->dict = copy;
+    zstd_params->dictSize = dictSize;
+    zstd_params->cdictLevel = level;
+    return 0;
+}
+
+//FASTCOVER searches k and d in parallel, see COVER_runJobs()
+AOCL_INT64 aocl_zstd_train_dictionary(const AOCL_CHAR *samples, const AOCL_UINTP *sampleSizes,
+                                 AOCL_UINT32 nbSamples, AOCL_CHAR *dict, AOCL_UINTP dictCapacity,
+                                 AOCL_UINTP level, AOCL_INT32 numThreads, AOCL_INTP rawContent)
+{
+    ZDICT_fastCover_params_t params;
+    AOCL_UINTP res, headerSize;
+
+    memset(&params, 0, sizeof(params));
+#ifdef AOCL_ENABLE_THREADS
+    params.nbThreads = aocl_get_available_threads_mt();
+    if (numThreads <= 0)
+        numThreads = aocl_get_num_threads_mt(); //budget of the calling thread
+    if ((AOCL_UINT32)numThreads < params.nbThreads)
+        params.nbThreads = numThreads;
+#else
+    params.nbThreads = 1;
+#endif
+    params.zParams.compressionLevel = (AOCL_INTP)level;
+    res = ZDICT_optimizeTrainFromBuffer_fastCover(dict, dictCapacity, samples, sampleSizes,
+                                                  nbSamples, &params);
+    if (ZDICT_isError(res))
+        return CODEC_ERROR;
+    if (!rawContent)
+        return res;
+
+    //Other methods take the content alone, which follows the zstd header and tables
+    headerSize = ZDICT_getDictHeaderSize(dict, res);
+    if (ZDICT_isError(headerSize) || headerSize >= res)
+        return CODEC_ERROR;
+    memmove(dict, dict + headerSize, res - headerSize);
+    return res - headerSize;
+}
+
 AOCL_INT64 aocl_zstd_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
                          AOCL_UINTP outsize, AOCL_UINTP level, AOCL_UINTP windowLog,
                          AOCL_CHAR *workmem)
@@ -395,6 +1991,25 @@ AOCL_INT64 aocl_zstd_compress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *ou
     if (!zstd_params || !zstd_params->cctx)
         return 0;
 
+    if (zstd_params->dict)
+    {
+        //Parameters come from the digested dictionary, which is rebuilt on a change of level
+        if (zstd_params->cdictLevel != level)
+        {
+            ZSTD_freeCDict(zstd_params->cdict);
+            zstd_params->cdict = ZSTD_createCDict_byReference(zstd_params->dict,
+                                        zstd_params->dictSize, (AOCL_INTP)level);
+            zstd_params->cdictLevel = level;
+        }
+        if (!zstd_params->cdict)
+            return CODEC_ERROR;
+        res = ZSTD_compress_usingCDict(zstd_params->cctx, outbuf, outsize, inbuf,
+                                       insize, zstd_params->cdict);
+        if (!ZSTD_isError(res))
+            return res;
+        return CODEC_ERROR;
+    }
+
     zstd_params->zparams = ZSTD_getParams(level, insize, 0);
     ZSTD_CCtx_setParameter(zstd_params->cctx, ZSTD_c_compressionLevel, level);
     zstd_params->zparams.fParams.contentSizeFlag = 1;
@@ -434,4 +2049,140 @@ AOCL_INT64 aocl_zstd_decompress(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *
 
     return CODEC_ERROR;
 }
+
+
+static AOCL_INT64 aocl_zstd_decode_prefix(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                     AOCL_UINTP outsize, AOCL_INT32, AOCL_INT32, AOCL_CHAR *, AOCL_CHAR *workmem)
+{
+    zstd_params_t *zstd_params = (zstd_params_t *) workmem;
+    ZSTD_inBuffer in = { inbuf, insize, 0 };
+    ZSTD_outBuffer out = { outbuf, outsize, 0 };
+
+    if (!zstd_params || !zstd_params->dctx)
+        return CODEC_ERROR;
+
+    ZSTD_DCtx_reset(zstd_params->dctx, ZSTD_reset_session_only);
+    while (out.pos < out.size)
+    {
+        AOCL_UINTP inPos = in.pos, outPos = out.pos;
+        AOCL_UINTP res = ZSTD_decompressStream(zstd_params->dctx, &out, &in);
+        if (ZSTD_isError(res))
+            return CODEC_ERROR;
+        if (res == 0 && in.pos == in.size)
+            break; //all the frames are decoded
+        if (in.pos == inPos && out.pos == outPos)
+            return CODEC_ERROR; //truncated frame
+    }
+    return out.pos;
+}
+
+//Every RAP partition of zstd streams is a complete zstd frame. The RAP frame
+//itself is held in a skippable frame at the start of the stream.
+AOCL_INT64 aocl_zstd_decompress_range(AOCL_CHAR *inbuf, AOCL_UINTP insize, AOCL_CHAR *outbuf,
+                                 AOCL_UINTP outsize, AOCL_UINT64 offset, AOCL_CHAR *workmem)
+{
+    AOCL_UINTP rappos = insize;
+    if (inbuf != NULL && ZSTD_isSkippableFrame(inbuf, insize))
+        rappos = ZSTD_SKIPPABLEHEADERSIZE;
+    return aocl_decompress_range(aocl_zstd_decode_prefix, inbuf, insize, 0, rappos,
+                                 outbuf, outsize, offset, workmem);
+}
+
+typedef struct {
+    AOCL_INTP decompress;
+    AOCL_INTP ended;
+    ZSTD_CStream *cstream;
+    ZSTD_DStream *dstream;
+    AOCL_UINTP lastRet;     //hint returned by the last ZSTD_decompressStream() call
+} zstd_stream_t;
+
+AOCL_VOID aocl_zstd_stream_free(AOCL_CHAR *stream)
+{
+    zstd_stream_t *zs = (zstd_stream_t *)stream;
+    if (zs == NULL)
+        return;
+    ZSTD_freeCStream(zs->cstream);
+    ZSTD_freeDStream(zs->dstream);
+    free(zs);
+}
+
+AOCL_CHAR *aocl_zstd_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP windowLog)
+{
+    zstd_stream_t *zs = (zstd_stream_t *)calloc(1, sizeof(zstd_stream_t));
+    if (zs == NULL)
+        return NULL;
+    zs->decompress = decompress;
+    zs->lastRet = 1; //no frame is decoded yet
+    if (decompress)
+    {
+        zs->dstream = ZSTD_createDStream();
+        if (zs->dstream == NULL)
+        {
+            aocl_zstd_stream_free((AOCL_CHAR *)zs);
+            return NULL;
+        }
+        return (AOCL_CHAR *)zs;
+    }
+
+    zs->cstream = ZSTD_createCStream();
+    if (zs->cstream == NULL ||
+        ZSTD_isError(ZSTD_CCtx_setParameter(zs->cstream, ZSTD_c_compressionLevel, level)))
+    {
+        aocl_zstd_stream_free((AOCL_CHAR *)zs);
+        return NULL;
+    }
+    //As in aocl_zstd_compress(), windowLog only lowers the window of the level
+    if (windowLog && ZSTD_getCParams(level, ZSTD_CONTENTSIZE_UNKNOWN, 0).windowLog > windowLog &&
+        ZSTD_isError(ZSTD_CCtx_setParameter(zs->cstream, ZSTD_c_windowLog, windowLog)))
+    {
+        aocl_zstd_stream_free((AOCL_CHAR *)zs);
+        return NULL;
+    }
+    return (AOCL_CHAR *)zs;
+}
+
+AOCL_INT64 aocl_zstd_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inbuf, AOCL_UINTP *insize,
+                              AOCL_CHAR *outbuf, AOCL_UINTP outsize, AOCL_INTP finish)
+{
+    zstd_stream_t *zs = (zstd_stream_t *)stream;
+    ZSTD_inBuffer in;
+    ZSTD_outBuffer out = { outbuf, outsize, 0 };
+
+    if (zs == NULL)
+        return CODEC_ERROR;
+    if (zs->ended && *insize > 0)
+        return CODEC_ERROR; //input after the end of the stream
+    in.src = *inbuf;
+    in.size = *insize;
+    in.pos = 0;
+    while (!zs->ended && out.pos < out.size)
+    {
+        AOCL_UINTP inPos = in.pos, outPos = out.pos, res;
+        if (zs->decompress)
+        {
+            res = ZSTD_decompressStream(zs->dstream, &out, &in);
+            if (ZSTD_isError(res))
+                return CODEC_ERROR;
+            if (in.pos != inPos || out.pos != outPos)
+                zs->lastRet = res; //an idle call hints at the next frame header
+        }
+        else
+        {
+            res = ZSTD_compressStream2(zs->cstream, &out, &in, finish ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(res))
+                return CODEC_ERROR;
+            if (finish && res == 0)
+                zs->ended = 1;
+        }
+        if (in.pos == inPos && out.pos == outPos)
+            break;
+    }
+    *inbuf += in.pos;
+    *insize -= in.pos;
+
+    //Frames end on a zero hint; a stream may hold several of them
+    if (zs->decompress && finish && *insize == 0 && out.pos < out.size && zs->lastRet != 0)
+        return CODEC_ERROR; //truncated stream
+    return out.pos;
+}
 #endif
@@ -45,6 +45,16 @@ typedef AOCL_INT64 (*comp_decomp_fp)(AOCL_CHAR *inStream, AOCL_UINTP inSize, AOC
 typedef AOCL_CHAR* (*setup_fp)(AOCL_INTP optOff, AOCL_INTP optLevel, AOCL_UINTP inSize, AOCL_UINTP,
                           AOCL_UINTP);
 typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
+typedef AOCL_VOID  (*dispatch_fp)(AOCL_INTP optOff, AOCL_INTP optLevel);
+typedef AOCL_INT64 (*decomp_range_fp)(AOCL_CHAR *inStream, AOCL_UINTP inSize, AOCL_CHAR *outStream,
+                                AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
+typedef AOCL_CHAR* (*stream_create_fp)(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+typedef AOCL_INT64 (*stream_update_fp)(AOCL_CHAR *stream, AOCL_CHAR **inStream, AOCL_UINTP *inSize,
+                                AOCL_CHAR *outStream, AOCL_UINTP outSize, AOCL_INTP finish);
+typedef AOCL_VOID  (*stream_free_fp)(AOCL_CHAR *stream);
+typedef AOCL_INT32 (*load_dict_fp)(AOCL_CHAR **workBuf, const AOCL_CHAR *dict, AOCL_UINTP dictSize,
+                                AOCL_UINTP level);
+typedef AOCL_CHAR* (*workmem_clone_fp)(AOCL_CHAR *workBuf);
 
 //Method 1
 #ifndef AOCL_EXCLUDE_BZIP2
@@ -52,14 +62,30 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_bzip2_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_bzip2_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_bzip2_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                            AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_bzip2_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_bzip2_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_bzip2_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_bzip2_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_bzip2_stream_free(AOCL_CHAR *stream);
+        AOCL_CHAR *aocl_bzip2_clone_workmem(AOCL_CHAR *workmem);
+        AOCL_VOID aocl_bzip2_free_workmem(AOCL_CHAR *workmem);
 #else
     #define aocl_bzip2_compress NULL
     #define aocl_bzip2_decompress NULL
+    #define aocl_bzip2_decompress_range NULL
     #define aocl_bzip2_setup NULL
+    #define aocl_bzip2_dispatch NULL
     #define aocl_bzip2_destroy NULL
+    #define aocl_bzip2_stream_create NULL
+    #define aocl_bzip2_stream_update NULL
+    #define aocl_bzip2_stream_free NULL
+    #define aocl_bzip2_clone_workmem NULL
+    #define aocl_bzip2_free_workmem NULL
 #endif
 //Method 2
 #ifndef AOCL_EXCLUDE_LZ4
@@ -67,14 +93,33 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_lz4_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf, 
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_lz4_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_lz4_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_lz4_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_lz4_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_lz4_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_lz4_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_lz4_stream_free(AOCL_CHAR *stream);
+        AOCL_CHAR *aocl_lz4_clone_workmem(AOCL_CHAR *workmem);
+        AOCL_VOID aocl_lz4_free_workmem(AOCL_CHAR *workmem);
+        AOCL_INT32 aocl_lz4_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                         AOCL_UINTP dictSize, AOCL_UINTP level);
 #else
     #define aocl_lz4_compress NULL
     #define aocl_lz4_decompress NULL
+    #define aocl_lz4_decompress_range NULL
     #define aocl_lz4_setup NULL
+    #define aocl_lz4_dispatch NULL
     #define aocl_lz4_destroy NULL
+    #define aocl_lz4_stream_create NULL
+    #define aocl_lz4_stream_update NULL
+    #define aocl_lz4_stream_free NULL
+    #define aocl_lz4_clone_workmem NULL
+    #define aocl_lz4_free_workmem NULL
+    #define aocl_lz4_load_dictionary NULL
 #endif
 //Method 3
 #if !defined(AOCL_EXCLUDE_LZ4HC) && !defined(AOCL_EXCLUDE_LZ4)
@@ -84,12 +129,16 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_lz4hc_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_lz4hc_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_lz4hc_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_lz4hc_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
 #else
     #define aocl_lz4hc_compress NULL
     #define aocl_lz4hc_decompress NULL
     #define aocl_lz4hc_setup NULL
+    #define aocl_lz4hc_dispatch NULL
     #define aocl_lz4hc_destroy NULL
+    #define aocl_lz4hc_stream_create NULL
 #endif
 //Method 4
 #ifndef AOCL_EXCLUDE_LZMA
@@ -97,14 +146,30 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_lzma_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf, 
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_lzma_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_lzma_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_lzma_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_lzma_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_lzma_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_lzma_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_lzma_stream_free(AOCL_CHAR *stream);
+        AOCL_CHAR *aocl_lzma_clone_workmem(AOCL_CHAR *workmem);
+        AOCL_VOID aocl_lzma_free_workmem(AOCL_CHAR *workmem);
 #else
     #define aocl_lzma_compress NULL
     #define aocl_lzma_decompress NULL
+    #define aocl_lzma_decompress_range NULL
     #define aocl_lzma_setup NULL
+    #define aocl_lzma_dispatch NULL
     #define aocl_lzma_destroy NULL
+    #define aocl_lzma_stream_create NULL
+    #define aocl_lzma_stream_update NULL
+    #define aocl_lzma_stream_free NULL
+    #define aocl_lzma_clone_workmem NULL
+    #define aocl_lzma_free_workmem NULL
 #endif
 //Method 5
 #ifndef AOCL_EXCLUDE_SNAPPY
@@ -112,14 +177,26 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_snappy_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf, 
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_snappy_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_snappy_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_snappy_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_snappy_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_snappy_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_snappy_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_snappy_stream_free(AOCL_CHAR *stream);
 #else
     #define aocl_snappy_compress NULL
     #define aocl_snappy_decompress NULL
+    #define aocl_snappy_decompress_range NULL
     #define aocl_snappy_setup NULL
+    #define aocl_snappy_dispatch NULL
     #define aocl_snappy_destroy NULL
+    #define aocl_snappy_stream_create NULL
+    #define aocl_snappy_stream_update NULL
+    #define aocl_snappy_stream_free NULL
 #endif
 //Method 6
 #ifndef AOCL_EXCLUDE_ZLIB
@@ -127,14 +204,33 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_zlib_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf, 
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_zlib_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_zlib_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_zlib_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_zlib_destroy(AOCL_CHAR* workmem);
+        AOCL_CHAR *aocl_zlib_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_zlib_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_zlib_stream_free(AOCL_CHAR *stream);
+        AOCL_CHAR *aocl_zlib_clone_workmem(AOCL_CHAR *workmem);
+        AOCL_VOID aocl_zlib_free_workmem(AOCL_CHAR *workmem);
+        AOCL_INT32 aocl_zlib_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                         AOCL_UINTP dictSize, AOCL_UINTP level);
 #else
     #define aocl_zlib_compress NULL
     #define aocl_zlib_decompress NULL
+    #define aocl_zlib_decompress_range NULL
     #define aocl_zlib_setup NULL
+    #define aocl_zlib_dispatch NULL
     #define aocl_zlib_destroy NULL
+    #define aocl_zlib_stream_create NULL
+    #define aocl_zlib_stream_update NULL
+    #define aocl_zlib_stream_free NULL
+    #define aocl_zlib_clone_workmem NULL
+    #define aocl_zlib_free_workmem NULL
+    #define aocl_zlib_load_dictionary NULL
 #endif
 //Method 7
 #ifndef AOCL_EXCLUDE_ZSTD
@@ -142,14 +238,39 @@ typedef AOCL_VOID  (*destroy_fp)(AOCL_CHAR *memBuff);
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
         AOCL_INT64 aocl_zstd_decompress(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf, 
                          AOCL_UINTP outSize, AOCL_UINTP level, AOCL_UINTP optVar, AOCL_CHAR *workBuf);
+        AOCL_INT64 aocl_zstd_decompress_range(AOCL_CHAR *inBuf, AOCL_UINTP inSize, AOCL_CHAR *outBuf,
+                         AOCL_UINTP outSize, AOCL_UINT64 offset, AOCL_CHAR *workBuf);
         AOCL_CHAR *aocl_zstd_setup(AOCL_INTP optOff, AOCL_INTP optLevel,
                          AOCL_UINTP insize, AOCL_UINTP level, AOCL_UINTP windowLog);
+        AOCL_VOID aocl_zstd_dispatch(AOCL_INTP optOff, AOCL_INTP optLevel);
         AOCL_VOID aocl_zstd_destroy(AOCL_CHAR *workmem);
+        AOCL_CHAR *aocl_zstd_stream_create(AOCL_INTP decompress, AOCL_UINTP level, AOCL_UINTP optVar);
+        AOCL_INT64 aocl_zstd_stream_update(AOCL_CHAR *stream, AOCL_CHAR **inBuf, AOCL_UINTP *inSize,
+                         AOCL_CHAR *outBuf, AOCL_UINTP outSize, AOCL_INTP finish);
+        AOCL_VOID aocl_zstd_stream_free(AOCL_CHAR *stream);
+        AOCL_CHAR *aocl_zstd_clone_workmem(AOCL_CHAR *workmem);
+        AOCL_VOID aocl_zstd_free_workmem(AOCL_CHAR *workmem);
+        AOCL_INT32 aocl_zstd_load_dictionary(AOCL_CHAR **workBuf, const AOCL_CHAR *dict,
+                         AOCL_UINTP dictSize, AOCL_UINTP level);
 #else
 	#define aocl_zstd_compress NULL
 	#define aocl_zstd_decompress NULL
+	#define aocl_zstd_decompress_range NULL
 	#define aocl_zstd_setup NULL
+	#define aocl_zstd_dispatch NULL
 	#define aocl_zstd_destroy NULL
+	#define aocl_zstd_stream_create NULL
+	#define aocl_zstd_stream_update NULL
+	#define aocl_zstd_stream_free NULL
+	#define aocl_zstd_clone_workmem NULL
+	#define aocl_zstd_free_workmem NULL
+	#define aocl_zstd_load_dictionary NULL
+#endif
+//Dictionaries of all methods are trained by the zstd dictionary builder
+#ifndef AOCL_EXCLUDE_ZSTD
+        AOCL_INT64 aocl_zstd_train_dictionary(const AOCL_CHAR *samples, const AOCL_UINTP *sampleSizes,
+                         AOCL_UINT32 nbSamples, AOCL_CHAR *dict, AOCL_UINTP dictCapacity,
+                         AOCL_UINTP level, AOCL_INT32 numThreads, AOCL_INTP rawContent);
 #endif
 
 typedef struct
@@ -160,17 +281,39 @@ typedef struct
     comp_decomp_fp decompress;
     setup_fp setup;
     destroy_fp destroy;
+    decomp_range_fp decompress_range;
+    stream_create_fp stream_create;
+    stream_update_fp stream_update;
+    stream_free_fp stream_free;
+    load_dict_fp load_dictionary;   //NULL for methods without dictionary support
+    workmem_clone_fp clone_workmem; //Independent copy of setup workmem for another thread
+    destroy_fp free_workmem;        //Frees a cloned workmem, leaves method setup intact
+    dispatch_fp dispatch;           //Sets up the calling thread with the optOff/optLevel of a handle
 } aocl_codec_t;
 
 static const aocl_codec_t aocl_codec[AOCL_COMPRESSOR_ALGOS_NUM] =
 {
-    { "lz4",    "1.9.3",      aocl_lz4_compress,    aocl_lz4_decompress,    aocl_lz4_setup,    aocl_lz4_destroy },
-    { "lz4hc",  "1.9.3",      aocl_lz4hc_compress,  aocl_lz4_decompress,    aocl_lz4hc_setup,  aocl_lz4hc_destroy },
-    { "lzma",   "22.01",      aocl_lzma_compress,   aocl_lzma_decompress,   aocl_lzma_setup,   aocl_lzma_destroy },
-    { "bzip2",  "1.0.8",      aocl_bzip2_compress,  aocl_bzip2_decompress,  aocl_bzip2_setup,  aocl_bzip2_destroy },
-    { "snappy", "2020-07-11", aocl_snappy_compress, aocl_snappy_decompress, aocl_snappy_setup, aocl_snappy_destroy },
-    { "zlib",   "1.3",        aocl_zlib_compress,   aocl_zlib_decompress,   aocl_zlib_setup,   aocl_zlib_destroy },
-    { "zstd",   "1.5.5",      aocl_zstd_compress,   aocl_zstd_decompress,   aocl_zstd_setup,   aocl_zstd_destroy }
+    { "lz4",    "1.9.3",      aocl_lz4_compress,    aocl_lz4_decompress,    aocl_lz4_setup,    aocl_lz4_destroy, aocl_lz4_decompress_range,
+      aocl_lz4_stream_create, aocl_lz4_stream_update, aocl_lz4_stream_free, aocl_lz4_load_dictionary,
+      aocl_lz4_clone_workmem, aocl_lz4_free_workmem, aocl_lz4_dispatch },
+    { "lz4hc",  "1.9.3",      aocl_lz4hc_compress,  aocl_lz4_decompress,    aocl_lz4hc_setup,  aocl_lz4hc_destroy, aocl_lz4_decompress_range,
+      aocl_lz4hc_stream_create, aocl_lz4_stream_update, aocl_lz4_stream_free, NULL, NULL, NULL,
+      aocl_lz4hc_dispatch },
+    { "lzma",   "22.01",      aocl_lzma_compress,   aocl_lzma_decompress,   aocl_lzma_setup,   aocl_lzma_destroy, aocl_lzma_decompress_range,
+      aocl_lzma_stream_create, aocl_lzma_stream_update, aocl_lzma_stream_free, NULL,
+      aocl_lzma_clone_workmem, aocl_lzma_free_workmem, aocl_lzma_dispatch },
+    { "bzip2",  "1.0.8",      aocl_bzip2_compress,  aocl_bzip2_decompress,  aocl_bzip2_setup,  aocl_bzip2_destroy, aocl_bzip2_decompress_range,
+      aocl_bzip2_stream_create, aocl_bzip2_stream_update, aocl_bzip2_stream_free, NULL,
+      aocl_bzip2_clone_workmem, aocl_bzip2_free_workmem, aocl_bzip2_dispatch },
+    { "snappy", "2020-07-11", aocl_snappy_compress, aocl_snappy_decompress, aocl_snappy_setup, aocl_snappy_destroy, aocl_snappy_decompress_range,
+      aocl_snappy_stream_create, aocl_snappy_stream_update, aocl_snappy_stream_free, NULL, NULL, NULL,
+      aocl_snappy_dispatch },
+    { "zlib",   "1.3",        aocl_zlib_compress,   aocl_zlib_decompress,   aocl_zlib_setup,   aocl_zlib_destroy, aocl_zlib_decompress_range,
+      aocl_zlib_stream_create, aocl_zlib_stream_update, aocl_zlib_stream_free, aocl_zlib_load_dictionary,
+      aocl_zlib_clone_workmem, aocl_zlib_free_workmem, aocl_zlib_dispatch },
+    { "zstd",   "1.5.5",      aocl_zstd_compress,   aocl_zstd_decompress,   aocl_zstd_setup,   aocl_zstd_destroy, aocl_zstd_decompress_range,
+      aocl_zstd_stream_create, aocl_zstd_stream_update, aocl_zstd_stream_free, aocl_zstd_load_dictionary,
+      aocl_zstd_clone_workmem, aocl_zstd_free_workmem, aocl_zstd_dispatch }
 };
 
 #endif
@@ -39,6 +39,8 @@
 #include <string>
 #include <limits>
 #include <vector>
+#include <random>
+#include <algorithm>
 #include "gtest/gtest.h"
 
 #include "utils/utils.h"
@@ -48,6 +50,10 @@
 #ifdef AOCL_ENABLE_THREADS
 #include "api/aocl_threads.h"
 #include "threads/threads.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #endif /* AOCL_ENABLE_THREADS */
 
 using namespace std;
@@ -310,6 +316,7 @@ void reset_ACD(ACD* desc, AOCL_INTP level) {
     desc->inBuf = nullptr;
     desc->outBuf = nullptr;
     desc->workBuf = nullptr;
+    desc->batchBuf = nullptr;
     desc->inSize = 0;
     desc->outSize = 0;
     desc->level = level;
@@ -366,6 +373,9 @@ public:
     void setup_and_validate() {
         EXPECT_NO_THROW(aocl_llc_setup(&desc, atp.algo));
         switch (atp.algo) {
+        case LZMA: //lzma keeps its encoder and decoder
+        case ZLIB: //zlib keeps its deflate and inflate streams
+        case BZIP2: //bzip2 keeps its compression and decompression states
         case ZSTD:
             EXPECT_NE(desc.workBuf, nullptr);  //ztd saves params and context 
             break;
@@ -516,6 +526,9 @@ public:
     void setup() {
         ASSERT_NO_THROW(aocl_llc_setup(&desc, atp.algo));
         switch (atp.algo) {
+        case LZMA: //lzma keeps its encoder and decoder
+        case ZLIB: //zlib keeps its deflate and inflate streams
+        case BZIP2: //bzip2 keeps its compression and decompression states
         case ZSTD:
             ASSERT_NE(desc.workBuf, nullptr); //ztd saves params and context 
             break;
@@ -768,6 +781,9 @@ public:
         //setup
         ASSERT_NO_THROW(aocl_llc_setup(&desc, atp.algo));
         switch (atp.algo) {
+        case LZMA: //lzma keeps its encoder and decoder
+        case ZLIB: //zlib keeps its deflate and inflate streams
+        case BZIP2: //bzip2 keeps its compression and decompression states
         case ZSTD:
             ASSERT_NE(desc.workBuf, nullptr); //ztd saves params and context 
             break;
@@ -939,6 +955,1020 @@ INSTANTIATE_TEST_SUITE_P(
  * End Decompress Tests
  ********************************************/
 
+/*********************************************
+ * Begin Decompress Range Tests
+ ********************************************/
+#define RANGE_TEST_SIZE (4 << 20)
+#define RANGE_TEST_THREADS 4
+
+/*
+* This function provides one test configuration for each valid algo id
+*/
+vector<ATP> get_api_range_test_params() {
+    vector<ATP> atps;
+    for (const ATP& atp : get_api_test_params()) {
+        if (atp.optOff == 0 && atp.optLevel == DEFAULT_OPT_LEVEL)
+            atps.push_back(atp);
+    }
+    if (atps.size() == 0) { //no algo enabled
+        atps.push_back({ 0, -1, AOCL_COMPRESSOR_ALGOS_NUM });
+    }
+    return atps;
+}
+
+/*
+    Fixture class for testing aocl_llc_decompress_range. Multi-threaded
+    builds compress the input into several RAP partitions.
+*/
+class API_decompress_range : public ::testing::TestWithParam<ATP> {
+public:
+    void SetUp() override {
+        atp = GetParam();
+        set_opt_off(atp.optOff);
+        set_opt_level(atp.optLevel);
+#ifdef AOCL_ENABLE_THREADS
+        max_threads = omp_get_max_threads();
+        omp_set_num_threads(RANGE_TEST_THREADS);
+#endif /* AOCL_ENABLE_THREADS */
+
+        //Short random words repeated at random distances: compressible but not trivial
+        src.resize(RANGE_TEST_SIZE);
+        std::mt19937 gen(RANGE_TEST_SIZE);
+        for (size_t i = 0; i < src.size(); i++) {
+            if (i >= 1024 && gen() % 4 == 0)
+                src[i] = src[i - 1 - (gen() % 1024)];
+            else
+                src[i] = 'a' + (gen() % 16);
+        }
+    }
+
+    void TearDown() override {
+        if (atp.algo < AOCL_COMPRESSOR_ALGOS_NUM)
+            aocl_llc_destroy(&desc, atp.algo);
+#ifdef AOCL_ENABLE_THREADS
+        omp_set_num_threads(max_threads);
+#endif /* AOCL_ENABLE_THREADS */
+    }
+
+    //setup and compress. desc inp is then set to the compressed data.
+    void setup_and_compress() {
+        reset_ACD(&desc, algo_levels[atp.algo].def);
+        cpr.resize(src.size() + src.size() / 2 + (1 << 16));
+        desc.inBuf = src.data();
+        desc.inSize = src.size();
+        desc.outBuf = cpr.data();
+        desc.outSize = cpr.size();
+
+        ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+        cSize = aocl_llc_compress(&desc, atp.algo);
+        ASSERT_GT(cSize, 0);
+
+        desc.inBuf = cpr.data();
+        desc.inSize = cSize;
+    }
+
+    //decompress [offset, offset + length) and match it with src
+    void decompress_range_and_validate(size_t offset, size_t length) {
+        vector<char> out(length + 1);
+        desc.outBuf = out.data();
+        desc.outSize = length;
+        int64_t dSize = aocl_llc_decompress_range(&desc, atp.algo, offset, length);
+
+        size_t expected = (offset >= src.size()) ? 0 : min(length, src.size() - offset);
+        ASSERT_EQ(dSize, (int64_t)expected);
+        if (expected > 0) {
+            EXPECT_EQ(memcmp(src.data() + offset, out.data(), expected), 0);
+        }
+    }
+
+    ATP atp;
+    ACD desc;
+    vector<char> src;
+    vector<char> cpr;
+    int64_t cSize = 0;
+#ifdef AOCL_ENABLE_THREADS
+    int max_threads = 1;
+#endif /* AOCL_ENABLE_THREADS */
+};
+
+TEST_P(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_full_common_1) //whole stream
+{
+    skip_test_if_algo_invalid(atp.algo)
+    setup_and_compress();
+    decompress_range_and_validate(0, src.size());
+}
+
+TEST_P(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_partial_common_2) //ranges inside the stream
+{
+    skip_test_if_algo_invalid(atp.algo)
+    setup_and_compress();
+    decompress_range_and_validate(0, 1);
+    decompress_range_and_validate(1000, 5000);
+    decompress_range_and_validate(src.size() / 3, src.size() / 3); //spans partitions
+    decompress_range_and_validate(src.size() - 10, 10);
+}
+
+TEST_P(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_pastEnd_common_3) //range past the end
+{
+    skip_test_if_algo_invalid(atp.algo)
+    setup_and_compress();
+    decompress_range_and_validate(src.size() - 100, 1000);
+    decompress_range_and_validate(src.size(), 10);
+    decompress_range_and_validate(src.size() + 5, 10);
+    decompress_range_and_validate(100, 0);
+}
+
+TEST_P(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_invalid_common_4) //invalid input
+{
+    skip_test_if_algo_invalid(atp.algo)
+    setup_and_compress();
+    vector<char> out(100);
+    desc.outBuf = out.data();
+    desc.outSize = out.size();
+    EXPECT_EQ(aocl_llc_decompress_range(&desc, atp.algo, 0, out.size() + 1), ERR_INVALID_INPUT); //out too small
+    desc.inBuf = nullptr;
+    EXPECT_EQ(aocl_llc_decompress_range(&desc, atp.algo, 0, out.size()), ERR_INVALID_INPUT); //inp NULL
+    desc.inBuf = cpr.data();
+    desc.outBuf = nullptr;
+    EXPECT_EQ(aocl_llc_decompress_range(&desc, atp.algo, 0, out.size()), ERR_INVALID_INPUT); //out NULL
+}
+
+#ifdef AOCL_ENABLE_THREADS
+TEST_P(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_rap_common_5) //other partitions are not decoded
+{
+    skip_test_if_algo_invalid(atp.algo)
+    setup_and_compress();
+    //RAP frame follows the lzma properties and the zstd skippable frame header
+    size_t rap_pos = (atp.algo == LZMA) ? 5 : (atp.algo == ZSTD) ? 8 : 0;
+    if (aocl_skip_rap_frame_mt(cpr.data() + rap_pos, (int32_t)(cSize - rap_pos)) <= 0)
+        return; //no RAP frame for this method
+    AOCL_USHORT num_partitions;
+    memcpy(&num_partitions, cpr.data() + rap_pos + RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES, sizeof(num_partitions));
+    ASSERT_GT(num_partitions, 1);
+
+    //corrupt the end of the last partition
+    for (int64_t i = cSize - 64; i < cSize; i++)
+        cpr[i] = ~cpr[i];
+    decompress_range_and_validate(0, 4096);
+    decompress_range_and_validate(RANGE_TEST_SIZE / 4, 4096);
+}
+#endif /* AOCL_ENABLE_THREADS */
+
+TEST(API_decompress_range, AOCL_Compression_api_aocl_llc_decompress_range_invalidAlgo_common_1) //invalid algo
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    char inp[16] = { 0 }, out[16];
+    desc.inBuf = inp;
+    desc.inSize = sizeof(inp);
+    desc.outBuf = out;
+    desc.outSize = sizeof(out);
+    EXPECT_EQ(aocl_llc_decompress_range(&desc, AOCL_COMPRESSOR_ALGOS_NUM, 0, sizeof(out)), ERR_INVALID_INPUT);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    API_TEST,
+    API_decompress_range,
+    ::testing::ValuesIn(get_api_range_test_params()));
+/*********************************************
+ * End Decompress Range Tests
+ ********************************************/
+
+/*********************************************
+ * Begin Stream Tests
+ ********************************************/
+#define STREAM_TEST_SIZE (5 << 20) //more than one lzma chunk
+#define STREAM_TEST_IN_PIECE 10007
+#define STREAM_TEST_OUT_PIECE 4093
+
+/*
+    Fixture class for testing aocl_llc_stream_begin/update/end. Data is passed
+    through the streams in small pieces.
+*/
+class API_stream : public ::testing::TestWithParam<ATP> {
+public:
+    void SetUp() override {
+        atp = GetParam();
+        set_opt_off(atp.optOff);
+        set_opt_level(atp.optLevel);
+        reset_ACD(&desc, (atp.algo < AOCL_COMPRESSOR_ALGOS_NUM) ? algo_levels[atp.algo].def : 0);
+
+        src.resize(STREAM_TEST_SIZE);
+        std::mt19937 gen(STREAM_TEST_SIZE);
+        for (size_t i = 0; i < src.size(); i++) {
+            if (i >= 1024 && gen() % 4 == 0)
+                src[i] = src[i - 1 - (gen() % 1024)];
+            else
+                src[i] = 'a' + (gen() % 16);
+        }
+    }
+
+    void TearDown() override {
+        if (atp.algo < AOCL_COMPRESSOR_ALGOS_NUM)
+            aocl_llc_destroy(&desc, atp.algo);
+    }
+
+    //pass inp through a new stream, inPiece bytes at a time, into outPiece sized output
+    //buffers. Returns the result of the failing call or 0.
+    int64_t run_stream(aocl_stream_mode mode, const vector<char>& inp, vector<char>& res,
+        size_t inPiece, size_t outPiece) {
+        aocl_stream* stream = nullptr;
+        vector<char> out(outPiece);
+        int64_t ret = aocl_llc_stream_begin(&desc, atp.algo, mode, &stream);
+        if (ret != 0)
+            return ret;
+        EXPECT_NE(stream, nullptr);
+        res.clear();
+        size_t pos = 0;
+        for (;;) {
+            size_t piece = min(inPiece, inp.size() - pos);
+            int32_t finish = (pos + piece == inp.size());
+            desc.inBuf = (char*)inp.data() + pos;
+            desc.inSize = piece;
+            desc.outBuf = out.data();
+            desc.outSize = out.size();
+            ret = aocl_llc_stream_update(&desc, stream, finish);
+            if (ret < 0)
+                break;
+            EXPECT_LE((size_t)ret, out.size());
+            res.insert(res.end(), out.begin(), out.begin() + ret);
+            pos += piece - desc.inSize;
+            if (finish && ret == 0 && desc.inSize == 0)
+                break;
+        }
+        aocl_llc_stream_end(stream);
+        return (ret < 0) ? ret : 0;
+    }
+
+    ATP atp;
+    ACD desc;
+    vector<char> src;
+};
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_roundtrip_common_1) //stream compress and decompress
+{
+    skip_test_if_algo_invalid(atp.algo)
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    vector<char> cpr, dcm;
+    ASSERT_EQ(run_stream(AOCL_STREAM_COMPRESS, src, cpr, STREAM_TEST_IN_PIECE, STREAM_TEST_OUT_PIECE), 0);
+    ASSERT_EQ(run_stream(AOCL_STREAM_DECOMPRESS, cpr, dcm, STREAM_TEST_OUT_PIECE, STREAM_TEST_IN_PIECE), 0);
+    ASSERT_EQ(dcm.size(), src.size());
+    EXPECT_TRUE(dcm == src);
+}
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_onePiece_common_2) //whole data in a single call
+{
+    skip_test_if_algo_invalid(atp.algo)
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    vector<char> cpr, dcm;
+    ASSERT_EQ(run_stream(AOCL_STREAM_COMPRESS, src, cpr, src.size(), src.size() * 2), 0);
+    ASSERT_EQ(run_stream(AOCL_STREAM_DECOMPRESS, cpr, dcm, cpr.size(), src.size() + 1), 0);
+    EXPECT_TRUE(dcm == src);
+}
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_empty_common_3) //no input
+{
+    skip_test_if_algo_invalid(atp.algo)
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    vector<char> empty, cpr, dcm;
+    ASSERT_EQ(run_stream(AOCL_STREAM_COMPRESS, empty, cpr, 1, 1), 0);
+    EXPECT_GT(cpr.size(), 0u);
+    ASSERT_EQ(run_stream(AOCL_STREAM_DECOMPRESS, cpr, dcm, 1, 1), 0);
+    EXPECT_EQ(dcm.size(), 0u);
+}
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_truncated_common_4) //truncated stream fails on finish
+{
+    skip_test_if_algo_invalid(atp.algo)
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    vector<char> cpr, dcm;
+    ASSERT_EQ(run_stream(AOCL_STREAM_COMPRESS, src, cpr, src.size(), STREAM_TEST_OUT_PIECE), 0);
+    cpr.resize(cpr.size() / 2);
+    EXPECT_EQ(run_stream(AOCL_STREAM_DECOMPRESS, cpr, dcm, STREAM_TEST_IN_PIECE, STREAM_TEST_OUT_PIECE),
+        ERR_COMPRESSION_FAILED);
+}
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_oneShot_common_5) //interoperability with aocl_llc_compress/decompress
+{
+    skip_test_if_algo_invalid(atp.algo)
+    if (atp.algo != ZLIB && atp.algo != BZIP2 && atp.algo != ZSTD && atp.algo != LZMA)
+        return; //block framed streams
+#ifdef AOCL_ENABLE_THREADS
+    int max_threads = omp_get_max_threads();
+    if (atp.algo == LZMA)
+        omp_set_num_threads(1); //multi-threaded lzma streams are not read
+#endif /* AOCL_ENABLE_THREADS */
+    desc.inSize = src.size();
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    vector<char> cpr(src.size() + src.size() / 2 + (1 << 16)), dcm;
+    desc.inBuf = src.data();
+    desc.inSize = src.size();
+    desc.outBuf = cpr.data();
+    desc.outSize = cpr.size();
+    int64_t cSize = aocl_llc_compress(&desc, atp.algo);
+#ifdef AOCL_ENABLE_THREADS
+    omp_set_num_threads(max_threads);
+#endif /* AOCL_ENABLE_THREADS */
+    ASSERT_GT(cSize, 0);
+    cpr.resize(cSize);
+    ASSERT_EQ(run_stream(AOCL_STREAM_DECOMPRESS, cpr, dcm, STREAM_TEST_IN_PIECE, STREAM_TEST_OUT_PIECE), 0);
+    EXPECT_TRUE(dcm == src);
+
+    if (atp.algo == LZMA)
+        return; //stream chunks carry end markers
+    ASSERT_EQ(run_stream(AOCL_STREAM_COMPRESS, src, cpr, STREAM_TEST_IN_PIECE, STREAM_TEST_OUT_PIECE), 0);
+    dcm.assign(src.size(), 0);
+    desc.inBuf = cpr.data();
+    desc.inSize = cpr.size();
+    desc.outBuf = dcm.data();
+    desc.outSize = dcm.size();
+    EXPECT_EQ(aocl_llc_decompress(&desc, atp.algo), (int64_t)src.size());
+    EXPECT_TRUE(dcm == src);
+}
+
+TEST_P(API_stream, AOCL_Compression_api_aocl_llc_stream_invalid_common_6) //invalid input
+{
+    skip_test_if_algo_invalid(atp.algo)
+    ASSERT_EQ(aocl_llc_setup(&desc, atp.algo), 0);
+    aocl_stream* stream = nullptr;
+    EXPECT_EQ(aocl_llc_stream_begin(nullptr, atp.algo, AOCL_STREAM_COMPRESS, &stream), ERR_INVALID_INPUT); //handle NULL
+    EXPECT_EQ(aocl_llc_stream_begin(&desc, atp.algo, AOCL_STREAM_COMPRESS, nullptr), ERR_INVALID_INPUT); //stream NULL
+    EXPECT_EQ(aocl_llc_stream_begin(&desc, atp.algo, (aocl_stream_mode)2, &stream), ERR_INVALID_INPUT); //invalid mode
+    ASSERT_EQ(aocl_llc_stream_begin(&desc, atp.algo, AOCL_STREAM_COMPRESS, &stream), 0);
+    char out[16];
+    desc.inBuf = src.data();
+    desc.inSize = 16;
+    desc.outBuf = out;
+    desc.outSize = 0;
+    EXPECT_EQ(aocl_llc_stream_update(&desc, stream, 0), ERR_INVALID_INPUT); //no output space
+    desc.outSize = sizeof(out);
+    desc.outBuf = nullptr;
+    EXPECT_EQ(aocl_llc_stream_update(&desc, stream, 0), ERR_INVALID_INPUT); //out NULL
+    desc.outBuf = out;
+    desc.inBuf = nullptr;
+    EXPECT_EQ(aocl_llc_stream_update(&desc, stream, 0), ERR_INVALID_INPUT); //inp NULL
+    EXPECT_EQ(aocl_llc_stream_update(&desc, nullptr, 0), ERR_INVALID_INPUT); //stream NULL
+    aocl_llc_stream_end(stream);
+    aocl_llc_stream_end(nullptr);
+}
+
+TEST(API_stream, AOCL_Compression_api_aocl_llc_stream_invalidAlgo_common_1) //invalid algo
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    aocl_stream* stream = nullptr;
+    EXPECT_EQ(aocl_llc_stream_begin(&desc, AOCL_COMPRESSOR_ALGOS_NUM, AOCL_STREAM_COMPRESS, &stream), ERR_INVALID_INPUT);
+    EXPECT_EQ(stream, nullptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    API_TEST,
+    API_stream,
+    ::testing::ValuesIn(get_api_range_test_params()));
+/*********************************************
+ * End Stream Tests
+ ********************************************/
+
+/*********************************************
+ * Begin Context Reuse Tests
+ ********************************************/
+//Compresses and decompresses records of random sizes and levels on one handle,
+//whose workBuf keeps the codec contexts across calls. Levels cycle through
+//[lowerLevel, upperLevel].
+static void run_reuse_test(aocl_compression_type algo, size_t maxSize, int lowerLevel, int upperLevel)
+{
+    ACD desc;
+    reset_ACD(&desc, algo_levels[algo].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, algo), 0);
+    ASSERT_NE(desc.workBuf, nullptr);
+
+    std::mt19937 gen(algo);
+    for (int i = 0; i < 16; i++) {
+        vector<char> src(1 + gen() % maxSize), cpr(src.size() * 2 + 64), dcm(src.size());
+        for (size_t j = 0; j < src.size(); j++)
+            src[j] = 'a' + (gen() % 8);
+        desc.level = lowerLevel + i % (upperLevel - lowerLevel + 1); //level changes between calls
+        desc.inBuf = src.data();
+        desc.inSize = src.size();
+        desc.outBuf = cpr.data();
+        desc.outSize = cpr.size();
+        int64_t cSize = aocl_llc_compress(&desc, algo);
+        ASSERT_GT(cSize, 0);
+
+        //same stream as a handle with no workBuf gives
+        ACD ref;
+        vector<char> refBuf(cpr.size());
+        reset_ACD(&ref, desc.level);
+        ref.inBuf = src.data();
+        ref.inSize = src.size();
+        ref.outBuf = refBuf.data();
+        ref.outSize = refBuf.size();
+        ASSERT_EQ(aocl_llc_compress(&ref, algo), cSize);
+        EXPECT_EQ(memcmp(refBuf.data(), cpr.data(), cSize), 0);
+
+        desc.inBuf = cpr.data();
+        desc.inSize = cSize;
+        desc.outBuf = dcm.data();
+        desc.outSize = dcm.size();
+        ASSERT_EQ(aocl_llc_decompress(&desc, algo), (int64_t)src.size());
+        EXPECT_TRUE(dcm == src);
+
+        desc.inSize = cSize / 2; //a failed call leaves the contexts reusable
+        if (algo == LZMA) { //lzma returns what it decoded before the input ran out
+            EXPECT_LT(aocl_llc_decompress(&desc, algo), (int64_t)src.size());
+        } else {
+            EXPECT_EQ(aocl_llc_decompress(&desc, algo), ERR_COMPRESSION_FAILED);
+        }
+    }
+    aocl_llc_destroy(&desc, algo);
+}
+
+TEST(API_reuse, AOCL_Compression_api_aocl_llc_compress_zlibReuse_common_1) //streams kept in workBuf across calls
+{
+    skip_test_if_algo_invalid(ZLIB)
+    run_reuse_test(ZLIB, 20000, 0, 9);
+}
+
+TEST(API_reuse, AOCL_Compression_api_aocl_llc_compress_lzmaReuse_common_1) //encoder and decoder kept in workBuf across calls
+{
+    skip_test_if_algo_invalid(LZMA)
+    run_reuse_test(LZMA, 100000, 0, 9);
+}
+
+TEST(API_reuse, AOCL_Compression_api_aocl_llc_compress_bzip2Reuse_common_1) //compression and decompression states kept in workBuf across calls
+{
+    skip_test_if_algo_invalid(BZIP2)
+    run_reuse_test(BZIP2, 300000, 1, 9);
+}
+/*********************************************
+ * End Context Reuse Tests
+ ********************************************/
+
+/*********************************************
+ * Begin Dictionary Tests
+ ********************************************/
+//Small JSON record of the kind dictionaries are meant for
+static string make_json_record(std::mt19937& gen)
+{
+    static const char* status[] = { "active", "suspended", "pending" };
+    return "{\"id\":" + to_string(gen() % 100000) + ",\"name\":\"user" + to_string(gen() % 1000) +
+        "\",\"email\":\"user" + to_string(gen() % 1000) + "@example.com\",\"status\":\"" +
+        status[gen() % 3] + "\",\"roles\":[\"reader\",\"writer\"],\"created\":\"2023-0" +
+        to_string(1 + gen() % 9) + "-1" + to_string(gen() % 10) + "T10:00:00Z\"}";
+}
+
+//Compresses records on a handle with a dictionary loaded and on one without
+static void run_dictionary_test(aocl_compression_type algo)
+{
+    ACD desc, ref;
+    reset_ACD(&desc, algo_levels[algo].def);
+    reset_ACD(&ref, algo_levels[algo].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, algo), 0);
+    ASSERT_EQ(aocl_llc_setup(&ref, algo), 0);
+
+    std::mt19937 gen(algo);
+    string dict;
+    for (int i = 0; i < 100; i++)
+        dict += make_json_record(gen);
+    ASSERT_EQ(aocl_llc_load_dictionary(&desc, algo, dict.data(), dict.size()), 0);
+
+    int64_t dictTotal = 0, refTotal = 0;
+    AOCL_INTP levels = algo_levels[algo].upper - algo_levels[algo].lower + 1;
+    for (int i = 0; i < 32; i++) {
+        string src = make_json_record(gen);
+        vector<char> cpr(src.size() * 2 + 64), refBuf(cpr.size()), dcm(src.size());
+        desc.level = ref.level = algo_levels[algo].lower + i % levels; //level changes between calls
+        desc.inBuf = (char*)src.data();
+        desc.inSize = src.size();
+        desc.outBuf = cpr.data();
+        desc.outSize = cpr.size();
+        int64_t cSize = aocl_llc_compress(&desc, algo);
+        ASSERT_GT(cSize, 0);
+        ref.inBuf = (char*)src.data();
+        ref.inSize = src.size();
+        ref.outBuf = refBuf.data();
+        ref.outSize = refBuf.size();
+        int64_t refSize = aocl_llc_compress(&ref, algo);
+        ASSERT_GT(refSize, 0);
+        dictTotal += cSize;
+        refTotal += refSize;
+
+        desc.inBuf = cpr.data();
+        desc.inSize = cSize;
+        desc.outBuf = dcm.data();
+        desc.outSize = dcm.size();
+        ASSERT_EQ(aocl_llc_decompress(&desc, algo), (int64_t)src.size());
+        EXPECT_EQ(memcmp(dcm.data(), src.data(), src.size()), 0);
+
+        //the records refer to the dictionary, without which they do not decode
+        std::fill(dcm.begin(), dcm.end(), 0);
+        ref.inBuf = cpr.data();
+        ref.inSize = cSize;
+        ref.outBuf = dcm.data();
+        ref.outSize = dcm.size();
+        int64_t dSize = aocl_llc_decompress(&ref, algo);
+        EXPECT_FALSE(dSize == (int64_t)src.size() && memcmp(dcm.data(), src.data(), src.size()) == 0);
+    }
+    EXPECT_LT(dictTotal * 2, refTotal);
+
+    //unloading gives the output of a handle without dictionary again
+    ASSERT_EQ(aocl_llc_load_dictionary(&desc, algo, NULL, 0), 0);
+    string src = make_json_record(gen);
+    vector<char> cpr(src.size() * 2 + 64), refBuf(cpr.size());
+    desc.inBuf = ref.inBuf = (char*)src.data();
+    desc.inSize = ref.inSize = src.size();
+    desc.outBuf = cpr.data();
+    desc.outSize = cpr.size();
+    ref.outBuf = refBuf.data();
+    ref.outSize = refBuf.size();
+    int64_t cSize = aocl_llc_compress(&desc, algo);
+    ASSERT_GT(cSize, 0);
+    ASSERT_EQ(aocl_llc_compress(&ref, algo), cSize);
+    EXPECT_EQ(memcmp(cpr.data(), refBuf.data(), cSize), 0);
+
+    aocl_llc_destroy(&desc, algo);
+    aocl_llc_destroy(&ref, algo);
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_load_dictionary_lz4_common_1) //records compressed against a digested dictionary
+{
+    skip_test_if_algo_invalid(LZ4)
+    run_dictionary_test(LZ4);
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_load_dictionary_zlib_common_1) //records compressed against a dictionary
+{
+    skip_test_if_algo_invalid(ZLIB)
+    run_dictionary_test(ZLIB);
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_load_dictionary_zstd_common_1) //records compressed against digested dictionaries
+{
+    skip_test_if_algo_invalid(ZSTD)
+    run_dictionary_test(ZSTD);
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_load_dictionary_unsupported_common_1) //codecs without dictionaries
+{
+    const ACT algos[] = { LZ4HC, LZMA, BZIP2, SNAPPY };
+    char dict[16] = { 0 };
+    for (ACT algo : algos) {
+        ACD desc;
+        reset_ACD(&desc, algo_levels[algo].def);
+        if (aocl_llc_setup(&desc, algo) != 0) //excluded from this build
+            continue;
+        EXPECT_EQ(aocl_llc_load_dictionary(&desc, algo, dict, sizeof(dict)), ERR_UNSUPPORTED_METHOD);
+        aocl_llc_destroy(&desc, algo);
+    }
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_load_dictionary_invalid_common_1) //invalid input
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    char dict[16] = { 0 };
+    EXPECT_EQ(aocl_llc_load_dictionary(NULL, ZSTD, dict, sizeof(dict)), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_load_dictionary(&desc, AOCL_COMPRESSOR_ALGOS_NUM, dict, sizeof(dict)), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_load_dictionary(&desc, ZSTD, NULL, sizeof(dict)), ERR_INVALID_INPUT);
+}
+
+//Trains a dictionary on records with numThreads threads
+static int64_t train_json_dictionary(aocl_compression_type algo, int numThreads, vector<char>& dict)
+{
+    std::mt19937 gen(algo);
+    string samples;
+    vector<size_t> sizes;
+    for (int i = 0; i < 2000; i++) {
+        string rec = make_json_record(gen);
+        samples += rec;
+        sizes.push_back(rec.size());
+    }
+    ACD desc;
+    reset_ACD(&desc, algo_levels[algo].def);
+    desc.numThreads = numThreads;
+    dict.assign(4096, 0);
+    return aocl_llc_train_dictionary(&desc, algo, samples.data(), sizes.data(),
+                                     (unsigned)sizes.size(), dict.data(), dict.size());
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_train_dictionary_common_1) //trained dictionary improves compression of records
+{
+    const ACT algos[] = { LZ4, ZLIB, ZSTD };
+    for (ACT algo : algos) {
+        if (algo == AOCL_COMPRESSOR_ALGOS_NUM)
+            continue;
+        vector<char> dict;
+        int64_t dictSize = train_json_dictionary(algo, 1, dict);
+        ASSERT_GT(dictSize, 0);
+        ASSERT_LE(dictSize, (int64_t)dict.size());
+
+        ACD desc, ref;
+        reset_ACD(&desc, algo_levels[algo].def);
+        reset_ACD(&ref, algo_levels[algo].def);
+        ASSERT_EQ(aocl_llc_setup(&desc, algo), 0);
+        ASSERT_EQ(aocl_llc_setup(&ref, algo), 0);
+        ASSERT_EQ(aocl_llc_load_dictionary(&desc, algo, dict.data(), dictSize), 0);
+
+        std::mt19937 gen(algo + 1); //records not among the samples
+        int64_t dictTotal = 0, refTotal = 0;
+        for (int i = 0; i < 16; i++) {
+            string src = make_json_record(gen);
+            vector<char> cpr(src.size() * 2 + 64), refBuf(cpr.size()), dcm(src.size());
+            desc.inBuf = ref.inBuf = (char*)src.data();
+            desc.inSize = ref.inSize = src.size();
+            desc.outBuf = cpr.data();
+            desc.outSize = cpr.size();
+            ref.outBuf = refBuf.data();
+            ref.outSize = refBuf.size();
+            int64_t cSize = aocl_llc_compress(&desc, algo);
+            ASSERT_GT(cSize, 0);
+            int64_t refSize = aocl_llc_compress(&ref, algo);
+            ASSERT_GT(refSize, 0);
+            dictTotal += cSize;
+            refTotal += refSize;
+
+            desc.inBuf = cpr.data();
+            desc.inSize = cSize;
+            desc.outBuf = dcm.data();
+            desc.outSize = dcm.size();
+            ASSERT_EQ(aocl_llc_decompress(&desc, algo), (int64_t)src.size());
+            EXPECT_EQ(memcmp(dcm.data(), src.data(), src.size()), 0);
+        }
+        EXPECT_LT(dictTotal, refTotal);
+
+        aocl_llc_destroy(&desc, algo);
+        aocl_llc_destroy(&ref, algo);
+    }
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_train_dictionary_threads_common_1) //parallel training gives the serial result
+{
+    skip_test_if_algo_invalid(ZSTD)
+    vector<char> dict1, dict4;
+    int64_t size1 = train_json_dictionary(ZSTD, 1, dict1);
+    int64_t size4 = train_json_dictionary(ZSTD, 4, dict4);
+    ASSERT_GT(size1, 0);
+    ASSERT_EQ(size1, size4);
+    EXPECT_EQ(memcmp(dict1.data(), dict4.data(), size1), 0);
+}
+
+TEST(API_dictionary, AOCL_Compression_api_aocl_llc_train_dictionary_invalid_common_1) //invalid input
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    char samples[64] = { 0 }, dict[256];
+    size_t sizes[1] = { sizeof(samples) };
+    EXPECT_EQ(aocl_llc_train_dictionary(NULL, ZSTD, samples, sizes, 1, dict, sizeof(dict)), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_train_dictionary(&desc, AOCL_COMPRESSOR_ALGOS_NUM, samples, sizes, 1, dict, sizeof(dict)), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_train_dictionary(&desc, ZSTD, samples, sizes, 0, dict, sizeof(dict)), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_train_dictionary(&desc, ZSTD, samples, sizes, 1, NULL, sizeof(dict)), ERR_INVALID_INPUT);
+    if (LZMA != AOCL_COMPRESSOR_ALGOS_NUM) {
+        EXPECT_EQ(aocl_llc_train_dictionary(&desc, LZMA, samples, sizes, 1, dict, sizeof(dict)), ERR_UNSUPPORTED_METHOD);
+    }
+}
+/*********************************************
+ * End Dictionary Tests
+ ********************************************/
+
+/*********************************************
+ * Begin Batch Tests
+ ********************************************/
+//Compresses records of 1 to 16KB in batches, which must match one call per record
+static void run_batch_test(aocl_compression_type algo, bool withDict)
+{
+    ACD desc;
+    reset_ACD(&desc, algo_levels[algo].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, algo), 0);
+
+    std::mt19937 gen(algo);
+    if (withDict) {
+        string dict;
+        for (int i = 0; i < 100; i++)
+            dict += make_json_record(gen);
+        ASSERT_EQ(aocl_llc_load_dictionary(&desc, algo, dict.data(), dict.size()), 0);
+    }
+
+    const size_t nbItems = 48;
+    vector<string> srcs(nbItems);
+    vector<vector<char>> refs(nbItems);
+    for (size_t i = 0; i < nbItems; i++) {
+        size_t target = 1024 + gen() % (15 * 1024);
+        while (srcs[i].size() < target)
+            srcs[i] += make_json_record(gen);
+        refs[i].resize(srcs[i].size() * 2 + 1024);
+        desc.inBuf = (char*)srcs[i].data();
+        desc.inSize = srcs[i].size();
+        desc.outBuf = refs[i].data();
+        desc.outSize = refs[i].size();
+        int64_t cSize = aocl_llc_compress(&desc, algo);
+        ASSERT_GT(cSize, 0);
+        refs[i].resize(cSize);
+    }
+
+    for (int numThreads : { 1, 4 }) {
+        desc.numThreads = numThreads;
+        vector<vector<char>> cprs(nbItems), dcms(nbItems);
+        vector<aocl_batch_item> items(nbItems);
+        for (size_t i = 0; i < nbItems; i++) {
+            cprs[i].resize(srcs[i].size() * 2 + 1024);
+            items[i] = { (char*)srcs[i].data(), srcs[i].size(), cprs[i].data(), cprs[i].size(), 0 };
+        }
+        ASSERT_EQ(aocl_llc_compress_batch(&desc, algo, items.data(), nbItems), 0);
+        for (size_t i = 0; i < nbItems; i++) {
+            ASSERT_EQ(items[i].result, (int64_t)refs[i].size());
+            EXPECT_EQ(memcmp(cprs[i].data(), refs[i].data(), refs[i].size()), 0);
+        }
+
+        for (size_t i = 0; i < nbItems; i++) {
+            dcms[i].resize(srcs[i].size());
+            items[i] = { cprs[i].data(), refs[i].size(), dcms[i].data(), dcms[i].size(), 0 };
+        }
+        ASSERT_EQ(aocl_llc_decompress_batch(&desc, algo, items.data(), nbItems), 0);
+        for (size_t i = 0; i < nbItems; i++) {
+            ASSERT_EQ(items[i].result, (int64_t)srcs[i].size());
+            EXPECT_EQ(memcmp(dcms[i].data(), srcs[i].data(), srcs[i].size()), 0);
+        }
+    }
+
+    aocl_llc_destroy(&desc, algo);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_lz4_common_1)
+{
+    skip_test_if_algo_invalid(LZ4)
+    run_batch_test(LZ4, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_lz4hc_common_1)
+{
+    skip_test_if_algo_invalid(LZ4HC)
+    run_batch_test(LZ4HC, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_lzma_common_1)
+{
+    skip_test_if_algo_invalid(LZMA)
+    run_batch_test(LZMA, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_bzip2_common_1)
+{
+    skip_test_if_algo_invalid(BZIP2)
+    run_batch_test(BZIP2, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_snappy_common_1)
+{
+    skip_test_if_algo_invalid(SNAPPY)
+    run_batch_test(SNAPPY, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_zlib_common_1)
+{
+    skip_test_if_algo_invalid(ZLIB)
+    run_batch_test(ZLIB, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_zstd_common_1)
+{
+    skip_test_if_algo_invalid(ZSTD)
+    run_batch_test(ZSTD, false);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_dictionary_common_1) //each thread holds a copy of the dictionary
+{
+    skip_test_if_algo_invalid(LZ4)
+    run_batch_test(LZ4, true);
+    skip_test_if_algo_invalid(ZLIB)
+    run_batch_test(ZLIB, true);
+    skip_test_if_algo_invalid(ZSTD)
+    run_batch_test(ZSTD, true);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_reuse_common_1) //cached worker contexts follow a new dictionary
+{
+    skip_test_if_algo_invalid(ZSTD)
+    ACD desc;
+    reset_ACD(&desc, algo_levels[ZSTD].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, ZSTD), 0);
+    desc.numThreads = 4;
+
+    std::mt19937 gen(7);
+    string src, dict;
+    while (src.size() < 4096)
+        src += make_json_record(gen);
+    for (int i = 0; i < 100; i++)
+        dict += make_json_record(gen);
+
+    const size_t nbItems = 8;
+    vector<char> ref(src.size() * 2 + 1024);
+    vector<vector<char>> cprs(nbItems, vector<char>(ref.size()));
+    vector<aocl_batch_item> items(nbItems);
+    for (int pass = 0; pass < 3; pass++) {
+        if (pass == 2) //invalidates the contexts cached by the earlier passes
+            ASSERT_EQ(aocl_llc_load_dictionary(&desc, ZSTD, dict.data(), dict.size()), 0);
+        desc.inBuf = (char*)src.data();
+        desc.inSize = src.size();
+        desc.outBuf = ref.data();
+        desc.outSize = ref.size();
+        int64_t cSize = aocl_llc_compress(&desc, ZSTD);
+        ASSERT_GT(cSize, 0);
+
+        for (size_t i = 0; i < nbItems; i++)
+            items[i] = { (char*)src.data(), src.size(), cprs[i].data(), cprs[i].size(), 0 };
+        ASSERT_EQ(aocl_llc_compress_batch(&desc, ZSTD, items.data(), nbItems), 0);
+#ifdef AOCL_ENABLE_THREADS
+        if (omp_get_max_threads() > 1) //a single worker runs on the handle itself
+            EXPECT_NE(desc.batchBuf, nullptr);
+#endif /* AOCL_ENABLE_THREADS */
+        for (size_t i = 0; i < nbItems; i++) {
+            ASSERT_EQ(items[i].result, cSize);
+            EXPECT_EQ(memcmp(cprs[i].data(), ref.data(), cSize), 0);
+        }
+    }
+
+    aocl_llc_destroy(&desc, ZSTD);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_decompress_batch_failed_item_common_1) //a corrupt item does not stop the others
+{
+    skip_test_if_algo_invalid(ZSTD)
+    ACD desc;
+    reset_ACD(&desc, algo_levels[ZSTD].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, ZSTD), 0);
+    desc.numThreads = 4;
+
+    std::mt19937 gen(ZSTD);
+    const size_t nbItems = 8;
+    vector<string> srcs(nbItems);
+    vector<vector<char>> cprs(nbItems), dcms(nbItems);
+    vector<aocl_batch_item> items(nbItems);
+    for (size_t i = 0; i < nbItems; i++) {
+        srcs[i] = make_json_record(gen) + make_json_record(gen);
+        cprs[i].resize(srcs[i].size() * 2 + 64);
+        items[i] = { (char*)srcs[i].data(), srcs[i].size(), cprs[i].data(), cprs[i].size(), 0 };
+    }
+    ASSERT_EQ(aocl_llc_compress_batch(&desc, ZSTD, items.data(), nbItems), 0);
+
+    for (size_t i = 0; i < nbItems; i++) {
+        dcms[i].resize(srcs[i].size());
+        items[i] = { cprs[i].data(), (size_t)items[i].result, dcms[i].data(), dcms[i].size(), 0 };
+    }
+    items[3].src = (char*)srcs[3].data(); //not zstd data
+    items[5].dst = NULL;
+    EXPECT_EQ(aocl_llc_decompress_batch(&desc, ZSTD, items.data(), nbItems), ERR_COMPRESSION_FAILED);
+    for (size_t i = 0; i < nbItems; i++) {
+        if (i == 3)
+            EXPECT_EQ(items[i].result, ERR_COMPRESSION_FAILED);
+        else if (i == 5)
+            EXPECT_EQ(items[i].result, ERR_INVALID_INPUT);
+        else {
+            ASSERT_EQ(items[i].result, (int64_t)srcs[i].size());
+            EXPECT_EQ(memcmp(dcms[i].data(), srcs[i].data(), srcs[i].size()), 0);
+        }
+    }
+    aocl_llc_destroy(&desc, ZSTD);
+}
+
+TEST(API_batch, AOCL_Compression_api_aocl_llc_compress_batch_invalid_common_1) //invalid input
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    aocl_batch_item item = { NULL, 0, NULL, 0, 0 };
+    EXPECT_EQ(aocl_llc_compress_batch(NULL, LZ4, &item, 1), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_compress_batch(&desc, AOCL_COMPRESSOR_ALGOS_NUM, &item, 1), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_decompress_batch(&desc, LZ4, NULL, 1), ERR_INVALID_INPUT);
+    if (LZ4 != AOCL_COMPRESSOR_ALGOS_NUM) {
+        EXPECT_EQ(aocl_llc_compress_batch(&desc, LZ4, NULL, 0), 0); //empty batch
+    }
+}
+/*********************************************
+ * End Batch Tests
+ ********************************************/
+
+/*********************************************
+ * Begin Dispatch Tests
+ ********************************************/
+//Compresses with a handle that turns optimizations off and one that keeps them on.
+//Each handle must give its own output whichever handle ran last on the thread,
+//and while the other handle runs on another thread.
+static void run_dispatch_test(aocl_compression_type algo)
+{
+    std::mt19937 gen(algo);
+    string src;
+    while (src.size() < 512 * 1024)
+        src += make_json_record(gen);
+
+    ACD desc[2];
+    for (int h = 0; h < 2; h++) {
+        reset_ACD(&desc[h], algo_levels[algo].def);
+        desc[h].optOff = (h == 0);
+        ASSERT_EQ(aocl_llc_setup(&desc[h], algo), 0);
+    }
+
+    //Compresses src with handle h, checks the round trip and returns the compressed data
+    auto run = [&](int h, vector<char>& cpr) {
+        ACD d = desc[h];
+        cpr.resize(src.size() * 2 + 1024);
+        d.inBuf = (char*)src.data();
+        d.inSize = src.size();
+        d.outBuf = cpr.data();
+        d.outSize = cpr.size();
+        int64_t cSize = aocl_llc_compress(&d, algo);
+        if (cSize <= 0) {
+            cpr.clear();
+            return;
+        }
+        cpr.resize(cSize);
+        vector<char> dcm(src.size());
+        d.inBuf = cpr.data();
+        d.inSize = cpr.size();
+        d.outBuf = dcm.data();
+        d.outSize = dcm.size();
+        if (aocl_llc_decompress(&d, algo) != (int64_t)src.size() ||
+            memcmp(dcm.data(), src.data(), src.size()) != 0)
+            cpr.clear();
+    };
+
+    vector<char> refs[2];
+    run(0, refs[0]);
+    run(1, refs[1]);
+    ASSERT_FALSE(refs[0].empty());
+    ASSERT_FALSE(refs[1].empty());
+
+    for (int h : { 1, 0, 0, 1 }) {
+        vector<char> cpr;
+        run(h, cpr);
+        EXPECT_TRUE(cpr == refs[h]);
+    }
+
+#ifdef AOCL_ENABLE_THREADS
+    bool same[2] = { true, true };
+    vector<std::thread> threads;
+    for (int h = 0; h < 2; h++) {
+        threads.emplace_back([&, h]() {
+            for (int i = 0; i < 3; i++) {
+                vector<char> cpr;
+                run(h, cpr);
+                same[h] = same[h] && (cpr == refs[h]);
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_TRUE(same[0]);
+    EXPECT_TRUE(same[1]);
+#endif
+
+    for (int h = 0; h < 2; h++)
+        aocl_llc_destroy(&desc[h], algo);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_lz4_common_1)
+{
+    skip_test_if_algo_invalid(LZ4)
+    run_dispatch_test(LZ4);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_lz4hc_common_1)
+{
+    skip_test_if_algo_invalid(LZ4HC)
+    run_dispatch_test(LZ4HC);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_lzma_common_1)
+{
+    skip_test_if_algo_invalid(LZMA)
+    run_dispatch_test(LZMA);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_bzip2_common_1)
+{
+    skip_test_if_algo_invalid(BZIP2)
+    run_dispatch_test(BZIP2);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_snappy_common_1)
+{
+    skip_test_if_algo_invalid(SNAPPY)
+    run_dispatch_test(SNAPPY);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_zlib_common_1)
+{
+    skip_test_if_algo_invalid(ZLIB)
+    run_dispatch_test(ZLIB);
+}
+
+TEST(API_dispatch, AOCL_Compression_api_aocl_llc_dispatch_zstd_common_1)
+{
+    skip_test_if_algo_invalid(ZSTD)
+    run_dispatch_test(ZSTD);
+}
+/*********************************************
+ * End Dispatch Tests
+ ********************************************/
+
 #ifdef AOCL_ENABLE_THREADS
 
 AOCL_INT32 Test_aocl_get_rap_frame_bound_mt() {
@@ -954,7 +1984,8 @@ AOCL_INT32 Test_aocl_skip_rap_frame_mt(char* src, int32_t src_size) {
 *********************************************/
 TEST(API_get_rap_frame_bound_MT, AOCL_Compression_api_aocl_get_rap_frame_bound_mt_common_1) {
     AOCL_UINT32 max_threads = Test_aocl_get_rap_frame_bound_mt();
-    EXPECT_EQ(max_threads, RAP_FRAME_LEN_WITH_DECOMP_LENGTH(omp_get_max_threads(), 0));
+    EXPECT_EQ(max_threads, RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(omp_get_max_threads() * PARTITIONS_PER_THREAD, 0));
+    EXPECT_GE(max_threads, RAP_FRAME_LEN_WITH_DECOMP_LENGTH(omp_get_max_threads(), 0));
 }
 /*********************************************
 * End rap frame bound Tests
@@ -974,11 +2005,12 @@ public:
         if (src) free(src);
     }
 
-    AOCL_INT32 add_rap_frame(int mainThreads) {
+    AOCL_INT32 add_rap_frame(int mainThreads, AOCL_UINT32 version = RAP_FRAME_VERSION_32) {
         src = (AOCL_CHAR*)malloc(src_size * sizeof(AOCL_CHAR));
         AOCL_CHAR* src_ptr = src;
-        AOCL_INT32 rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH(mainThreads, 0);
-        *(AOCL_INT64*)src_ptr = RAP_MAGIC_WORD; //For storing the magic word
+        AOCL_INT32 rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(version, mainThreads, 0);
+        *(AOCL_INT64*)src_ptr = (version == RAP_FRAME_VERSION_64) ?
+            RAP_MAGIC_WORD_64 : RAP_MAGIC_WORD; //For storing the magic word
         src_ptr += RAP_MAGIC_WORD_BYTES;
         *(AOCL_UINT32*)src_ptr = rap_frame_len; //For storing the total RAP frame length
         src_ptr += RAP_METADATA_LEN_BYTES;
@@ -1029,8 +2061,179 @@ TEST_F(API_skip_rap_frame_MT, AOCL_Compression_api_aocl_skip_rap_frame_mt_common
 TEST_F(API_skip_rap_frame_MT, AOCL_Compression_api_aocl_skip_rap_frame_mt_common_5) { //src null
     EXPECT_EQ(Test_aocl_skip_rap_frame_mt(src, src_size), ERR_INVALID_INPUT);
 }
+
+TEST_F(API_skip_rap_frame_MT, AOCL_Compression_api_aocl_skip_rap_frame_mt_common_6) { //64-bit RAP frame + stream
+    //Create RAP frame
+    int mainThreads = 2;
+    src_size = RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(mainThreads, 0) + 1024; //1024 for stream
+    AOCL_INT32 val_size = add_rap_frame(mainThreads, RAP_FRAME_VERSION_64);
+
+    EXPECT_EQ(Test_aocl_skip_rap_frame_mt(src, src_size), val_size);
+}
 /*********************************************
 * End skip rap frame Tests
 *********************************************/
 
+/*********************************************
+* Begin async Tests
+*********************************************/
+typedef struct {
+    std::mutex lock;
+    std::condition_variable cv;
+    vector<int64_t> results;
+    size_t completed = 0;
+} async_test_ctx;
+
+typedef struct {
+    async_test_ctx* ctx;
+    size_t index;
+} async_test_arg;
+
+static void async_test_callback(void* userData, int64_t result)
+{
+    async_test_arg* arg = (async_test_arg*)userData;
+    std::lock_guard<std::mutex> guard(arg->ctx->lock);
+    arg->ctx->results[arg->index] = result;
+    arg->ctx->completed++;
+    arg->ctx->cv.notify_all();
+}
+
+//Jobs in flight on one handle each, checked against synchronous calls
+static void run_async_test(aocl_compression_type algo)
+{
+    const size_t nbJobs = 8;
+    vector<ACD> descs(nbJobs);
+    vector<string> srcs(nbJobs);
+    vector<vector<char>> cprs(nbJobs), refs(nbJobs), dcms(nbJobs);
+    vector<aocl_async_job*> jobs(nbJobs);
+    std::mt19937 gen(algo);
+    for (size_t i = 0; i < nbJobs; i++) {
+        reset_ACD(&descs[i], algo_levels[algo].def);
+        ASSERT_EQ(aocl_llc_setup(&descs[i], algo), 0);
+        while (srcs[i].size() < 64 * 1024 * (i + 1))
+            srcs[i] += make_json_record(gen);
+        cprs[i].resize(srcs[i].size() * 2 + 1024);
+        refs[i].resize(cprs[i].size());
+        dcms[i].resize(srcs[i].size());
+        descs[i].inBuf = (char*)srcs[i].data();
+        descs[i].inSize = srcs[i].size();
+        descs[i].outBuf = refs[i].data();
+        descs[i].outSize = refs[i].size();
+        int64_t refSize = aocl_llc_compress(&descs[i], algo);
+        ASSERT_GT(refSize, 0);
+        refs[i].resize(refSize);
+    }
+
+    //compression completion through aocl_llc_async_wait()
+    for (size_t i = 0; i < nbJobs; i++) {
+        descs[i].outBuf = cprs[i].data();
+        descs[i].outSize = cprs[i].size();
+        ASSERT_EQ(aocl_llc_compress_async(&descs[i], algo, NULL, NULL, &jobs[i]), 0);
+        ASSERT_NE(jobs[i], nullptr);
+    }
+    for (size_t i = 0; i < nbJobs; i++) {
+        ASSERT_EQ(aocl_llc_async_wait(jobs[i]), (int64_t)refs[i].size());
+        EXPECT_EQ(memcmp(cprs[i].data(), refs[i].data(), refs[i].size()), 0);
+    }
+
+    //decompression completion through callbacks and aocl_llc_async_poll()
+    async_test_ctx ctx;
+    ctx.results.assign(nbJobs, 0);
+    vector<async_test_arg> args(nbJobs);
+    for (size_t i = 0; i < nbJobs; i++) {
+        args[i] = { &ctx, i };
+        descs[i].inBuf = cprs[i].data();
+        descs[i].inSize = refs[i].size();
+        descs[i].outBuf = dcms[i].data();
+        descs[i].outSize = dcms[i].size();
+        ASSERT_EQ(aocl_llc_decompress_async(&descs[i], algo, async_test_callback, &args[i], &jobs[i]), 0);
+    }
+    for (size_t i = 0; i < nbJobs; i++) {
+        int64_t result = 0;
+        int32_t done;
+        while ((done = aocl_llc_async_poll(jobs[i], &result)) == 0)
+            std::this_thread::yield();
+        ASSERT_EQ(done, 1);
+        EXPECT_EQ(result, (int64_t)srcs[i].size());
+        { //the callback has returned once the job reads as complete
+            std::lock_guard<std::mutex> guard(ctx.lock);
+            EXPECT_EQ(ctx.results[i], (int64_t)srcs[i].size());
+        }
+        EXPECT_EQ(aocl_llc_async_wait(jobs[i]), (int64_t)srcs[i].size());
+        EXPECT_EQ(memcmp(dcms[i].data(), srcs[i].data(), srcs[i].size()), 0);
+    }
+    EXPECT_EQ(ctx.completed, nbJobs);
+
+    for (size_t i = 0; i < nbJobs; i++)
+        aocl_llc_destroy(&descs[i], algo);
+}
+
+TEST(API_async, AOCL_Compression_api_aocl_llc_compress_async_lz4_common_1)
+{
+    skip_test_if_algo_invalid(LZ4)
+    run_async_test(LZ4);
+}
+
+TEST(API_async, AOCL_Compression_api_aocl_llc_compress_async_zstd_common_1)
+{
+    skip_test_if_algo_invalid(ZSTD)
+    run_async_test(ZSTD);
+}
+
+TEST(API_async, AOCL_Compression_api_aocl_llc_compress_async_detached_common_1) //completion reported by callback alone
+{
+    skip_test_if_algo_invalid(ZLIB)
+    const size_t nbJobs = 16;
+    vector<ACD> descs(nbJobs);
+    vector<string> srcs(nbJobs);
+    vector<vector<char>> cprs(nbJobs);
+    async_test_ctx ctx;
+    ctx.results.assign(nbJobs, 0);
+    vector<async_test_arg> args(nbJobs);
+    std::mt19937 gen(ZLIB);
+    for (size_t i = 0; i < nbJobs; i++) {
+        reset_ACD(&descs[i], algo_levels[ZLIB].def);
+        ASSERT_EQ(aocl_llc_setup(&descs[i], ZLIB), 0);
+        srcs[i] = make_json_record(gen) + make_json_record(gen);
+        cprs[i].resize(srcs[i].size() * 2 + 64);
+        descs[i].inBuf = (char*)srcs[i].data();
+        descs[i].inSize = srcs[i].size();
+        descs[i].outBuf = cprs[i].data();
+        descs[i].outSize = cprs[i].size();
+        args[i] = { &ctx, i };
+    }
+    //failed jobs are reported too
+    descs[5].outSize = 1;
+    for (size_t i = 0; i < nbJobs; i++)
+        ASSERT_EQ(aocl_llc_compress_async(&descs[i], ZLIB, async_test_callback, &args[i], NULL), 0);
+
+    {
+        std::unique_lock<std::mutex> guard(ctx.lock);
+        ASSERT_TRUE(ctx.cv.wait_for(guard, std::chrono::seconds(60),
+            [&ctx, nbJobs] { return ctx.completed == nbJobs; }));
+    }
+    for (size_t i = 0; i < nbJobs; i++) {
+        if (i == 5)
+            EXPECT_EQ(ctx.results[i], ERR_COMPRESSION_FAILED);
+        else
+            EXPECT_GT(ctx.results[i], 0);
+        aocl_llc_destroy(&descs[i], ZLIB);
+    }
+}
+
+TEST(API_async, AOCL_Compression_api_aocl_llc_compress_async_invalid_common_1) //invalid input
+{
+    ACD desc;
+    reset_ACD(&desc, 0);
+    aocl_async_job* job = (aocl_async_job*)&desc;
+    EXPECT_EQ(aocl_llc_compress_async(NULL, LZ4, NULL, NULL, &job), ERR_INVALID_INPUT);
+    EXPECT_EQ(job, nullptr);
+    EXPECT_EQ(aocl_llc_decompress_async(&desc, AOCL_COMPRESSOR_ALGOS_NUM, NULL, NULL, &job), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_async_poll(NULL, NULL), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_llc_async_wait(NULL), ERR_INVALID_INPUT);
+}
+/*********************************************
+* End async Tests
+*********************************************/
+
 #endif /* AOCL_ENABLE_THREADS */
@@ -755,6 +755,124 @@ TEST_F(BZIP2_BZ2_bzBuffToBuffDecompress, pass_cases)
  * "End" of BZ2_bzBuffToBuffDecompress Tests
  ********************************************/
 
+/*********************************************
+ * "Begin" of multi-block BZ2_bzBuffToBuff Tests
+ ********************************************/
+
+/*
+    Streams of many blocks, which are compressed and decompressed by
+    multiple threads in builds with AOCL_ENABLE_THREADS. The streams must
+    stay interchangeable with the ones of the low-level interface.
+*/
+class BZIP2_BZ2_bzBuffToBuff_multiBlock : public BZIP2_setup_and_gtest_class
+{
+    public:
+    const unsigned int sourceLen = 2000000;
+    const unsigned int destSize = sourceLen * 1.01 + 600;
+    int blockSize100k = 1;
+    vector<char> source, dest, uncompressed;
+
+    void SetUp() override
+    {
+        source = vector<char>(sourceLen);
+        uncompressed = vector<char>(sourceLen);
+        dest = vector<char>(destSize);
+        // Compressible data with runs, spread over 20 blocks. A local generator
+        // leaves the rand() sequence of the other tests unchanged
+        std::mt19937 gen(1);
+        for (unsigned int i = 0; i < sourceLen; i++)
+            source[i] = (gen() % 8 == 0) ? (char)(gen() % 256) : (char)('a' + (i / 7) % 5);
+    }
+
+    // Compresses `source` into `dest` through the low-level interface
+    unsigned int stream_compress()
+    {
+        bz_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        EXPECT_EQ(BZIP2_API::CompressInit(&strm, blockSize100k, 0, 0), BZ_OK);
+        strm.next_in = source.data();
+        strm.avail_in = sourceLen;
+        strm.next_out = dest.data();
+        strm.avail_out = destSize;
+        EXPECT_EQ(BZIP2_API::Compress(&strm, BZ_FINISH), BZ_STREAM_END);
+        unsigned int len = destSize - strm.avail_out;
+        BZIP2_API::CompressEnd(&strm);
+        return len;
+    }
+
+    // Decompresses `len` bytes of `dest` into `uncompressed` through the low-level interface
+    int stream_decompress(unsigned int len, unsigned int* uncompressedLen)
+    {
+        bz_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        EXPECT_EQ(BZIP2_API::DecompressInit(&strm, 0, 0), BZ_OK);
+        strm.next_in = dest.data();
+        strm.avail_in = len;
+        strm.next_out = uncompressed.data();
+        strm.avail_out = sourceLen;
+        int ret = BZIP2_API::Decompress(&strm);
+        *uncompressedLen = sourceLen - strm.avail_out;
+        BZIP2_API::DecompressEnd(&strm);
+        return ret;
+    }
+};
+
+TEST_F(BZIP2_BZ2_bzBuffToBuff_multiBlock, AOCL_Compression_bzip2_BZ2_bzBuffToBuff_multiBlock_common_1)
+{
+    // Output of BZ2_bzBuffToBuffCompress is a standard stream
+    unsigned int destLen = destSize, uncompressedLen = 0;
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OK);
+    EXPECT_EQ(stream_decompress(destLen, &uncompressedLen), BZ_STREAM_END);
+    EXPECT_EQ(uncompressedLen, sourceLen);
+    EXPECT_EQ(memcmp(uncompressed.data(), source.data(), sourceLen), 0);
+}
+
+TEST_F(BZIP2_BZ2_bzBuffToBuff_multiBlock, AOCL_Compression_bzip2_BZ2_bzBuffToBuff_multiBlock_common_2)
+{
+    // BZ2_bzBuffToBuffDecompress decodes streams of the low-level interface
+    unsigned int destLen = stream_compress();
+    unsigned int uncompressedLen = sourceLen;
+    EXPECT_EQ(BZIP2_API::BuffToBuffDecompress(uncompressed.data(), &uncompressedLen, dest.data(), destLen, 0, 0), BZ_OK);
+    EXPECT_EQ(uncompressedLen, sourceLen);
+    EXPECT_EQ(memcmp(uncompressed.data(), source.data(), sourceLen), 0);
+}
+
+TEST_F(BZIP2_BZ2_bzBuffToBuff_multiBlock, AOCL_Compression_bzip2_BZ2_bzBuffToBuff_multiBlock_common_3)
+{
+    unsigned int destLen = destSize;
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OK);
+    unsigned int compressedLen = destLen;
+    destLen = compressedLen - 1;    // dest is one byte short of the compressed size
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OUTBUFF_FULL);
+
+    destLen = compressedLen;
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OK);
+    unsigned int uncompressedLen = sourceLen - 1;   // uncompressed data does not fit by one byte
+    EXPECT_EQ(BZIP2_API::BuffToBuffDecompress(uncompressed.data(), &uncompressedLen, dest.data(), destLen, 0, 0), BZ_OUTBUFF_FULL);
+    EXPECT_EQ(uncompressedLen, sourceLen - 1);
+}
+
+TEST_F(BZIP2_BZ2_bzBuffToBuff_multiBlock, AOCL_Compression_bzip2_BZ2_bzBuffToBuff_multiBlock_common_4)
+{
+    unsigned int destLen = destSize;
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OK);
+    dest[destLen / 2]++;    // Corrupting a block in the middle of the stream
+    unsigned int uncompressedLen = sourceLen;
+    EXPECT_EQ(BZIP2_API::BuffToBuffDecompress(uncompressed.data(), &uncompressedLen, dest.data(), destLen, 0, 0), BZ_DATA_ERROR);
+}
+
+TEST_F(BZIP2_BZ2_bzBuffToBuff_multiBlock, AOCL_Compression_bzip2_BZ2_bzBuffToBuff_multiBlock_common_5)
+{
+    unsigned int destLen = destSize;
+    EXPECT_EQ(BZIP2_API::BuffToBuffCompress(dest.data(), &destLen, source.data(), sourceLen, blockSize100k, 0, 0), BZ_OK);
+    unsigned int uncompressedLen = sourceLen;
+    // Only the first half of the stream is provided
+    EXPECT_EQ(BZIP2_API::BuffToBuffDecompress(uncompressed.data(), &uncompressedLen, dest.data(), destLen / 2, 0, 0), BZ_UNEXPECTED_EOF);
+}
+/*********************************************
+ * "End" of multi-block BZ2_bzBuffToBuff Tests
+ ********************************************/
+
 /*********************************************
  * "Begin" of BZ2_bzCompress Tests
  ********************************************/
@@ -412,6 +412,52 @@ TEST_F(LZ4_compress_fast_test, AOCL_Compression_lz4_LZ4_compress_fast_common_6)
  * "End" of LZ4_compress_fast Tests
  *********************************************/
 
+/*********************************************
+ * "Begin" of LZ4_compress_fast_MTCtx
+ *********************************************/
+class LZ4_compress_fast_MTCtx_test : public AOCL_setup_lz4 {
+};
+
+TEST_F(LZ4_compress_fast_MTCtx_test, AOCL_Compression_lz4_LZ4_compress_fast_MTCtx_common_1) // src_NULL
+{
+    TestLoad d(800);
+    void* mtCtx = LZ4_createMTCtx();
+
+    EXPECT_EQ(LZ4_compress_fast_MTCtx(mtCtx, NULL, d.getCompressedBuff(), d.getOrigSize(), d.getCompressedSize(), 1), 0);
+    LZ4_freeMTCtx(mtCtx);
+}
+
+TEST_F(LZ4_compress_fast_MTCtx_test, AOCL_Compression_lz4_LZ4_compress_fast_MTCtx_common_2) // mtCtx_NULL
+{
+    TestLoad d(800);
+
+    int compressedSize = LZ4_compress_fast_MTCtx(NULL, d.getOrigData(), d.getCompressedBuff(), d.getOrigSize(), d.getCompressedSize(), 1);
+    EXPECT_NE(compressedSize, 0);
+    EXPECT_TRUE(check_uncompressed_equal_to_original(d.getOrigData(),d.getOrigSize(),d.getCompressedBuff(),compressedSize));
+}
+
+TEST_F(LZ4_compress_fast_MTCtx_test, AOCL_Compression_lz4_LZ4_compress_fast_MTCtx_common_3) // Pass, context reused
+{
+    TestLoad d(1024 * 1024);
+    void* mtCtx = LZ4_createMTCtx();
+    char* ref = (char*)malloc(d.getCompressedSize());
+    int refSize = LZ4_compress_fast(d.getOrigData(), ref, d.getOrigSize(), d.getCompressedSize(), 1);
+
+    for (int i = 0; i < 3; i++)
+    {
+        int compressedSize = LZ4_compress_fast_MTCtx(mtCtx, d.getOrigData(), d.getCompressedBuff(), d.getOrigSize(), d.getCompressedSize(), 1);
+        EXPECT_EQ(compressedSize, refSize);
+        EXPECT_EQ(memcmp(d.getCompressedBuff(), ref, refSize), 0);
+        EXPECT_TRUE(check_uncompressed_equal_to_original(d.getOrigData(),d.getOrigSize(),d.getCompressedBuff(),compressedSize));
+    }
+    free(ref);
+    LZ4_freeMTCtx(mtCtx);
+}
+
+/*********************************************
+ * "End" of LZ4_compress_fast_MTCtx Tests
+ *********************************************/
+
 /*********************************************
  * "Begin" of LZ4_compress_destSize
  *********************************************/
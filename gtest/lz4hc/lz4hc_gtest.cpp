@@ -38,11 +38,16 @@
 
 #include <string>
 #include <climits>
+#include <random>
 #include "gtest/gtest.h"
 
 #include "algos/lz4/lz4.h"
 #include "algos/lz4/lz4hc.h"
 
+#ifdef AOCL_ENABLE_THREADS
+#include "threads/threads.h"
+#endif /* AOCL_ENABLE_THREADS */
+
 using namespace std;
 
 /* read function to be called for Hash */
@@ -326,6 +331,96 @@ TEST_F(LZ4HC_LZ4_compress_HC, AOCL_Compression_lz4hc_LZ4_compress_HC_common_6) /
  * "End" of LZ4_compress_HC Tests
  *********************************************/
 
+/*********************************************
+ * "Begin" of LZ4_compress_HC multi-partition Tests
+ *********************************************/
+#define LZ4HC_MP_IN_SIZE (4 << 20)
+#define LZ4HC_MP_THREADS 4
+
+/*
+    Fixture class for testing LZ4_compress_HC on inputs large enough to
+    be split into several partitions. Multi-threaded builds compress the
+    partitions in parallel and join them into a single LZ4 block held in
+    a RAP frame.
+*/
+class LZ4HC_LZ4_compress_HC_multiPartition : public AOCL_setup_lz4hc
+{
+public:
+    void SetUp() override {
+        src = (char*)malloc(LZ4HC_MP_IN_SIZE);
+        dstSize = LZ4_compressBound(LZ4HC_MP_IN_SIZE);
+        dst = (char*)malloc(dstSize);
+        ASSERT_NE(src, nullptr);
+        ASSERT_NE(dst, nullptr);
+        //Short random words repeated at random distances: compressible but not trivial
+        std::mt19937 gen(LZ4HC_MP_IN_SIZE);
+        for (int i = 0; i < LZ4HC_MP_IN_SIZE; i++) {
+            if (i >= 1024 && gen() % 4 == 0)
+                src[i] = src[i - 1 - (gen() % 1024)];
+            else
+                src[i] = 'a' + (gen() % 16);
+        }
+#ifdef AOCL_ENABLE_THREADS
+        max_threads = omp_get_max_threads();
+        omp_set_num_threads(LZ4HC_MP_THREADS);
+#endif /* AOCL_ENABLE_THREADS */
+    }
+
+    void TearDown() override {
+#ifdef AOCL_ENABLE_THREADS
+        omp_set_num_threads(max_threads);
+#endif /* AOCL_ENABLE_THREADS */
+        free(src);
+        free(dst);
+    }
+
+    char* src = NULL;
+    char* dst = NULL;
+    int dstSize = 0;
+#ifdef AOCL_ENABLE_THREADS
+    int max_threads = 1;
+#endif /* AOCL_ENABLE_THREADS */
+};
+
+TEST_F(LZ4HC_LZ4_compress_HC_multiPartition, AOCL_Compression_lz4hc_LZ4_compress_HC_multiPartition_common_1) // round_trip
+{
+    for (int level : { 1, 4, 9, 12 }) {
+        int outLen = LZ4_compress_HC(src, dst, LZ4HC_MP_IN_SIZE, dstSize, level);
+        ASSERT_GT(outLen, 0);
+        EXPECT_TRUE(lz4hc_check_uncompressed_equal_to_original(src, LZ4HC_MP_IN_SIZE, dst, outLen));
+    }
+}
+
+TEST_F(LZ4HC_LZ4_compress_HC_multiPartition, AOCL_Compression_lz4hc_LZ4_compress_HC_multiPartition_common_2) // dst_size_not_enough
+{
+    int outLen = LZ4_compress_HC(src, dst, LZ4HC_MP_IN_SIZE, dstSize, 9);
+    ASSERT_GT(outLen, 0);
+    EXPECT_EQ(LZ4_compress_HC(src, dst, LZ4HC_MP_IN_SIZE, outLen / 2, 9), 0);
+    // Joined partitions that do not fit are compressed again without the RAP frame
+    int fitLen = LZ4_compress_HC(src, dst, LZ4HC_MP_IN_SIZE, outLen - 1, 9);
+    if (fitLen > 0) {
+        EXPECT_LT(fitLen, outLen);
+        EXPECT_TRUE(lz4hc_check_uncompressed_equal_to_original(src, LZ4HC_MP_IN_SIZE, dst, fitLen));
+    }
+}
+
+#ifdef AOCL_ENABLE_THREADS
+TEST_F(LZ4HC_LZ4_compress_HC_multiPartition, AOCL_Compression_lz4hc_LZ4_compress_HC_multiPartition_rap_common_1) // decompress_with_one_thread
+{
+    int outLen = LZ4_compress_HC(src, dst, LZ4HC_MP_IN_SIZE, dstSize, 9);
+    ASSERT_GT(outLen, 0);
+    AOCL_UINT64 magic;
+    memcpy(&magic, dst, sizeof(magic));
+    EXPECT_EQ(magic, (AOCL_UINT64)RAP_MAGIC_WORD);
+    omp_set_num_threads(1);
+    EXPECT_TRUE(lz4hc_check_uncompressed_equal_to_original(src, LZ4HC_MP_IN_SIZE, dst, outLen));
+}
+#endif /* AOCL_ENABLE_THREADS */
+
+/*********************************************
+ * "End" of LZ4_compress_HC multi-partition Tests
+ *********************************************/
+
 
 /*********************************************
  * "Begin" of LZ4_sizeofStateHC Test
@@ -47,6 +47,10 @@
 #include "algos/lzma/LzmaDec.h"
 #include "algos/common/aoclHashChain.h"
 
+#ifdef AOCL_ENABLE_THREADS
+#include "threads/threads.h"
+#endif /* AOCL_ENABLE_THREADS */
+
 using namespace std;
 
 #define DEFAULT_OPT_LEVEL 2 // system running gtest must have AVX support
@@ -2411,6 +2415,143 @@ INSTANTIATE_TEST_SUITE_P(
 * End of LZMA_encodeFile
 *********************************************/
 
+/*********************************************
+* Begin of LZMA_encodeMultiPartition
+*********************************************/
+#define LZMA_MP_DICT_SIZE ((unsigned)1 << 16)
+#define LZMA_MP_IN_SIZE ((size_t)1 << 20) //16 dictionaries
+#define LZMA_MP_THREADS 4
+
+/*
+    Fixture class for testing LzmaEncode and LzmaDecode on inputs that
+    span several dictionaries. Multi-threaded builds split such inputs
+    into independently coded partitions held in a RAP frame.
+*/
+class LZMA_encodeMultiPartition : public LZMA_encodeBase
+{
+public:
+    void SetUp() override {
+        SetUpEncode(LZMA_MP_IN_SIZE);
+#ifdef AOCL_ENABLE_THREADS
+        max_threads = omp_get_max_threads();
+        omp_set_num_threads(LZMA_MP_THREADS);
+#endif /* AOCL_ENABLE_THREADS */
+    }
+
+    void TearDown() override
+    {
+#ifdef AOCL_ENABLE_THREADS
+        omp_set_num_threads(max_threads);
+#endif /* AOCL_ENABLE_THREADS */
+        TearDownEncode();
+    }
+
+    void encode(int level) {
+        LzmaEncProps_Init(&props);
+        props.level = level;
+        props.dictSize = LZMA_MP_DICT_SIZE;
+        outLen = outSize - LZMA_PROPS_SIZE;
+        SRes res = LzmaEncode((uint8_t*)compPtr + LZMA_PROPS_SIZE, &outLen, (uint8_t*)inPtr, inSize,
+            &props, (uint8_t*)compPtr, &headerSize, 0, NULL, &g_Alloc, &g_AllocBig);
+        ASSERT_EQ(res, SZ_OK);
+    }
+
+    SRes decode(SizeT* destLen, SizeT* srcLen, ELzmaFinishMode finishMode, ELzmaStatus* status) {
+        return LzmaDecode((uint8_t*)decompPtr, destLen, (uint8_t*)compPtr + LZMA_PROPS_SIZE,
+            srcLen, (uint8_t*)compPtr, LZMA_PROPS_SIZE, finishMode, status, &g_Alloc);
+    }
+
+#ifdef AOCL_ENABLE_THREADS
+    int max_threads = 1;
+#endif /* AOCL_ENABLE_THREADS */
+};
+
+TEST_F(LZMA_encodeMultiPartition, AOCL_Compression_lzma_LzmaEncode_multiPartition_common_1) //round trip
+{
+    for (int level = LZMA_MIN_LEVEL; level <= LZMA_MAX_LEVEL; ++level) {
+        encode(level);
+        SizeT destLen = inSize, srcLen = outLen;
+        ELzmaStatus status;
+        EXPECT_EQ(decode(&destLen, &srcLen, LZMA_FINISH_END, &status), SZ_OK);
+        EXPECT_EQ(destLen, inSize);
+        EXPECT_EQ(srcLen, outLen); //whole stream consumed
+        EXPECT_EQ(memcmp(inPtr, decompPtr, inSize), 0);
+    }
+}
+
+TEST_F(LZMA_encodeMultiPartition, AOCL_Compression_lzma_LzmaEncode_multiPartition_common_2) //dest ends inside the stream
+{
+    encode(5);
+    SizeT destLen = inSize / 2 + 1, srcLen = outLen;
+    ELzmaStatus status;
+    EXPECT_NE(decode(&destLen, &srcLen, LZMA_FINISH_END, &status), SZ_OK);
+
+    destLen = inSize / 2 + 1;
+    srcLen = outLen;
+    EXPECT_EQ(decode(&destLen, &srcLen, LZMA_FINISH_ANY, &status), SZ_OK);
+    EXPECT_EQ(status, LZMA_STATUS_NOT_FINISHED);
+    EXPECT_EQ(destLen, inSize / 2 + 1);
+    EXPECT_EQ(memcmp(inPtr, decompPtr, destLen), 0);
+}
+
+#ifdef AOCL_ENABLE_THREADS
+TEST_F(LZMA_encodeMultiPartition, AOCL_Compression_lzma_LzmaEncode_multiPartition_rap_common_1) //each partition is a standalone stream
+{
+    encode(5);
+    const char* frame = compPtr + LZMA_PROPS_SIZE;
+    ASSERT_EQ(*(AOCL_INT64*)frame, (AOCL_INT64)RAP_MAGIC_WORD);
+    AOCL_UINT32 num_partitions = *(AOCL_UINT32*)(frame + RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES);
+    EXPECT_GT(num_partitions, 1u);
+    EXPECT_EQ(*(AOCL_UINT32*)(frame + RAP_MAGIC_WORD_BYTES), (AOCL_UINT32)RAP_FRAME_LEN_WITH_DECOMP_LENGTH(num_partitions, 0));
+
+    const char* rap_ptr = frame + RAP_START_OF_PARTITIONS;
+    size_t decomp_total = 0;
+    for (AOCL_UINT32 i = 0; i < num_partitions; i++) {
+        AOCL_UINT32 rap_offset = *(AOCL_UINT32*)rap_ptr;
+        AOCL_UINT32 rap_len = *(AOCL_UINT32*)(rap_ptr + RAP_OFFSET_BYTES);
+        AOCL_UINT32 decomp_len = *(AOCL_UINT32*)(rap_ptr + RAP_OFFSET_BYTES + RAP_LEN_BYTES);
+        rap_ptr += RAP_DATA_BYTES_WITH_DECOMP_LEN;
+
+        SizeT destLen = decomp_len, srcLen = rap_len;
+        ELzmaStatus status;
+        EXPECT_EQ(LzmaDecode((uint8_t*)decompPtr + decomp_total, &destLen, (uint8_t*)frame + rap_offset,
+            &srcLen, (uint8_t*)compPtr, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc), SZ_OK);
+        EXPECT_EQ(destLen, decomp_len);
+        decomp_total += decomp_len;
+    }
+    EXPECT_EQ(decomp_total, inSize);
+    EXPECT_EQ(memcmp(inPtr, decompPtr, inSize), 0);
+}
+
+TEST_F(LZMA_encodeMultiPartition, AOCL_Compression_lzma_LzmaEncode_multiPartition_rap_common_2) //decode with one thread
+{
+    encode(5);
+    omp_set_num_threads(1);
+    SizeT destLen = inSize, srcLen = outLen;
+    ELzmaStatus status;
+    EXPECT_EQ(decode(&destLen, &srcLen, LZMA_FINISH_END, &status), SZ_OK);
+    EXPECT_EQ(destLen, inSize);
+    EXPECT_EQ(memcmp(inPtr, decompPtr, inSize), 0);
+}
+
+TEST_F(LZMA_encodeMultiPartition, AOCL_Compression_lzma_LzmaEncode_multiPartition_rap_common_3) //corrupt partition length
+{
+    encode(5);
+    char* rap_len = compPtr + LZMA_PROPS_SIZE + RAP_START_OF_PARTITIONS + RAP_OFFSET_BYTES;
+    *(AOCL_UINT32*)rap_len = (AOCL_UINT32)outLen; //runs past the end of the stream
+    for (int threads = LZMA_MP_THREADS; threads >= 1; threads -= (LZMA_MP_THREADS - 1)) {
+        omp_set_num_threads(threads);
+        SizeT destLen = inSize, srcLen = outLen;
+        ELzmaStatus status;
+        EXPECT_EQ(decode(&destLen, &srcLen, LZMA_FINISH_END, &status), SZ_ERROR_DATA);
+    }
+}
+#endif /* AOCL_ENABLE_THREADS */
+
+/*********************************************
+* End of LZMA_encodeMultiPartition
+*********************************************/
+
 /*********************************************
  * End API tests for LzmaEnc
  *********************************************/
@@ -1465,6 +1465,53 @@ TEST_F(SNAPPY_RawCompress, fail_case3)    // AOCL_Compression_snappy_RawCompress
     EXPECT_STREQ(src,"helloWorld");
 }
 
+TEST_F(SNAPPY_RawCompress, fail_case4)    // AOCL_Compression_snappy_RawCompress_common_8
+{
+    size_t c_len = -1;
+    char compressed[50];
+    void* mt_ctx = CreateMTContext();
+
+    RawCompress(NULL, 0, compressed, &c_len, mt_ctx);
+
+    EXPECT_EQ(c_len, (size_t)(-1));
+    FreeMTContext(mt_ctx);
+}
+
+TEST_F(SNAPPY_RawCompress, pass_case_mt_ctx)    // AOCL_Compression_snappy_RawCompress_common_9
+{
+    const size_t input_size = 1024 * 1024;
+    std::string input(input_size, 0);
+    for (size_t i = 0; i < input_size; i++)
+        input[i] = (char)((i % 251) ^ (rand() % 4));
+
+    size_t max_len = MaxCompressedLength(input_size);
+    char *ref = (char *)malloc(max_len);
+    char *c = (char *)malloc(max_len);
+    size_t ref_len, c_len;
+    RawCompress(input.data(), input_size, ref, &ref_len);
+
+    // the context is reused by every call and gives the same output as RawCompress()
+    void* mt_ctx = CreateMTContext();
+    for (int i = 0; i < 3; i++)
+    {
+        RawCompress(input.data(), input_size, c, &c_len, mt_ctx);
+        EXPECT_EQ(c_len, ref_len);
+        EXPECT_EQ(memcmp(c, ref, ref_len), 0);
+    }
+    std::string uncompressed(input_size, 0);
+    EXPECT_TRUE(snappy::RawUncompress(c, c_len, string_as_array(&uncompressed)));
+    EXPECT_EQ(uncompressed, input);
+    FreeMTContext(mt_ctx);
+
+    // NULL context
+    RawCompress(input.data(), input_size, c, &c_len, NULL);
+    EXPECT_EQ(c_len, ref_len);
+    EXPECT_EQ(memcmp(c, ref, ref_len), 0);
+
+    free(ref);
+    free(c);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SNAPPY,
     SNAPPY_RawCompress_,
@@ -38,11 +38,15 @@
 #include <string>
 #include <limits>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
 #include "gtest/gtest.h"
 
 #include "utils/utils.h"
 #include "threads/threads.h"
 #include "api/aocl_compression.h"
+#include "api/aocl_threads.h"
 #include "api/types.h"
 
 using namespace std;
@@ -250,11 +254,12 @@ void reset_ACD(ACD* desc, AOCL_INTP level) {
     desc->inBuf = nullptr;
     desc->outBuf = nullptr;
     desc->workBuf = nullptr;
+    desc->batchBuf = nullptr;
     desc->inSize = 0;
     desc->outSize = 0;
     desc->level = level;
     desc->optVar = 0;
-    desc->numThreads = 1;
+    desc->numThreads = 0; //all available threads
     desc->numMPIranks = 1;
     desc->memLimit = MAX_MEM_SIZE_FOR_FILE_READ;
     desc->measureStats = 0;
@@ -314,6 +319,9 @@ public:
     void setup() {
         ASSERT_NO_THROW(aocl_llc_setup(&desc, atp.algo));
         switch (atp.algo) {
+        case LZMA: //lzma keeps its encoder and decoder
+        case ZLIB: //zlib keeps its deflate and inflate streams
+        case BZIP2: //bzip2 keeps its compression and decompression states
         case ZSTD:
             ASSERT_NE(desc.workBuf, nullptr); //ztd saves params and context 
             break;
@@ -442,13 +450,39 @@ INSTANTIATE_TEST_SUITE_P(
  ********************************************/
 
 AOCL_INT32 Test_aocl_setup_parallel_compress_mt(aocl_thread_group_t* thread_grp,
-    AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INT32 in_size,
-    AOCL_INT32 out_size, AOCL_INT32 window_len,
+    AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+    AOCL_INTP out_size, AOCL_INT32 window_len,
     AOCL_INT32 window_factor) {
     return aocl_setup_parallel_compress_mt(thread_grp, src, dst, in_size,
         out_size, window_len, window_factor);
 }
 
+AOCL_INT32 Test_aocl_setup_parallel_compress_ctx_mt(aocl_thread_group_t* thread_grp,
+    aocl_thread_ctx_t* ctx, AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+    AOCL_INTP out_size, AOCL_INT32 window_len,
+    AOCL_INT32 window_factor) {
+    return aocl_setup_parallel_compress_ctx_mt(thread_grp, ctx, src, dst, in_size,
+        out_size, window_len, window_factor);
+}
+
+aocl_thread_ctx_t* Test_aocl_create_thread_ctx_mt(aocl_free_thread_state_t free_state) {
+    return aocl_create_thread_ctx_mt(free_state);
+}
+
+void Test_aocl_destroy_thread_ctx_mt(aocl_thread_ctx_t* ctx) {
+    aocl_destroy_thread_ctx_mt(ctx);
+}
+
+AOCL_VOID* Test_aocl_get_thread_state_mt(const aocl_thread_group_t* thread_grp,
+    AOCL_UINT32 thread_id, aocl_free_thread_state_t free_state) {
+    return aocl_get_thread_state_mt(thread_grp, thread_id, free_state);
+}
+
+AOCL_INT32 Test_aocl_set_thread_state_mt(aocl_thread_group_t* thread_grp,
+    AOCL_UINT32 thread_id, AOCL_VOID* state, aocl_free_thread_state_t free_state) {
+    return aocl_set_thread_state_mt(thread_grp, thread_id, state, free_state);
+}
+
 AOCL_INT32 Test_aocl_do_partition_compress_mt(aocl_thread_group_t* thread_grp,
     aocl_thread_info_t* cur_thread_info,
     AOCL_UINT32 cmpr_bound_pad, AOCL_UINT32 thread_id) {
@@ -460,9 +494,19 @@ void Test_aocl_destroy_parallel_compress_mt(aocl_thread_group_t* thread_grp) {
     aocl_destroy_parallel_compress_mt(thread_grp);
 }
 
+AOCL_INT32 Test_aocl_enable_in_place_compress_mt(aocl_thread_group_t* thread_grp,
+    AOCL_UINT32 cmpr_bound_pad, AOCL_INTP dst_reserved) {
+    return aocl_enable_in_place_compress_mt(thread_grp, cmpr_bound_pad, dst_reserved);
+}
+
+AOCL_INT32 Test_aocl_compact_partitions_mt(aocl_partition_move_t* moves,
+    AOCL_UINT32 num_moves, AOCL_UINT32 num_threads) {
+    return aocl_compact_partitions_mt(moves, num_moves, num_threads);
+}
+
 AOCL_INT32 Test_aocl_setup_parallel_decompress_mt(aocl_thread_group_t* thread_grp,
-    AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INT32 in_size,
-    AOCL_INT32 out_size, AOCL_INT32 use_ST_decompressor) {
+    AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+    AOCL_INTP out_size, AOCL_INT32 use_ST_decompressor) {
     return aocl_setup_parallel_decompress_mt(thread_grp,
         src, dst, in_size, out_size, use_ST_decompressor);
 }
@@ -478,6 +522,34 @@ void Test_aocl_destroy_parallel_decompress_mt(aocl_thread_group_t* thread_grp) {
     aocl_destroy_parallel_decompress_mt(thread_grp);
 }
 
+AOCL_CHAR* Test_aocl_write_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+    AOCL_CHAR* rap_ptr, AOCL_INTP rap_offset, AOCL_INTP rap_len, AOCL_INTP decomp_len) {
+    return aocl_write_rap_partition_mt(thread_grp, rap_ptr, rap_offset, rap_len, decomp_len);
+}
+
+void Test_aocl_read_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+    AOCL_UINT32 partition_id, AOCL_INTP* rap_offset, AOCL_INTP* rap_len, AOCL_INTP* decomp_len) {
+    aocl_read_rap_partition_mt(thread_grp, partition_id, rap_offset, rap_len, decomp_len);
+}
+
+void Test_aocl_mark_rap_dependent_mt(const aocl_thread_group_t* thread_grp, AOCL_CHAR* rap_ptr) {
+    aocl_mark_rap_dependent_mt(thread_grp, rap_ptr);
+}
+
+AOCL_INT32 Test_aocl_is_rap_dependent_mt(const aocl_thread_group_t* thread_grp, AOCL_UINT32 partition_id) {
+    return aocl_is_rap_dependent_mt(thread_grp, partition_id);
+}
+
+AOCL_INT32 Test_aocl_read_rap_chain_mt(const aocl_thread_group_t* thread_grp, AOCL_UINT32 partition_id,
+    AOCL_UINT32 num_partitions, AOCL_INTP* rap_offset, AOCL_INTP* rap_len, AOCL_INTP* decomp_len) {
+    return aocl_read_rap_chain_mt(thread_grp, partition_id, num_partitions, rap_offset, rap_len, decomp_len);
+}
+
+AOCL_INT32 Test_aocl_get_next_partition_mt(aocl_thread_group_t* thread_grp,
+    AOCL_UINT32 worker_id, AOCL_UINT32* partition_id) {
+    return aocl_get_next_partition_mt(thread_grp, worker_id, partition_id);
+}
+
 void init_thread_group(aocl_thread_group_t* thread_grp) {
     thread_grp->threads_info_list = nullptr;
     thread_grp->src = nullptr;
@@ -487,7 +559,14 @@ void init_thread_group(aocl_thread_group_t* thread_grp) {
     thread_grp->common_part_src_size = 0;
     thread_grp->leftover_part_src_bytes = 0;
     thread_grp->num_threads = 0;
+    thread_grp->num_workers = 0;
     thread_grp->search_window_length = 0;
+    thread_grp->rap_version = 0;
+    thread_grp->in_place_dst = 0;
+    thread_grp->in_place_offset = 0;
+    thread_grp->in_place_stride = 0;
+    thread_grp->ctx = nullptr;
+    thread_grp->partition_queues = nullptr;
 }
 
 /*********************************************
@@ -533,8 +612,9 @@ public:
             //| <--RAP Magic word(8 bytes)--> | <--RAP Metadata length(4 bytes)--> |
             //<--- Num Main Threads (2 bytes) --> | <-- Num Child Threads (2 bytes) ---> |
             AOCL_CHAR* rap_head = thread_grp.dst;
-            EXPECT_EQ(rap_frame_len, RAP_FRAME_LEN_WITH_DECOMP_LENGTH(thread_grp.num_threads, 0));
-            EXPECT_EQ(*(AOCL_INT64*)rap_head, RAP_MAGIC_WORD);
+            EXPECT_EQ(rap_frame_len, RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(thread_grp.rap_version, thread_grp.num_threads, 0));
+            EXPECT_EQ(*(AOCL_INT64*)rap_head, 
+                (thread_grp.rap_version == RAP_FRAME_VERSION_64) ? RAP_MAGIC_WORD_64 : RAP_MAGIC_WORD);
             EXPECT_EQ(*(AOCL_UINT32*)(rap_head + 8), rap_frame_len);
             EXPECT_EQ(*(AOCL_SHORT*)(rap_head + 12), thread_grp.num_threads);
             EXPECT_EQ(*(AOCL_SHORT*)(rap_head + 14), 0);
@@ -546,7 +626,7 @@ public:
 
     aocl_thread_group_t thread_grp;
     AOCL_CHAR* src, * dst;
-    AOCL_INT32 in_size, out_size;
+    AOCL_INTP in_size, out_size;
     const AOCL_INT32 buff_size = 1024 * 16;
 };
 
@@ -557,6 +637,7 @@ TEST_F(API_setup_parallel_compress_MT, AOCL_Compression_api_aocl_setup_parallel_
         out_size, window_len, window_factor);
     validate(res, window_len);
     EXPECT_LE(thread_grp.num_threads, 8); // num_parallel_partitions = 8 based on window_len and window_factor
+    EXPECT_EQ(thread_grp.rap_version, RAP_FRAME_VERSION_32); // stream fits in 32-bit RAP metadata
     Test_aocl_destroy_parallel_compress_mt(&thread_grp);
 }
 
@@ -659,6 +740,34 @@ TEST_F(API_setup_parallel_compress_MT, AOCL_Compression_api_aocl_setup_parallel_
     Test_aocl_destroy_parallel_compress_mt(&thread_grp);
 }
 
+TEST_F(API_setup_parallel_compress_MT, AOCL_Compression_api_aocl_setup_parallel_compress_mt_common_12) { // in_size > 4 GiB, 64-bit RAP frame
+    AOCL_INT32 window_len = 1 << 28;
+    AOCL_INT32 window_factor = 4;
+    in_size = RAP_FRAME_32BIT_LIMIT + 1; // src is not read during setup
+    AOCL_INT32 res = Test_aocl_setup_parallel_compress_mt(&thread_grp, src, dst, in_size,
+        out_size, window_len, window_factor);
+    EXPECT_EQ(thread_grp.rap_version, RAP_FRAME_VERSION_64);
+    validate(res, window_len);
+    EXPECT_LE(thread_grp.num_threads, 4); // num_parallel_partitions = 4 based on window_len and window_factor
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+}
+
+TEST_F(API_setup_parallel_compress_MT, AOCL_Compression_api_aocl_setup_parallel_compress_mt_common_13) { // more partitions than threads
+    AOCL_INT32 max_threads = omp_get_max_threads();
+    AOCL_INT32 window_len = in_size / 32;
+    AOCL_INT32 window_factor = 1;
+    omp_set_num_threads(2);
+    AOCL_INT32 res = Test_aocl_setup_parallel_compress_mt(&thread_grp, src, dst, in_size,
+        out_size, window_len, window_factor);
+    omp_set_num_threads(max_threads);
+    validate(res, window_len);
+    EXPECT_EQ(thread_grp.num_threads, 2 * PARTITIONS_PER_THREAD); // num_parallel_partitions = 32, limited by partitions per thread
+    EXPECT_EQ(thread_grp.num_workers, 2);
+    EXPECT_NE(thread_grp.partition_queues, nullptr);
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    EXPECT_EQ(thread_grp.partition_queues, nullptr);
+}
+
 /*********************************************
 * End multi-threaded compress setup Tests
 *********************************************/
@@ -720,34 +829,405 @@ public:
 TEST_F(API_do_partition_compress_MT, AOCL_Compression_api_aocl_do_partition_compress_mt_common_1) { // partition the problem
     aocl_thread_info_t cur_thread_info;
     const AOCL_UINT32 cmpr_bound_pad = 16;
-    #pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_threads)
+    #pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_workers)
+    {
+        AOCL_UINT32 thread_id;
+        while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &thread_id)) {
+            EXPECT_EQ(Test_aocl_do_partition_compress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
+
+            thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
+            thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
+            thread_grp.threads_info_list[thread_id].additional_state_info = cur_thread_info.additional_state_info;
+            thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
+            thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
+            thread_grp.threads_info_list[thread_id].last_bytes_len        = cur_thread_info.last_bytes_len;
+            thread_grp.threads_info_list[thread_id].num_child_threads     = 0; // not used as of now
+            thread_grp.threads_info_list[thread_id].is_error              = cur_thread_info.is_error;
+            thread_grp.threads_info_list[thread_id].thread_id             = cur_thread_info.thread_id;
+            thread_grp.threads_info_list[thread_id].next                  = cur_thread_info.next;
+        }
+    } // #pragma omp parallel
+    validate(cmpr_bound_pad);
+}
+
+TEST_F(API_do_partition_compress_MT, AOCL_Compression_api_aocl_do_partition_compress_mt_common_2) { // partition the problem in-place
+    aocl_thread_info_t cur_thread_info;
+    const AOCL_UINT32 cmpr_bound_pad = 16;
+    // bounds of all partitions exceed dst size. Per thread buffers are used.
+    EXPECT_EQ(Test_aocl_enable_in_place_compress_mt(&thread_grp, cmpr_bound_pad, 64), 0);
+    EXPECT_EQ(thread_grp.in_place_dst, 0);
+
+    // dst large enough to hold the bounds of all partitions
+    free(dst);
+    out_size = in_size + (cmpr_bound_pad * thread_grp.num_threads) + 64;
+    dst = (AOCL_CHAR*)calloc(out_size, sizeof(AOCL_CHAR));
+    thread_grp.dst = dst;
+    thread_grp.dst_size = out_size;
+    AOCL_INT32 in_place = Test_aocl_enable_in_place_compress_mt(&thread_grp, cmpr_bound_pad, 64);
+    EXPECT_EQ(in_place, thread_grp.num_threads > 1 ? 1 : 0);
+
+    #pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_workers)
     {
-        AOCL_UINT32 thread_id = omp_get_thread_num();
-        EXPECT_EQ(Test_aocl_do_partition_compress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
-
-        thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
-        thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
-        thread_grp.threads_info_list[thread_id].additional_state_info = cur_thread_info.additional_state_info;
-        thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
-        thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
-        thread_grp.threads_info_list[thread_id].last_bytes_len        = cur_thread_info.last_bytes_len;
-        thread_grp.threads_info_list[thread_id].num_child_threads     = 0; // not used as of now
-        thread_grp.threads_info_list[thread_id].is_error              = cur_thread_info.is_error;
-        thread_grp.threads_info_list[thread_id].thread_id             = cur_thread_info.thread_id;
-        thread_grp.threads_info_list[thread_id].next                  = cur_thread_info.next;
+        AOCL_UINT32 thread_id;
+        while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &thread_id)) {
+            EXPECT_EQ(Test_aocl_do_partition_compress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
+            thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
+            thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
+            thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
+            thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
+        }
     } // #pragma omp parallel
     validate(cmpr_bound_pad);
+
+    if (in_place) {
+        // partition outputs are laid out back to back in dst, within its bounds
+        AOCL_CHAR* expected = dst + 64;
+        for (AOCL_UINT32 thread_id = 0; thread_id < thread_grp.num_threads; ++thread_id) {
+            EXPECT_EQ(thread_grp.threads_info_list[thread_id].dst_trap, expected);
+            expected += thread_grp.threads_info_list[thread_id].dst_trap_size;
+        }
+        EXPECT_LE(expected, dst + out_size);
+    }
 }
 
 /*********************************************
 * End multi-threaded compress partition Tests
 *********************************************/
 
+/*********************************************
+* Begin partition scheduler Tests
+*********************************************/
+class API_get_next_partition_MT : public ::testing::Test {
+public:
+    void SetUp() override {
+        init_thread_group(&thread_grp);
+        max_threads = omp_get_max_threads();
+        src = (AOCL_CHAR*)calloc(buff_size, sizeof(AOCL_CHAR));
+        dst = (AOCL_CHAR*)calloc(buff_size, sizeof(AOCL_CHAR));
+    }
+
+    void TearDown() override {
+        omp_set_num_threads(max_threads);
+        Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+        free(src);
+        free(dst);
+    }
+
+    // Sets up num_partitions partitions for num_workers threads
+    void setup(AOCL_INT32 num_workers, AOCL_INT32 num_partitions) {
+        omp_set_num_threads(num_workers);
+        ASSERT_GT(Test_aocl_setup_parallel_compress_mt(&thread_grp, src, dst, buff_size,
+            buff_size, buff_size / num_partitions, 1), 0);
+        ASSERT_EQ(thread_grp.num_threads, (AOCL_UINT32)num_partitions);
+        ASSERT_EQ(thread_grp.num_workers, (AOCL_UINT32)num_workers);
+    }
+
+    aocl_thread_group_t thread_grp;
+    AOCL_CHAR* src, * dst;
+    AOCL_INT32 max_threads;
+    const AOCL_INT32 buff_size = 1024 * 16;
+};
+
+TEST_F(API_get_next_partition_MT, AOCL_Compression_api_aocl_get_next_partition_mt_common_1) { // own queue in order, then steal
+    setup(2, 8);
+    AOCL_UINT32 partition_id;
+    // worker 0 owns partitions 0-3 and worker 1 owns partitions 4-7
+    for (AOCL_UINT32 expected = 0; expected < 4; ++expected) {
+        EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 0, &partition_id), 1);
+        EXPECT_EQ(partition_id, expected);
+    }
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 1, &partition_id), 1);
+    EXPECT_EQ(partition_id, 4u);
+    // worker 0 steals from the tail of worker 1's queue
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 0, &partition_id), 1);
+    EXPECT_EQ(partition_id, 7u);
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 0, &partition_id), 1);
+    EXPECT_EQ(partition_id, 6u);
+    // owner continues from the head of its queue
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 1, &partition_id), 1);
+    EXPECT_EQ(partition_id, 5u);
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 1, &partition_id), 0);
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 0, &partition_id), 0);
+}
+
+TEST_F(API_get_next_partition_MT, AOCL_Compression_api_aocl_get_next_partition_mt_common_2) { // every partition handed out once
+    setup(4, 16);
+    std::vector<AOCL_INT32> taken(thread_grp.num_threads, 0);
+    #pragma omp parallel shared(thread_grp, taken) num_threads(thread_grp.num_workers)
+    {
+        AOCL_UINT32 partition_id;
+        while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &partition_id)) {
+            #pragma omp atomic
+            taken[partition_id]++;
+        }
+    } // #pragma omp parallel
+    for (AOCL_UINT32 partition_id = 0; partition_id < thread_grp.num_threads; ++partition_id)
+        EXPECT_EQ(taken[partition_id], 1);
+}
+
+TEST_F(API_get_next_partition_MT, AOCL_Compression_api_aocl_get_next_partition_mt_common_3) { // single threaded or invalid worker
+    AOCL_UINT32 partition_id;
+    omp_set_num_threads(1);
+    ASSERT_EQ(Test_aocl_setup_parallel_compress_mt(&thread_grp, src, dst, buff_size,
+        buff_size, buff_size / 8, 1), 0);
+    EXPECT_EQ(thread_grp.num_threads, 1u); // no partition queues in single threaded mode
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 0, &partition_id), 0);
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+
+    setup(2, 4);
+    EXPECT_EQ(Test_aocl_get_next_partition_mt(&thread_grp, 2, &partition_id), 0);
+}
+
+TEST_F(API_get_next_partition_MT, AOCL_Compression_api_aocl_get_next_partition_mt_common_4) { // NUMA placement on and off
+    aocl_numa_stats stats;
+    for (AOCL_INT32 placement : { 0, 1 }) {
+        aocl_set_numa_placement_mt(placement);
+        ASSERT_EQ(aocl_get_numa_stats_mt(nullptr, 1), 0);
+        init_thread_group(&thread_grp);
+        setup(4, 16);
+        std::vector<AOCL_INT32> taken(thread_grp.num_threads, 0);
+        #pragma omp parallel shared(thread_grp, taken) num_threads(thread_grp.num_workers)
+        {
+            AOCL_UINT32 partition_id;
+            while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &partition_id)) {
+                #pragma omp atomic
+                taken[partition_id]++;
+            }
+        } // #pragma omp parallel
+        for (AOCL_UINT32 partition_id = 0; partition_id < thread_grp.num_threads; ++partition_id)
+            EXPECT_EQ(taken[partition_id], 1);
+
+        // only partitions with a known source node are counted
+        ASSERT_EQ(aocl_get_numa_stats_mt(&stats, 1), 0);
+        EXPECT_LE(stats.localPartitions + stats.remotePartitions, (uint64_t)thread_grp.num_threads);
+        if (stats.numNodes == 1) {
+            EXPECT_EQ(stats.localPartitions + stats.remotePartitions, 0u);
+        }
+        Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    }
+    aocl_set_numa_placement_mt(1);
+}
+/*********************************************
+* End partition scheduler Tests
+*********************************************/
+
+/*********************************************
+* Begin reusable thread context Tests
+*********************************************/
+static AOCL_INT32 freed_thread_states = 0;
+
+static AOCL_VOID free_test_thread_state(AOCL_VOID* state) {
+    free(state);
+    freed_thread_states++;
+}
+
+static AOCL_VOID free_other_thread_state(AOCL_VOID* state) {
+    free(state);
+}
+
+class API_thread_ctx_MT : public ::testing::Test {
+public:
+    void SetUp() override {
+        init_thread_group(&thread_grp);
+        src = (AOCL_CHAR*)calloc(buff_size, sizeof(AOCL_CHAR));
+        dst = (AOCL_CHAR*)calloc(buff_size, sizeof(AOCL_CHAR));
+        freed_thread_states = 0;
+        ctx = Test_aocl_create_thread_ctx_mt(free_test_thread_state);
+        ASSERT_NE(ctx, nullptr);
+    }
+
+    void TearDown() override {
+        Test_aocl_destroy_thread_ctx_mt(ctx);
+        free(src);
+        free(dst);
+    }
+
+    // Sets up thread_grp with ctx and partitions it, without in-place mode
+    void setup_and_partition(aocl_thread_ctx_t* cur_ctx, AOCL_UINT32 cmpr_bound_pad) {
+        aocl_thread_info_t cur_thread_info;
+        ASSERT_GE(Test_aocl_setup_parallel_compress_ctx_mt(&thread_grp, cur_ctx, src, dst,
+            buff_size, buff_size, buff_size / 16, 2), 0);
+        if (thread_grp.num_threads == 1)
+            return; // single threaded, no thread buffers are needed
+        #pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_workers)
+        {
+            AOCL_UINT32 thread_id;
+            while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &thread_id)) {
+                EXPECT_EQ(Test_aocl_do_partition_compress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
+                thread_grp.threads_info_list[thread_id].dst_trap      = cur_thread_info.dst_trap;
+                thread_grp.threads_info_list[thread_id].dst_trap_size = cur_thread_info.dst_trap_size;
+            }
+        } // #pragma omp parallel
+    }
+
+    aocl_thread_group_t thread_grp;
+    aocl_thread_ctx_t* ctx;
+    AOCL_CHAR* src, * dst;
+    const AOCL_INT32 buff_size = 1024 * 16;
+};
+
+TEST_F(API_thread_ctx_MT, AOCL_Compression_api_aocl_thread_ctx_mt_common_1) { // buffers reused across calls
+    setup_and_partition(ctx, 16);
+    if (thread_grp.num_threads == 1)
+        return;
+    EXPECT_EQ(thread_grp.ctx, ctx);
+    EXPECT_EQ(thread_grp.threads_info_list, ctx->threads_info_list);
+    EXPECT_GE(ctx->max_threads, thread_grp.num_threads);
+    AOCL_UINT32 num_threads = thread_grp.num_threads;
+    std::vector<AOCL_CHAR*> dst_traps(num_threads);
+    for (AOCL_UINT32 thread_id = 0; thread_id < num_threads; ++thread_id) {
+        dst_traps[thread_id] = thread_grp.threads_info_list[thread_id].dst_trap;
+        EXPECT_EQ(dst_traps[thread_id], ctx->dst_trap_list[thread_id]);
+        EXPECT_GE(ctx->dst_trap_capacity[thread_id], thread_grp.threads_info_list[thread_id].dst_trap_size);
+    }
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    EXPECT_EQ(thread_grp.threads_info_list, nullptr);
+    EXPECT_NE(ctx->threads_info_list, nullptr); // kept by the context
+
+    // same sized call reuses the buffers
+    setup_and_partition(ctx, 16);
+    EXPECT_EQ(thread_grp.num_threads, num_threads);
+    for (AOCL_UINT32 thread_id = 0; thread_id < num_threads; ++thread_id)
+        EXPECT_EQ(thread_grp.threads_info_list[thread_id].dst_trap, dst_traps[thread_id]);
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+
+    // larger pad grows the buffers
+    setup_and_partition(ctx, 1024);
+    for (AOCL_UINT32 thread_id = 0; thread_id < num_threads; ++thread_id)
+        EXPECT_GE(ctx->dst_trap_capacity[thread_id], thread_grp.threads_info_list[thread_id].dst_trap_size);
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+}
+
+TEST_F(API_thread_ctx_MT, AOCL_Compression_api_aocl_thread_ctx_mt_common_2) { // per thread states
+    setup_and_partition(ctx, 16);
+    if (thread_grp.num_threads == 1)
+        return;
+    for (AOCL_UINT32 thread_id = 0; thread_id < thread_grp.num_threads; ++thread_id) {
+        EXPECT_EQ(Test_aocl_get_thread_state_mt(&thread_grp, thread_id, free_test_thread_state), nullptr);
+        AOCL_VOID* state = malloc(8);
+        EXPECT_EQ(Test_aocl_set_thread_state_mt(&thread_grp, thread_id, state, free_test_thread_state), 0);
+        EXPECT_EQ(Test_aocl_get_thread_state_mt(&thread_grp, thread_id, free_test_thread_state), state);
+        // states of another codec are not served by this context
+        EXPECT_EQ(Test_aocl_get_thread_state_mt(&thread_grp, thread_id, free_other_thread_state), nullptr);
+        AOCL_VOID* other = malloc(8);
+        EXPECT_EQ(Test_aocl_set_thread_state_mt(&thread_grp, thread_id, other, free_other_thread_state), -1);
+        free(other);
+    }
+    // replacing a state frees the previous one
+    EXPECT_EQ(Test_aocl_set_thread_state_mt(&thread_grp, 0, malloc(8), free_test_thread_state), 0);
+    EXPECT_EQ(freed_thread_states, 1);
+    AOCL_UINT32 num_threads = thread_grp.num_threads;
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    EXPECT_EQ(freed_thread_states, 1); // states are kept by the context
+
+    Test_aocl_destroy_thread_ctx_mt(ctx);
+    ctx = nullptr;
+    EXPECT_EQ(freed_thread_states, (AOCL_INT32)num_threads + 1);
+}
+
+TEST_F(API_thread_ctx_MT, AOCL_Compression_api_aocl_thread_ctx_mt_common_3) { // no context
+    setup_and_partition(nullptr, 16);
+    EXPECT_EQ(thread_grp.ctx, nullptr);
+    AOCL_VOID* state = malloc(8);
+    EXPECT_EQ(Test_aocl_get_thread_state_mt(&thread_grp, 0, free_test_thread_state), nullptr);
+    EXPECT_EQ(Test_aocl_set_thread_state_mt(&thread_grp, 0, state, free_test_thread_state), -1);
+    free(state);
+    Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    EXPECT_EQ(thread_grp.threads_info_list, nullptr);
+    Test_aocl_destroy_thread_ctx_mt(nullptr); // no-op
+}
+/*********************************************
+* End reusable thread context Tests
+*********************************************/
+
+/*********************************************
+* Begin partition compaction Tests
+*********************************************/
+class API_compact_partitions_MT : public ::testing::Test {
+public:
+    void SetUp() override {
+        buf = (AOCL_CHAR*)malloc(buff_size);
+        ref = (AOCL_CHAR*)malloc(buff_size);
+        for (AOCL_INT32 i = 0; i < buff_size; ++i)
+            buf[i] = (AOCL_CHAR)(i * 7 + 3);
+    }
+
+    void TearDown() override {
+        free(buf);
+        free(ref);
+    }
+
+    // build expected output from a snapshot of the sources
+    void prepare_reference(aocl_partition_move_t* moves, AOCL_UINT32 num_moves) {
+        memcpy(ref, buf, buff_size);
+        for (AOCL_UINT32 i = 0; i < num_moves; ++i)
+            expected.push_back(std::vector<AOCL_CHAR>(ref + (moves[i].src - buf), ref + (moves[i].src - buf) + moves[i].size));
+    }
+
+    void validate(aocl_partition_move_t* moves, AOCL_UINT32 num_moves) {
+        for (AOCL_UINT32 i = 0; i < num_moves; ++i)
+            EXPECT_EQ(memcmp(moves[i].dst, expected[i].data(), moves[i].size), 0);
+    }
+
+    AOCL_CHAR* buf, * ref;
+    std::vector<std::vector<AOCL_CHAR>> expected;
+    const AOCL_INT32 buff_size = 1024;
+};
+
+TEST_F(API_compact_partitions_MT, AOCL_Compression_api_aocl_compact_partitions_mt_common_1) { // in-place slots compacted to the left
+    aocl_partition_move_t moves[4];
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        moves[i].src = buf + 16 + i * 200;  // slot per partition
+        moves[i].size = 150 - i * 10;       // compressed size smaller than slot
+    }
+    AOCL_CHAR* out = buf + 16;
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        moves[i].dst = out;
+        out += moves[i].size;
+    }
+    prepare_reference(moves, 4);
+    EXPECT_EQ(Test_aocl_compact_partitions_mt(moves, 4, 4), 0);
+    validate(moves, 4);
+}
+
+TEST_F(API_compact_partitions_MT, AOCL_Compression_api_aocl_compact_partitions_mt_common_2) { // moves to the right and overlapping sources
+    aocl_partition_move_t moves[3];
+    moves[0].src = buf + 100; moves[0].size = 100; moves[0].dst = buf + 150; // overlaps own source and source of 1
+    moves[1].src = buf + 200; moves[1].size = 100; moves[1].dst = buf + 250; // overlaps own source and source of 2
+    moves[2].src = buf + 300; moves[2].size = 100; moves[2].dst = buf + 600;
+    prepare_reference(moves, 3);
+    EXPECT_EQ(Test_aocl_compact_partitions_mt(moves, 3, 2), 0);
+    validate(moves, 3);
+}
+
+TEST_F(API_compact_partitions_MT, AOCL_Compression_api_aocl_compact_partitions_mt_common_3) { // cyclic dependency (swap)
+    aocl_partition_move_t moves[2];
+    moves[0].src = buf;       moves[0].size = 64; moves[0].dst = buf + 64;
+    moves[1].src = buf + 64;  moves[1].size = 64; moves[1].dst = buf;
+    prepare_reference(moves, 2);
+    EXPECT_EQ(Test_aocl_compact_partitions_mt(moves, 2, 2), 0);
+    validate(moves, 2);
+}
+
+TEST_F(API_compact_partitions_MT, AOCL_Compression_api_aocl_compact_partitions_mt_common_4) { // empty and no-op moves
+    aocl_partition_move_t moves[2];
+    moves[0].src = buf; moves[0].size = 64; moves[0].dst = buf;
+    moves[1].src = buf + 64; moves[1].size = 0; moves[1].dst = buf + 500;
+    prepare_reference(moves, 2);
+    EXPECT_EQ(Test_aocl_compact_partitions_mt(moves, 2, 2), 0);
+    validate(moves, 2);
+    EXPECT_EQ(Test_aocl_compact_partitions_mt(moves, 0, 2), 0);
+}
+/*********************************************
+* End partition compaction Tests
+*********************************************/
+
 /*********************************************
 * Begin multi-threaded compress destroy Tests
 *********************************************/
 TEST(API_destroy_parallel_compress_MT, AOCL_Compression_api_aocl_destroy_parallel_compress_mt_common_1) { // threads_info_list non-NULL
     aocl_thread_group_t thread_grp;
+    init_thread_group(&thread_grp);
     thread_grp.num_threads = 16;
     thread_grp.threads_info_list = (aocl_thread_info_t*)calloc(thread_grp.num_threads, sizeof(aocl_thread_info_t));
     for (AOCL_INT32 thread_cnt = 0; thread_cnt < thread_grp.num_threads; thread_cnt++) {
@@ -762,6 +1242,8 @@ TEST(API_destroy_parallel_compress_MT, AOCL_Compression_api_aocl_destroy_paralle
 TEST(API_destroy_parallel_compress_MT, AOCL_Compression_api_aocl_destroy_parallel_compress_mt_common_2) { // threads_info_list NULL
     aocl_thread_group_t thread_grp;
     thread_grp.threads_info_list = nullptr;
+    thread_grp.ctx = nullptr;
+    thread_grp.partition_queues = nullptr;
     
     Test_aocl_destroy_parallel_compress_mt(&thread_grp);
     
@@ -771,9 +1253,11 @@ TEST(API_destroy_parallel_compress_MT, AOCL_Compression_api_aocl_destroy_paralle
 * End multi-threaded compress destroy Tests
 *********************************************/
 
-AOCL_INT32 add_RAP_frame_header(AOCL_CHAR* buf, AOCL_INT32 num_threads) {
-    AOCL_INT32 rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH(num_threads, 0);
-    *(AOCL_INT64*)buf = RAP_MAGIC_WORD; //For storing the magic word
+AOCL_INT32 add_RAP_frame_header(AOCL_CHAR* buf, AOCL_INT32 num_threads,
+    AOCL_UINT32 rap_version = RAP_FRAME_VERSION_32) {
+    AOCL_INT32 rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(rap_version, num_threads, 0);
+    *(AOCL_INT64*)buf = (rap_version == RAP_FRAME_VERSION_64) ?
+        RAP_MAGIC_WORD_64 : RAP_MAGIC_WORD; //For storing the magic word
     buf += RAP_MAGIC_WORD_BYTES;
     *(AOCL_UINT32*)buf = rap_frame_len; //For storing the total RAP frame length
     buf += RAP_METADATA_LEN_BYTES;
@@ -800,10 +1284,11 @@ public:
         if (dst) free(dst);
     }
 
-    void create_src_with_RAP_frame_header(AOCL_INT32 main_threads) {
+    void create_src_with_RAP_frame_header(AOCL_INT32 main_threads,
+        AOCL_UINT32 rap_version = RAP_FRAME_VERSION_32) {
         in_size = buff_size;
         src = (AOCL_CHAR*)calloc(in_size, sizeof(AOCL_CHAR));
-        add_RAP_frame_header(src, main_threads);
+        add_RAP_frame_header(src, main_threads, rap_version);
     }
 
     void validate(AOCL_INT32 rap_metadata_len) {
@@ -921,6 +1406,29 @@ TEST_F(API_setup_parallel_decompress_MT, AOCL_Compression_api_aocl_setup_paralle
         out_size, 0);
     validate(rap_metadata_len);
 }
+
+TEST_F(API_setup_parallel_decompress_MT, AOCL_Compression_api_aocl_setup_parallel_decompress_mt_common_11) { // 64-bit RAP frame present
+    create_src_with_RAP_frame_header(8, RAP_FRAME_VERSION_64);
+
+    AOCL_INT32 rap_metadata_len = Test_aocl_setup_parallel_decompress_mt(&thread_grp, src, dst, in_size,
+        out_size, 0);
+    EXPECT_EQ(rap_metadata_len, RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(8, 0));
+    EXPECT_EQ(thread_grp.rap_version, RAP_FRAME_VERSION_64);
+    validate(rap_metadata_len);
+}
+
+TEST_F(API_setup_parallel_decompress_MT, AOCL_Compression_api_aocl_setup_parallel_decompress_mt_common_12) { // more partitions than threads
+    AOCL_INT32 max_threads = omp_get_max_threads();
+    omp_set_num_threads(2);
+    create_src_with_RAP_frame_header(8);
+
+    AOCL_INT32 rap_metadata_len = Test_aocl_setup_parallel_decompress_mt(&thread_grp, src, dst, in_size,
+        out_size, 0);
+    omp_set_num_threads(max_threads);
+    EXPECT_EQ(thread_grp.num_threads, 8); // all partitions are decompressed in parallel
+    EXPECT_EQ(thread_grp.num_workers, 2);
+    validate(rap_metadata_len);
+}
 /*********************************************
 * End multi-threaded decompress setup Tests
 *********************************************/
@@ -930,6 +1438,10 @@ TEST_F(API_setup_parallel_decompress_MT, AOCL_Compression_api_aocl_setup_paralle
 *********************************************/
 class API_do_partition_decompress_MT : public ::testing::Test {
 public:
+    virtual AOCL_UINT32 get_rap_version() {
+        return RAP_FRAME_VERSION_32;
+    }
+
     void SetUp() override {
         //init
         init_thread_group(&thread_grp);
@@ -943,23 +1455,31 @@ public:
         //create compressed stream with RAP frame
         in_size = buff_size;
         src = (AOCL_CHAR*)calloc(in_size, sizeof(AOCL_CHAR));
-        add_RAP_frame_header(src, num_threads); //add RAP frame header
+        add_RAP_frame_header(src, num_threads, get_rap_version()); //add RAP frame header
         AOCL_INT32 dst_offset = RAP_START_OF_PARTITIONS;
         //add RAP frame metadata
         AOCL_CHAR* src_ptr = src + dst_offset;
         for (AOCL_UINT32 thread_cnt = 0; thread_cnt < num_threads; thread_cnt++)
         {
-            *(AOCL_UINT32*)src_ptr = dst_offset; //for storing this thread's RAP offset
-            src_ptr += RAP_OFFSET_BYTES;
+            if (get_rap_version() == RAP_FRAME_VERSION_64) {
+                *(AOCL_INT64*)src_ptr = dst_offset; //for storing this thread's RAP offset
+                *(AOCL_INT64*)(src_ptr + RAP_OFFSET_BYTES_64) = cpr_chunk_len[thread_cnt]; //for storing this thread's RAP length
+                *(AOCL_INT64*)(src_ptr + RAP_OFFSET_BYTES_64 + RAP_LEN_BYTES_64) = dpr_chunk_len[thread_cnt];
+                src_ptr += RAP_DATA_BYTES_WITH_DECOMP_LEN_64;
+            }
+            else {
+                *(AOCL_UINT32*)src_ptr = dst_offset; //for storing this thread's RAP offset
+                src_ptr += RAP_OFFSET_BYTES;
 
-            AOCL_INT32 cur_rap_len = cpr_chunk_len[thread_cnt];
-            *(AOCL_INT32*)src_ptr = cur_rap_len; //for storing this thread's RAP length
-            src_ptr += RAP_LEN_BYTES;
+                AOCL_INT32 cur_rap_len = cpr_chunk_len[thread_cnt];
+                *(AOCL_INT32*)src_ptr = cur_rap_len; //for storing this thread's RAP length
+                src_ptr += RAP_LEN_BYTES;
 
-            *(AOCL_INT32*)src_ptr = dpr_chunk_len[thread_cnt];
-            src_ptr += DECOMP_LEN_BYTES;
+                *(AOCL_INT32*)src_ptr = dpr_chunk_len[thread_cnt];
+                src_ptr += DECOMP_LEN_BYTES;
+            }
 
-            dst_offset += cur_rap_len;
+            dst_offset += cpr_chunk_len[thread_cnt];
         }
 
         //setup
@@ -1010,21 +1530,49 @@ TEST_F(API_do_partition_decompress_MT, AOCL_Compression_api_aocl_do_partition_de
     aocl_thread_info_t cur_thread_info;
     const AOCL_UINT32 cmpr_bound_pad = 16;
     //for(int thread_id =0; thread_id< num_threads;++thread_id)
-#pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_threads)
+#pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_workers)
+    {
+        AOCL_UINT32 thread_id;
+        while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &thread_id)) {
+            EXPECT_EQ(Test_aocl_do_partition_decompress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
+
+            thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
+            thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
+            thread_grp.threads_info_list[thread_id].additional_state_info = cur_thread_info.additional_state_info;
+            thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
+            thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
+            thread_grp.threads_info_list[thread_id].last_bytes_len        = cur_thread_info.last_bytes_len;
+            thread_grp.threads_info_list[thread_id].num_child_threads     = 0; // not used as of now
+            thread_grp.threads_info_list[thread_id].is_error              = cur_thread_info.is_error;
+            thread_grp.threads_info_list[thread_id].thread_id             = cur_thread_info.thread_id;
+            thread_grp.threads_info_list[thread_id].next                  = cur_thread_info.next;
+        }
+    } // #pragma omp parallel
+    validate(cmpr_bound_pad);
+}
+
+class API_do_partition_decompress_MT_64 : public API_do_partition_decompress_MT {
+public:
+    AOCL_UINT32 get_rap_version() override {
+        return RAP_FRAME_VERSION_64;
+    }
+};
+
+TEST_F(API_do_partition_decompress_MT_64, AOCL_Compression_api_aocl_do_partition_decompress_mt_common_2) { // partition the problem, 64-bit RAP frame
+    aocl_thread_info_t cur_thread_info;
+    const AOCL_UINT32 cmpr_bound_pad = 16;
+    EXPECT_EQ(thread_grp.rap_version, RAP_FRAME_VERSION_64);
+#pragma omp parallel private(cur_thread_info) shared(thread_grp, cmpr_bound_pad) num_threads(thread_grp.num_workers)
     {
-        AOCL_UINT32 thread_id = omp_get_thread_num();
-        EXPECT_EQ(Test_aocl_do_partition_decompress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
-
-        thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
-        thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
-        thread_grp.threads_info_list[thread_id].additional_state_info = cur_thread_info.additional_state_info;
-        thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
-        thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
-        thread_grp.threads_info_list[thread_id].last_bytes_len        = cur_thread_info.last_bytes_len;
-        thread_grp.threads_info_list[thread_id].num_child_threads     = 0; // not used as of now
-        thread_grp.threads_info_list[thread_id].is_error              = cur_thread_info.is_error;
-        thread_grp.threads_info_list[thread_id].thread_id             = cur_thread_info.thread_id;
-        thread_grp.threads_info_list[thread_id].next                  = cur_thread_info.next;
+        AOCL_UINT32 thread_id;
+        while (Test_aocl_get_next_partition_mt(&thread_grp, omp_get_thread_num(), &thread_id)) {
+            EXPECT_EQ(Test_aocl_do_partition_decompress_mt(&thread_grp, &cur_thread_info, cmpr_bound_pad, thread_id), 0);
+
+            thread_grp.threads_info_list[thread_id].partition_src         = cur_thread_info.partition_src;
+            thread_grp.threads_info_list[thread_id].dst_trap              = cur_thread_info.dst_trap;
+            thread_grp.threads_info_list[thread_id].partition_src_size    = cur_thread_info.partition_src_size;
+            thread_grp.threads_info_list[thread_id].dst_trap_size         = cur_thread_info.dst_trap_size;
+        }
     } // #pragma omp parallel
     validate(cmpr_bound_pad);
 }
@@ -1038,6 +1586,7 @@ TEST_F(API_do_partition_decompress_MT, AOCL_Compression_api_aocl_do_partition_de
 *********************************************/
 TEST(API_destroy_parallel_decompress_MT, AOCL_Compression_api_aocl_destroy_parallel_decompress_mt_common_1) { // threads_info_list non-NULL
     aocl_thread_group_t thread_grp;
+    init_thread_group(&thread_grp);
     thread_grp.num_threads = 16;
     thread_grp.threads_info_list = (aocl_thread_info_t*)calloc(thread_grp.num_threads, sizeof(aocl_thread_info_t));
     for (AOCL_INT32 thread_cnt = 0; thread_cnt < thread_grp.num_threads; thread_cnt++) {
@@ -1052,6 +1601,7 @@ TEST(API_destroy_parallel_decompress_MT, AOCL_Compression_api_aocl_destroy_paral
 TEST(API_destroy_parallel_decompress_MT, AOCL_Compression_api_aocl_destroy_parallel_decompress_mt_common_2) { // threads_info_list NULL
     aocl_thread_group_t thread_grp;
     thread_grp.threads_info_list = nullptr;
+    thread_grp.partition_queues = nullptr;
 
     Test_aocl_destroy_parallel_decompress_mt(&thread_grp);
 
@@ -1061,4 +1611,723 @@ TEST(API_destroy_parallel_decompress_MT, AOCL_Compression_api_aocl_destroy_paral
 * End multi-threaded compress destroy Tests
 *********************************************/
 
+/*********************************************
+* Begin RAP partition metadata Tests
+*********************************************/
+class API_rap_partition_MT : public ::testing::TestWithParam<AOCL_UINT32> {
+public:
+    void SetUp() override {
+        init_thread_group(&thread_grp);
+        thread_grp.rap_version = GetParam();
+        thread_grp.src = buf;
+        memset(buf, 0, sizeof(buf));
+    }
+
+    aocl_thread_group_t thread_grp;
+    AOCL_CHAR buf[RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(4, 0)];
+};
+
+TEST_P(API_rap_partition_MT, AOCL_Compression_api_aocl_rap_partition_mt_common_1) { // write then read back entries
+    const AOCL_INTP big = (thread_grp.rap_version == RAP_FRAME_VERSION_64) ?
+        (RAP_FRAME_32BIT_LIMIT + 7) : 7; // values beyond 32 bits only for 64-bit frames
+    AOCL_CHAR* rap_ptr = buf + RAP_START_OF_PARTITIONS;
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        AOCL_CHAR* next = Test_aocl_write_rap_partition_mt(&thread_grp, rap_ptr,
+            big * (i + 1), big + i, big * 2 + i);
+        EXPECT_EQ(next - rap_ptr, RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(thread_grp.rap_version));
+        rap_ptr = next;
+    }
+    EXPECT_EQ(rap_ptr - buf, RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(thread_grp.rap_version, 4, 0));
+
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        AOCL_INTP rap_offset, rap_len, decomp_len;
+        Test_aocl_read_rap_partition_mt(&thread_grp, i, &rap_offset, &rap_len, &decomp_len);
+        EXPECT_EQ(rap_offset, big * (i + 1));
+        EXPECT_EQ(rap_len, big + i);
+        EXPECT_EQ(decomp_len, big * 2 + i);
+    }
+}
+
+TEST_P(API_rap_partition_MT, AOCL_Compression_api_aocl_read_rap_chain_mt_common_1) { // dependent partitions join the chain before them
+    AOCL_CHAR* rap_ptr = buf + RAP_START_OF_PARTITIONS;
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        rap_ptr = Test_aocl_write_rap_partition_mt(&thread_grp, rap_ptr, 100 + i * 10, 10, 1000 + i);
+        if (i == 1 || i == 2)
+            Test_aocl_mark_rap_dependent_mt(&thread_grp, rap_ptr);
+    }
+
+    AOCL_INTP rap_offset, rap_len, decomp_len;
+    for (AOCL_UINT32 i = 0; i < 4; ++i) {
+        EXPECT_EQ(Test_aocl_is_rap_dependent_mt(&thread_grp, i), (i == 1 || i == 2) ? 1 : 0);
+        Test_aocl_read_rap_partition_mt(&thread_grp, i, &rap_offset, &rap_len, &decomp_len);
+        EXPECT_EQ(decomp_len, 1000 + i); // mark is not part of the length
+    }
+
+    EXPECT_EQ(Test_aocl_read_rap_chain_mt(&thread_grp, 0, 4, &rap_offset, &rap_len, &decomp_len), 3);
+    EXPECT_EQ(rap_offset, 100);
+    EXPECT_EQ(rap_len, 30);
+    EXPECT_EQ(decomp_len, 3003);
+    EXPECT_EQ(Test_aocl_read_rap_chain_mt(&thread_grp, 3, 4, &rap_offset, &rap_len, &decomp_len), 1);
+    EXPECT_EQ(rap_offset, 130);
+    EXPECT_EQ(decomp_len, 1003);
+    EXPECT_EQ(Test_aocl_read_rap_chain_mt(&thread_grp, 0, 2, &rap_offset, &rap_len, &decomp_len), 2); // chain ends with the partitions
+
+    // chains must be contiguous
+    rap_ptr = buf + RAP_START_OF_PARTITIONS + RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(thread_grp.rap_version);
+    rap_ptr = Test_aocl_write_rap_partition_mt(&thread_grp, rap_ptr, 111, 10, 1001);
+    Test_aocl_mark_rap_dependent_mt(&thread_grp, rap_ptr);
+    EXPECT_EQ(Test_aocl_read_rap_chain_mt(&thread_grp, 0, 4, &rap_offset, &rap_len, &decomp_len), -1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    API_TEST,
+    API_rap_partition_MT,
+    ::testing::Values(RAP_FRAME_VERSION_32, RAP_FRAME_VERSION_64));
+/*********************************************
+* End RAP partition metadata Tests
+*********************************************/
+
+/*********************************************
+* Begin thread budget Tests
+*********************************************/
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_set_num_threads_mt_common_1) { // budget is capped by available threads
+    AOCL_INT32 available = aocl_get_available_threads_mt();
+    EXPECT_GE(available, 1);
+    EXPECT_LE(available, omp_get_max_threads());
+
+    aocl_set_num_threads_mt(0);
+    EXPECT_EQ(aocl_get_num_threads_mt(), available);
+    aocl_set_num_threads_mt(1);
+    EXPECT_EQ(aocl_get_num_threads_mt(), 1);
+    aocl_set_num_threads_mt(available + 4);
+    EXPECT_EQ(aocl_get_num_threads_mt(), available);
+    aocl_set_num_threads_mt(-3);
+    EXPECT_EQ(aocl_get_num_threads_mt(), available);
+}
+
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_set_num_threads_mt_common_2) { // budget is per thread
+    AOCL_INT32 available = aocl_get_available_threads_mt();
+    AOCL_INT32 other = 0;
+    aocl_set_num_threads_mt(1);
+    std::thread t([&other]() { other = aocl_get_num_threads_mt(); });
+    t.join();
+    EXPECT_EQ(other, available);
+    EXPECT_EQ(aocl_get_num_threads_mt(), 1);
+    aocl_set_num_threads_mt(0);
+}
+
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_set_num_threads_mt_common_3) { // setup honors budget
+    const AOCL_INT32 in_size = 1024 * 16;
+    vector<AOCL_CHAR> src(in_size), dst(in_size);
+    aocl_thread_group_t thread_grp;
+
+    for (AOCL_INT32 budget : { 1, 2 }) {
+        init_thread_group(&thread_grp);
+        aocl_set_num_threads_mt(budget);
+        AOCL_INT32 res = Test_aocl_setup_parallel_compress_mt(&thread_grp, src.data(), dst.data(),
+            in_size, in_size, in_size / 64, 1);
+        EXPECT_GE(res, 0);
+        EXPECT_LE(thread_grp.num_workers, (AOCL_UINT32)budget);
+        EXPECT_LE(thread_grp.num_threads, (AOCL_UINT32)budget * PARTITIONS_PER_THREAD);
+        if (budget == 1) {
+            EXPECT_EQ(thread_grp.num_threads, 1);
+        }
+        Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+    }
+    aocl_set_num_threads_mt(0);
+}
+
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_llc_compress_numThreads_common_1) { // handle numThreads is honored
+    skip_test_if_algo_invalid(LZ4)
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+
+    desc.numThreads = 1; // single threaded: no RAP frame
+    int64_t cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    EXPECT_EQ(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+
+    desc.numThreads = 0; // all available threads
+    cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    if (aocl_get_available_threads_mt() > 1) {
+        EXPECT_GT(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+    }
+
+    aocl_llc_destroy(&desc, LZ4);
+    aocl_set_num_threads_mt(0);
+}
+
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_llc_compress_numThreads_common_2) { // budget of the caller is kept
+    skip_test_if_algo_invalid(LZ4)
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+
+    aocl_set_num_threads_mt(1);
+    desc.numThreads = 0; // budget of the calling thread: no RAP frame
+    int64_t cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    EXPECT_EQ(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+    EXPECT_EQ(aocl_get_num_threads_mt(), 1);
+
+    desc.numThreads = 2; // handle overrides the budget for the call only
+    cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    if (aocl_get_available_threads_mt() > 1) {
+        EXPECT_GT(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+    }
+    EXPECT_EQ(aocl_get_num_threads_mt(), 1);
+
+    aocl_llc_destroy(&desc, LZ4);
+    aocl_set_num_threads_mt(0);
+}
+
+TEST(API_thread_budget_MT, AOCL_Compression_api_aocl_llc_compress_zlib_common_1) { // threads write one standard zlib stream
+    skip_test_if_algo_invalid(ZLIB)
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[ZLIB].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, ZLIB), 0);
+    vector<char> stCpr, dcm(cpr.getInpSize());
+
+    for (int numThreads : { 1, 0 }) {
+        desc.numThreads = numThreads;
+        desc.inBuf = cpr.getInpData();
+        desc.inSize = cpr.getInpSize();
+        desc.outBuf = cpr.getOutData();
+        desc.outSize = cpr.getOutSize();
+        int64_t cSize = aocl_llc_compress(&desc, ZLIB);
+        ASSERT_GT(cSize, 0);
+        // no RAP frame: a zlib header with a 32 KB window starts the stream
+        EXPECT_EQ(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+        AOCL_UINT8 cmf = (AOCL_UINT8)cpr.getOutData()[0], flg = (AOCL_UINT8)cpr.getOutData()[1];
+        EXPECT_EQ(cmf, 0x78);
+        EXPECT_EQ((cmf * 256 + flg) % 31, 0);
+        if (numThreads == 1)
+            stCpr.assign(cpr.getOutData(), cpr.getOutData() + cSize);
+        else if (aocl_get_available_threads_mt() > 1) // partitions end with sync flushes
+            EXPECT_FALSE(cSize == (int64_t)stCpr.size() &&
+                         memcmp(stCpr.data(), cpr.getOutData(), cSize) == 0);
+
+        desc.inBuf = cpr.getOutData();
+        desc.inSize = cSize;
+        desc.outBuf = dcm.data();
+        desc.outSize = dcm.size();
+        ASSERT_EQ(aocl_llc_decompress(&desc, ZLIB), (int64_t)cpr.getInpSize());
+        EXPECT_EQ(memcmp(dcm.data(), cpr.getInpData(), dcm.size()), 0);
+    }
+
+    aocl_llc_destroy(&desc, ZLIB);
+}
+/*********************************************
+* End thread budget Tests
+*********************************************/
+
+/*********************************************
+* Begin adaptive partition sizing Tests
+*********************************************/
+TEST(API_partition_mode_MT, AOCL_Compression_api_aocl_set_partition_mode_mt_common_1) { // valid and invalid modes
+    EXPECT_EQ(aocl_get_partition_mode_mt(), AOCL_PARTITION_FIXED);
+    EXPECT_EQ(aocl_set_partition_mode_mt(-1), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_set_partition_mode_mt(AOCL_PARTITION_MODES_NUM), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_get_partition_mode_mt(), AOCL_PARTITION_FIXED);
+    for (AOCL_INT32 mode = AOCL_PARTITION_FIXED; mode < AOCL_PARTITION_MODES_NUM; ++mode) {
+        EXPECT_EQ(aocl_set_partition_mode_mt(mode), 0);
+        EXPECT_EQ(aocl_get_partition_mode_mt(), mode);
+    }
+    AOCL_INT32 other = -1;
+    std::thread t([&other]() { other = aocl_get_partition_mode_mt(); }); // mode is per thread
+    t.join();
+    EXPECT_EQ(other, AOCL_PARTITION_FIXED);
+    EXPECT_EQ(aocl_set_partition_mode_mt(AOCL_PARTITION_FIXED), 0);
+}
+
+class API_adaptive_partition_MT : public ::testing::Test {
+public:
+    void SetUp() override {
+        init_thread_group(&thread_grp);
+        max_threads = omp_get_max_threads();
+        omp_set_num_threads(4);
+        dst.resize(in_size);
+    }
+
+    void TearDown() override {
+        omp_set_num_threads(max_threads);
+        aocl_set_partition_mode_mt(AOCL_PARTITION_FIXED);
+    }
+
+    // Number of partitions set up for src in mode
+    AOCL_UINT32 get_partitions(vector<AOCL_CHAR>& src, AOCL_INT32 mode) {
+        EXPECT_EQ(aocl_set_partition_mode_mt(mode), 0);
+        init_thread_group(&thread_grp);
+        EXPECT_GE(Test_aocl_setup_parallel_compress_mt(&thread_grp, src.data(), dst.data(),
+            in_size, in_size, window_len, 4), 0);
+        AOCL_UINT32 num_partitions = thread_grp.num_threads;
+        EXPECT_LE(thread_grp.num_threads, thread_grp.num_workers * PARTITIONS_PER_THREAD);
+        Test_aocl_destroy_parallel_compress_mt(&thread_grp);
+        return num_partitions;
+    }
+
+    aocl_thread_group_t thread_grp;
+    vector<AOCL_CHAR> dst;
+    AOCL_INT32 max_threads;
+    const AOCL_INT32 in_size = 1024 * 1024;
+    const AOCL_INT32 window_len = 64 * 1024; // 4 partitions of window_len * 4 in fixed mode
+};
+
+TEST_F(API_adaptive_partition_MT, AOCL_Compression_api_aocl_setup_parallel_compress_mt_adaptive_common_1) { // compressible data gets fewer partitions
+    if (aocl_get_num_threads_mt() < 4)
+        GTEST_SKIP() << "needs 4 threads";
+    vector<AOCL_CHAR> src(in_size);
+    for (AOCL_INT32 i = 0; i < in_size; ++i)
+        src[i] = "abcdefgh"[i % 8];
+    AOCL_UINT32 fixed = get_partitions(src, AOCL_PARTITION_FIXED);
+    EXPECT_EQ(fixed, 4u);
+    EXPECT_EQ(get_partitions(src, AOCL_PARTITION_ADAPTIVE_SPEED), fixed);
+    EXPECT_LT(get_partitions(src, AOCL_PARTITION_ADAPTIVE_BALANCED), fixed);
+    EXPECT_LE(get_partitions(src, AOCL_PARTITION_ADAPTIVE_RATIO),
+              get_partitions(src, AOCL_PARTITION_ADAPTIVE_BALANCED));
+}
+
+TEST_F(API_adaptive_partition_MT, AOCL_Compression_api_aocl_setup_parallel_compress_mt_adaptive_common_2) { // incompressible data gets more partitions
+    if (aocl_get_num_threads_mt() < 4)
+        GTEST_SKIP() << "needs 4 threads";
+    vector<AOCL_CHAR> src(in_size);
+    std::mt19937 gen(7);
+    for (AOCL_INT32 i = 0; i < in_size; ++i)
+        src[i] = (AOCL_CHAR)gen();
+    AOCL_UINT32 fixed = get_partitions(src, AOCL_PARTITION_FIXED);
+    EXPECT_GT(get_partitions(src, AOCL_PARTITION_ADAPTIVE_SPEED), fixed);
+    EXPECT_GT(get_partitions(src, AOCL_PARTITION_ADAPTIVE_BALANCED), fixed);
+    EXPECT_EQ(get_partitions(src, AOCL_PARTITION_ADAPTIVE_RATIO), fixed);
+}
+
+TEST_P(API_compress_MT, AOCL_Compression_api_aocl_set_partition_mode_mt_common_1) //round trip in each adaptive mode
+{
+    skip_test_if_algo_invalid(atp.algo)
+    for (AOCL_INT32 mode = AOCL_PARTITION_ADAPTIVE_SPEED; mode < AOCL_PARTITION_MODES_NUM; ++mode) {
+        EXPECT_EQ(aocl_set_partition_mode_mt(mode), 0);
+        reset_ACD(&desc, algo_levels[atp.algo].def);
+        run_test();
+    }
+    EXPECT_EQ(aocl_set_partition_mode_mt(AOCL_PARTITION_FIXED), 0);
+}
+/*********************************************
+* End adaptive partition sizing Tests
+*********************************************/
+
+/*********************************************
+* Begin executor Tests
+*********************************************/
+//Executor running each task on a thread of its own
+struct TestExecutorGroup {
+    vector<std::thread> threads;
+};
+
+static std::atomic<int> test_executor_submits(0);
+
+static void* test_executor_create_group(void* ctx) {
+    (void)ctx;
+    return new TestExecutorGroup();
+}
+
+static int32_t test_executor_submit(void* ctx, void* group, aocl_executor_task task, void* arg) {
+    (void)ctx;
+    ((TestExecutorGroup*)group)->threads.emplace_back(task, arg);
+    test_executor_submits++;
+    return 0;
+}
+
+static int32_t test_executor_submit_fail(void* ctx, void* group, aocl_executor_task task, void* arg) {
+    (void)ctx; (void)group; (void)task; (void)arg;
+    test_executor_submits++;
+    return -1;
+}
+
+static void test_executor_wait(void* ctx, void* group) {
+    (void)ctx;
+    TestExecutorGroup* grp = (TestExecutorGroup*)group;
+    for (std::thread& t : grp->threads)
+        t.join();
+    delete grp;
+}
+
+static aocl_executor get_test_executor(int32_t numThreads) {
+    aocl_executor exec;
+    exec.ctx = nullptr;
+    exec.create_group = test_executor_create_group;
+    exec.submit = test_executor_submit;
+    exec.wait = test_executor_wait;
+    exec.numThreads = numThreads;
+    return exec;
+}
+
+//Counts the calls of each worker and item
+struct TestParallelCount {
+    std::atomic<int> calls[64];
+};
+
+static AOCL_VOID test_count_worker(AOCL_VOID* arg, AOCL_UINT32 worker_id) {
+    ((TestParallelCount*)arg)->calls[worker_id]++;
+}
+
+static AOCL_VOID test_count_item(AOCL_VOID* arg, AOCL_INTP item, AOCL_UINT32 worker_id) {
+    (void)worker_id;
+    ((TestParallelCount*)arg)->calls[item]++;
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_set_executor_common_1) { // invalid executor
+    aocl_executor exec = get_test_executor(4);
+    exec.wait = nullptr;
+    EXPECT_EQ(aocl_set_executor(&exec), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_set_executor_common_2) { // numThreads sets available threads
+    aocl_executor exec = get_test_executor(3);
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+    EXPECT_LE(aocl_get_available_threads_mt(), 3);
+    exec.numThreads = 0;
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+    EXPECT_LE(aocl_get_available_threads_mt(), (AOCL_UINT32)omp_get_max_threads());
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_run_parallel_mt_common_1) { // regions run on the executor
+    aocl_executor exec = get_test_executor(4);
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+
+    TestParallelCount workers = {};
+    test_executor_submits = 0;
+    aocl_run_parallel_mt(test_count_worker, &workers, 4);
+    EXPECT_EQ(test_executor_submits, 3); // the calling thread runs worker 0
+    for (int w = 0; w < 4; w++)
+        EXPECT_EQ(workers.calls[w], 1);
+
+    TestParallelCount items = {};
+    aocl_run_parallel_for_mt(test_count_item, &items, 64, 4);
+    for (int i = 0; i < 64; i++)
+        EXPECT_EQ(items.calls[i], 1);
+
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_run_parallel_mt_common_2) { // work of tasks that were not queued is done
+    aocl_executor exec = get_test_executor(4);
+    exec.submit = test_executor_submit_fail;
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+
+    TestParallelCount items = {};
+    test_executor_submits = 0;
+    aocl_run_parallel_for_mt(test_count_item, &items, 64, 4);
+    EXPECT_EQ(test_executor_submits, 1); // no more tasks are queued after a failure
+    for (int i = 0; i < 64; i++)
+        EXPECT_EQ(items.calls[i], 1);
+
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_llc_compress_executor_common_1) { // codecs submit partitions to the executor
+    skip_test_if_algo_invalid(LZ4)
+    aocl_executor exec = get_test_executor(4);
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+
+    test_executor_submits = 0;
+    int64_t cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    if (aocl_get_available_threads_mt() > 1) {
+        EXPECT_GT(test_executor_submits, 0);
+    }
+
+    TestLoadSingle dpr(cSize, cpr.getOutData(), cpr.getInpSize());
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&dpr);
+    int64_t dSize = aocl_llc_decompress(&desc, LZ4);
+    EXPECT_EQ(dSize, (int64_t)cpr.getInpSize());
+    EXPECT_EQ(memcmp(cpr.getInpData(), dpr.getOutData(), cpr.getInpSize()), 0);
+
+    aocl_llc_destroy(&desc, LZ4);
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST(API_executor_MT, AOCL_Compression_api_aocl_llc_compress_executor_common_2) { // executor replaced while calls are in flight
+    skip_test_if_algo_invalid(LZ4)
+    aocl_executor exec = get_test_executor(4);
+    std::atomic<bool> stop(false);
+    std::thread setter([&exec, &stop]() {
+        while (!stop) {
+            EXPECT_EQ(aocl_set_executor(&exec), 0);
+            EXPECT_EQ(aocl_set_executor(nullptr), 0);
+            std::this_thread::yield();
+        }
+    });
+
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+    for (int i = 0; i < 16; i++) {
+        set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+        int64_t cSize = aocl_llc_compress(&desc, LZ4);
+        ASSERT_GT(cSize, 0);
+        TestLoadSingle dpr(cSize, cpr.getOutData(), cpr.getInpSize());
+        set_ACD_io_bufs(&desc, (TestLoadBase*)&dpr);
+        ASSERT_EQ(aocl_llc_decompress(&desc, LZ4), (int64_t)cpr.getInpSize());
+        EXPECT_EQ(memcmp(cpr.getInpData(), dpr.getOutData(), cpr.getInpSize()), 0);
+    }
+    stop = true;
+    setter.join();
+    aocl_llc_destroy(&desc, LZ4);
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+
+TEST_P(API_compress_MT, AOCL_Compression_api_aocl_set_executor_common_1) //round trip on an executor
+{
+    skip_test_if_algo_invalid(atp.algo)
+    aocl_executor exec = get_test_executor(4);
+    ASSERT_EQ(aocl_set_executor(&exec), 0);
+    reset_ACD(&desc, algo_levels[atp.algo].def);
+    run_test();
+    EXPECT_EQ(aocl_set_executor(nullptr), 0);
+}
+/*********************************************
+* End executor Tests
+*********************************************/
+
+/*********************************************
+* Begin NUMA placement Tests
+*********************************************/
+TEST(API_numa_MT, AOCL_Compression_api_aocl_get_numa_stats_mt_common_1) { // invalid input and reset
+    aocl_numa_stats stats;
+    EXPECT_EQ(aocl_get_numa_stats_mt(nullptr, 0), ERR_INVALID_INPUT);
+    EXPECT_EQ(aocl_get_numa_stats_mt(nullptr, 1), 0);
+    ASSERT_EQ(aocl_get_numa_stats_mt(&stats, 0), 0);
+    EXPECT_GE(stats.numNodes, 1u);
+    EXPECT_EQ(stats.localPartitions, 0u);
+    EXPECT_EQ(stats.remotePartitions, 0u);
+    EXPECT_EQ(stats.localBytes, 0u);
+    EXPECT_EQ(stats.remoteBytes, 0u);
+}
+
+TEST(API_numa_MT, AOCL_Compression_api_aocl_get_numa_stats_mt_common_2) { // partitions of a call are counted once
+    skip_test_if_algo_invalid(LZ4)
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    aocl_numa_stats stats;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+
+    ASSERT_EQ(aocl_get_numa_stats_mt(nullptr, 1), 0);
+    int64_t cSize = aocl_llc_compress(&desc, LZ4);
+    ASSERT_GT(cSize, 0);
+    ASSERT_EQ(aocl_get_numa_stats_mt(&stats, 1), 0);
+    EXPECT_LE(stats.localBytes + stats.remoteBytes, (uint64_t)cpr.getInpSize());
+    if (stats.numNodes == 1) {
+        EXPECT_EQ(stats.localPartitions + stats.remotePartitions, 0u);
+    }
+
+    aocl_llc_destroy(&desc, LZ4);
+}
+
+TEST_P(API_compress_MT, AOCL_Compression_api_aocl_set_numa_placement_mt_common_1) //round trip with NUMA placement off
+{
+    skip_test_if_algo_invalid(atp.algo)
+    aocl_set_numa_placement_mt(0);
+    reset_ACD(&desc, algo_levels[atp.algo].def);
+    run_test();
+    aocl_set_numa_placement_mt(1);
+}
+/*********************************************
+* End NUMA placement Tests
+*********************************************/
+
+/*********************************************
+* Begin dictionary priming Tests
+*********************************************/
+TEST(API_dict_priming_MT, AOCL_Compression_api_aocl_set_dict_priming_mt_common_1) { // enable and disable
+    EXPECT_EQ(aocl_get_dict_priming_mt(), 0);
+    aocl_set_dict_priming_mt(2);
+    EXPECT_EQ(aocl_get_dict_priming_mt(), 1);
+    AOCL_INT32 other = -1;
+    std::thread t([&other]() { other = aocl_get_dict_priming_mt(); }); // setting is per thread
+    t.join();
+    EXPECT_EQ(other, 0);
+    aocl_set_dict_priming_mt(0);
+    EXPECT_EQ(aocl_get_dict_priming_mt(), 0);
+}
+
+class API_dict_priming_lz4_MT : public ::testing::Test {
+public:
+    void SetUp() override {
+        max_threads = omp_get_max_threads();
+        omp_set_num_threads(4);
+        // text of words from a small vocabulary: matches are found across partition boundaries
+        const char* words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ", "zeta ", "eta ", "theta " };
+        std::mt19937 gen(11);
+        while (src.size() < in_size) {
+            const char* w = words[gen() % 8];
+            src.insert(src.end(), w, w + strlen(w));
+        }
+        src.resize(in_size);
+        dst.resize(in_size * 2);
+        out.resize(in_size);
+    }
+
+    void TearDown() override {
+        omp_set_num_threads(max_threads);
+        aocl_set_dict_priming_mt(0);
+    }
+
+    int64_t compress(AOCL_INT32 priming) {
+        ACD desc;
+        reset_ACD(&desc, algo_levels[LZ4].def);
+        desc.inBuf = src.data();
+        desc.inSize = src.size();
+        desc.outBuf = dst.data();
+        desc.outSize = dst.size();
+        aocl_set_dict_priming_mt(priming);
+        EXPECT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+        int64_t cSize = aocl_llc_compress(&desc, LZ4);
+        aocl_llc_destroy(&desc, LZ4);
+        aocl_set_dict_priming_mt(0);
+        return cSize;
+    }
+
+    void decompress_and_validate(int64_t cSize, int num_threads) {
+        ACD desc;
+        reset_ACD(&desc, algo_levels[LZ4].def);
+        desc.inBuf = dst.data();
+        desc.inSize = cSize;
+        desc.outBuf = out.data();
+        desc.outSize = out.size();
+        omp_set_num_threads(num_threads);
+        ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+        EXPECT_EQ(aocl_llc_decompress(&desc, LZ4), (int64_t)in_size);
+        EXPECT_EQ(memcmp(src.data(), out.data(), in_size), 0);
+        aocl_llc_destroy(&desc, LZ4);
+        omp_set_num_threads(4);
+    }
+
+    AOCL_INT32 max_threads;
+    const size_t in_size = 2 * 1024 * 1024;
+    vector<AOCL_CHAR> src, dst, out;
+};
+
+TEST_F(API_dict_priming_lz4_MT, AOCL_Compression_api_aocl_set_dict_priming_mt_lz4_1) { // primed partitions compress better
+    skip_test_if_algo_invalid(LZ4)
+    if (aocl_get_num_threads_mt() < 4)
+        GTEST_SKIP() << "needs 4 threads";
+    int64_t plain = compress(0);
+    int64_t primed = compress(1);
+    ASSERT_GT(plain, 0);
+    ASSERT_GT(primed, 0);
+    EXPECT_LT(primed, plain);
+
+    // dependent partitions are marked in the RAP frame
+    aocl_thread_group_t thread_grp;
+    AOCL_INT32 rap_metadata_len = aocl_setup_parallel_decompress_mt(&thread_grp, dst.data(), out.data(),
+                                                                    primed, in_size, 1);
+    ASSERT_GT(rap_metadata_len, 0);
+    AOCL_UINT32 num_partitions = *(AOCL_USHORT*)(dst.data() + RAP_MAGIC_WORD_BYTES + RAP_METADATA_LEN_BYTES);
+    AOCL_UINT32 num_dependent = 0;
+    for (AOCL_UINT32 i = 0; i < num_partitions; ++i)
+        num_dependent += Test_aocl_is_rap_dependent_mt(&thread_grp, i);
+    EXPECT_EQ(Test_aocl_is_rap_dependent_mt(&thread_grp, 0), 0);
+    EXPECT_GT(num_dependent, 0u);
+    EXPECT_LT(num_dependent, num_partitions);
+
+    decompress_and_validate(primed, 4);
+    decompress_and_validate(primed, 2);
+    decompress_and_validate(primed, 1); // single-threaded decompressor reads the whole stream
+}
+
+TEST_F(API_dict_priming_lz4_MT, AOCL_Compression_api_aocl_set_dict_priming_mt_lz4_2) { // range inside a dependent partition
+    skip_test_if_algo_invalid(LZ4)
+    int64_t primed = compress(1);
+    ASSERT_GT(primed, 0);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    desc.inBuf = dst.data();
+    desc.inSize = primed;
+    desc.outBuf = out.data();
+    desc.outSize = out.size();
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+    const size_t offset = in_size * 5 / 8 + 12345, length = 4096; // in the second partition of a chain
+    EXPECT_EQ(aocl_llc_decompress_range(&desc, LZ4, offset, length), (int64_t)length);
+    EXPECT_EQ(memcmp(src.data() + offset, out.data(), length), 0);
+    aocl_llc_destroy(&desc, LZ4);
+}
+
+TEST_P(API_compress_MT, AOCL_Compression_api_aocl_set_dict_priming_mt_common_2) //round trip with priming, decompressed with fewer threads
+{
+    skip_test_if_algo_invalid(atp.algo)
+    int max_threads = omp_get_max_threads();
+    aocl_set_dict_priming_mt(1);
+    reset_ACD(&desc, algo_levels[atp.algo].def);
+    run_test();
+    reset_ACD(&desc, algo_levels[atp.algo].def);
+    run_test_different_threads(4, 1);
+    aocl_set_dict_priming_mt(0);
+    omp_set_num_threads(max_threads);
+}
+/*********************************************
+* End dictionary priming Tests
+*********************************************/
+
+/*********************************************
+* Begin async Tests
+*********************************************/
+TEST(API_async_MT, AOCL_Compression_api_aocl_llc_compress_async_common_1) // jobs run with the budget and modes of the caller
+{
+    skip_test_if_algo_invalid(LZ4)
+    TestLoad cpr(1024 * 1024, 1024 * 1024 * 2, true);
+    ACD desc;
+    reset_ACD(&desc, algo_levels[LZ4].def);
+    set_ACD_io_bufs(&desc, (TestLoadBase*)&cpr);
+    ASSERT_EQ(aocl_llc_setup(&desc, LZ4), 0);
+    aocl_async_job* job = NULL;
+
+    aocl_set_num_threads_mt(1); // single threaded: no RAP frame
+    ASSERT_EQ(aocl_llc_compress_async(&desc, LZ4, NULL, NULL, &job), 0);
+    int64_t cSize = aocl_llc_async_wait(job);
+    ASSERT_GT(cSize, 0);
+    EXPECT_EQ(aocl_skip_rap_frame_mt(cpr.getOutData(), (int32_t)cSize), 0);
+    aocl_set_num_threads_mt(0);
+
+    if (omp_get_max_threads() > 1) {
+        // a job alone in the pool gets the threads of the handle
+        desc.numThreads = 2;
+        int64_t plainSize = aocl_llc_compress(&desc, LZ4);
+        ASSERT_GT(plainSize, 0);
+        std::vector<char> plain(cpr.getOutData(), cpr.getOutData() + plainSize);
+        aocl_set_dict_priming_mt(1);
+        int64_t refSize = aocl_llc_compress(&desc, LZ4);
+        ASSERT_GT(refSize, 0);
+        std::vector<char> ref(cpr.getOutData(), cpr.getOutData() + refSize);
+        EXPECT_TRUE(ref != plain);
+
+        ASSERT_EQ(aocl_llc_compress_async(&desc, LZ4, NULL, NULL, &job), 0);
+        aocl_set_dict_priming_mt(0); // the job keeps the priming set when it was queued
+        ASSERT_EQ(aocl_llc_async_wait(job), refSize);
+        EXPECT_EQ(memcmp(ref.data(), cpr.getOutData(), refSize), 0);
+    }
+    aocl_llc_destroy(&desc, LZ4);
+}
+/*********************************************
+* End async Tests
+*********************************************/
+
 #endif /* AOCL_ENABLE_THREADS */
@@ -37,6 +37,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "algos/zlib/zlib.h"
 #include "algos/zlib/zutil.h"
@@ -439,6 +440,104 @@ TEST_F(ZLIB_compress2, pass2)
   dest = nullptr;
 }
 
+class ZLIB_aocl_parallel_compress_zlib : public AOCL_setup_zlib {
+public:
+  void SetUp() override {
+    // compressible data with matches across the partition boundaries
+    src.resize(srcLen);
+    uint32_t seed = 1;
+    for (uLong i = 0; i < srcLen; i++) {
+      seed = seed * 1103515245 + 12345;
+      src[i] = (i % 4096 < 64) ? (Bytef)(seed >> 16) : (Bytef)('a' + (i % 4096) % 23);
+    }
+    destLen = aocl_parallel_compressBound_zlib(srcLen);
+    dest.resize(destLen);
+  }
+
+  // decompresses with a plain inflate stream
+  int inflate_stream(int windowBits, std::vector<Bytef>& out, uLong& outLen) {
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    int err = inflateInit2(&strm, windowBits);
+    if (err != Z_OK)
+      return err;
+    out.resize(srcLen + 1);
+    strm.next_in = dest.data();
+    strm.avail_in = (uInt)destLen;
+    strm.next_out = out.data();
+    strm.avail_out = (uInt)out.size();
+    err = inflate(&strm, Z_FINISH);
+    outLen = strm.total_out;
+    inflateEnd(&strm);
+    return err == Z_STREAM_END ? Z_OK : err;
+  }
+
+  void validate(int windowBits) {
+    std::vector<Bytef> out;
+    uLong outLen = 0;
+    ASSERT_EQ(inflate_stream(windowBits, out, outLen), Z_OK);
+    ASSERT_EQ(outLen, srcLen);
+    EXPECT_EQ(memcmp(out.data(), src.data(), srcLen), 0);
+  }
+
+  const uLong srcLen = 1 << 20;
+  std::vector<Bytef> src, dest;
+  uLongf destLen;
+};
+
+TEST_F(ZLIB_aocl_parallel_compress_zlib, fail_cases)
+{
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), NULL, src.data(), srcLen, 6, MAX_WBITS), Z_BUF_ERROR);
+  EXPECT_EQ(aocl_parallel_compress_zlib(NULL, &destLen, src.data(), srcLen, 6, MAX_WBITS), Z_STREAM_ERROR);
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, NULL, srcLen, 6, MAX_WBITS), Z_STREAM_ERROR);
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), srcLen, 23, MAX_WBITS), Z_STREAM_ERROR);
+  destLen = dest.size();
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), srcLen, 6, 99), Z_STREAM_ERROR);
+  destLen = 64; // too small for the compressed stream
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), srcLen, 6, MAX_WBITS), Z_BUF_ERROR);
+}
+
+TEST_F(ZLIB_aocl_parallel_compress_zlib, pass_zlib)
+{
+  EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), srcLen, 6, MAX_WBITS), Z_OK);
+  EXPECT_LE(destLen, aocl_parallel_compressBound_zlib(srcLen));
+  EXPECT_EQ(dest[0], 0x78); // standard zlib header, no RAP frame
+  EXPECT_EQ(((dest[0] << 8) | dest[1]) % 31, 0);
+  validate(MAX_WBITS);
+
+  // decodable by uncompress() as well
+  std::vector<Bytef> out(srcLen);
+  uLongf outLen = srcLen;
+  EXPECT_EQ(uncompress(out.data(), &outLen, dest.data(), destLen), Z_OK);
+  EXPECT_EQ(outLen, srcLen);
+}
+
+TEST_F(ZLIB_aocl_parallel_compress_zlib, pass_gzip)
+{
+  for (int level : {Z_DEFAULT_COMPRESSION, 0, 1, 9}) {
+    destLen = dest.size();
+    EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), srcLen, level, MAX_WBITS + 16), Z_OK);
+    EXPECT_EQ(dest[0], 0x1f);
+    EXPECT_EQ(dest[1], 0x8b);
+    validate(MAX_WBITS + 16);
+    validate(MAX_WBITS + 32); // automatic header detection
+  }
+}
+
+TEST_F(ZLIB_aocl_parallel_compress_zlib, pass_small)
+{
+  // single partition and empty input
+  for (uLong len : {0UL, 1UL, 1000UL}) {
+    destLen = dest.size();
+    EXPECT_EQ(aocl_parallel_compress_zlib(dest.data(), &destLen, src.data(), len, 6, MAX_WBITS), Z_OK);
+    std::vector<Bytef> out(len + 1);
+    uLongf outLen = len + 1;
+    EXPECT_EQ(uncompress(out.data(), &outLen, dest.data(), destLen), Z_OK);
+    ASSERT_EQ(outLen, len);
+    EXPECT_EQ(memcmp(out.data(), src.data(), len), 0);
+  }
+}
+
 class ZLIB_uncompress2 : public AOCL_setup_zlib {
 };
 
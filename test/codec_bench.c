@@ -109,6 +109,11 @@ AOCL_VOID print_user_options (AOCL_VOID)
     printf("-f          Input uncompressed file to be used for validation in -rdecompress mode.\n\n");
     printf("-c          Run IPP library methods. Provide the path for the IPP library path after the -c option.\n\n");
     printf("-n          Use Native APIs for compression/decompression.\n\n");
+#ifdef AOCL_ENABLE_THREADS
+    printf("-u          Compare multi-threaded runs with NUMA placement of partitions off and on. Prints speeds and local/remote partition counts.\n\n");
+    printf("-s<>        Partition sizing of multi-threaded compression: 0 fixed (default), 1 adaptive for speed, 2 adaptive balanced, 3 adaptive for ratio.\n\n");
+    printf("-g          Prime multi-threaded LZ4 partitions with the end of the previous partition.\n\n");
+#endif
 }
 
 AOCL_VOID print_supported_compressors (AOCL_VOID)
@@ -339,6 +344,7 @@ AOCL_INTP read_user_options (AOCL_INTP argc,
     codec_bench_handle->dumpFile = NULL;
     codec_bench_handle->valFp = NULL;
     codec_bench_handle->runOperation = RUN_OPERATION_DEFAULT;
+    codec_bench_handle->numaBench = 0;
     
     while (cnt < argc)
     {
@@ -400,6 +406,22 @@ AOCL_INTP read_user_options (AOCL_INTP argc,
                 case 'o':
                     codec_bench_handle->optOff = 1;
                 break;
+#ifdef AOCL_ENABLE_THREADS
+                case 'u':
+                    codec_bench_handle->numaBench = 1;
+                break;
+                case 's':
+                    if (aocl_set_partition_mode_mt(atoi(&argv[cnt][2])) != 0)
+                    {
+                        printf("Invalid -s option. Valid options are 0 to %d\n\n",
+                            AOCL_PARTITION_MODES_NUM - 1);
+                        ret = ERR_CODEC_BENCH_ARGS;
+                    }
+                break;
+                case 'g':
+                    aocl_set_dict_priming_mt(1);
+                break;
+#endif
                 case 'c':
                     codec_bench_handle->useIPP = 1;
                     codec_bench_handle->ippDir = &argv[cnt][2];
@@ -555,10 +577,11 @@ AOCL_INTP init(aocl_codec_bench_info *codec_bench_handle,
 
     aocl_codec_handle->level = codec_bench_handle->codec_level;
     aocl_codec_handle->optVar = codec_bench_handle->optVar;
-    aocl_codec_handle->numThreads = 1;
+    aocl_codec_handle->numThreads = 0; //all available threads
     aocl_codec_handle->numMPIranks = 0;
     aocl_codec_handle->measureStats = codec_bench_handle->print_stats;
     aocl_codec_handle->workBuf = NULL;
+    aocl_codec_handle->batchBuf = NULL;
     aocl_codec_handle->optOff = codec_bench_handle->optOff;
 
 
@@ -1229,6 +1252,54 @@ AOCL_INTP aocl_bench_run(aocl_compression_desc *aocl_codec_handle,
     return retStatus;
 }
 
+#ifdef AOCL_ENABLE_THREADS
+AOCL_INTP numa_bench_run(aocl_compression_desc *aocl_codec_handle,
+                   aocl_codec_bench_info *codec_bench_handle)
+{
+    AOCL_INTP retStatus = 0;
+    AOCL_INT32 placement;
+    aocl_numa_stats stats;
+
+    LOG_UNFORMATTED(TRACE, log_ctx, "Enter");
+
+    //Speeds of both runs are printed for comparison
+    codec_bench_handle->print_stats = 1;
+    aocl_codec_handle->measureStats = 1;
+
+    for (placement = 0; placement <= 1; placement++)
+    {
+        AOCL_INTP status;
+        aocl_set_numa_placement_mt(placement);
+        aocl_get_numa_stats_mt(NULL, 1);
+        printf("NUMA placement %s ==========================================\n",
+            placement ? "on" : "off");
+
+        status = aocl_bench_run(aocl_codec_handle, codec_bench_handle);
+        if (status < 0)
+            retStatus = status;
+
+        aocl_get_numa_stats_mt(&stats, 1);
+        printf("NUMA nodes:          %u\n", stats.numNodes);
+        printf("NUMA partitions:     local %llu, remote %llu\n",
+            (unsigned long long)stats.localPartitions,
+            (unsigned long long)stats.remotePartitions);
+        printf("NUMA source bytes:   local %llu, remote %llu (%.2f%% remote)\n",
+            (unsigned long long)stats.localBytes,
+            (unsigned long long)stats.remoteBytes,
+            (stats.localBytes + stats.remoteBytes) ?
+            (stats.remoteBytes * 100.0) / (stats.localBytes + stats.remoteBytes) : 0.0);
+        if (retStatus == -2)
+            break;
+    }
+    if (stats.numNodes <= 1)
+        printf("Single NUMA node: partitions are not counted and placement has no effect\n");
+    aocl_set_numa_placement_mt(1);
+
+    LOG_UNFORMATTED(TRACE, log_ctx, "Exit");
+    return retStatus;
+}
+#endif
+
 AOCL_VOID destroy(aocl_codec_bench_info *codec_bench_handle)
 {
     LOG_UNFORMATTED(TRACE, log_ctx, "Enter");
@@ -1401,6 +1472,10 @@ AOCL_INT32 main (AOCL_INT32 argc, AOCL_CHAR **argv)
         {
             result = native_api_bench_run(aocl_codec_handle, &codec_bench_handle);
         }   
+#ifdef AOCL_ENABLE_THREADS
+    else if (codec_bench_handle.numaBench)
+        result = numa_bench_run(aocl_codec_handle, &codec_bench_handle);
+#endif
     else
         result = aocl_bench_run(aocl_codec_handle, &codec_bench_handle);
     if (result != 0)
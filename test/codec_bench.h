@@ -138,10 +138,11 @@ typedef struct
     FILE* dumpFp;           //optional file for saving output data
     FILE* valFp;            //optional file for loading validation data in decompress only mode
     AOCL_INTP runOperation;      //operation to run: compress, decompress, both (default)
+    AOCL_INTP numaBench;         //compare runs with NUMA placement of MT partitions off and on
 } aocl_codec_bench_info;
 
 #ifdef AOCL_ENABLE_LOG_FEATURE
-static aocl_log_ctx log_ctx = {-1};
+static aocl_log_ctx log_ctx = {AOCL_LOG_LEVEL_UNSET};
 #endif /* AOCL_ENABLE_LOG_FEATURE */
 
 //Function declarations
@@ -156,6 +157,10 @@ AOCL_INTP ipp_bench_run(aocl_compression_desc *aocl_codec_handle,
                     aocl_codec_bench_info *codec_bench_handle);
 AOCL_INTP native_api_bench_run(aocl_compression_desc *aocl_codec_handle, 
                     aocl_codec_bench_info *codec_bench_handle);
+#ifdef AOCL_ENABLE_THREADS
+AOCL_INTP numa_bench_run(aocl_compression_desc *aocl_codec_handle,
+                    aocl_codec_bench_info *codec_bench_handle);
+#endif
 AOCL_VOID destroy(aocl_codec_bench_info *codec_bench_handle);
 
 #endif
@@ -0,0 +1,225 @@
+/**
+ * Copyright (C) 2023, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /** @file async_pool.cpp
+ *
+ *  @brief Library-owned thread pool running asynchronous jobs
+ *
+ *  The workers are started on the first job, as many as the OpenMP threads
+ *  available then, and wait on a shared FIFO queue for further jobs. The
+ *  threads a job runs on are counted in the pool until it completes.
+ */
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "threads/async_pool.h"
+#include "threads/threads.h"
+
+struct aocl_async_job_s
+{
+    aocl_async_fp fn;
+    AOCL_VOID *arg;
+    AOCL_INT32 numThreads;      //threads asked for
+    aocl_async_callback callback;
+    AOCL_VOID *userData;
+    AOCL_INTP detached;
+    AOCL_INTP done;
+    AOCL_INT64 result;
+};
+
+typedef struct
+{
+    std::mutex lock;
+    std::condition_variable jobQueued;
+    std::condition_variable jobDone;
+    std::deque<aocl_async_job *> queue;
+    std::vector<std::thread> workers;
+    AOCL_INT32 threadsInUse;    //threads granted to the jobs running
+    AOCL_INTP stop;
+} aocl_async_pool_t;
+
+//Idle workers are stopped at unload. On Windows, threads are no longer
+//joinable once the runtime unloads the library, so they are left to exit.
+static struct aocl_async_pool_holder
+{
+    aocl_async_pool_t pool;
+    aocl_async_pool_holder() { pool.threadsInUse = 0; pool.stop = 0; }
+    ~aocl_async_pool_holder()
+    {
+        {
+            std::lock_guard<std::mutex> guard(pool.lock);
+            pool.stop = 1;
+        }
+        pool.jobQueued.notify_all();
+        for (std::thread &t : pool.workers)
+        {
+#ifdef _WINDOWS
+            t.detach();
+#else
+            t.join();
+#endif
+        }
+    }
+} aocl_async_pool;
+
+static AOCL_VOID aocl_async_worker(aocl_async_pool_t *pool)
+{
+    for (;;)
+    {
+        aocl_async_job *job;
+        AOCL_INT32 numThreads;
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            pool->jobQueued.wait(guard, [pool] { return pool->stop || !pool->queue.empty(); });
+            if (pool->queue.empty())
+                return;
+            job = pool->queue.front();
+            pool->queue.pop_front();
+            //The job gets what the running jobs leave free of the threads it asks for, at least one
+            AOCL_INT32 freeThreads = (AOCL_INT32)aocl_get_available_threads_mt() - pool->threadsInUse;
+            numThreads = (job->numThreads < freeThreads) ? job->numThreads : freeThreads;
+            if (numThreads < 1)
+                numThreads = 1;
+            pool->threadsInUse += numThreads;
+        }
+
+        AOCL_INT64 result = job->fn(job->arg, numThreads);
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            pool->threadsInUse -= numThreads;
+        }
+        //The callback returns before the job reads as complete, so that waiters
+        //may release what it refers to
+        if (job->callback)
+            job->callback(job->userData, result);
+
+        if (job->detached)
+        {
+            free(job);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            job->result = result;
+            job->done = 1;
+        }
+        pool->jobDone.notify_all();
+    }
+}
+
+//Called with the pool lock held
+static AOCL_INT32 aocl_async_pool_start(aocl_async_pool_t *pool)
+{
+    if (!pool->workers.empty())
+        return 0;
+
+    AOCL_INT32 nbWorkers = aocl_get_available_threads_mt();
+    try
+    {
+        for (AOCL_INT32 i = 0; i < nbWorkers; i++)
+            pool->workers.emplace_back(aocl_async_worker, pool);
+    }
+    catch (const std::system_error &)
+    {
+    }
+    catch (const std::bad_alloc &)
+    {
+    }
+    return pool->workers.empty() ? -1 : 0;
+}
+
+aocl_async_job *aocl_async_job_submit(aocl_async_fp fn, AOCL_VOID *arg, AOCL_INT32 numThreads,
+                                      aocl_async_callback callback, AOCL_VOID *userData,
+                                      AOCL_INTP detached, AOCL_INT32 *err)
+{
+    aocl_async_pool_t *pool = &aocl_async_pool.pool;
+    aocl_async_job *job = (aocl_async_job *)malloc(sizeof(aocl_async_job));
+    *err = -1;
+    if (job == NULL)
+        return NULL;
+    job->fn = fn;
+    job->arg = arg;
+    job->numThreads = (numThreads > 0) ? numThreads : 1;
+    job->callback = callback;
+    job->userData = userData;
+    job->detached = detached;
+    job->done = 0;
+    job->result = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        if (aocl_async_pool_start(pool) != 0)
+        {
+            free(job);
+            return NULL;
+        }
+        try
+        {
+            pool->queue.push_back(job);
+        }
+        catch (const std::bad_alloc &)
+        {
+            free(job);
+            return NULL;
+        }
+    }
+    pool->jobQueued.notify_one();
+
+    *err = 0;
+    return detached ? NULL : job;
+}
+
+AOCL_INT32 aocl_async_job_poll(aocl_async_job *job, AOCL_INT64 *result)
+{
+    aocl_async_pool_t *pool = &aocl_async_pool.pool;
+    std::lock_guard<std::mutex> guard(pool->lock);
+    if (!job->done)
+        return 0;
+    if (result)
+        *result = job->result;
+    return 1;
+}
+
+AOCL_INT64 aocl_async_job_wait(aocl_async_job *job)
+{
+    aocl_async_pool_t *pool = &aocl_async_pool.pool;
+    AOCL_INT64 result;
+    {
+        std::unique_lock<std::mutex> guard(pool->lock);
+        pool->jobDone.wait(guard, [job] { return job->done != 0; });
+        result = job->result;
+    }
+    free(job);
+    return result;
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) 2023, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /** @file async_pool.h
+ *
+ *  @brief Library-owned thread pool running asynchronous jobs
+ *
+ *  Jobs queued here run on a fixed set of worker threads started on first
+ *  use, so that callers of the asynchronous APIs are not blocked while the
+ *  compression or decompression takes place.
+ */
+
+#ifndef ASYNC_POOL_H
+#define ASYNC_POOL_H
+
+#include "api/types.h"
+#include "api/aocl_threads.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//Body of a job, returns the result reported on completion. numThreads is the
+//number of threads the job may use
+typedef AOCL_INT64 (*aocl_async_fp)(AOCL_VOID *arg, AOCL_INT32 numThreads);
+
+/**
+ * Queues fn(arg) on the pool. Jobs in flight share the available threads: a job
+ * asking for numThreads gets at most what the others leave free, and at least
+ * one, so that every worker of the pool does not start a team of threads of
+ * its own. callback, if not NULL, is called on the worker
+ * thread with userData and the result once fn returns. Returns the job, to be
+ * released by aocl_async_job_wait(), or NULL on failure. With detached set,
+ * the job is released by the pool on completion and NULL is returned on success
+ * as well: *err tells the two apart.
+ */
+aocl_async_job *aocl_async_job_submit(aocl_async_fp fn, AOCL_VOID *arg, AOCL_INT32 numThreads,
+                                      aocl_async_callback callback, AOCL_VOID *userData,
+                                      AOCL_INTP detached, AOCL_INT32 *err);
+
+//Returns 1 and sets *result if the job completed, else 0
+AOCL_INT32 aocl_async_job_poll(aocl_async_job *job, AOCL_INT64 *result);
+
+//Blocks until the job completes, releases it and returns its result
+AOCL_INT64 aocl_async_job_wait(aocl_async_job *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
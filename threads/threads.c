@@ -37,24 +37,870 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "api/types.h"
 #include "api/aocl_compression.h"
 #include "api/aocl_threads.h"
+#include "utils/utils.h"
 #include "threads.h"
+#ifdef __linux__
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#if defined(SYS_getcpu) && defined(SYS_move_pages) && defined(SYS_mbind)
+#define AOCL_NUMA_LINUX
+//Memory policy flags of the mbind system call, as defined in <linux/mempolicy.h>
+#define AOCL_MPOL_PREFERRED 1
+#define AOCL_MPOL_MF_MOVE (1 << 1)
+#endif
+#endif
+
+//Thread budget set for the calling thread by aocl_set_num_threads_mt(). 0 when not set
+static AOCL_TLS AOCL_INT32 thread_budget = 0;
+//Partition sizing mode set for the calling thread by aocl_set_partition_mode_mt()
+static AOCL_TLS AOCL_INT32 partition_mode = AOCL_PARTITION_FIXED;
+//Dictionary priming set for the calling thread by aocl_set_dict_priming_mt()
+static AOCL_TLS AOCL_INT32 dict_priming = 0;
+//Threads allowed by the cgroup CPU quota of the process. 0 when there is no quota, -1 when not read yet
+static AOCL_INT32 cgroup_quota_threads = -1;
+//Executor registered by aocl_set_executor(), published as a whole through this pointer.
+//Parallel regions run on OpenMP threads while it is NULL
+typedef struct executor_entry
+{
+    aocl_executor exec;                     //Copy of the registered executor, not changed once published
+    struct executor_entry *next_replaced;   //Next entry of the list of replaced executors
+} aocl_executor_entry_t;
+static aocl_executor_entry_t *executor = NULL;
+//Executors replaced by later registrations. They are kept, as calls in flight may still use them
+static aocl_executor_entry_t *replaced_executors = NULL;
+//Serializes aocl_set_executor()
+static aocl_lock_t executor_lock = 0;
+//Guards the partition queues of all thread groups
+static aocl_lock_t partition_queue_lock = 0;
+//Online NUMA nodes of the system. 1 when not on a NUMA system or not known, 0 when not read yet
+static AOCL_INT32 numa_num_nodes = 0;
+//NUMA aware placement of partitions, set by aocl_set_numa_placement_mt()
+static AOCL_INT32 numa_placement = 1;
+//Partitions and source bytes processed by a thread on the NUMA node holding their source, and on another node
+static AOCL_UINT64 numa_local_partitions = 0;
+static AOCL_UINT64 numa_remote_partitions = 0;
+static AOCL_UINT64 numa_local_bytes = 0;
+static AOCL_UINT64 numa_remote_bytes = 0;
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AOCL_FETCH_ADD(var, val) _InterlockedExchangeAdd64((volatile long long *)&(var), (val))
+#define AOCL_EXCHANGE(var, val) _InterlockedExchange((volatile long *)&(var), (val))
+#define AOCL_LOAD_ACQUIRE_PTR(var) (*(AOCL_VOID * volatile *)&(var))
+#define AOCL_STORE_RELEASE_PTR(var, val) (*(AOCL_VOID * volatile *)&(var) = (val))
+#define AOCL_YIELD() SwitchToThread()
+#else
+#include <sched.h>
+#define AOCL_FETCH_ADD(var, val) __atomic_fetch_add(&(var), (val), __ATOMIC_RELAXED)
+#define AOCL_EXCHANGE(var, val) __atomic_exchange_n(&(var), (val), __ATOMIC_ACQUIRE)
+#define AOCL_LOAD_ACQUIRE_PTR(var) __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define AOCL_STORE_RELEASE_PTR(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#define AOCL_YIELD() sched_yield()
+#endif
+
+#ifdef __linux__
+//Reads the CPU quota of a cgroup v2 directory from its cpu.max file ("<quota> <period>" or "max <period>").
+//Returns the number of CPUs the quota allows, rounded up, or 0 when there is no quota
+static AOCL_INT32 read_cgroup_v2_quota(const AOCL_CHAR *dir)
+{
+    AOCL_CHAR path[512];
+    AOCL_CHAR quota[32];
+    long long period = 0;
+    AOCL_INT32 cpus = 0;
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "/sys/fs/cgroup%s/cpu.max", dir);
+    fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%31s %lld", quota, &period) == 2 && period > 0 &&
+        strcmp(quota, "max") != 0)
+    {
+        long long quota_us = atoll(quota);
+        if (quota_us > 0)
+            cpus = (AOCL_INT32)((quota_us + period - 1) / period);
+    }
+    fclose(fp);
+    return cpus;
+}
+
+//Reads the CPU quota of a cgroup v1 cpu controller directory from cpu.cfs_quota_us and cpu.cfs_period_us.
+//Returns the number of CPUs the quota allows, rounded up, or 0 when there is no quota
+static AOCL_INT32 read_cgroup_v1_quota(const AOCL_CHAR *dir)
+{
+    AOCL_CHAR path[512];
+    long long quota_us = -1, period = 0;
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/cpu.cfs_quota_us", dir);
+    fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%lld", &quota_us) != 1)
+        quota_us = -1;
+    fclose(fp);
+
+    snprintf(path, sizeof(path), "%s/cpu.cfs_period_us", dir);
+    fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%lld", &period) != 1)
+        period = 0;
+    fclose(fp);
+
+    if (quota_us <= 0 || period <= 0)
+        return 0;
+    return (AOCL_INT32)((quota_us + period - 1) / period);
+}
+
+//Keeps the smaller of two quotas, where 0 means no quota
+static AOCL_INT32 min_quota(AOCL_INT32 a, AOCL_INT32 b)
+{
+    if (a == 0)
+        return b;
+    if (b == 0)
+        return a;
+    return (a < b) ? a : b;
+}
+
+//Checks if the comma separated controller list of a cgroup v1 hierarchy has the cpu controller
+static AOCL_INT32 has_cpu_controller(const AOCL_CHAR *controllers)
+{
+    while (controllers != NULL)
+    {
+        if (strncmp(controllers, "cpu", 3) == 0 &&
+            (controllers[3] == ',' || controllers[3] == '\0'))
+            return 1;
+        controllers = strchr(controllers, ',');
+        if (controllers != NULL)
+            controllers++;
+    }
+    return 0;
+}
+
+//Finds the CPU quota of the process's cgroup and of its parents.
+//Returns the number of CPUs the quota allows, rounded up, or 0 when there is no quota
+static AOCL_INT32 read_cgroup_quota(void)
+{
+    AOCL_CHAR line[512];
+    AOCL_INT32 cpus = 0;
+    FILE *fp = fopen("/proc/self/cgroup", "r");
+    if (fp == NULL)
+        return 0;
+
+    //Lines are "<id>:<controllers>:<path>". cgroup v2 has the single line "0::<path>"
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        AOCL_CHAR *controllers = strchr(line, ':');
+        AOCL_CHAR *dir, *end;
+        if (controllers == NULL)
+            continue;
+        controllers++;
+        dir = strchr(controllers, ':');
+        if (dir == NULL)
+            continue;
+        *dir++ = '\0';
+        end = dir + strcspn(dir, "\n");
+        *end = '\0';
+
+        if (controllers[0] == '\0')
+        {
+            //cgroup v2: every ancestor's quota applies, down to the root of the namespace
+            while (1)
+            {
+                AOCL_CHAR *slash;
+                cpus = min_quota(cpus, read_cgroup_v2_quota(strcmp(dir, "/") == 0 ? "" : dir));
+                slash = strrchr(dir, '/');
+                if (slash == NULL || slash == dir)
+                    break;
+                *slash = '\0';
+            }
+            cpus = min_quota(cpus, read_cgroup_v2_quota(""));
+        }
+        else if (has_cpu_controller(controllers))
+        {
+            //cgroup v1 cpu controller, mounted as cpu or cpu,cpuacct. Inside a container only the root is visible
+            AOCL_CHAR path[512];
+            const AOCL_CHAR *mounts[] = { "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" };
+            AOCL_UINT32 i;
+            for (i = 0; i < sizeof(mounts) / sizeof(mounts[0]); i++)
+            {
+                snprintf(path, sizeof(path), "%s%s", mounts[i], strcmp(dir, "/") == 0 ? "" : dir);
+                cpus = min_quota(cpus, read_cgroup_v1_quota(path));
+                cpus = min_quota(cpus, read_cgroup_v1_quota(mounts[i]));
+            }
+        }
+    }
+    fclose(fp);
+    return cpus;
+}
+#endif /* __linux__ */
+
+#ifdef AOCL_NUMA_LINUX
+//Reads the number of online NUMA nodes from the node list in sysfs ("0", "0-1", "0,2-3", ...).
+//Returns 1 when it cannot be read
+static AOCL_INT32 read_numa_num_nodes(void)
+{
+    AOCL_INT32 nodes = 0;
+    int first, last, sep;
+    FILE *fp = fopen("/sys/devices/system/node/online", "r");
+    if (fp == NULL)
+        return 1;
+    while (fscanf(fp, "%d", &first) == 1)
+    {
+        last = first;
+        sep = fgetc(fp);
+        if (sep == '-')
+        {
+            if (fscanf(fp, "%d", &last) != 1)
+                break;
+            sep = fgetc(fp);
+        }
+        if (last >= first)
+            nodes += last - first + 1;
+        if (sep != ',')
+            break;
+    }
+    fclose(fp);
+    return (nodes > 0) ? nodes : 1;
+}
+#endif /* AOCL_NUMA_LINUX */
+
+static AOCL_INT32 get_numa_num_nodes(void)
+{
+    AOCL_INT32 nodes = AOCL_LOAD_ACQUIRE(numa_num_nodes);
+    if (nodes == 0)
+    {
+        //Read once. Threads racing here read the same value
+#ifdef AOCL_NUMA_LINUX
+        nodes = read_numa_num_nodes();
+#else
+        nodes = 1;
+#endif
+        AOCL_STORE_RELEASE(numa_num_nodes, nodes);
+    }
+    return nodes;
+}
+
+static inline AOCL_INT32 numa_placement_active(void)
+{
+    return AOCL_LOAD_ACQUIRE(numa_placement) && get_numa_num_nodes() > 1;
+}
+
+//NUMA node of the CPU running the calling thread. -1 when unknown
+static AOCL_INT32 get_current_numa_node(void)
+{
+#ifdef AOCL_NUMA_LINUX
+    unsigned int cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0)
+        return (AOCL_INT32)node;
+#endif
+    return -1;
+}
+
+//Finds the NUMA node of the page holding each of the num addresses. The node is -1 for
+//pages that are not faulted in yet or cannot be queried
+static AOCL_VOID get_numa_nodes(AOCL_VOID **pages, AOCL_INT32 *nodes, AOCL_UINT32 num)
+{
+    AOCL_UINT32 i;
+#ifdef AOCL_NUMA_LINUX
+    //Without target nodes, move_pages only reports the node of each page
+    if (syscall(SYS_move_pages, 0, (unsigned long)num, pages, NULL, nodes, 0) == 0)
+    {
+        for (i = 0; i < num; i++)
+        {
+            if (nodes[i] < 0)
+                nodes[i] = -1;
+        }
+        return;
+    }
+#else
+    (AOCL_VOID)pages;
+#endif
+    for (i = 0; i < num; i++)
+        nodes[i] = -1;
+}
+
+//Moves the pages that lie within buf to node, so that a buffer first touched on another node is local again
+static AOCL_VOID move_to_numa_node(AOCL_CHAR *buf, AOCL_INTP size, AOCL_INT32 node)
+{
+#ifdef AOCL_NUMA_LINUX
+    unsigned long mask;
+    long page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t start, end;
+    if (page_size <= 0 || node < 0 || node >= (AOCL_INT32)(sizeof(mask) * 8))
+        return;
+    start = ((uintptr_t)buf + page_size - 1) & ~(uintptr_t)(page_size - 1);
+    end = ((uintptr_t)buf + size) & ~(uintptr_t)(page_size - 1);
+    if (end <= start)
+        return;
+    mask = 1UL << node;
+    //Failure leaves the buffer where it is
+    syscall(SYS_mbind, start, end - start, AOCL_MPOL_PREFERRED, &mask,
+            sizeof(mask) * 8 + 1, AOCL_MPOL_MF_MOVE);
+#else
+    (AOCL_VOID)buf;
+    (AOCL_VOID)size;
+    (AOCL_VOID)node;
+#endif
+}
+
+AOCL_VOID aocl_set_numa_placement_mt(AOCL_INT32 enable)
+{
+    AOCL_STORE_RELEASE(numa_placement, (enable != 0) ? 1 : 0);
+}
+
+AOCL_INT32 aocl_get_numa_stats_mt(aocl_numa_stats *stats, AOCL_INT32 reset)
+{
+    AOCL_UINT64 local_partitions, remote_partitions, local_bytes, remote_bytes;
+    if (stats == NULL && reset == 0)
+        return ERR_INVALID_INPUT;
+
+    local_partitions = AOCL_FETCH_ADD(numa_local_partitions, 0);
+    remote_partitions = AOCL_FETCH_ADD(numa_remote_partitions, 0);
+    local_bytes = AOCL_FETCH_ADD(numa_local_bytes, 0);
+    remote_bytes = AOCL_FETCH_ADD(numa_remote_bytes, 0);
+    if (stats)
+    {
+        stats->numNodes = (AOCL_UINT32)get_numa_num_nodes();
+        stats->localPartitions = local_partitions;
+        stats->remotePartitions = remote_partitions;
+        stats->localBytes = local_bytes;
+        stats->remoteBytes = remote_bytes;
+    }
+    if (reset)
+    {
+        //Subtract what was read, so that partitions counted meanwhile are kept
+        AOCL_FETCH_ADD(numa_local_partitions, (AOCL_UINT64)0 - local_partitions);
+        AOCL_FETCH_ADD(numa_remote_partitions, (AOCL_UINT64)0 - remote_partitions);
+        AOCL_FETCH_ADD(numa_local_bytes, (AOCL_UINT64)0 - local_bytes);
+        AOCL_FETCH_ADD(numa_remote_bytes, (AOCL_UINT64)0 - remote_bytes);
+    }
+    return 0;
+}
+
+AOCL_UINT32 aocl_get_available_threads_mt(void)
+{
+    aocl_executor_entry_t *entry = (aocl_executor_entry_t*)AOCL_LOAD_ACQUIRE_PTR(executor);
+    AOCL_INT32 max_threads = (entry != NULL && entry->exec.numThreads > 0) ?
+                                entry->exec.numThreads : omp_get_max_threads();
+    AOCL_INT32 quota = AOCL_LOAD_ACQUIRE(cgroup_quota_threads);
+    if (quota < 0)
+    {
+        //Read once. Threads racing here read the same value
+#ifdef __linux__
+        quota = read_cgroup_quota();
+#else
+        quota = 0;
+#endif
+        AOCL_STORE_RELEASE(cgroup_quota_threads, quota);
+    }
+    if (quota > 0 && quota < max_threads)
+        max_threads = quota;
+    return (max_threads > 0) ? (AOCL_UINT32)max_threads : 1;
+}
+
+AOCL_VOID aocl_set_num_threads_mt(AOCL_INT32 num_threads)
+{
+    thread_budget = (num_threads > 0) ? num_threads : 0;
+}
+
+AOCL_INT32 aocl_swap_num_threads_mt(AOCL_INT32 num_threads)
+{
+    AOCL_INT32 prev_budget = thread_budget;
+    if (num_threads > 0)
+        thread_budget = num_threads;
+    return prev_budget;
+}
+
+AOCL_INT32 aocl_get_num_threads_mt(void)
+{
+    AOCL_UINT32 max_threads = aocl_get_available_threads_mt();
+    if (thread_budget > 0 && (AOCL_UINT32)thread_budget < max_threads)
+        return thread_budget;
+    return (AOCL_INT32)max_threads;
+}
+
+AOCL_VOID aocl_lock_mt(aocl_lock_t *lock)
+{
+    while (AOCL_EXCHANGE(*lock, 1))
+    {
+        //Wait for the lock to be released before trying to take it again
+        while (AOCL_LOAD_ACQUIRE(*lock))
+            AOCL_YIELD();
+    }
+}
+
+AOCL_VOID aocl_unlock_mt(aocl_lock_t *lock)
+{
+    AOCL_STORE_RELEASE(*lock, 0);
+}
+
+static AOCL_INT32 same_executor(const aocl_executor *a, const aocl_executor *b)
+{
+    return a->ctx == b->ctx && a->create_group == b->create_group && a->submit == b->submit &&
+           a->wait == b->wait && a->numThreads == b->numThreads;
+}
+
+AOCL_INT32 aocl_set_executor(const aocl_executor *exec)
+{
+    aocl_executor_entry_t *entry = NULL, *prev, **link;
+    if (exec != NULL && (exec->create_group == NULL || exec->submit == NULL || exec->wait == NULL))
+        return ERR_INVALID_INPUT;
+
+    aocl_lock_mt(&executor_lock);
+    prev = executor;
+    if (exec != NULL)
+    {
+        if (prev != NULL && same_executor(&prev->exec, exec))
+        {
+            aocl_unlock_mt(&executor_lock);
+            return 0;
+        }
+        //An executor replaced before is published again, so that switching between
+        //a few executors allocates once for each
+        for (link = &replaced_executors; *link != NULL; link = &(*link)->next_replaced)
+        {
+            if (same_executor(&(*link)->exec, exec))
+            {
+                entry = *link;
+                *link = entry->next_replaced;
+                break;
+            }
+        }
+        if (entry == NULL)
+        {
+            entry = (aocl_executor_entry_t*)malloc(sizeof(aocl_executor_entry_t));
+            if (entry == NULL)
+            {
+                aocl_unlock_mt(&executor_lock);
+                return ERR_COMPRESSION_FAILED;
+            }
+            entry->exec = *exec;
+        }
+        entry->next_replaced = NULL;
+    }
+
+    AOCL_STORE_RELEASE_PTR(executor, entry);
+    if (prev != NULL)
+    {
+        prev->next_replaced = replaced_executors;
+        replaced_executors = prev;
+    }
+    aocl_unlock_mt(&executor_lock);
+    return 0;
+}
+
+//Worker of a parallel region submitted to the executor
+typedef struct
+{
+    aocl_parallel_task_t task;
+    AOCL_VOID *arg;
+    AOCL_UINT32 worker_id;
+} aocl_executor_job_t;
+
+static AOCL_VOID aocl_run_executor_job(AOCL_VOID *arg)
+{
+    aocl_executor_job_t *job = (aocl_executor_job_t*)arg;
+    job->task(job->arg, job->worker_id);
+}
+
+AOCL_VOID aocl_run_parallel_mt(aocl_parallel_task_t task, AOCL_VOID *arg, AOCL_UINT32 num_workers)
+{
+    if (num_workers <= 1)
+    {
+        task(arg, 0);
+        return;
+    }
+
+    aocl_executor_entry_t *entry = (aocl_executor_entry_t*)AOCL_LOAD_ACQUIRE_PTR(executor);
+    if (entry != NULL)
+    {
+        //The region keeps the executor it started with, whatever is registered meanwhile
+        const aocl_executor *exec = &entry->exec;
+        aocl_executor_job_t *jobs = (aocl_executor_job_t*)malloc(sizeof(aocl_executor_job_t) * num_workers);
+        AOCL_VOID *group = (jobs != NULL) ? exec->create_group(exec->ctx) : NULL;
+        AOCL_UINT32 worker_id;
+        if (group == NULL)
+        {
+            //Worker 0 takes all the work on the calling thread
+            free(jobs);
+            task(arg, 0);
+            return;
+        }
+        for (worker_id = 1; worker_id < num_workers; worker_id++)
+        {
+            jobs[worker_id].task = task;
+            jobs[worker_id].arg = arg;
+            jobs[worker_id].worker_id = worker_id;
+            //Work of the workers that could not be queued is taken by the others
+            if (exec->submit(exec->ctx, group, aocl_run_executor_job, &jobs[worker_id]) != 0)
+                break;
+        }
+        //The calling thread runs worker 0, as the master thread of an OpenMP region does
+        task(arg, 0);
+        exec->wait(exec->ctx, group);
+        free(jobs);
+        return;
+    }
+
+#pragma omp parallel num_threads(num_workers)
+    {
+        task(arg, omp_get_thread_num());
+    }
+}
+
+//Loop shared by the workers of aocl_run_parallel_for_mt()
+typedef struct
+{
+    aocl_parallel_for_task_t task;
+    AOCL_VOID *arg;
+    AOCL_INT64 num_items;
+    AOCL_INT64 next_item;
+} aocl_parallel_for_t;
+
+static AOCL_VOID aocl_parallel_for_worker(AOCL_VOID *arg, AOCL_UINT32 worker_id)
+{
+    aocl_parallel_for_t *loop = (aocl_parallel_for_t*)arg;
+    AOCL_INT64 item;
+    //Items are taken one at a time, as in a dynamic schedule
+    while ((item = AOCL_FETCH_ADD(loop->next_item, 1)) < loop->num_items)
+        loop->task(loop->arg, (AOCL_INTP)item, worker_id);
+}
+
+AOCL_VOID aocl_run_parallel_for_mt(aocl_parallel_for_task_t task, AOCL_VOID *arg,
+                                   AOCL_INTP num_items, AOCL_UINT32 num_workers)
+{
+    aocl_parallel_for_t loop;
+    loop.task = task;
+    loop.arg = arg;
+    loop.num_items = num_items;
+    loop.next_item = 0;
+    if ((AOCL_INTP)num_workers > num_items)
+        num_workers = (AOCL_UINT32)num_items;
+    aocl_run_parallel_mt(aocl_parallel_for_worker, &loop, num_workers);
+}
+
+AOCL_INT32 aocl_set_partition_mode_mt(AOCL_INT32 mode)
+{
+    if (mode < AOCL_PARTITION_FIXED || mode >= AOCL_PARTITION_MODES_NUM)
+        return ERR_INVALID_INPUT;
+    partition_mode = mode;
+    return 0;
+}
+
+AOCL_INT32 aocl_get_partition_mode_mt(void)
+{
+    return partition_mode;
+}
+
+AOCL_VOID aocl_set_dict_priming_mt(AOCL_INT32 enable)
+{
+    dict_priming = (enable != 0);
+}
+
+AOCL_INT32 aocl_get_dict_priming_mt(void)
+{
+    return dict_priming;
+}
+
+//Number and length of the source samples taken by the adaptive partition sizing
+#define ADAPTIVE_NUM_SAMPLES 8
+#define ADAPTIVE_SAMPLE_LEN 4096
+#define ADAPTIVE_HASH_LOG 12
+
+//Classes of sampled data, from the redundancy of the samples (1/256 units)
+#define ADAPTIVE_INCOMPRESSIBLE 0   //Redundancy below ADAPTIVE_LOW_REDUNDANCY
+#define ADAPTIVE_MIXED 1
+#define ADAPTIVE_COMPRESSIBLE 2     //Redundancy above ADAPTIVE_HIGH_REDUNDANCY
+#define ADAPTIVE_LOW_REDUNDANCY 26
+#define ADAPTIVE_HIGH_REDUNDANCY 128
+//Spread of redundancy across the samples above which the data is uneven
+#define ADAPTIVE_UNEVEN_SPREAD 64
+
+//Partition sizing of each adaptive mode for each class of data: minimum partition length in
+//quarters of window_len * window_factor, and maximum number of partitions per thread.
+//Larger partitions keep more matches and improve ratio on compressible data. More partitions
+//per thread balance the load better and cost little ratio on incompressible data
+static const struct
+{
+    AOCL_UINT32 chunk_quarters;
+    AOCL_UINT32 partitions_per_thread;
+} adaptive_sizing[AOCL_PARTITION_MODES_NUM - 1][3] =
+{
+    //ADAPTIVE_INCOMPRESSIBLE  ADAPTIVE_MIXED  ADAPTIVE_COMPRESSIBLE
+    { { 2, 4 }, { 4, 4 }, {  4, 2 } }, //AOCL_PARTITION_ADAPTIVE_SPEED
+    { { 2, 4 }, { 4, 2 }, {  8, 1 } }, //AOCL_PARTITION_ADAPTIVE_BALANCED
+    { { 4, 2 }, { 8, 1 }, { 16, 1 } }  //AOCL_PARTITION_ADAPTIVE_RATIO
+};
+
+//log2(x) of x >= 1 in 1/256 units, linearly interpolated between powers of two
+static AOCL_UINT32 log2_fixed(AOCL_UINT32 x)
+{
+    AOCL_UINT32 bits = 0;
+    while ((x >> bits) > 1)
+        bits++;
+    //x = 2^bits * (1 + f) with log2(x) ~= bits + f
+    return (bits << 8) + (AOCL_UINT32)((((AOCL_UINT64)x << 8) >> bits) - 256);
+}
+
+//Estimates the redundancy of a sample in 1/256 units, as the larger of its order-0 entropy
+//saving and of the share of its positions that start a 4 byte match of an earlier position
+static AOCL_UINT32 sample_redundancy(const AOCL_UCHAR *sample, AOCL_UINT32 len,
+                                     AOCL_USHORT *hash_table)
+{
+    AOCL_UINT32 histogram[256] = { 0 };
+    AOCL_UINT64 weighted_log = 0;
+    AOCL_UINT32 entropy, entropy_saving, match_density;
+    AOCL_UINT32 matches = 0, pos, sym;
+
+    memset(hash_table, 0, sizeof(AOCL_USHORT) << ADAPTIVE_HASH_LOG);
+    for (pos = 0; pos < len; pos++)
+        histogram[sample[pos]]++;
+    for (pos = 0; pos + 4 <= len; pos++)
+    {
+        AOCL_UINT32 seq;
+        AOCL_UINT32 hash;
+        memcpy(&seq, sample + pos, sizeof(seq));
+        hash = (seq * 2654435761U) >> (32 - ADAPTIVE_HASH_LOG);
+        //Positions are stored plus one so that 0 marks an empty slot
+        if (hash_table[hash] != 0 &&
+            memcmp(sample + hash_table[hash] - 1, sample + pos, 4) == 0)
+            matches++;
+        hash_table[hash] = (AOCL_USHORT)(pos + 1);
+    }
+
+    //Entropy H = log2(len) - sum(c * log2(c)) / len bits per byte
+    for (sym = 0; sym < 256; sym++)
+    {
+        if (histogram[sym])
+            weighted_log += (AOCL_UINT64)histogram[sym] * log2_fixed(histogram[sym]);
+    }
+    entropy = log2_fixed(len) - (AOCL_UINT32)(weighted_log / len);
+    entropy_saving = (entropy < 8 * 256) ? 256 - (entropy >> 3) : 0;
+    match_density = (len >= 4) ? (matches << 8) / (len - 3) : 0;
+    return (entropy_saving > match_density) ? entropy_saving : match_density;
+}
+
+//Samples src at evenly spread offsets and adapts the minimum partition length chunk_size and the
+//maximum number of partitions per thread to the sizing mode and to the compressibility of the samples
+static AOCL_VOID adapt_partition_sizing(const AOCL_CHAR *src, AOCL_INTP src_size,
+                                        AOCL_INT32 window_len, AOCL_INT32 mode,
+                                        AOCL_INTP *chunk_size, AOCL_UINT32 *partitions_per_thread)
+{
+    AOCL_USHORT hash_table[1 << ADAPTIVE_HASH_LOG];
+    AOCL_UINT32 sample_len = (src_size < ADAPTIVE_SAMPLE_LEN) ? (AOCL_UINT32)src_size :
+                                ADAPTIVE_SAMPLE_LEN;
+    AOCL_UINT32 redundancy, min_redundancy = 256, max_redundancy = 0, total_redundancy = 0;
+    AOCL_UINT32 sample_cnt, data_class;
+    AOCL_INTP adapted_chunk;
+
+    for (sample_cnt = 0; sample_cnt < ADAPTIVE_NUM_SAMPLES; sample_cnt++)
+    {
+        AOCL_INTP offset = ((src_size - sample_len) / (ADAPTIVE_NUM_SAMPLES - 1)) * sample_cnt;
+        redundancy = sample_redundancy((const AOCL_UCHAR*)src + offset, sample_len, hash_table);
+        total_redundancy += redundancy;
+        if (redundancy < min_redundancy)
+            min_redundancy = redundancy;
+        if (redundancy > max_redundancy)
+            max_redundancy = redundancy;
+    }
+    redundancy = total_redundancy / ADAPTIVE_NUM_SAMPLES;
+    data_class = (redundancy < ADAPTIVE_LOW_REDUNDANCY) ? ADAPTIVE_INCOMPRESSIBLE :
+                    ((redundancy > ADAPTIVE_HIGH_REDUNDANCY) ? ADAPTIVE_COMPRESSIBLE : ADAPTIVE_MIXED);
+
+    adapted_chunk = (*chunk_size >> 2) * adaptive_sizing[mode - 1][data_class].chunk_quarters;
+    *chunk_size = (adapted_chunk > window_len) ? adapted_chunk : window_len;
+    *partitions_per_thread = adaptive_sizing[mode - 1][data_class].partitions_per_thread;
+    //Parts of uneven data compress at different speeds: keep enough partitions to balance them
+    if (max_redundancy - min_redundancy > ADAPTIVE_UNEVEN_SPREAD)
+        *partitions_per_thread = PARTITIONS_PER_THREAD;
+#ifdef AOCL_THREADS_LOG
+    printf("Adaptive partition sizing: redundancy [%u] (min [%u], max [%u]), chunk size [%td], partitions per thread [%u]\n",
+        redundancy, min_redundancy, max_redundancy, *chunk_size, *partitions_per_thread);
+#endif
+}
+
+//Grows the per thread lists of ctx to hold at least num_threads entries
+static AOCL_INT32 reserve_thread_ctx(aocl_thread_ctx_t *ctx, AOCL_UINT32 num_threads)
+{
+    aocl_thread_info_t *threads_info_list;
+    AOCL_CHAR **dst_trap_list;
+    AOCL_INTP *dst_trap_capacity;
+    AOCL_INT32 *dst_trap_node;
+    AOCL_VOID **state_list;
+    aocl_partition_queue_t *partition_queues;
+    AOCL_UINT32 thread_cnt;
+
+    if (ctx->max_threads >= num_threads)
+        return 0;
+
+    threads_info_list = (aocl_thread_info_t*)realloc(ctx->threads_info_list,
+                            sizeof(aocl_thread_info_t) * num_threads);
+    if (threads_info_list == NULL)
+        return -1;
+    ctx->threads_info_list = threads_info_list;
+
+    dst_trap_list = (AOCL_CHAR**)realloc(ctx->dst_trap_list, sizeof(AOCL_CHAR*) * num_threads);
+    if (dst_trap_list == NULL)
+        return -1;
+    ctx->dst_trap_list = dst_trap_list;
+
+    dst_trap_capacity = (AOCL_INTP*)realloc(ctx->dst_trap_capacity, sizeof(AOCL_INTP) * num_threads);
+    if (dst_trap_capacity == NULL)
+        return -1;
+    ctx->dst_trap_capacity = dst_trap_capacity;
+
+    dst_trap_node = (AOCL_INT32*)realloc(ctx->dst_trap_node, sizeof(AOCL_INT32) * num_threads);
+    if (dst_trap_node == NULL)
+        return -1;
+    ctx->dst_trap_node = dst_trap_node;
+
+    state_list = (AOCL_VOID**)realloc(ctx->state_list, sizeof(AOCL_VOID*) * num_threads);
+    if (state_list == NULL)
+        return -1;
+    ctx->state_list = state_list;
+
+    partition_queues = (aocl_partition_queue_t*)realloc(ctx->partition_queues,
+                            sizeof(aocl_partition_queue_t) * num_threads);
+    if (partition_queues == NULL)
+        return -1;
+    ctx->partition_queues = partition_queues;
+
+    //New entries start without buffers or states
+    memset(ctx->dst_trap_list + ctx->max_threads, 0,
+            sizeof(AOCL_CHAR*) * (num_threads - ctx->max_threads));
+    memset(ctx->dst_trap_capacity + ctx->max_threads, 0,
+            sizeof(AOCL_INTP) * (num_threads - ctx->max_threads));
+    memset(ctx->state_list + ctx->max_threads, 0,
+            sizeof(AOCL_VOID*) * (num_threads - ctx->max_threads));
+    for (thread_cnt = ctx->max_threads; thread_cnt < num_threads; thread_cnt++)
+        ctx->dst_trap_node[thread_cnt] = -1;
+    ctx->max_threads = num_threads;
+    return 0;
+}
+
+//Distributes the partitions of thread_grp to the queues of its threads.
+//Each thread gets a contiguous range of partitions chained through next
+static AOCL_VOID init_partition_queues(aocl_thread_group_t *thread_grp)
+{
+    AOCL_UINT32 num_partitions = thread_grp->num_threads;
+    AOCL_UINT32 num_workers = thread_grp->num_workers;
+    AOCL_UINT32 partitions_per_worker = num_partitions / num_workers;
+    AOCL_UINT32 leftover_partitions = num_partitions % num_workers;
+    AOCL_UINT32 worker_id, partition_id = 0;
+
+    for (worker_id = 0; worker_id < num_workers; worker_id++)
+    {
+        aocl_partition_queue_t *queue = &thread_grp->partition_queues[worker_id];
+        AOCL_UINT32 cnt;
+        queue->num_pending = partitions_per_worker + (worker_id < leftover_partitions ? 1 : 0);
+        queue->head = (queue->num_pending > 0) ?
+                        &thread_grp->threads_info_list[partition_id] : NULL;
+        queue->numa_node = -1;
+        queue->started = 0;
+        for (cnt = 0; cnt < queue->num_pending; cnt++, partition_id++)
+        {
+            thread_grp->threads_info_list[partition_id].thread_id = partition_id;
+            thread_grp->threads_info_list[partition_id].dst_trap = NULL;
+            thread_grp->threads_info_list[partition_id].numa_node = -1;
+            thread_grp->threads_info_list[partition_id].dict_size = 0;
+            thread_grp->threads_info_list[partition_id].num_chained = 1;
+            thread_grp->threads_info_list[partition_id].next = (cnt + 1 < queue->num_pending) ?
+                        &thread_grp->threads_info_list[partition_id + 1] : NULL;
+        }
+    }
+}
+
+//Finds the NUMA node holding the source of each partition of thread_grp, and the node of each
+//queue from the partition in the middle of its range. Sets partition_src_size of the partitions
+//for the NUMA statistics. Nodes are left unknown on systems with a single node
+static AOCL_VOID init_partition_nodes(aocl_thread_group_t *thread_grp, AOCL_INT32 is_decompress)
+{
+    AOCL_UINT32 num_partitions = thread_grp->num_threads;
+    AOCL_UINT32 partition_id, worker_id;
+    AOCL_VOID **pages;
+    AOCL_INT32 *nodes;
+
+    if (get_numa_num_nodes() <= 1 || thread_grp->src == NULL)
+        return;
+    pages = (AOCL_VOID**)malloc(sizeof(AOCL_VOID*) * num_partitions);
+    nodes = (AOCL_INT32*)malloc(sizeof(AOCL_INT32) * num_partitions);
+    if (pages == NULL || nodes == NULL)
+    {
+        free(pages);
+        free(nodes);
+        return;
+    }
+
+    for (partition_id = 0; partition_id < num_partitions; partition_id++)
+    {
+        aocl_thread_info_t *partition = &thread_grp->threads_info_list[partition_id];
+        AOCL_INTP offset;
+        if (is_decompress)
+        {
+            AOCL_INTP rap_len, decomp_len;
+            aocl_read_rap_partition_mt(thread_grp, partition_id, &offset, &rap_len, &decomp_len);
+            partition->partition_src_size = rap_len;
+        }
+        else
+        {
+            offset = thread_grp->common_part_src_size * partition_id;
+            partition->partition_src_size = (partition_id != num_partitions - 1) ?
+                thread_grp->common_part_src_size :
+                thread_grp->common_part_src_size + thread_grp->leftover_part_src_bytes;
+        }
+        //The page in the middle of the partition stands for the whole partition
+        if (offset < 0 || partition->partition_src_size < 0 ||
+            offset + partition->partition_src_size > thread_grp->src_size)
+            offset = partition->partition_src_size = 0;
+        pages[partition_id] = thread_grp->src + offset + (partition->partition_src_size >> 1);
+    }
+    get_numa_nodes(pages, nodes, num_partitions);
+
+    for (partition_id = 0; partition_id < num_partitions; partition_id++)
+        thread_grp->threads_info_list[partition_id].numa_node = nodes[partition_id];
+    for (worker_id = 0; worker_id < thread_grp->num_workers; worker_id++)
+    {
+        aocl_partition_queue_t *queue = &thread_grp->partition_queues[worker_id];
+        if (queue->num_pending > 0)
+            queue->numa_node = queue->head[queue->num_pending >> 1].numa_node;
+    }
+    free(pages);
+    free(nodes);
+}
 
 AOCL_INT32 aocl_setup_parallel_compress_mt(aocl_thread_group_t *thread_grp, 
-                                      AOCL_CHAR *src, AOCL_CHAR *dst, AOCL_INT32 in_size,
-                                      AOCL_INT32 out_size, AOCL_INT32 window_len,
+                                      AOCL_CHAR *src, AOCL_CHAR *dst, AOCL_INTP in_size,
+                                      AOCL_INTP out_size, AOCL_INT32 window_len,
+                                      AOCL_INT32 window_factor)
+{
+    return aocl_setup_parallel_compress_ctx_mt(thread_grp, NULL, src, dst, in_size,
+                                               out_size, window_len, window_factor);
+}
+
+AOCL_INT32 aocl_setup_parallel_compress_ctx_mt(aocl_thread_group_t *thread_grp,
+                                      aocl_thread_ctx_t *ctx,
+                                      AOCL_CHAR *src, AOCL_CHAR *dst, AOCL_INTP in_size,
+                                      AOCL_INTP out_size, AOCL_INT32 window_len,
                                       AOCL_INT32 window_factor)
 {
     assert(thread_grp != NULL);
+    thread_grp->ctx = NULL;
     if (dst == NULL || window_len <= 0 || window_factor <= 0)
         return ERR_INVALID_INPUT;
 
-    AOCL_UINT32 max_threads = omp_get_max_threads();
+    AOCL_UINT32 max_threads = aocl_get_num_threads_mt();
     AOCL_INT32 rap_frame_len = 0;
-    AOCL_INT32 chunk_size = window_len * window_factor;
+    AOCL_INTP chunk_size = (AOCL_INTP)window_len * window_factor;
+    AOCL_UINT32 partitions_per_thread = PARTITIONS_PER_THREAD;
 
     thread_grp->src = src;
     thread_grp->dst = dst;
@@ -62,6 +908,19 @@ AOCL_INT32 aocl_setup_parallel_compress_mt(aocl_thread_group_t *thread_grp,
     thread_grp->dst_size = out_size;
     thread_grp->search_window_length = window_len;
     thread_grp->threads_info_list = NULL;
+    thread_grp->partition_queues = NULL;
+    thread_grp->num_workers = 1;
+    thread_grp->chain_len = 1;
+    thread_grp->in_place_dst = 0;
+    //Offsets and lengths of streams beyond 4 GiB need 64-bit RAP metadata fields
+    thread_grp->rap_version = (in_size > RAP_FRAME_32BIT_LIMIT || out_size > RAP_FRAME_32BIT_LIMIT) ?
+                                RAP_FRAME_VERSION_64 : RAP_FRAME_VERSION_32;
+
+    //Adaptive modes resize partitions from samples of src. Streams too small to partition are not sampled
+    if (partition_mode != AOCL_PARTITION_FIXED && max_threads > 1 && src != NULL &&
+        thread_grp->src_size >= chunk_size)
+        adapt_partition_sizing(src, thread_grp->src_size, window_len, partition_mode,
+                               &chunk_size, &partitions_per_thread);
 
     if (thread_grp->src_size < chunk_size)
     {
@@ -71,49 +930,87 @@ AOCL_INT32 aocl_setup_parallel_compress_mt(aocl_thread_group_t *thread_grp,
     else
     {
         //Find number of partitions in the src stream
-        AOCL_INT32 num_parallel_partitions = thread_grp->src_size / chunk_size;
-        AOCL_INT32 leftover_size = thread_grp->src_size % chunk_size;
+        AOCL_INTP num_parallel_partitions = thread_grp->src_size / chunk_size;
+        AOCL_INTP leftover_size = thread_grp->src_size % chunk_size;
         
         //Sufficiently large leftover bytes adds another thread for processing
         if (leftover_size >= 
             ((window_factor > 1) ? (chunk_size >> 1) : (window_len >> 1)))
             num_parallel_partitions++;
 
-        //Find number of threads to process the number of parallel partitions
-        if (max_threads >= num_parallel_partitions)
-            //Use only upto num_parallel_partitions threads
+        //Find number of partitions to be processed by the threads
+        if (max_threads == 1)
+            //Single threaded execution when only one thread is available
+            thread_grp->num_threads = 1;
+        else if ((AOCL_INTP)max_threads * partitions_per_thread >= num_parallel_partitions)
+            //Use only upto num_parallel_partitions partitions
             thread_grp->num_threads = num_parallel_partitions;
         else
-            //Use all the available threads
-            thread_grp->num_threads = max_threads;
+            //Use upto partitions_per_thread (PARTITIONS_PER_THREAD unless adapted) partitions per available thread
+            thread_grp->num_threads = max_threads * partitions_per_thread;
 
         if (thread_grp->num_threads == 1)
             return rap_frame_len;
 
+        //Find number of threads to process the partitions
+        thread_grp->num_workers = (max_threads < thread_grp->num_threads) ?
+                                    max_threads : thread_grp->num_threads;
+
         //Tentative partitioning. Actual partitioning is done at thread level
         thread_grp->common_part_src_size = thread_grp->src_size /
                                                 thread_grp->num_threads;
         thread_grp->leftover_part_src_bytes = thread_grp->src_size %
                                                 thread_grp->num_threads;
 
-        //Allocate threads list to hold references to threads_info
-        thread_grp->threads_info_list = (aocl_thread_info_t*)malloc(
-                        sizeof(aocl_thread_info_t) * thread_grp->num_threads);
-        if (thread_grp->threads_info_list == NULL)
-            return -1;
+        //Chains of primed partitions keep one chain per thread for the decompressor.
+        //Below 2 GiB, decompressed lengths leave the top bit of 32-bit RAP fields free for the dependent mark
+        if (dict_priming && (thread_grp->rap_version == RAP_FRAME_VERSION_64 ||
+                             thread_grp->src_size < (AOCL_INTP)RAP_DEPENDENT_FLAG))
+            thread_grp->chain_len = (thread_grp->num_threads + thread_grp->num_workers - 1) /
+                                        thread_grp->num_workers;
 
-        rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH(thread_grp->num_threads, 0);
-        *(AOCL_INT64*)dst = RAP_MAGIC_WORD; //For storing the magic word
+        if (ctx)
+        {
+            //Reuse the threads list held by the context
+            if (reserve_thread_ctx(ctx, thread_grp->num_threads) != 0)
+                return -1;
+            thread_grp->ctx = ctx;
+            thread_grp->threads_info_list = ctx->threads_info_list;
+            thread_grp->partition_queues = ctx->partition_queues;
+        }
+        else
+        {
+            //Allocate threads list to hold references to threads_info
+            thread_grp->threads_info_list = (aocl_thread_info_t*)malloc(
+                            sizeof(aocl_thread_info_t) * thread_grp->num_threads);
+            if (thread_grp->threads_info_list == NULL)
+                return -1;
+            thread_grp->partition_queues = (aocl_partition_queue_t*)malloc(
+                            sizeof(aocl_partition_queue_t) * thread_grp->num_workers);
+            if (thread_grp->partition_queues == NULL)
+            {
+                free(thread_grp->threads_info_list);
+                thread_grp->threads_info_list = NULL;
+                return -1;
+            }
+        }
+        init_partition_queues(thread_grp);
+        init_partition_nodes(thread_grp, 0);
+
+        rap_frame_len = RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(thread_grp->rap_version,
+                                                    thread_grp->num_threads, 0);
+        *(AOCL_INT64*)dst = (thread_grp->rap_version == RAP_FRAME_VERSION_64) ?
+                                RAP_MAGIC_WORD_64 : RAP_MAGIC_WORD; //For storing the magic word
         dst += RAP_MAGIC_WORD_BYTES;
         *(AOCL_UINT32*)dst = rap_frame_len; //For storing the total RAP frame length
         dst += RAP_METADATA_LEN_BYTES;
         *(AOCL_UINT32*)dst = thread_grp->num_threads; //For storing the no. of threads
     }
 #ifdef AOCL_THREADS_LOG
-    printf("Input stream size: [%td], Minimum per thread chunk size: [%d]\n",
+    printf("Input stream size: [%td], Minimum per thread chunk size: [%td]\n",
         thread_grp->src_size, chunk_size);
-    printf("Number of max threads: [%d], Number of threads set for execution: [%d]\n",
-        max_threads, thread_grp->num_threads);
+    printf("Number of max threads: [%d], Number of threads set for execution: [%d], Number of partitions: [%d]\n",
+        max_threads, thread_grp->num_workers, thread_grp->num_threads);
 #endif
     return rap_frame_len;
 }
@@ -133,11 +1030,42 @@ AOCL_INT32 aocl_do_partition_compress_mt(aocl_thread_group_t *thread_grp,
     else
         cur_thread_info->partition_src_size = thread_grp->common_part_src_size +
                                         thread_grp->leftover_part_src_bytes;
+
+    //Partitions but the first of a chain may reference the previous partition
+    cur_thread_info->dict_size = (thread_id % thread_grp->chain_len) ?
+                                    thread_grp->common_part_src_size : 0;
     
     cur_thread_info->dst_trap_size = cur_thread_info->partition_src_size +
                                         cmpr_bound_pad;
 
-    cur_thread_info->dst_trap = (AOCL_CHAR *)malloc(cur_thread_info->dst_trap_size);
+    if (thread_grp->in_place_dst)
+        //Bound sized slot reserved for this partition in dst by aocl_enable_in_place_compress_mt()
+        cur_thread_info->dst_trap = thread_grp->dst + thread_grp->in_place_offset +
+                                        (thread_grp->in_place_stride * thread_id);
+    else if (thread_grp->ctx)
+    {
+        //Reuse this thread's buffer from the context, growing it if needed
+        aocl_thread_ctx_t *ctx = thread_grp->ctx;
+        AOCL_INT32 node = numa_placement_active() ? get_current_numa_node() : -1;
+        if (ctx->dst_trap_capacity[thread_id] < cur_thread_info->dst_trap_size)
+        {
+            free(ctx->dst_trap_list[thread_id]);
+            ctx->dst_trap_list[thread_id] = (AOCL_CHAR *)malloc(cur_thread_info->dst_trap_size);
+            ctx->dst_trap_capacity[thread_id] = (ctx->dst_trap_list[thread_id] != NULL) ?
+                                                    cur_thread_info->dst_trap_size : 0;
+            //New pages are first touched by this thread, on its node
+            ctx->dst_trap_node[thread_id] = node;
+        }
+        else if (node >= 0 && ctx->dst_trap_node[thread_id] != node)
+        {
+            //Buffer was placed by a thread of another node on an earlier call
+            move_to_numa_node(ctx->dst_trap_list[thread_id], ctx->dst_trap_capacity[thread_id], node);
+            ctx->dst_trap_node[thread_id] = node;
+        }
+        cur_thread_info->dst_trap = ctx->dst_trap_list[thread_id];
+    }
+    else
+        cur_thread_info->dst_trap = (AOCL_CHAR *)malloc(cur_thread_info->dst_trap_size);
 
 #ifdef AOCL_THREADS_LOG
     printf("aocl_do_partition_compress_mt(): thread id: [%d] dest_trap_size [%td]\n",
@@ -147,20 +1075,270 @@ AOCL_INT32 aocl_do_partition_compress_mt(aocl_thread_group_t *thread_grp,
     if (cur_thread_info->dst_trap == NULL)
         return -1;
 
-    cur_thread_info->next = NULL;//Unused as of now
+    return 0;
+}
+
+//Moves the queue of the calling thread's first partitions to its NUMA node: when the source of its
+//own queue is on another node, the queue is swapped with one not started yet that is on the node
+static AOCL_VOID claim_local_queue(aocl_thread_group_t *thread_grp, AOCL_UINT32 worker_id,
+                                   AOCL_INT32 node)
+{
+    aocl_partition_queue_t *queue = &thread_grp->partition_queues[worker_id];
+    AOCL_UINT32 other_id;
+    if (node < 0 || queue->numa_node == node)
+        return;
+    for (other_id = 0; other_id < thread_grp->num_workers; other_id++)
+    {
+        aocl_partition_queue_t *other = &thread_grp->partition_queues[other_id];
+        if (!other->started && other->numa_node == node && other->num_pending > 0)
+        {
+            aocl_partition_queue_t swap = *queue;
+            queue->head = other->head;
+            queue->num_pending = other->num_pending;
+            queue->numa_node = other->numa_node;
+            other->head = swap.head;
+            other->num_pending = swap.num_pending;
+            other->numa_node = swap.numa_node;
+            return;
+        }
+    }
+}
+
+AOCL_INT32 aocl_get_next_partition_mt(aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 worker_id, AOCL_UINT32* partition_id)
+{
+    assert(thread_grp != NULL);
+    assert(partition_id != NULL);
+    aocl_thread_info_t *partition = NULL;
+    AOCL_INT32 node = -1, placement = 0;
+
+    if (thread_grp->partition_queues == NULL || worker_id >= thread_grp->num_workers)
+        return 0;
+
+    if (get_numa_num_nodes() > 1)
+    {
+        node = get_current_numa_node();
+        placement = AOCL_LOAD_ACQUIRE(numa_placement);
+    }
+
+    aocl_lock_mt(&partition_queue_lock);
+    {
+        aocl_partition_queue_t *queue = &thread_grp->partition_queues[worker_id];
+        if (!queue->started)
+        {
+            if (placement)
+                claim_local_queue(thread_grp, worker_id, node);
+            queue->started = 1;
+        }
+        if (queue->num_pending > 0)
+        {
+            //Take the next partition in order from this thread's own queue
+            partition = queue->head;
+            queue->head = partition->next;
+            queue->num_pending--;
+        }
+        else
+        {
+            //Steal the last partition of the queue with most pending partitions.
+            //The owner keeps working from the head of its queue. With NUMA placement,
+            //queues whose last partition is on this thread's node are preferred
+            AOCL_UINT32 victim_id, max_pending = 0, max_local_pending = 0;
+            aocl_partition_queue_t *victim = NULL, *local_victim = NULL;
+            for (victim_id = 0; victim_id < thread_grp->num_workers; victim_id++)
+            {
+                aocl_partition_queue_t *cur = &thread_grp->partition_queues[victim_id];
+                if (cur->num_pending > max_pending)
+                {
+                    victim = cur;
+                    max_pending = cur->num_pending;
+                }
+                //Queues hold a contiguous range of partitions starting at head
+                if (placement && node >= 0 && cur->num_pending > max_local_pending &&
+                    cur->head[cur->num_pending - 1].numa_node == node)
+                {
+                    local_victim = cur;
+                    max_local_pending = cur->num_pending;
+                }
+            }
+            if (local_victim)
+                victim = local_victim;
+            if (victim)
+            {
+                if (victim->num_pending == 1)
+                {
+                    partition = victim->head;
+                    victim->head = NULL;
+                }
+                else
+                {
+                    aocl_thread_info_t *tail = victim->head;
+                    AOCL_UINT32 cnt;
+                    for (cnt = 2; cnt < victim->num_pending; cnt++)
+                        tail = tail->next;
+                    partition = tail->next;
+                    tail->next = NULL;
+                }
+                victim->num_pending--;
+            }
+        }
+    }
+    aocl_unlock_mt(&partition_queue_lock);
+
+    if (partition == NULL)
+        return 0;
+    if (node >= 0 && partition->numa_node >= 0)
+    {
+        if (partition->numa_node == node)
+        {
+            AOCL_FETCH_ADD(numa_local_partitions, 1);
+            AOCL_FETCH_ADD(numa_local_bytes, (AOCL_UINT64)partition->partition_src_size);
+        }
+        else
+        {
+            AOCL_FETCH_ADD(numa_remote_partitions, 1);
+            AOCL_FETCH_ADD(numa_remote_bytes, (AOCL_UINT64)partition->partition_src_size);
+        }
+    }
+    //Partition ids are assigned by init_partition_queues()
+    *partition_id = (AOCL_UINT32)(partition - thread_grp->threads_info_list);
+    return 1;
+}
+
+AOCL_INT32 aocl_enable_in_place_compress_mt(aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 cmpr_bound_pad, AOCL_INTP dst_reserved)
+{
+    assert(thread_grp != NULL);
+    thread_grp->in_place_dst = 0;
+    if (thread_grp->num_threads <= 1 || thread_grp->dst == NULL)
+        return 0;
+
+    AOCL_INTP stride = thread_grp->common_part_src_size + cmpr_bound_pad;
+    //Last partition also holds the leftover bytes
+    AOCL_INTP bound_end = dst_reserved + (stride * thread_grp->num_threads) +
+                            thread_grp->leftover_part_src_bytes;
+    if (bound_end > thread_grp->dst_size)
+        return 0;
+
+    thread_grp->in_place_offset = dst_reserved;
+    thread_grp->in_place_stride = stride;
+    thread_grp->in_place_dst = 1;
+    return 1;
+}
+
+static inline AOCL_INT32 ranges_overlap(const AOCL_CHAR* a, AOCL_INTP a_size,
+                                        const AOCL_CHAR* b, AOCL_INTP b_size)
+{
+    return (a < b + b_size) && (b < a + a_size);
+}
 
+//Moves of one round of aocl_compact_partitions_mt()
+typedef struct
+{
+    aocl_partition_move_t *moves;
+    const AOCL_CHAR *movable;
+} aocl_compaction_t;
+
+static AOCL_VOID aocl_move_partition(AOCL_VOID *arg, AOCL_INTP k, AOCL_UINT32 worker_id)
+{
+    aocl_compaction_t *compaction = (aocl_compaction_t*)arg;
+    (AOCL_VOID)worker_id;
+    if (compaction->movable[k])
+        memmove(compaction->moves[k].dst, compaction->moves[k].src, compaction->moves[k].size);
+}
+
+AOCL_INT32 aocl_compact_partitions_mt(aocl_partition_move_t* moves,
+                                   AOCL_UINT32 num_moves, AOCL_UINT32 num_threads)
+{
+    AOCL_UINT32 i, j;
+    AOCL_UINT32 num_pending = 0;
+    AOCL_CHAR *pending, *movable;
+    aocl_compaction_t compaction;
+
+    if (num_moves == 0)
+        return 0;
+
+    pending = (AOCL_CHAR*)malloc(2 * num_moves);
+    if (pending == NULL)
+        return -1;
+    movable = pending + num_moves;
+
+    for (i = 0; i < num_moves; i++)
+    {
+        pending[i] = (moves[i].size > 0 && moves[i].src != moves[i].dst);
+        num_pending += pending[i];
+    }
+
+    while (num_pending > 0)
+    {
+        AOCL_UINT32 num_movable = 0;
+        //A move can run now if its destination does not clobber another pending move's source
+        for (i = 0; i < num_moves; i++)
+        {
+            movable[i] = (pending[i] != 0);
+            for (j = 0; j < num_moves && movable[i]; j++)
+            {
+                if (j != i && pending[j] &&
+                    ranges_overlap(moves[i].dst, moves[i].size, moves[j].src, moves[j].size))
+                    movable[i] = 0;
+            }
+            num_movable += movable[i];
+        }
+
+        if (num_movable == 0)
+        {
+            //Cyclic dependency: stage the first pending partition in a temporary buffer
+            AOCL_CHAR *temp_buf;
+            for (i = 0; pending[i] != 1; i++);
+            temp_buf = (AOCL_CHAR*)malloc(moves[i].size);
+            if (temp_buf == NULL)
+            {
+                free(pending);
+                return -1;
+            }
+            memcpy(temp_buf, moves[i].src, moves[i].size);
+            moves[i].src = temp_buf;
+            pending[i] = 2; //Source is now a staged copy to be freed once moved
+            continue;
+        }
+
+        compaction.moves = moves;
+        compaction.movable = movable;
+        aocl_run_parallel_for_mt(aocl_move_partition, &compaction, num_moves,
+                                 (num_movable > 1) ? num_threads : 1);
+
+        for (i = 0; i < num_moves; i++)
+        {
+            if (movable[i])
+            {
+                if (pending[i] == 2)
+                    free(moves[i].src);
+                pending[i] = 0;
+            }
+        }
+        num_pending -= num_movable;
+    }
+
+    free(pending);
     return 0;
 }
 
 void aocl_destroy_parallel_compress_mt(aocl_thread_group_t *thread_grp)
 {
     assert(thread_grp != NULL);
+    if (thread_grp->ctx)
+    {
+        //Threads list, partition queues and dst_trap buffers are owned by the context
+        thread_grp->threads_info_list = NULL;
+        thread_grp->partition_queues = NULL;
+        return;
+    }
     if (thread_grp->threads_info_list)
     {
         AOCL_UINT32 thread_cnt;
         for (thread_cnt = 0; thread_cnt < thread_grp->num_threads; thread_cnt++)
         {
-            if (thread_grp->threads_info_list[thread_cnt].dst_trap)
+            //In in-place mode dst_trap points into dst and is not owned by the thread
+            if (thread_grp->threads_info_list[thread_cnt].dst_trap && !thread_grp->in_place_dst)
             {
                 free(thread_grp->threads_info_list[thread_cnt].dst_trap);
                 thread_grp->threads_info_list[thread_cnt].dst_trap = NULL;
@@ -169,11 +1347,67 @@ void aocl_destroy_parallel_compress_mt(aocl_thread_group_t *thread_grp)
         free(thread_grp->threads_info_list);
         thread_grp->threads_info_list = NULL;
     }
+    free(thread_grp->partition_queues);
+    thread_grp->partition_queues = NULL;
+}
+
+aocl_thread_ctx_t* aocl_create_thread_ctx_mt(aocl_free_thread_state_t free_state)
+{
+    aocl_thread_ctx_t *ctx = (aocl_thread_ctx_t*)calloc(1, sizeof(aocl_thread_ctx_t));
+    if (ctx == NULL)
+        return NULL;
+    ctx->free_state = free_state;
+    return ctx;
+}
+
+void aocl_destroy_thread_ctx_mt(aocl_thread_ctx_t *ctx)
+{
+    AOCL_UINT32 thread_cnt;
+    if (ctx == NULL)
+        return;
+    for (thread_cnt = 0; thread_cnt < ctx->max_threads; thread_cnt++)
+    {
+        free(ctx->dst_trap_list[thread_cnt]);
+        if (ctx->state_list[thread_cnt] && ctx->free_state)
+            ctx->free_state(ctx->state_list[thread_cnt]);
+    }
+    free(ctx->threads_info_list);
+    free(ctx->dst_trap_list);
+    free(ctx->dst_trap_capacity);
+    free(ctx->dst_trap_node);
+    free(ctx->state_list);
+    free(ctx->partition_queues);
+    free(ctx);
+}
+
+AOCL_VOID* aocl_get_thread_state_mt(const aocl_thread_group_t *thread_grp,
+                                   AOCL_UINT32 thread_id, aocl_free_thread_state_t free_state)
+{
+    assert(thread_grp != NULL);
+    if (thread_grp->ctx == NULL || thread_grp->ctx->free_state != free_state ||
+        thread_id >= thread_grp->ctx->max_threads)
+        return NULL;
+    return thread_grp->ctx->state_list[thread_id];
+}
+
+AOCL_INT32 aocl_set_thread_state_mt(aocl_thread_group_t *thread_grp,
+                                   AOCL_UINT32 thread_id, AOCL_VOID *state,
+                                   aocl_free_thread_state_t free_state)
+{
+    assert(thread_grp != NULL);
+    aocl_thread_ctx_t *ctx = thread_grp->ctx;
+    if (ctx == NULL || ctx->free_state == NULL || ctx->free_state != free_state ||
+        thread_id >= ctx->max_threads)
+        return -1;
+    if (ctx->state_list[thread_id] && ctx->state_list[thread_id] != state)
+        ctx->free_state(ctx->state_list[thread_id]);
+    ctx->state_list[thread_id] = state;
+    return 0;
 }
 
 AOCL_INT32 aocl_setup_parallel_decompress_mt(aocl_thread_group_t *thread_grp,
-                                        AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INT32 in_size,
-                                        AOCL_INT32 out_size, AOCL_INT32 use_ST_decompressor)
+                                        AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+                                        AOCL_INTP out_size, AOCL_INT32 use_ST_decompressor)
 {
     assert(thread_grp != NULL);
     if (src == NULL)
@@ -181,18 +1415,28 @@ AOCL_INT32 aocl_setup_parallel_decompress_mt(aocl_thread_group_t *thread_grp,
 
     AOCL_CHAR *src_base;
     AOCL_UINT32 rap_metadata_len;
-    AOCL_UINT32 max_threads = omp_get_max_threads();
+    AOCL_UINT32 max_threads = aocl_get_num_threads_mt();
 
     thread_grp->src = src;
     thread_grp->dst = dst;
     thread_grp->src_size = in_size;
     thread_grp->dst_size = out_size;
     thread_grp->threads_info_list = NULL;
+    thread_grp->partition_queues = NULL;
+    thread_grp->num_workers = 1;
+    thread_grp->chain_len = 1;
+    thread_grp->rap_version = RAP_FRAME_VERSION_32;
+    thread_grp->ctx = NULL;
 
     src_base = thread_grp->src;
 
+    if (thread_grp->src_size >= RAP_MAGIC_WORD_BYTES &&
+        RAP_MAGIC_WORD_64 == *(AOCL_INT64*)src_base)
+        thread_grp->rap_version = RAP_FRAME_VERSION_64;
+
     if ((thread_grp->src_size < RAP_MAGIC_WORD_BYTES) ||
-        (RAP_MAGIC_WORD != *(AOCL_INT64*)src_base))
+        (RAP_MAGIC_WORD != *(AOCL_INT64*)src_base &&
+         RAP_MAGIC_WORD_64 != *(AOCL_INT64*)src_base))
     {
         //Stream is very small or not in multi-threaded RAP format
         //Decompress in single threaded mode
@@ -214,24 +1458,21 @@ AOCL_INT32 aocl_setup_parallel_decompress_mt(aocl_thread_group_t *thread_grp,
         if (use_ST_decompressor == 1)
             return rap_metadata_len;
         
-        //Find number of threads to process the number of parallel partitions
-        if (max_threads >= num_main_threads)
-            //Use exactly num_main_threads threads
-            thread_grp->num_threads = num_main_threads;
-        else
-            //When max_threads is lesser than num_main_threads, we can handle
-            //in two ways:
-            //1) Multi partitions are assigned to each thread as a linked list
-            //using next pointer - This is the efficient and smart approach.
-            //2) Decompress using single-threaded decompressor - This is the
-            //simplest (less complex) and less efficient approach.
-            //Currently, approach 2) is implemented.
-            //thread_grp->num_threads = max_threads;
+        //Each partition in the stream is decompressed independently
+        if (max_threads == 1)
+            //Decompress in single threaded mode when only one thread is available
             thread_grp->num_threads = 1;
+        else
+            thread_grp->num_threads = num_main_threads;
 
         if (thread_grp->num_threads == 1)
             return rap_metadata_len;
 
+        //When max_threads is lesser than num_main_threads, multiple partitions
+        //are queued to each thread through the next pointer
+        thread_grp->num_workers = (max_threads < thread_grp->num_threads) ?
+                                    max_threads : thread_grp->num_threads;
+
         //Tentative partitioning. Actual partitioning is done at thread level
         thread_grp->common_part_src_size = thread_grp->dst_size /
                                             thread_grp->num_threads;
@@ -244,6 +1485,17 @@ AOCL_INT32 aocl_setup_parallel_decompress_mt(aocl_thread_group_t *thread_grp,
 
         if (thread_grp->threads_info_list == NULL)
             return -1;
+
+        thread_grp->partition_queues = (aocl_partition_queue_t*)malloc(
+                        sizeof(aocl_partition_queue_t) * thread_grp->num_workers);
+        if (thread_grp->partition_queues == NULL)
+        {
+            free(thread_grp->threads_info_list);
+            thread_grp->threads_info_list = NULL;
+            return -1;
+        }
+        init_partition_queues(thread_grp);
+        init_partition_nodes(thread_grp, 1);
     }
     return rap_metadata_len;
 }
@@ -255,13 +1507,30 @@ AOCL_INT32 aocl_do_partition_decompress_mt(aocl_thread_group_t* thread_grp,
     assert(thread_grp != NULL);
     assert(cur_thread_info != NULL);
 
-    AOCL_UINT32 cur_rap_pos = RAP_START_OF_PARTITIONS + 
-                            (thread_id * (RAP_DATA_BYTES_WITH_DECOMP_LEN));
-    cur_thread_info->partition_src = thread_grp->src +
-                            *(AOCL_UINT32*)(thread_grp->src + cur_rap_pos);
-    cur_thread_info->partition_src_size = *(AOCL_UINT32*)(thread_grp->src +
-                                            cur_rap_pos + RAP_OFFSET_BYTES);
+    AOCL_INTP rap_offset, rap_len, decomp_len;
+    AOCL_INT32 num_chained;
     cur_thread_info->thread_id = thread_id;
+    cur_thread_info->num_chained = 1;
+
+    //Dependent partitions are decompressed with the start of their chain
+    if (aocl_is_rap_dependent_mt(thread_grp, thread_id))
+    {
+        cur_thread_info->partition_src = NULL;
+        cur_thread_info->partition_src_size = 0;
+        cur_thread_info->dst_trap = NULL;
+        return 1;
+    }
+
+    num_chained = aocl_read_rap_chain_mt(thread_grp, thread_id, thread_grp->num_threads,
+                                         &rap_offset, &rap_len, &decomp_len);
+    if (num_chained < 0)
+    {
+        cur_thread_info->dst_trap = NULL;
+        return -1;
+    }
+    cur_thread_info->partition_src = thread_grp->src + rap_offset;
+    cur_thread_info->partition_src_size = rap_len;
+    cur_thread_info->num_chained = num_chained;
 
     if (cur_thread_info->partition_src_size == 0)
     {
@@ -275,9 +1544,7 @@ AOCL_INT32 aocl_do_partition_decompress_mt(aocl_thread_group_t* thread_grp,
         (thread_grp->dst_size % thread_grp->num_threads) + cmpr_bound_pad;
     cur_thread_info->dst_trap = (AOCL_CHAR*)malloc(cur_thread_info->dst_trap_size);
 #else
-    cur_thread_info->dst_trap_size = (*(AOCL_UINT32*)(thread_grp->src +
-                                        cur_rap_pos + RAP_DATA_BYTES)) +
-                                        cmpr_bound_pad;
+    cur_thread_info->dst_trap_size = decomp_len + cmpr_bound_pad;
     cur_thread_info->dst_trap = (AOCL_CHAR*)malloc(cur_thread_info->dst_trap_size);
 #endif
 
@@ -310,11 +1577,13 @@ void aocl_destroy_parallel_decompress_mt(aocl_thread_group_t* thread_grp)
         free(thread_grp->threads_info_list);
         thread_grp->threads_info_list = NULL;
     }
+    free(thread_grp->partition_queues);
+    thread_grp->partition_queues = NULL;
 }
 
 AOCL_INT32 aocl_get_rap_frame_bound_mt(void) {
-    AOCL_UINT32 max_threads = omp_get_max_threads();
-    return RAP_FRAME_LEN_WITH_DECOMP_LENGTH(max_threads, 0); // upper bound of rap frame length in bytes based on max threads possible
+    AOCL_UINT32 max_threads = aocl_get_available_threads_mt();
+    return RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(max_threads * PARTITIONS_PER_THREAD, 0); // upper bound of rap frame length in bytes based on max partitions possible and the widest RAP format
 }
 
 AOCL_INT32 aocl_skip_rap_frame_mt(AOCL_CHAR* src, AOCL_INT32 src_size)
@@ -323,7 +1592,8 @@ AOCL_INT32 aocl_skip_rap_frame_mt(AOCL_CHAR* src, AOCL_INT32 src_size)
         return ERR_INVALID_INPUT;
 
     if ((src_size < RAP_MAGIC_WORD_BYTES) ||
-        (RAP_MAGIC_WORD != *(AOCL_INT64*)src))
+        (RAP_MAGIC_WORD != *(AOCL_INT64*)src &&
+         RAP_MAGIC_WORD_64 != *(AOCL_INT64*)src))
     {
         return 0; //Stream is very small or not in multi-threaded RAP format
     }
@@ -334,3 +1604,90 @@ AOCL_INT32 aocl_skip_rap_frame_mt(AOCL_CHAR* src, AOCL_INT32 src_size)
         return rap_metadata_len;
     }
 }
+
+AOCL_CHAR* aocl_write_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_CHAR* rap_ptr, AOCL_INTP rap_offset,
+                                     AOCL_INTP rap_len, AOCL_INTP decomp_len)
+{
+    assert(thread_grp != NULL);
+    if (thread_grp->rap_version == RAP_FRAME_VERSION_64)
+    {
+        *(AOCL_INT64*)rap_ptr = rap_offset; //For storing this partition's RAP offset
+        rap_ptr += RAP_OFFSET_BYTES_64;
+        *(AOCL_INT64*)rap_ptr = rap_len; //For storing this partition's RAP length
+        rap_ptr += RAP_LEN_BYTES_64;
+        *(AOCL_INT64*)rap_ptr = decomp_len; //For storing this partition's decompressed length
+        rap_ptr += DECOMP_LEN_BYTES_64;
+    }
+    else
+    {
+        *(AOCL_UINT32*)rap_ptr = (AOCL_UINT32)rap_offset; //For storing this partition's RAP offset
+        rap_ptr += RAP_OFFSET_BYTES;
+        *(AOCL_INT32*)rap_ptr = (AOCL_INT32)rap_len; //For storing this partition's RAP length
+        rap_ptr += RAP_LEN_BYTES;
+        *(AOCL_INT32*)rap_ptr = (AOCL_INT32)decomp_len; //For storing this partition's decompressed length
+        rap_ptr += DECOMP_LEN_BYTES;
+    }
+    return rap_ptr;
+}
+
+void aocl_read_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+                                AOCL_UINT32 partition_id, AOCL_INTP* rap_offset,
+                                AOCL_INTP* rap_len, AOCL_INTP* decomp_len)
+{
+    assert(thread_grp != NULL);
+    AOCL_CHAR* rap_ptr = thread_grp->src + RAP_START_OF_PARTITIONS +
+        ((AOCL_INTP)partition_id * RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(thread_grp->rap_version));
+    if (thread_grp->rap_version == RAP_FRAME_VERSION_64)
+    {
+        *rap_offset = *(AOCL_INT64*)rap_ptr;
+        *rap_len = *(AOCL_INT64*)(rap_ptr + RAP_OFFSET_BYTES_64);
+        *decomp_len = (AOCL_INT64)(*(AOCL_UINT64*)(rap_ptr + RAP_OFFSET_BYTES_64 + RAP_LEN_BYTES_64) &
+                                   ~RAP_DEPENDENT_FLAG_64);
+    }
+    else
+    {
+        *rap_offset = *(AOCL_UINT32*)rap_ptr;
+        *rap_len = *(AOCL_UINT32*)(rap_ptr + RAP_OFFSET_BYTES);
+        *decomp_len = *(AOCL_UINT32*)(rap_ptr + RAP_DATA_BYTES) & ~RAP_DEPENDENT_FLAG;
+    }
+}
+
+void aocl_mark_rap_dependent_mt(const aocl_thread_group_t* thread_grp, AOCL_CHAR* rap_ptr)
+{
+    assert(thread_grp != NULL);
+    //Decompressed length is the last field of the entry
+    if (thread_grp->rap_version == RAP_FRAME_VERSION_64)
+        *(AOCL_UINT64*)(rap_ptr - DECOMP_LEN_BYTES_64) |= RAP_DEPENDENT_FLAG_64;
+    else
+        *(AOCL_UINT32*)(rap_ptr - DECOMP_LEN_BYTES) |= RAP_DEPENDENT_FLAG;
+}
+
+AOCL_INT32 aocl_is_rap_dependent_mt(const aocl_thread_group_t* thread_grp, AOCL_UINT32 partition_id)
+{
+    assert(thread_grp != NULL);
+    AOCL_CHAR* rap_ptr = thread_grp->src + RAP_START_OF_PARTITIONS +
+        ((AOCL_INTP)(partition_id + 1) * RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(thread_grp->rap_version));
+    if (thread_grp->rap_version == RAP_FRAME_VERSION_64)
+        return (*(AOCL_UINT64*)(rap_ptr - DECOMP_LEN_BYTES_64) & RAP_DEPENDENT_FLAG_64) != 0;
+    return (*(AOCL_UINT32*)(rap_ptr - DECOMP_LEN_BYTES) & RAP_DEPENDENT_FLAG) != 0;
+}
+
+AOCL_INT32 aocl_read_rap_chain_mt(const aocl_thread_group_t* thread_grp,
+                                  AOCL_UINT32 partition_id, AOCL_UINT32 num_partitions,
+                                  AOCL_INTP* rap_offset, AOCL_INTP* rap_len, AOCL_INTP* decomp_len)
+{
+    assert(thread_grp != NULL);
+    AOCL_UINT32 next = partition_id + 1;
+    aocl_read_rap_partition_mt(thread_grp, partition_id, rap_offset, rap_len, decomp_len);
+    for (; next < num_partitions && aocl_is_rap_dependent_mt(thread_grp, next); next++)
+    {
+        AOCL_INTP offset, len, part_decomp_len;
+        aocl_read_rap_partition_mt(thread_grp, next, &offset, &len, &part_decomp_len);
+        if (offset != *rap_offset + *rap_len)
+            return -1;
+        *rap_len += len;
+        *decomp_len += part_decomp_len;
+    }
+    return (AOCL_INT32)(next - partition_id);
+}
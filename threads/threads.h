@@ -69,6 +69,13 @@
  * Note 3: To seamlessly decode a AOCL RAP compliant by a legacy single-threaded decompressor without any minor change :                                        *
  *         The decompressors are recommended to skip processing the invalid sequences/blocks/frames and continue with the                                       *
  *         processing of the next sequences/blocks/frames in the stream.                                                                                        *
+ * Note 4: The format is versioned by the magic word. Version 1 (magic word AOCL_LLC) stores RAP Offset, RAP Length and Decompressed Length                *
+ *         in 4 bytes each. Version 2 (magic word AOCL_L64) uses the same header but stores these three fields in 8 bytes each so that                          *
+ *         streams and partitions larger than 4 GiB can be described. The compressor writes version 2 only when the input or output stream                      *
+ *         size does not fit in 32 bits. The decompressor reads both versions.                                                                                  *
+ * Note 5: The top bit of a partition's Decompressed Length marks a dependent partition, whose matches may reference the decompressed data of the             *
+ *         previous partition. A partition without the mark starts a chain, that ends before the next partition without the mark. The compressed data of a     *
+ *         chain is contiguous and is decompressed as a whole. Streams of a single-threaded decompressor are not affected.                                      *
  ****************************************************************************************************************************************************************/
 
 #ifdef __cplusplus
@@ -77,6 +84,10 @@ extern "C"
 #endif
 
 #define RAP_MAGIC_WORD 0x434C4C5F4C434F41 //ASCII encoding of AOCL_LLC
+#define RAP_MAGIC_WORD_64 0x34364C5F4C434F41 //ASCII encoding of AOCL_L64
+#define RAP_FRAME_VERSION_32 1 //RAP metadata fields stored in 4 bytes
+#define RAP_FRAME_VERSION_64 2 //RAP metadata fields stored in 8 bytes
+#define RAP_FRAME_32BIT_LIMIT 0xFFFFFFFFLL //Largest stream size described by RAP_FRAME_VERSION_32
 #define RAP_MAGIC_WORD_BYTES 8
 #define RAP_METADATA_LEN_BYTES 4
 #define RAP_MAIN_THREAD_COUNT_BYTES 2
@@ -101,10 +112,31 @@ extern "C"
     RAP_MAIN_THREAD_COUNT_BYTES + RAP_CHILD_THREAD_COUNT_BYTES + \
     (mainThreads * (RAP_OFFSET_BYTES + RAP_LEN_BYTES + DECOMP_LEN_BYTES)) + \
     (childThreads * mainThreads * (RAP_OFFSET_BYTES + RAP_LEN_BYTES)) )
+#define RAP_OFFSET_BYTES_64 8
+#define RAP_LEN_BYTES_64 8
+#define DECOMP_LEN_BYTES_64 8
+#define RAP_DATA_BYTES_WITH_DECOMP_LEN_64 (RAP_OFFSET_BYTES_64 + RAP_LEN_BYTES_64 + DECOMP_LEN_BYTES_64)
+#define RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(mainThreads, childThreads)    ( \
+    RAP_MAGIC_WORD_BYTES + \
+    RAP_METADATA_LEN_BYTES + \
+    RAP_MAIN_THREAD_COUNT_BYTES + RAP_CHILD_THREAD_COUNT_BYTES + \
+    (mainThreads * (RAP_OFFSET_BYTES_64 + RAP_LEN_BYTES_64 + DECOMP_LEN_BYTES_64)) + \
+    (childThreads * mainThreads * (RAP_OFFSET_BYTES_64 + RAP_LEN_BYTES_64)) )
+#define RAP_DEPENDENT_FLAG 0x80000000U //Top bit of Decompressed Length marking a dependent partition (RAP_FRAME_VERSION_32)
+#define RAP_DEPENDENT_FLAG_64 0x8000000000000000ULL //Top bit of Decompressed Length marking a dependent partition (RAP_FRAME_VERSION_64)
+#define RAP_DATA_BYTES_WITH_DECOMP_LEN_VER(version) (((version) == RAP_FRAME_VERSION_64) ? \
+    RAP_DATA_BYTES_WITH_DECOMP_LEN_64 : RAP_DATA_BYTES_WITH_DECOMP_LEN)
+#define RAP_FRAME_LEN_WITH_DECOMP_LENGTH_VER(version, mainThreads, childThreads) (((version) == RAP_FRAME_VERSION_64) ? \
+    RAP_FRAME_LEN_WITH_DECOMP_LENGTH_64(mainThreads, childThreads) : \
+    RAP_FRAME_LEN_WITH_DECOMP_LENGTH(mainThreads, childThreads))
 //#define APPROX_PADDED_DST_CHUNK //Keep this disabled as it is more accurate to send the actual dest decompressed len bytes
 
 #define WINDOW_FACTOR 4
 
+//Maximum number of partitions per thread. Input is over-partitioned so that threads that finish
+//early can steal pending partitions from slower threads
+#define PARTITIONS_PER_THREAD 4
+
 //#define AOCL_THREADS_LOG
 #ifdef AOCL_THREADS_LOG
 #include <stdio.h>
@@ -122,24 +154,73 @@ typedef struct thread_info
     AOCL_UINT32 num_child_threads;   //Child threads : May be used in future for further overlapped parallel processing
     AOCL_UINT32 is_error;            //Has the compression or decompression executed for this chunk: Does not gurantee correctness of results
     AOCL_UINT32 thread_id;           //Thread id of the current thread
-    struct thread_info *next;   //In case, more no. of compressed chunks/partitions needs to be decompressed using a smaller no. of threads
+    AOCL_INT32 numa_node;            //NUMA node holding the partition's source. -1 when unknown or not on a NUMA system
+    AOCL_INTP dict_size;             //Compression: source bytes just before partition_src that the partition may reference. 0 for independent partitions
+    AOCL_UINT32 num_chained;         //Decompression: partitions decompressed together, starting with this one. 1 when no partition depends on it
+    struct thread_info *next;   //Next partition in the same thread's queue of pending partitions
 } aocl_thread_info_t;
 
+//Queue of partitions pending for one thread. Partitions are chained through aocl_thread_info_t::next
+typedef struct partition_queue
+{
+    aocl_thread_info_t *head;   //Next partition to be processed by the owning thread
+    AOCL_UINT32 num_pending;    //Number of partitions in the queue
+    AOCL_INT32 numa_node;       //NUMA node holding the source of the partitions in the queue. -1 when unknown
+    AOCL_UINT32 started;        //Set once the owning thread has taken its first partition
+} aocl_partition_queue_t;
+
+//Release function for a per thread codec state held in a reusable thread context
+typedef AOCL_VOID (*aocl_free_thread_state_t)(AOCL_VOID *state);
+
+//Reusable multi-threaded compression context
+// Created once by the caller and passed to repeated compression calls, so that the thread info list,
+// the per thread dst_trap buffers and the per thread codec states (hash tables, codec contexts)
+// are allocated on the first call and reused by the later ones
+typedef struct thread_ctx
+{
+    aocl_thread_info_t *threads_info_list;  //Thread info list shared by the thread groups set up with this context
+    AOCL_CHAR **dst_trap_list;              //Per thread dst_trap buffers used when not compressing in-place
+    AOCL_INTP *dst_trap_capacity;           //Allocated length of each buffer in dst_trap_list
+    AOCL_INT32 *dst_trap_node;              //NUMA node each buffer in dst_trap_list was placed on. -1 when unknown
+    AOCL_VOID **state_list;                 //Per thread codec states
+    aocl_partition_queue_t *partition_queues; //Per thread partition queues
+    aocl_free_thread_state_t free_state;    //Release function for the entries in state_list. Identifies the codec owning the states
+    AOCL_UINT32 max_threads;                //Number of entries allocated in the lists above
+} aocl_thread_ctx_t;
+
 //Thread group data structure held by the master thread that spawns all the threads
-// Holds a list of thread info related to all the spawned threads and actual input and output stream buffer pointer
+// Holds a list of thread info related to all the partitions and actual input and output stream buffer pointer
+// There may be more partitions than threads. Each thread processes the partitions in its queue
+// and then steals pending partitions from the queues of the other threads
 typedef struct thread_group
 {
-    aocl_thread_info_t *threads_info_list;  //List of thread info related to all the spawned threads 
+    aocl_thread_info_t *threads_info_list;  //List of thread info related to all the partitions
     AOCL_CHAR *src;                              //Actual input stream buffer pointer
     AOCL_CHAR *dst;                              //Actual output stream buffer pointer
     AOCL_INTP src_size;                          //Actual input stream buffer length
     AOCL_INTP dst_size;                          //Actual output stream buffer length
     AOCL_INTP common_part_src_size;              //Partitioned src length based on num_threads (may not be equal)
     AOCL_INTP leftover_part_src_bytes;           //Leftover src length after partitioning
-    AOCL_UINT32 num_threads;                     //Dynamically determined threads to be used for processing
+    AOCL_UINT32 num_threads;                     //Dynamically determined number of partitions, each processed by one thread at a time
+    AOCL_UINT32 num_workers;                     //Number of threads spawned to process the partitions (<= num_threads)
     AOCL_UINT32 search_window_length;            //Search window (dictionary) size used by the partitioning scheme
+    AOCL_UINT32 rap_version;                     //RAP frame format version (RAP_FRAME_VERSION_32 or RAP_FRAME_VERSION_64)
+    AOCL_UINT32 chain_len;                       //Partitions per chain when dictionary priming is enabled, 1 otherwise
+    AOCL_UINT32 in_place_dst;                    //When set, partitions are compressed directly into dst instead of per thread buffers
+    AOCL_INTP in_place_offset;                   //Offset in dst of the first partition's output in in-place mode
+    AOCL_INTP in_place_stride;                   //Distance in dst between consecutive partition outputs in in-place mode
+    aocl_thread_ctx_t *ctx;                      //Reusable context owning the thread buffers, NULL when they are allocated per call
+    aocl_partition_queue_t *partition_queues;    //Per thread queues of pending partitions
 } aocl_thread_group_t;
 
+//Describes the move of one partition's compressed output to its final position in the output stream
+typedef struct partition_move
+{
+    AOCL_CHAR *src;                              //Current position of the partition output
+    AOCL_CHAR *dst;                              //Final position of the partition output
+    AOCL_INTP size;                              //Number of bytes to move
+} aocl_partition_move_t;
+
 #ifndef EXPORT_SYM_THREADS
 #ifdef AOCL_UNIT_TEST
 #ifdef _WINDOWS
@@ -171,7 +252,11 @@ typedef struct thread_group
  * The master thread shall allocate and hold thread_grp before calling this function
  *
  * This function allocates thread context and determines how many threads are suitable to compress the input.
- * Each thread processes a part of the src (partition). partition size = win_len * window_factor.
+ * The src is split into partitions of at least win_len * window_factor bytes, up to PARTITIONS_PER_THREAD
+ * partitions per thread. thread_grp->num_threads is set to the number of partitions and
+ * thread_grp->num_workers to the number of threads to spawn.
+ * RAP_FRAME_VERSION_64 is selected when in_size or out_size exceeds RAP_FRAME_32BIT_LIMIT,
+ * RAP_FRAME_VERSION_32 otherwise. The selected version is saved in thread_grp->rap_version.
  *
  * | Parameters             | Direction   | Description |
  * |:-----------------------|:-----------:|:------------|
@@ -192,8 +277,42 @@ typedef struct thread_group
  *
  */
 EXPORT_SYM_THREADS AOCL_INT32 aocl_setup_parallel_compress_mt(aocl_thread_group_t* thread_grp,
-                                      AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INT32 in_size,
-                                      AOCL_INT32 out_size, AOCL_INT32 win_len,
+                                      AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+                                      AOCL_INTP out_size, AOCL_INT32 win_len,
+                                      AOCL_INT32 window_factor);
+
+/**
+ * Function to setup the multi-threaded compressor with a reusable context.
+ *
+ * Same as aocl_setup_parallel_compress_mt(), except that the thread info list and the
+ * per thread dst_trap buffers are taken from ctx. ctx grows them when more threads are needed
+ * and keeps them after aocl_destroy_parallel_compress_mt(), so that a later call with the same
+ * ctx does not allocate them again. When ctx is NULL, this behaves as aocl_setup_parallel_compress_mt().
+ * A context must not be used by two thread groups at the same time.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | out         | Holds list of thread info, pointers to input and output streams and other information needed for multi-threaded compression. |
+ * | \b ctx                 | in/out      | Reusable context created by aocl_create_thread_ctx_mt(), or NULL. |
+ * | \b src                 | in          | Input stream buffer pointer. |
+ * | \b dst                 | in          | Output stream buffer pointer. |
+ * | \b in_size             | in          | Input stream buffer size. |
+ * | \b out_size            | in          | Output stream buffer pointer. |
+ * | \b win_len             | in          | Search window length. |
+ * | \b window_factor       | in          | Multiplication factor used to determine partition size. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | RAP frame length (RAP header + RAP metadata) |
+ * | Fail       | `ERR_INVALID_INPUT`                          |
+ * | ^          | -1                                           |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_setup_parallel_compress_ctx_mt(aocl_thread_group_t* thread_grp,
+                                      aocl_thread_ctx_t* ctx,
+                                      AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+                                      AOCL_INTP out_size, AOCL_INT32 win_len,
                                       AOCL_INT32 window_factor);
 
 /**
@@ -202,18 +321,23 @@ EXPORT_SYM_THREADS AOCL_INT32 aocl_setup_parallel_compress_mt(aocl_thread_group_
  * Sets cur_thread_info with info about the partition said thread is expected to process.
  * If an algorithm has a compress bound of D bytes for a source of S bytes, cmpr_bound_pad must be set to (D-S) bytes.
  *
- * Call for each thread from a multi-threaded parallel region.
+ * Call for each partition returned by aocl_get_next_partition_mt() from a multi-threaded parallel region.
  *
  * This function partitions the problem and allocates thread working buffer.
  * Each thread holds its own local cur_thread_info that is allocated here.
  * Upon completion of compression, references from cur_thread_info should be copied into thread_grp->threads_info_list[thread_id].
+ * With NUMA placement enabled, a buffer kept in the thread context that was placed on another node by an
+ * earlier call is moved to the node of the calling thread.
+ * With dictionary priming enabled (aocl_set_dict_priming_mt()), every partition but the first of each chain of
+ * thread_grp->chain_len partitions gets a non zero cur_thread_info->dict_size: the codec may prime its match finder with
+ * the source just before the partition and must then mark the partition with aocl_mark_rap_dependent_mt().
  *
  * | Parameters             | Direction   | Description |
  * |:-----------------------|:-----------:|:------------|
  * | \b thread_grp          | in          | Holds list of thread info, pointers to input and output streams and other information needed for multi-threaded compression. |
  * | \b cur_thread_info     | out         | Current thread info. |
  * | \b cmpr_bound_pad      | in          | Numbers of bytes in addition to source partition size that compressed stream can produce. |
- * | \b thread_id           | in          | Current thread id. |
+ * | \b thread_id           | in          | Partition id returned by aocl_get_next_partition_mt(). |
  *
  * return
  * | Result     | Description |
@@ -226,11 +350,88 @@ EXPORT_SYM_THREADS AOCL_INT32 aocl_do_partition_compress_mt(aocl_thread_group_t*
                                    aocl_thread_info_t* cur_thread_info,
                                    AOCL_UINT32 cmpr_bound_pad, AOCL_UINT32 thread_id);
 
+/**
+ * Function to get the next partition for a thread to process.
+ *
+ * Call from a multi-threaded parallel region of thread_grp->num_workers threads, in a loop until it returns 0.
+ * Partitions are first taken in order from the calling thread's own queue. When that queue is empty,
+ * the last pending partition of the queue with most pending partitions is stolen.
+ * Works for thread groups set up by both the compressor and the decompressor.
+ * On NUMA systems with placement enabled (aocl_set_numa_placement_mt()), a thread first swaps its
+ * queue with a queue not started yet whose source is on the thread's node, and steals from queues
+ * whose last partition is on its node before the others.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in/out      | Thread group set up by aocl_setup_parallel_compress_mt() or aocl_setup_parallel_decompress_mt(). |
+ * | \b worker_id           | in          | Current thread id in the parallel region. |
+ * | \b partition_id        | out         | Index in thread_grp->threads_info_list of the partition to process. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | 1 when a partition is returned |
+ * | ^          | 0 when all partitions have been taken |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_get_next_partition_mt(aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 worker_id, AOCL_UINT32* partition_id);
+
+/**
+ * Function to switch the multi-threaded compressor to in-place (zero-copy) mode.
+ *
+ * Call from the master thread after aocl_setup_parallel_compress_mt() and before the parallel region.
+ * If dst can hold dst_reserved bytes followed by every partition's compress bound, later calls to
+ * aocl_do_partition_compress_mt() point dst_trap directly into dst at precomputed bound offsets
+ * instead of allocating a buffer per thread. Partition outputs are then gathered with
+ * aocl_compact_partitions_mt(). If dst is too small, per thread buffers are used as before.
+ * All threads must pass this same cmpr_bound_pad to aocl_do_partition_compress_mt().
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in/out      | Thread group set up by aocl_setup_parallel_compress_mt(). |
+ * | \b cmpr_bound_pad      | in          | Numbers of bytes in addition to source partition size that compressed stream can produce. |
+ * | \b dst_reserved        | in          | Bytes at the start of dst kept free for the RAP frame and any other stream header. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | 1 when in-place mode is enabled, 0 when per thread buffers are used |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_enable_in_place_compress_mt(aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 cmpr_bound_pad, AOCL_INTP dst_reserved);
+
+/**
+ * Function to move partition outputs to their final positions in the output stream.
+ *
+ * Call from the master thread after the parallel compression region.
+ * Source and destination ranges may overlap, as in in-place mode. Moves whose destination does not
+ * overlap the source of any other pending move are done in parallel with memmove. Moves are
+ * repeated in rounds until all partitions are placed.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b moves               | in          | List of partition moves. |
+ * | \b num_moves           | in          | Number of entries in moves. |
+ * | \b num_threads         | in          | Maximum number of threads to use. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | 0           |
+ * | Fail       | -1          |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_compact_partitions_mt(aocl_partition_move_t* moves,
+                                   AOCL_UINT32 num_moves, AOCL_UINT32 num_threads);
+
 /**
  * Function to free memory associated with the multi-threaded compressor.
  *
  * Call from the master thread.
  * Frees the thread related buffers and context.
+ * Buffers owned by the reusable context thread_grp->ctx are kept for the next call.
  *
  * | Parameters             | Direction   | Description |
  * |:-----------------------|:-----------:|:------------|
@@ -248,7 +449,10 @@ EXPORT_SYM_THREADS void aocl_destroy_parallel_compress_mt(aocl_thread_group_t* t
  *
  * Call from a single master thread.
  * Reads the RAP Frame header from the src buffer to setup the thread group.
+ * Both RAP_FRAME_VERSION_32 and RAP_FRAME_VERSION_64 frames are accepted.
  * Allocates thread context and determines no. of threads suitable to decompress the input.
+ * thread_grp->num_threads is set to the number of partitions in the RAP frame and
+ * thread_grp->num_workers to the number of threads to spawn, which may be smaller.
  * The master thread shall allocate and hold thread_grp before calling this function.
  *
  *
@@ -270,32 +474,35 @@ EXPORT_SYM_THREADS void aocl_destroy_parallel_compress_mt(aocl_thread_group_t* t
  *
  */
 EXPORT_SYM_THREADS AOCL_INT32 aocl_setup_parallel_decompress_mt(aocl_thread_group_t* thread_grp,
-                                        AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INT32 in_size,
-                                        AOCL_INT32 out_size, 
+                                        AOCL_CHAR* src, AOCL_CHAR* dst, AOCL_INTP in_size,
+                                        AOCL_INTP out_size, 
                                         AOCL_INT32 use_ST_decoompressor);
 /**
  * Function to perform partitioning for the multi-threaded decompressor.
  *
  * Sets cur_thread_info with info about the partition said thread is expected to process.
  *
- * Call for each thread from a multi-threaded parallel region.
+ * Call for each partition returned by aocl_get_next_partition_mt() from a multi-threaded parallel region.
  *
  * This function partitions the problem and allocates thread working buffer.
  * Each thread holds its own local cur_thread_info that is allocated here.
  * Upon completion of decompression, references from cur_thread_info should be copied into thread_grp->threads_info_list[thread_id].
+ * A partition that starts a chain (see aocl_read_rap_chain_mt()) is set up with the compressed and decompressed data of the
+ * whole chain, and cur_thread_info->num_chained is the number of partitions in it. Dependent partitions are decompressed
+ * with the start of their chain and are reported as empty.
  *
  * | Parameters             | Direction   | Description |
  * |:-----------------------|:-----------:|:------------|
  * | \b thread_grp          | in          | Holds list of thread info, pointers to input and output streams and other information needed for multi-threaded decompression. |
  * | \b cur_thread_info     | out         | Current thread info. |
  * | \b cmpr_bound_pad      | in          | Number of additional padding bytes if needed for the allocated destination buffer. |
- * | \b thread_id           | in          | Current thread id. |
+ * | \b thread_id           | in          | Partition id returned by aocl_get_next_partition_mt(). |
  *
  * return
  * | Result     | Description |
  * |:-----------|:------------|
  * | Success    | 0           |
- * | Success    | 1 when partition source size for this thread_id is 0 |
+ * | Success    | 1 when partition source size for this thread_id is 0 or the partition is dependent |
  * | Fail       | -1                                                   |
  *
  */
@@ -318,6 +525,304 @@ EXPORT_SYM_THREADS AOCL_INT32 aocl_do_partition_decompress_mt(aocl_thread_group_
  */
 EXPORT_SYM_THREADS void aocl_destroy_parallel_decompress_mt(aocl_thread_group_t* thread_grp);
 
+/**
+ * Function to write the RAP metadata of one partition.
+ *
+ * Call from the master thread during post processing, once per partition and in partition order.
+ * Field widths follow thread_grp->rap_version as set by aocl_setup_parallel_compress_mt().
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_compress_mt(). |
+ * | \b rap_ptr             | out         | Position in the RAP metadata where this partition's entry is written. |
+ * | \b rap_offset          | in          | Offset of the partition's compressed data from the start of the RAP frame. |
+ * | \b rap_len             | in          | Length of the partition's compressed data. |
+ * | \b decomp_len          | in          | Length of the partition's decompressed data. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Position in the RAP metadata just past the written entry |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_CHAR* aocl_write_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_CHAR* rap_ptr, AOCL_INTP rap_offset,
+                                     AOCL_INTP rap_len, AOCL_INTP decomp_len);
+
+/**
+ * Function to read the RAP metadata of one partition.
+ *
+ * Field widths follow thread_grp->rap_version as set by aocl_setup_parallel_decompress_mt().
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_decompress_mt(). |
+ * | \b partition_id        | in          | Index of the partition in the RAP metadata. |
+ * | \b rap_offset          | out         | Offset of the partition's compressed data from the start of the RAP frame. |
+ * | \b rap_len             | out         | Length of the partition's compressed data. |
+ * | \b decomp_len          | out         | Length of the partition's decompressed data. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS void aocl_read_rap_partition_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_UINT32 partition_id, AOCL_INTP* rap_offset,
+                                     AOCL_INTP* rap_len, AOCL_INTP* decomp_len);
+
+/**
+ * Function to mark the partition whose RAP metadata was just written as dependent.
+ *
+ * A dependent partition may reference the decompressed data of the previous partition.
+ * Mark the partitions compressed with a non zero aocl_thread_info_t::dict_size.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_compress_mt(). |
+ * | \b rap_ptr             | in/out      | Position returned by aocl_write_rap_partition_mt() for the partition. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS void aocl_mark_rap_dependent_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_CHAR* rap_ptr);
+
+/**
+ * Function to check if a partition depends on the previous one.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_decompress_mt(). |
+ * | \b partition_id        | in          | Index of the partition in the RAP metadata. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | 1 if the partition is marked dependent, 0 otherwise |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_is_rap_dependent_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_UINT32 partition_id);
+
+/**
+ * Function to read the RAP metadata of the chain that starts with a partition.
+ *
+ * The chain holds the partition and the dependent partitions that follow it. Its compressed
+ * data is contiguous and decompresses to the concatenation of the partitions' decompressed data.
+ * For a partition that nothing depends on, this is aocl_read_rap_partition_mt().
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_decompress_mt(). |
+ * | \b partition_id        | in          | Index of the first partition of the chain in the RAP metadata. |
+ * | \b num_partitions      | in          | Number of partitions in the RAP metadata. |
+ * | \b rap_offset          | out         | Offset of the chain's compressed data from the start of the RAP frame. |
+ * | \b rap_len             | out         | Length of the chain's compressed data. |
+ * | \b decomp_len          | out         | Length of the chain's decompressed data. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Number of partitions in the chain |
+ * | Fail       | -1, the compressed data of the chain is not contiguous |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_read_rap_chain_mt(const aocl_thread_group_t* thread_grp,
+                                     AOCL_UINT32 partition_id, AOCL_UINT32 num_partitions,
+                                     AOCL_INTP* rap_offset, AOCL_INTP* rap_len, AOCL_INTP* decomp_len);
+
+/**
+ * Function to create a reusable multi-threaded compression context.
+ *
+ * The context starts empty. Buffers are allocated by the first aocl_setup_parallel_compress_ctx_mt()
+ * call that uses it and are freed by aocl_destroy_thread_ctx_mt().
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b free_state          | in          | Release function for the per thread codec states stored with aocl_set_thread_state_mt(). May be NULL if no state is stored. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Pointer to the context |
+ * | Fail       | NULL                   |
+ *
+ */
+EXPORT_SYM_THREADS aocl_thread_ctx_t* aocl_create_thread_ctx_mt(aocl_free_thread_state_t free_state);
+
+/**
+ * Function to free a reusable multi-threaded compression context.
+ *
+ * Frees the thread info list, the per thread dst_trap buffers and the per thread codec states.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b ctx                 | in/out      | Context created by aocl_create_thread_ctx_mt(). May be NULL. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS void aocl_destroy_thread_ctx_mt(aocl_thread_ctx_t* ctx);
+
+/**
+ * Function to get the codec state kept for a thread by the reusable context.
+ *
+ * Call for each thread from a multi-threaded parallel region.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_compress_ctx_mt(). |
+ * | \b thread_id           | in          | Current thread id. |
+ * | \b free_state          | in          | Release function of the calling codec's states. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | State stored by an earlier call with the same context |
+ * | Fail       | NULL when there is no context, no state yet, or the context belongs to another codec |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_VOID* aocl_get_thread_state_mt(const aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 thread_id, aocl_free_thread_state_t free_state);
+
+/**
+ * Function to keep a thread's codec state in the reusable context for later calls.
+ *
+ * Call for each thread from a multi-threaded parallel region.
+ * On success the context owns state and releases it with free_state. On failure the caller
+ * still owns state and must release it.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b thread_grp          | in          | Thread group set up by aocl_setup_parallel_compress_ctx_mt(). |
+ * | \b thread_id           | in          | Current thread id. |
+ * | \b state               | in          | Codec state to keep. |
+ * | \b free_state          | in          | Release function of the calling codec's states. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | 0           |
+ * | Fail       | -1 when there is no context or the context belongs to another codec |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_set_thread_state_mt(aocl_thread_group_t* thread_grp,
+                                   AOCL_UINT32 thread_id, AOCL_VOID* state,
+                                   aocl_free_thread_state_t free_state);
+
+//Task run by each worker of aocl_run_parallel_mt(). worker_id is in [0, num_workers)
+typedef AOCL_VOID (*aocl_parallel_task_t)(AOCL_VOID *arg, AOCL_UINT32 worker_id);
+
+//Task run for each item of aocl_run_parallel_for_mt() by the worker worker_id
+typedef AOCL_VOID (*aocl_parallel_for_task_t)(AOCL_VOID *arg, AOCL_INTP item, AOCL_UINT32 worker_id);
+
+/**
+ * Function to run a parallel region of num_workers workers.
+ *
+ * Calls task(arg, worker_id) once for each worker_id in [0, num_workers) and returns when all
+ * the calls have completed. The workers run on the executor registered with aocl_set_executor(),
+ * or in an OpenMP parallel region when there is none. The calling thread runs worker 0.
+ * The workers may run on fewer threads than num_workers, one after the other, and the executor
+ * may fail to queue some of them: a task should share its work through aocl_get_next_partition_mt()
+ * or a shared counter, so that the running workers take the work of the others.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b task                | in          | Worker function. |
+ * | \b arg                 | in          | Passed to task. |
+ * | \b num_workers         | in          | Number of workers. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS AOCL_VOID aocl_run_parallel_mt(aocl_parallel_task_t task, AOCL_VOID *arg,
+                                   AOCL_UINT32 num_workers);
+
+/**
+ * Function to run a loop of num_items items on up to num_workers workers.
+ *
+ * Calls task(arg, item, worker_id) once for each item in [0, num_items). Items are handed out
+ * one at a time to the workers of aocl_run_parallel_mt(), as a dynamic schedule does.
+ *
+ * | Parameters             | Direction   | Description |
+ * |:-----------------------|:-----------:|:------------|
+ * | \b task                | in          | Function run for each item. |
+ * | \b arg                 | in          | Passed to task. |
+ * | \b num_items           | in          | Number of items. |
+ * | \b num_workers         | in          | Maximum number of workers. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS AOCL_VOID aocl_run_parallel_for_mt(aocl_parallel_for_task_t task, AOCL_VOID *arg,
+                                   AOCL_INTP num_items, AOCL_UINT32 num_workers);
+
+/**
+ * Lock guarding the short critical sections shared by the workers of a parallel region.
+ * Workers may be threads of an executor registered by aocl_set_executor() rather than
+ * OpenMP threads, so OpenMP critical sections are not used for these. A lock set to 0 is
+ * released.
+ */
+typedef AOCL_INT32 aocl_lock_t;
+
+/**
+ * Function to take a lock, waiting while another thread holds it.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b lock         | in,out      | Lock to take. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS AOCL_VOID aocl_lock_mt(aocl_lock_t *lock);
+
+/**
+ * Function to release a lock taken by aocl_lock_mt().
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b lock         | in,out      | Lock to release. |
+ *
+ * return void
+ *
+ */
+EXPORT_SYM_THREADS AOCL_VOID aocl_unlock_mt(aocl_lock_t *lock);
+
+/**
+ * Function to get the number of threads available to the process.
+ *
+ * This is aocl_executor::numThreads of the registered executor, or omp_get_max_threads(),
+ * capped by the cgroup CPU quota of the process when it runs under one (Linux only). The quota
+ * is read on the first call. The thread budget set by aocl_set_num_threads_mt() is not applied,
+ * so this bounds the threads of any call.
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Number of available threads, at least 1 |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_UINT32 aocl_get_available_threads_mt(void);
+
+/**
+ * Function to replace the thread budget of the calling thread for the duration of a call.
+ *
+ * The aocl_llc_* APIs apply aocl_compression_desc::numThreads with it, and give the budget it
+ * returns back to aocl_set_num_threads_mt() before they return, so that the budget of the caller
+ * is kept.
+ *
+ * | Parameters      | Direction   | Description |
+ * |:----------------|:-----------:|:------------|
+ * | \b num_threads  | in          | Budget for the call. 0 or less keeps the budget already set. |
+ *
+ * return
+ * | Result     | Description |
+ * |:-----------|:------------|
+ * | Success    | Budget replaced, 0 when none was set |
+ *
+ */
+EXPORT_SYM_THREADS AOCL_INT32 aocl_swap_num_threads_mt(AOCL_INT32 num_threads);
+
 #ifdef __cplusplus
 }
 #endif
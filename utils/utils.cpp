@@ -42,17 +42,233 @@
 #include "utils/utils.h"
 
 #ifdef AOCL_ENABLE_LOG_FEATURE
+#include <stdarg.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-aocl_log_ctx logCtx = {-1};
+aocl_log_ctx logCtx = {AOCL_LOG_LEVEL_UNSET};
 
 #ifdef __cplusplus
 }
 #endif
 
+#define AOCL_LOG_LINE_MAX 512
+#define AOCL_LOG_RING_SLOTS 4096 //power of 2
+
+//Copies the value of an environment variable into value, returns 0 if not set
+static int aocl_log_getenv(const char* name, char* value, size_t size)
+{
+#ifdef _WINDOWS
+    size_t len = 0;
+    if (getenv_s(&len, value, size, name) != 0 || len == 0)
+        return 0;
+#else
+    const char* env = getenv(name);
+    if (env == NULL)
+        return 0;
+    strncpy(value, env, size - 1);
+    value[size - 1] = '\0';
+#endif
+    return 1;
+}
+
+int aocl_log_get_level(aocl_log_ctx* ctx)
+{
+    int level = AOCL_LOAD_ACQUIRE(ctx->maxLevel);
+    if (level != AOCL_LOG_LEVEL_UNSET)
+        return level;
+
+    //Threads racing here read the same value
+    char value[8] = { 0 };
+    level = 0;
+    if (aocl_log_getenv("AOCL_ENABLE_LOG", value, sizeof(value)))
+    {
+        if (!strcmp(value, "ERR"))
+            level = ERR;
+        else if (!strcmp(value, "INFO"))
+            level = INFO;
+        else if (!strcmp(value, "DEBUG"))
+            level = DEBUG;
+        else if (!strcmp(value, "TRACE"))
+            level = TRACE;
+    }
+    AOCL_STORE_RELEASE(ctx->maxLevel, level);
+    return level;
+}
+
+/* Asynchronous log sink: a bounded ring of log lines, filled by any thread
+ * without locks and written to stdio by a background thread. Each slot holds
+ * a sequence number telling whether it is free for the producer of a given
+ * position or holds a line for the consumer of that position. */
+typedef struct {
+    std::atomic<size_t> seq;
+    int toStderr;
+    char line[AOCL_LOG_LINE_MAX];
+} aocl_log_slot;
+
+typedef struct {
+    aocl_log_slot* slots;
+    std::atomic<size_t> enqueuePos;
+    std::atomic<size_t> dequeuePos;
+    std::atomic<int> running;
+    std::thread writer;
+} aocl_log_ring;
+
+static std::atomic<aocl_log_ring*> aocl_log_sink(NULL); //NULL when lines are written directly
+static std::once_flag aocl_log_sink_once;
+
+static int aocl_log_ring_push(aocl_log_ring* ring, const char* line, int toStderr)
+{
+    size_t pos = ring->enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        aocl_log_slot* slot = &ring->slots[pos & (AOCL_LOG_RING_SLOTS - 1)];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        if (seq == pos)
+        {
+            if (ring->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                strcpy(slot->line, line);
+                slot->toStderr = toStderr;
+                slot->seq.store(pos + 1, std::memory_order_release);
+                return 1;
+            }
+        }
+        else if (seq < pos)
+            return 0; //full
+        else
+            pos = ring->enqueuePos.load(std::memory_order_relaxed);
+    }
+}
+
+//Writes out the next line, returns 0 if the ring is empty
+static int aocl_log_ring_pop(aocl_log_ring* ring)
+{
+    size_t pos = ring->dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        aocl_log_slot* slot = &ring->slots[pos & (AOCL_LOG_RING_SLOTS - 1)];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        if (seq == pos + 1)
+        {
+            if (ring->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                fputs(slot->line, slot->toStderr ? stderr : stdout);
+                slot->seq.store(pos + AOCL_LOG_RING_SLOTS, std::memory_order_release);
+                return 1;
+            }
+        }
+        else if (seq < pos + 1)
+            return 0; //empty
+        else
+            pos = ring->dequeuePos.load(std::memory_order_relaxed);
+    }
+}
+
+static void aocl_log_ring_writer(aocl_log_ring* ring)
+{
+    while (ring->running.load(std::memory_order_acquire))
+    {
+        if (!aocl_log_ring_pop(ring))
+        {
+            fflush(stdout);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    while (aocl_log_ring_pop(ring))
+        ;
+    fflush(stdout);
+}
+
+//Stops the writer at exit once the pending lines are out. The ring is kept,
+//as lines logged afterwards are written directly.
+static struct aocl_log_sink_stopper {
+    ~aocl_log_sink_stopper()
+    {
+        aocl_log_ring* ring = aocl_log_sink.exchange(NULL);
+        if (ring == NULL)
+            return;
+        ring->running.store(0, std::memory_order_release);
+#ifdef _WINDOWS
+        //The writer may no longer run during unload
+        ring->writer.detach();
+        while (aocl_log_ring_pop(ring))
+            ;
+#else
+        ring->writer.join();
+#endif
+    }
+} aocl_log_sink_stop;
+
+static void aocl_log_sink_start(void)
+{
+    char value[4] = { 0 };
+    if (!aocl_log_getenv("AOCL_ENABLE_LOG_ASYNC", value, sizeof(value)) || strcmp(value, "ON"))
+        return;
+
+    aocl_log_ring* ring = new (std::nothrow) aocl_log_ring;
+    if (ring == NULL)
+        return;
+    ring->slots = new (std::nothrow) aocl_log_slot[AOCL_LOG_RING_SLOTS];
+    if (ring->slots == NULL)
+    {
+        delete ring;
+        return;
+    }
+    for (size_t i = 0; i < AOCL_LOG_RING_SLOTS; i++)
+        ring->slots[i].seq.store(i, std::memory_order_relaxed);
+    ring->enqueuePos.store(0, std::memory_order_relaxed);
+    ring->dequeuePos.store(0, std::memory_order_relaxed);
+    ring->running.store(1, std::memory_order_relaxed);
+    try
+    {
+        ring->writer = std::thread(aocl_log_ring_writer, ring);
+    }
+    catch (...)
+    {
+        delete[] ring->slots;
+        delete ring;
+        return;
+    }
+    aocl_log_sink.store(ring);
+}
+
+void aocl_log_write(int logType, const char* file, const char* func, int line,
+    const char* fmt, ...)
+{
+    static const char* types[] = { "", "ERR", "INFO", "DEBUG", "TRACE" };
+    char buf[AOCL_LOG_LINE_MAX];
+    int len = snprintf(buf, sizeof(buf), "[%s] : %s : %s : %d : ",
+        types[(logType >= ERR && logType <= TRACE) ? logType : 0], file, func, line);
+    if (len < 0)
+        return;
+    if (len < (int)sizeof(buf) - 1)
+    {
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+        va_end(args);
+    }
+    //Lines cut to the buffer keep their newline
+    len = (int)strlen(buf);
+    if (len > (int)sizeof(buf) - 2)
+        len = (int)sizeof(buf) - 2;
+    buf[len] = '\n';
+    buf[len + 1] = '\0';
+
+    std::call_once(aocl_log_sink_once, aocl_log_sink_start);
+    aocl_log_ring* ring = aocl_log_sink.load(std::memory_order_acquire);
+    if (ring == NULL || !aocl_log_ring_push(ring, buf, logType == ERR))
+        fputs(buf, (logType == ERR) ? stderr : stdout);
+}
+
 #endif /* AOCL_ENABLE_LOG_FEATURE */
 
 AOCL_INTP is_SSE2_supported(AOCL_VOID)
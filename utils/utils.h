@@ -84,6 +84,48 @@ typedef struct timespec timeVal;
 #define AOCL_ENTER_CRITICAL(func) AOCL_BUILD_PRAGMA(omp critical (func)) {
 #define AOCL_EXIT_CRITICAL(func) }
 
+/* Flags shared across threads are read with AOCL_LOAD_ACQUIRE() and
+ * published with AOCL_STORE_RELEASE(). */
+#if defined(_MSC_VER) && !defined(__clang__)
+/* volatile accesses have acquire/release semantics under /volatile:ms, the
+ * default for x86 targets */
+#define AOCL_LOAD_ACQUIRE(var) (*(volatile int *)&(var))
+#define AOCL_STORE_RELEASE(var, val) (*(volatile int *)&(var) = (val))
+#else
+#define AOCL_LOAD_ACQUIRE(var) __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define AOCL_STORE_RELEASE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#endif
+
+/* Dynamic dispatcher state (registered function pointers and the key they
+ * were registered for) is thread local. Each thread is bound to the
+ * optOff/optLevel of the handle it is running, so handles with different
+ * settings can be used at the same time without overwriting each other.
+ * The initial-exec model reads it at a fixed offset from the thread pointer
+ * instead of calling __tls_get_addr() on each access from the shared library.
+ * Hot loops still load the pointers they call into locals once per call. */
+#if defined(_MSC_VER)
+#define AOCL_TLS __declspec(thread)
+#else
+#define AOCL_TLS __thread __attribute__((tls_model("initial-exec")))
+#endif
+
+/* Dispatcher key of a thread that has not been set up yet */
+#define AOCL_DISPATCH_UNSET 0
+/* Encode optOff and optLevel (-1 to 4) of a setup into a single non-zero key */
+#define AOCL_DISPATCH_KEY(optOff, optLevel) ((((optLevel) + 8) << 1) | ((optOff) ? 1 : 0))
+#define AOCL_DISPATCH_OPT_OFF(key) ((key) & 1)
+#define AOCL_DISPATCH_OPT_LEVEL(key) (((key) >> 1) - 8)
+
+/* Workers of a codec's parallel region, OpenMP threads or threads of the
+ * executor set by aocl_set_executor(), are not set up yet. Pass them
+ * the key of the thread that started the region, and each worker calls the
+ * codec's setup(optOff, optLevel, insize, level, windowLog) with it. */
+#define AOCL_SETUP_WORKER(key, setup) do {                                    \
+        if ((key) != AOCL_DISPATCH_UNSET)                                     \
+            setup(AOCL_DISPATCH_OPT_OFF(key), AOCL_DISPATCH_OPT_LEVEL(key),   \
+                  0, 0, 0);                                                   \
+    } while (0)
+
 #include <string.h>
 #include <stdio.h>
 #include "api/types.h"
@@ -92,124 +134,43 @@ typedef struct timespec timeVal;
 #ifdef AOCL_ENABLE_LOG_FEATURE
 
 typedef struct {
-int maxLevel; // set via AOCL_ENABLE_LOG
+int maxLevel; // set via AOCL_ENABLE_LOG, AOCL_LOG_LEVEL_UNSET until read
 //LOG* filePtr; in the future, we can add a pointer to a log file here and pass it instead of logging to stdout
 } aocl_log_ctx;
 
+/* Above all log levels, so that the first log statement reads AOCL_ENABLE_LOG */
+#define AOCL_LOG_LEVEL_UNSET 0x7fffffff
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
     extern aocl_log_ctx logCtx;
 
+    /* Reads AOCL_ENABLE_LOG into ctx->maxLevel on first use and returns it */
+    int aocl_log_get_level(aocl_log_ctx* ctx);
+
+    /* Writes a log line. Lines go to stdout, or stderr for ERR, through a
+     * background thread when AOCL_ENABLE_LOG_ASYNC=ON is set. */
+    void aocl_log_write(int logType, const char* file, const char* func, int line,
+        const char* fmt, ...);
+
 #ifdef __cplusplus
 }
 #endif
 
-#ifdef AOCL_ENABLE_LOG_FEATURE
-#ifdef _WINDOWS
-#include <stdlib.h>
-#define SET_MAX_LOG_LEVEL(logCtx)\
-{\
-                            _Pragma("omp critical")\
-                            {\
-                                char AOCL_Compression_logs[8] = {0};\
-                                size_t env_var_size = 8;\
-                                getenv_s(&env_var_size, AOCL_Compression_logs, env_var_size, "AOCL_ENABLE_LOG");\
-                                if(env_var_size == 0)\
-                                    logCtx.maxLevel = 0;\
-                                else if(!strcmp(AOCL_Compression_logs, "ERR"))\
-                                    logCtx.maxLevel = 1;\
-                                else if(!strcmp(AOCL_Compression_logs, "INFO"))\
-                                    logCtx.maxLevel = 2;\
-                                else if(!strcmp(AOCL_Compression_logs, "DEBUG"))\
-                                    logCtx.maxLevel = 3;\
-                                else if(!strcmp(AOCL_Compression_logs, "TRACE"))\
-                                    logCtx.maxLevel = 4;\
-                                else\
-                                    logCtx.maxLevel = 0;\
-                            }\
-}
-#else
-#define SET_MAX_LOG_LEVEL(logCtx)\
-{\
-                            _Pragma("omp critical")\
-                            {\
-                                const char * AOCL_Compression_logs = getenv("AOCL_ENABLE_LOG");\
-                                if(AOCL_Compression_logs == NULL)\
-                                    logCtx.maxLevel = 0;\
-                                else if(!strcmp(AOCL_Compression_logs, "ERR"))\
-                                    logCtx.maxLevel = 1;\
-                                else if(!strcmp(AOCL_Compression_logs, "INFO"))\
-                                    logCtx.maxLevel = 2;\
-                                else if(!strcmp(AOCL_Compression_logs, "DEBUG"))\
-                                    logCtx.maxLevel = 3;\
-                                else if(!strcmp(AOCL_Compression_logs, "TRACE"))\
-                                    logCtx.maxLevel = 4;\
-                                else\
-                                    logCtx.maxLevel = 0;\
-                            }\
-}
-#endif /* _WINDOWS */
-#endif
+/* Once the level is read, a disabled log statement costs a single load and
+ * compare. Only enabled levels reach aocl_log_get_level(). */
+#define AOCL_LOG_ENABLED(logType, logCtx) \
+    ((logType) <= AOCL_LOAD_ACQUIRE(logCtx.maxLevel) && (logType) <= aocl_log_get_level(&logCtx))
 
 #define LOG_UNFORMATTED(logType, logCtx, str)     do {\
-                            SET_MAX_LOG_LEVEL(logCtx)\
-                            if (logType <= logCtx.maxLevel)\
-                            {\
-                                const char *type=NULL;\
-                                if (logType == ERR)\
-                                    type = "ERR";\
-                                else if (logType == INFO)\
-                                    type = "INFO";\
-                                else if (logType == DEBUG)\
-                                    type = "DEBUG";\
-                                else if (logType == TRACE)\
-                                    type = "TRACE";\
-                                if(logType == ERR)\
-                                {\
-                                    fprintf(stderr, "[%s] : %s : %s : %d : ",\
-                                    type, __FILE__, FUNC_NAME, __LINE__);\
-                                    fprintf(stderr, str);\
-                                    fprintf(stderr, "\n");\
-                                }\
-                                else\
-                                {\
-                                    fprintf(stdout, "[%s] : %s : %s : %d : ",\
-                                    type, __FILE__, FUNC_NAME, __LINE__);\
-                                    fprintf(stdout, str);\
-                                    fprintf(stdout, "\n");\
-                                }\
-                            }\
+                            if (AOCL_LOG_ENABLED(logType, logCtx))\
+                                aocl_log_write(logType, __FILE__, FUNC_NAME, __LINE__, str);\
                         } while (0)
 #define LOG_FORMATTED(logType, logCtx, str, ...)     do {\
-                            SET_MAX_LOG_LEVEL(logCtx)\
-                            if (logType <= logCtx.maxLevel)\
-                            {\
-                                const char *type=NULL;\
-                                if (logType == ERR)\
-                                    type = "ERR";\
-                                else if (logType == INFO)\
-                                    type = "INFO";\
-                                else if (logType == DEBUG)\
-                                    type = "DEBUG";\
-                                else if (logType == TRACE)\
-                                    type = "TRACE";\
-                                if(logType == ERR)\
-                                {\
-                                    fprintf(stderr, "[%s] : %s : %s : %d : ",\
-                                    type, __FILE__, FUNC_NAME, __LINE__);\
-                                    fprintf(stderr, str, __VA_ARGS__);\
-                                    fprintf(stderr, "\n");\
-                                }\
-                                else\
-                                {\
-                                    fprintf(stdout, "[%s] : %s : %s : %d : ",\
-                                    type, __FILE__, FUNC_NAME, __LINE__);\
-                                    fprintf(stdout, str, __VA_ARGS__);\
-                                    fprintf(stdout, "\n");\
-                                }\
-                            }\
+                            if (AOCL_LOG_ENABLED(logType, logCtx))\
+                                aocl_log_write(logType, __FILE__, FUNC_NAME, __LINE__, str, __VA_ARGS__);\
                         } while (0)
 #else /* !AOCL_ENABLE_LOG_FEATURE */
 #define LOG_UNFORMATTED(logType, logCtx, str)